@@ -0,0 +1,994 @@
+//
+//  bench.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Generates synthetic heck programs with a tunable shape and times heck_scan, heck_parse,
+//	and heck_resolve separately while the program size is scaled up. The results can be saved
+//	as a JSON baseline and later runs can be compared against it.
+//	The programs are type correct, so a scale that fails to parse or resolve fails the whole run.
+//
+//	Build it with every file in src except main.c, for example:
+//	cc -O2 -Isrc/... bench/bench.c $(find src -name '*.c' ! -name main.c) -lpthread -lm
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+
+#include "code_impl.h"
+#include "scanner.h"
+#include "parser.h"
+#include "resolver.h"
+#include "function.h"
+#include "flat_tree.h"
+#include "mem.h"
+
+// functions, classes, and globals are split between namespaces in groups of this size
+#define BENCH_GROUP_SIZE 64
+
+#define BENCH_MAX_POINTS 32
+
+typedef struct bench_shape {
+	int num_funcs;		// before scaling, includes every overload
+	int num_classes;
+	int num_globals;
+	int num_stmts;		// let statements in each function body
+	int nest_depth;		// depth of the if/else blocks in each function body
+	int overloads;		// overloads for each function name
+	int expr_len;		// operands in each expression
+	int nmsp_depth;		// depth of the namespaces around each group
+	double fwd_refs;	// fraction of calls from initializers to functions that come later in the program
+	unsigned seed;
+} bench_shape;
+
+typedef struct bench_point {
+	int scale;
+	size_t bytes;
+	int lines;
+	size_t tokens;
+	size_t nodes;
+	double scan_ms;
+	double parse_ms;
+	double resolve_ms;
+	size_t peak_bytes;
+	bool parsed;
+	bool resolved;
+} bench_point;
+
+/*
+ *
+ * Generating
+ *
+ */
+
+typedef struct gen {
+	FILE* f;
+	const bench_shape* shape;
+	int num_funcs;
+	int num_classes;
+	int num_globals;
+	int num_groups;
+	uint32_t rng;
+} gen;
+
+// the current declaration and the locals it can use in expressions
+typedef struct gen_ctx {
+	int group;
+	double pos; // how far into the program the declaration is, used for forward references
+	int num_params;
+	int num_locals;
+	bool in_func;
+} gen_ctx;
+
+// the types that expressions are generated for
+typedef enum gen_type {
+	GEN_INT,
+	GEN_FLOAT,
+	GEN_BOOL,
+	GEN_STRING, // only used for arguments
+} gen_type;
+
+// parameter i has the type i % 4, locals, globals, and members have the type i % 3,
+// and every overload of function name i returns the type i % 3
+static const char* param_types[] = { "int", "float", "bool", "string" };
+
+// what an operator needs on each side
+typedef enum gen_operands {
+	OPERANDS_RESULT,	// the same type as the result
+	OPERANDS_NUMBERS,	// ints or floats, with at least one float if the result is a float
+	OPERANDS_EQUAL,		// any type, as long as both sides are the same
+} gen_operands;
+
+typedef struct gen_op {
+	const char* op;
+	int prec; // matches the precedence in expression.c, lower binds tighter
+	gen_operands operands;
+} gen_op;
+
+static const gen_op int_ops[] = {
+	{ "*", 3, OPERANDS_RESULT }, { "/", 3, OPERANDS_RESULT }, { "%", 3, OPERANDS_RESULT },
+	{ "+", 4, OPERANDS_RESULT }, { "-", 4, OPERANDS_RESULT }, { "<<", 5, OPERANDS_RESULT },
+	{ ">>", 5, OPERANDS_RESULT }, { "&", 6, OPERANDS_RESULT }, { "^", 7, OPERANDS_RESULT },
+	{ "|", 8, OPERANDS_RESULT }
+};
+static const gen_op float_ops[] = {
+	{ "*", 3, OPERANDS_NUMBERS }, { "/", 3, OPERANDS_NUMBERS },
+	{ "+", 4, OPERANDS_NUMBERS }, { "-", 4, OPERANDS_NUMBERS }
+};
+static const gen_op bool_ops[] = {
+	{ "<", 9, OPERANDS_NUMBERS }, { "==", 10, OPERANDS_EQUAL },
+	{ "&&", 11, OPERANDS_RESULT }, { "||", 13, OPERANDS_RESULT }
+};
+
+// an expression that is never inside of another one doesn't need parentheses
+#define GEN_PREC_TOP 100
+
+#define array_len(a) (sizeof(a) / sizeof((a)[0]))
+
+// xorshift so the same seed gives the same program everywhere
+static uint32_t gen_rand(gen* g) {
+	uint32_t x = g->rng;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	g->rng = x;
+	return x;
+}
+
+static int gen_below(gen* g, int n) {
+	return n <= 0 ? 0 : (int)(gen_rand(g) % (uint32_t)n);
+}
+
+static bool gen_chance(gen* g, double p) {
+	return (gen_rand(g) >> 8) < p * (double)(1 << 24);
+}
+
+static int gen_group(gen* g, int item, int num_items) {
+	return (int)((long)item * g->num_groups / num_items);
+}
+
+static void gen_indent(gen* g, int indent) {
+	for (int i = 0; i < indent; ++i)
+		fputc('\t', g->f);
+}
+
+// picks an item from a list, later in the program than ctx with a probability of fwd_refs
+static int gen_target(gen* g, const gen_ctx* ctx, int num_items) {
+	int item = (int)(ctx->pos * num_items);
+	if (item >= num_items)
+		item = num_items - 1;
+	
+	bool forward = gen_chance(g, g->shape->fwd_refs);
+	int num_after = num_items - item - 1;
+	
+	if ((forward || item == 0) && num_after > 0)
+		return item + 1 + gen_below(g, num_after);
+	if (item > 0)
+		return gen_below(g, item);
+	return item;
+}
+
+// picks an item that comes before ctx in the program, or -1 if there isn't one
+static int gen_earlier(gen* g, const gen_ctx* ctx, int num_items) {
+	int item = (int)(ctx->pos * num_items);
+	if (item > num_items)
+		item = num_items;
+	return item > 0 ? gen_below(g, item) : -1;
+}
+
+// names in another group are qualified with their namespaces
+static void gen_qualify(gen* g, const gen_ctx* ctx, int group) {
+	if (group == ctx->group)
+		return;
+	for (int d = 0; d < g->shape->nmsp_depth; ++d)
+		fprintf(g->f, "n%d_%d.", group, d);
+}
+
+// picks one of the items before limit with the type, where item i has the type i % period
+static int gen_typed(gen* g, gen_type type, int limit, int period) {
+	if (limit <= (int)type)
+		return -1;
+	return (int)type + period * gen_below(g, (limit - 1 - (int)type) / period + 1);
+}
+
+static void gen_literal(gen* g, gen_type type) {
+	switch (type) {
+		case GEN_INT:
+			fprintf(g->f, "%d", gen_below(g, 100));
+			break;
+		case GEN_FLOAT:
+			fprintf(g->f, "%d.%d", gen_below(g, 100), gen_below(g, 10));
+			break;
+		case GEN_BOOL:
+			fputs(gen_chance(g, 0.5) ? "true" : "false", g->f);
+			break;
+		case GEN_STRING:
+			fprintf(g->f, "\"s%d\"", gen_below(g, 100));
+			break;
+	}
+}
+
+// moves func to the nearest name that returns the type, keeping the overload.
+// functions can only call earlier functions, so it only moves forward for initializers
+static int gen_func_returning(gen* g, int func, gen_type type, bool in_func) {
+	int overloads = g->shape->overloads;
+	int name = func / overloads;
+	name -= (name % 3 - (int)type + 3) % 3;
+	if (name < 0 && !in_func)
+		name += 3;
+	
+	func = name * overloads + func % overloads;
+	return name >= 0 && func < g->num_funcs ? func : -1;
+}
+
+static void gen_expr(gen* g, const gen_ctx* ctx, gen_type type, int len, int limit, bool in_call);
+
+static void gen_call(gen* g, const gen_ctx* ctx, gen_type type) {
+	/*
+	 *	the program has to be free of cycles to resolve, so functions only call earlier functions
+	 *	and never use globals, while initializers only use earlier globals but can call any function
+	 */
+	int func = ctx->in_func ? gen_earlier(g, ctx, g->num_funcs) : gen_target(g, ctx, g->num_funcs);
+	if (func >= 0)
+		func = gen_func_returning(g, func, type, ctx->in_func);
+	if (func < 0) {
+		gen_literal(g, type);
+		return;
+	}
+	
+	gen_qualify(g, ctx, gen_group(g, func, g->num_funcs));
+	fprintf(g->f, "f%d(", func / g->shape->overloads);
+	
+	// the argument count picks the overload, and the arguments match its parameters
+	int num_args = func % g->shape->overloads + 1;
+	for (int i = 0; i < num_args; ++i) {
+		if (i > 0)
+			fputs(", ", g->f);
+		gen_expr(g, ctx, (gen_type)(i % array_len(param_types)), 1, GEN_PREC_TOP, true);
+	}
+	fputc(')', g->f);
+}
+
+static void gen_operand(gen* g, const gen_ctx* ctx, gen_type type, bool in_call) {
+	if (type == GEN_STRING) {
+		gen_literal(g, type);
+		return;
+	}
+	
+	int item;
+	switch (gen_below(g, in_call ? 3 : 5)) {
+		case 0:
+			gen_literal(g, type);
+			return;
+		case 1:
+			if ((item = gen_typed(g, type, ctx->num_params, array_len(param_types))) >= 0) {
+				fprintf(g->f, "a%d", item);
+				return;
+			}
+			break;
+		case 2:
+			if ((item = gen_typed(g, type, ctx->num_locals, 3)) >= 0) {
+				fprintf(g->f, "v%d", item);
+				return;
+			}
+			break;
+		case 3:
+			gen_call(g, ctx, type);
+			return;
+	}
+	
+	int global = ctx->in_func ? -1 : gen_earlier(g, ctx, g->num_globals);
+	if (global >= 0)
+		global = gen_typed(g, type, global + 1, 3);
+	if (global < 0) {
+		gen_literal(g, type);
+		return;
+	}
+	
+	gen_qualify(g, ctx, gen_group(g, global, g->num_globals));
+	fprintf(g->f, "g%d", global);
+}
+
+static gen_type gen_number(gen* g) {
+	return gen_chance(g, 0.5) ? GEN_INT : GEN_FLOAT;
+}
+
+// an expression with len operands, in parentheses if its operator has a precedence of limit or more
+static void gen_expr(gen* g, const gen_ctx* ctx, gen_type type, int len, int limit, bool in_call) {
+	if (len <= 1 || type == GEN_STRING) {
+		gen_operand(g, ctx, type, in_call);
+		return;
+	}
+	
+	const gen_op* op;
+	switch (type) {
+		case GEN_INT:
+			op = &int_ops[gen_below(g, array_len(int_ops))];
+			break;
+		case GEN_FLOAT:
+			op = &float_ops[gen_below(g, array_len(float_ops))];
+			break;
+		default:
+			op = &bool_ops[gen_below(g, array_len(bool_ops))];
+			break;
+	}
+	
+	gen_type left = type, right = type;
+	if (op->operands == OPERANDS_NUMBERS) {
+		left = gen_number(g);
+		right = gen_number(g);
+		if (type == GEN_FLOAT && left == GEN_INT && right == GEN_INT)
+			*(gen_chance(g, 0.5) ? &left : &right) = GEN_FLOAT;
+	} else if (op->operands == OPERANDS_EQUAL) {
+		left = right = (gen_type)gen_below(g, 3);
+	}
+	
+	bool parens = op->prec >= limit;
+	if (parens)
+		fputc('(', g->f);
+	
+	// operators are left associative, so only the right side needs parentheses for the same precedence
+	int left_len = 1 + gen_below(g, len - 1);
+	gen_expr(g, ctx, left, left_len, op->prec + 1, in_call);
+	fprintf(g->f, " %s ", op->op);
+	gen_expr(g, ctx, right, len - left_len, op->prec, in_call);
+	
+	if (parens)
+		fputc(')', g->f);
+}
+
+static void gen_let(gen* g, gen_ctx* ctx, int indent) {
+	gen_indent(g, indent);
+	fprintf(g->f, "let v%d = ", ctx->num_locals);
+	gen_expr(g, ctx, (gen_type)(ctx->num_locals % 3), g->shape->expr_len, GEN_PREC_TOP, false);
+	fputc('\n', g->f);
+	++ctx->num_locals;
+}
+
+static void gen_nested(gen* g, gen_ctx* ctx, int depth, int indent) {
+	if (depth == 0)
+		return;
+	
+	gen_indent(g, indent);
+	fprintf(g->f, "if a0 < %d {\n", gen_below(g, 100));
+	
+	// locals declared in the block are out of scope once it ends
+	int num_locals = ctx->num_locals;
+	gen_let(g, ctx, indent + 1);
+	gen_nested(g, ctx, depth - 1, indent + 1);
+	ctx->num_locals = num_locals;
+	
+	gen_indent(g, indent);
+	fputs("} else {\n", g->f);
+	gen_let(g, ctx, indent + 1);
+	ctx->num_locals = num_locals;
+	
+	gen_indent(g, indent);
+	fputs("}\n", g->f);
+}
+
+static void gen_func(gen* g, const char* name, int func, int num_params, int indent) {
+	gen_ctx ctx = { gen_group(g, func, g->num_funcs), (double)func / g->num_funcs, num_params, 0, true };
+	
+	gen_indent(g, indent);
+	fprintf(g->f, "func %s(", name);
+	for (int i = 0; i < num_params; ++i)
+		fprintf(g->f, "%s%s a%d", i > 0 ? ", " : "", param_types[i % array_len(param_types)], i);
+	fputs(") {\n", g->f);
+	
+	int half = g->shape->num_stmts / 2;
+	for (int i = 0; i < half; ++i)
+		gen_let(g, &ctx, indent + 1);
+	gen_nested(g, &ctx, g->shape->nest_depth, indent + 1);
+	for (int i = half; i < g->shape->num_stmts; ++i)
+		gen_let(g, &ctx, indent + 1);
+	
+	// the latest local with the return type, or any other operand with it
+	gen_type return_type = (gen_type)(func / g->shape->overloads % 3);
+	int local = ctx.num_locals - 1;
+	while (local >= 0 && local % 3 != (int)return_type)
+		--local;
+	
+	gen_indent(g, indent + 1);
+	fputs("return ", g->f);
+	if (local >= 0)
+		fprintf(g->f, "v%d", local);
+	else
+		gen_operand(g, &ctx, return_type, true);
+	fputc('\n', g->f);
+	
+	gen_indent(g, indent);
+	fputs("}\n", g->f);
+}
+
+static void gen_class(gen* g, int class, int indent) {
+	gen_ctx ctx = { gen_group(g, class, g->num_classes), (double)class / g->num_classes, 0, 0, false };
+	
+	gen_indent(g, indent);
+	fprintf(g->f, "class C%d {\n", class);
+	for (int i = 0; i < 2; ++i) {
+		gen_indent(g, indent + 1);
+		fprintf(g->f, "let m%d = ", i);
+		gen_expr(g, &ctx, (gen_type)(i % 3), g->shape->expr_len, GEN_PREC_TOP, false);
+		fputc('\n', g->f);
+	}
+	
+	char name[32];
+	for (int i = 0; i < 2; ++i) {
+		snprintf(name, sizeof(name), "method%d", i);
+		gen_func(g, name, (int)(ctx.pos * g->num_funcs), i + 1, indent + 1);
+	}
+	
+	gen_indent(g, indent);
+	fputs("}\n", g->f);
+}
+
+static void gen_global(gen* g, int global, int indent) {
+	gen_ctx ctx = { gen_group(g, global, g->num_globals), (double)global / g->num_globals, 0, 0, false };
+	
+	gen_indent(g, indent);
+	fprintf(g->f, "let g%d = ", global);
+	gen_expr(g, &ctx, (gen_type)(global % 3), g->shape->expr_len, GEN_PREC_TOP, false);
+	fputc('\n', g->f);
+}
+
+static void gen_program(FILE* f, const bench_shape* shape, int scale) {
+	gen g = { f, shape };
+	g.num_funcs = shape->num_funcs * scale;
+	g.num_classes = shape->num_classes * scale;
+	g.num_globals = shape->num_globals * scale;
+	g.rng = shape->seed != 0 ? shape->seed : 1;
+	
+	int largest = g.num_funcs;
+	if (g.num_classes > largest)
+		largest = g.num_classes;
+	if (g.num_globals > largest)
+		largest = g.num_globals;
+	
+	g.num_groups = (largest + BENCH_GROUP_SIZE - 1) / BENCH_GROUP_SIZE;
+	if (g.num_groups < 1)
+		g.num_groups = 1;
+	
+	int next_func = 0, next_class = 0, next_global = 0;
+	
+	for (int group = 0; group < g.num_groups; ++group) {
+		int indent = 0;
+		for (int d = 0; d < shape->nmsp_depth; ++d) {
+			gen_indent(&g, indent++);
+			fprintf(f, "namespace n%d_%d {\n", group, d);
+		}
+		
+		for (; next_global < g.num_globals && gen_group(&g, next_global, g.num_globals) == group; ++next_global)
+			gen_global(&g, next_global, indent);
+		
+		for (; next_class < g.num_classes && gen_group(&g, next_class, g.num_classes) == group; ++next_class)
+			gen_class(&g, next_class, indent);
+		
+		char name[32];
+		for (; next_func < g.num_funcs && gen_group(&g, next_func, g.num_funcs) == group; ++next_func) {
+			snprintf(name, sizeof(name), "f%d", next_func / shape->overloads);
+			gen_func(&g, name, next_func, next_func % shape->overloads + 1, indent);
+		}
+		
+		while (indent > 0) {
+			gen_indent(&g, --indent);
+			fputs("}\n", f);
+		}
+	}
+}
+
+/*
+ *
+ * Measuring
+ *
+ */
+
+static double now_ms(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// diagnostics from the generated programs would drown out the results
+static int silence_stderr(void) {
+	fflush(stderr);
+	int saved = dup(STDERR_FILENO);
+	int null_fd = open("/dev/null", O_WRONLY);
+	if (null_fd >= 0) {
+		dup2(null_fd, STDERR_FILENO);
+		close(null_fd);
+	}
+	return saved;
+}
+
+static void restore_stderr(int saved) {
+	if (saved < 0)
+		return;
+	fflush(stderr);
+	dup2(saved, STDERR_FILENO);
+	close(saved);
+}
+
+static size_t count_block_nodes(heck_block* block) {
+	heck_flat_tree* tree = flat_tree_create(block);
+	size_t num_nodes = flat_tree_num_nodes(tree);
+	flat_tree_free(tree);
+	return num_nodes;
+}
+
+// the global block plus every function body that was parsed
+static size_t count_nodes(heck_code* c) {
+	size_t num_nodes = count_block_nodes(c->global);
+	
+	if (c->body_vec != NULL) {
+		vec_size_t num_bodies = vector_size(c->body_vec);
+		for (vec_size_t i = 0; i < num_bodies; ++i) {
+			heck_func* func = c->body_vec[i];
+			if (func->body_parsed && func->code != NULL)
+				num_nodes += count_block_nodes(func->code);
+		}
+	}
+	
+	return num_nodes;
+}
+
+static size_t max_rss_bytes(void) {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return (size_t)usage.ru_maxrss * 1024; // kilobytes on linux
+}
+
+// runs one pass over the source, times are only kept if they beat the ones in point
+static void bench_run(bench_point* point, char* source, size_t size, int num_threads, bool verbose, bool first) {
+	FILE* f = fmemopen(source, size, "rb");
+	if (f == NULL) {
+		perror("fmemopen");
+		exit(1);
+	}
+	
+	size_t start_bytes = mem_current_bytes();
+	mem_reset_peak();
+	
+	int saved = verbose ? -1 : silence_stderr();
+	
+	heck_code* c = heck_create();
+	
+	double t0 = now_ms();
+	bool scanned = heck_scan(c, f);
+	double t1 = now_ms();
+	bool parsed = heck_parse(c, num_threads);
+	double t2 = now_ms();
+	bool resolved = heck_resolve(c, num_threads);
+	double t3 = now_ms();
+	
+	restore_stderr(saved);
+	
+	if (first || t1 - t0 < point->scan_ms)
+		point->scan_ms = t1 - t0;
+	if (first || t2 - t1 < point->parse_ms)
+		point->parse_ms = t2 - t1;
+	if (first || t3 - t2 < point->resolve_ms)
+		point->resolve_ms = t3 - t2;
+	
+	if (first) {
+		point->lines = heck_num_lines(c);
+		point->tokens = heck_num_tokens(c);
+		point->nodes = count_nodes(c);
+		point->parsed = scanned && parsed;
+		point->resolved = resolved;
+		point->peak_bytes = mem_stats_enabled() ? mem_peak_bytes() - start_bytes : max_rss_bytes();
+	}
+	
+	heck_free(c);
+	fclose(f);
+}
+
+static void bench_point_run(bench_point* point, const bench_shape* shape, int scale, int reps, int num_threads, bool verbose) {
+	char* source = NULL;
+	size_t size = 0;
+	FILE* f = open_memstream(&source, &size);
+	gen_program(f, shape, scale);
+	fclose(f);
+	
+	point->scale = scale;
+	point->bytes = size;
+	
+	for (int i = 0; i < reps; ++i)
+		bench_run(point, source, size, num_threads, verbose, i == 0);
+	
+	free(source);
+}
+
+// the slope of the least squares line through log(tokens) and log(time),
+// about 1 for a phase that scales linearly with the size of the program
+static double scaling_exponent(const bench_point* points, int num_points, size_t phase) {
+	double sum_x = 0, sum_y = 0, sum_xx = 0, sum_xy = 0;
+	int n = 0;
+	
+	for (int i = 0; i < num_points; ++i) {
+		double ms = *(const double*)((const char*)&points[i] + phase);
+		if (ms <= 0 || points[i].tokens == 0)
+			continue;
+		
+		double x = log((double)points[i].tokens), y = log(ms);
+		sum_x += x;
+		sum_y += y;
+		sum_xx += x * x;
+		sum_xy += x * y;
+		++n;
+	}
+	
+	double denom = n * sum_xx - sum_x * sum_x;
+	if (n < 2 || denom == 0)
+		return 0;
+	
+	return (n * sum_xy - sum_x * sum_y) / denom;
+}
+
+typedef struct bench_phase {
+	const char* name;
+	size_t offset;
+} bench_phase;
+
+static const bench_phase phases[] = {
+	{ "scan", offsetof(bench_point, scan_ms) },
+	{ "parse", offsetof(bench_point, parse_ms) },
+	{ "resolve", offsetof(bench_point, resolve_ms) },
+};
+
+#define NUM_PHASES array_len(phases)
+
+static double phase_ms(const bench_point* point, int phase) {
+	return *(const double*)((const char*)point + phases[phase].offset);
+}
+
+static double per_sec(size_t count, double ms) {
+	return ms > 0 ? count / (ms / 1000.0) : 0;
+}
+
+static void print_results(const bench_point* points, int num_points) {
+	printf("%6s %9s %10s %10s %10s %10s %10s %12s %12s %10s\n",
+		   "scale", "lines", "tokens", "nodes", "scan ms", "parse ms", "resolve ms",
+		   "tokens/s", "nodes/s", "peak MB");
+	
+	for (int i = 0; i < num_points; ++i) {
+		const bench_point* p = &points[i];
+		printf("%6d %9d %10zu %10zu %10.2f %10.2f %10.2f %12.0f %12.0f %10.1f\n",
+			   p->scale, p->lines, p->tokens, p->nodes, p->scan_ms, p->parse_ms, p->resolve_ms,
+			   per_sec(p->tokens, p->scan_ms), per_sec(p->nodes, p->parse_ms),
+			   p->peak_bytes / (1024.0 * 1024.0));
+	}
+	
+	if (!mem_stats_enabled())
+		printf("\npeak is the max RSS of the whole process, build with HECK_MEM_STATS for the peak of each run\n");
+	
+	if (num_points < 2)
+		return;
+	
+	printf("\nscaling exponents (time ~ tokens^k):\n");
+	for (int i = 0; i < NUM_PHASES; ++i) {
+		double k = scaling_exponent(points, num_points, phases[i].offset);
+		printf("  %-8s %.2f%s\n", phases[i].name, k, k > 1.15 ? "  superlinear" : "");
+	}
+}
+
+/*
+ *
+ * Baselines
+ *
+ */
+
+static bool save_results(const char* path, const bench_shape* shape, int num_threads, const bench_point* points, int num_points) {
+	FILE* f = fopen(path, "w");
+	if (f == NULL) {
+		fprintf(stderr, "error: unable to open %s\n", path);
+		return false;
+	}
+	
+	fprintf(f, "{\n");
+	fprintf(f, "\t\"shape\": { \"funcs\": %d, \"classes\": %d, \"globals\": %d, \"stmts\": %d, "
+			"\"depth\": %d, \"overloads\": %d, \"expr\": %d, \"nmsp\": %d, \"fwd\": %g, \"seed\": %u },\n",
+			shape->num_funcs, shape->num_classes, shape->num_globals, shape->num_stmts, shape->nest_depth,
+			shape->overloads, shape->expr_len, shape->nmsp_depth, shape->fwd_refs, shape->seed);
+	fprintf(f, "\t\"threads\": %d,\n", num_threads);
+	fprintf(f, "\t\"peak\": \"%s\",\n", mem_stats_enabled() ? "mem_stats" : "max_rss");
+	
+	fprintf(f, "\t\"points\": [\n");
+	for (int i = 0; i < num_points; ++i) {
+		const bench_point* p = &points[i];
+		fprintf(f, "\t\t{ \"scale\": %d, \"bytes\": %zu, \"lines\": %d, \"tokens\": %zu, \"nodes\": %zu, "
+				"\"scan_ms\": %.3f, \"parse_ms\": %.3f, \"resolve_ms\": %.3f, \"peak_bytes\": %zu }%s\n",
+				p->scale, p->bytes, p->lines, p->tokens, p->nodes, p->scan_ms, p->parse_ms, p->resolve_ms,
+				p->peak_bytes, i + 1 < num_points ? "," : "");
+	}
+	fprintf(f, "\t],\n");
+	
+	fprintf(f, "\t\"exponents\": {");
+	for (int i = 0; i < NUM_PHASES; ++i)
+		fprintf(f, "%s \"%s\": %.3f", i > 0 ? "," : "", phases[i].name, scaling_exponent(points, num_points, phases[i].offset));
+	fprintf(f, " }\n}\n");
+	
+	fclose(f);
+	return true;
+}
+
+// finds "key": inside of [start, end) and reads the number after it
+static bool json_number(const char* start, const char* end, const char* key, double* out) {
+	char pattern[64];
+	snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+	
+	size_t len = strlen(pattern);
+	for (const char* s = start; s + len <= end; ++s) {
+		if (memcmp(s, pattern, len) == 0) {
+			*out = strtod(s + len, NULL);
+			return true;
+		}
+	}
+	return false;
+}
+
+// only reads the files written by save_results
+static int load_results(const char* path, bench_point* points) {
+	FILE* f = fopen(path, "rb");
+	if (f == NULL) {
+		fprintf(stderr, "error: unable to open %s\n", path);
+		return -1;
+	}
+	
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	
+	char* data = malloc(size + 1);
+	size_t read = fread(data, 1, size, f);
+	data[read] = '\0';
+	fclose(f);
+	
+	int num_points = 0;
+	const char* s = strstr(data, "\"points\"");
+	const char* list_end = s != NULL ? strchr(s, ']') : NULL;
+	
+	while (s != NULL && num_points < BENCH_MAX_POINTS) {
+		const char* obj = strchr(s, '{');
+		if (obj == NULL || obj > list_end)
+			break;
+		const char* obj_end = strchr(obj, '}');
+		if (obj_end == NULL)
+			break;
+		
+		bench_point* p = &points[num_points];
+		memset(p, 0, sizeof(bench_point));
+		
+		double value;
+		if (json_number(obj, obj_end, "scale", &value))
+			p->scale = (int)value;
+		if (json_number(obj, obj_end, "tokens", &value))
+			p->tokens = (size_t)value;
+		json_number(obj, obj_end, "scan_ms", &p->scan_ms);
+		json_number(obj, obj_end, "parse_ms", &p->parse_ms);
+		json_number(obj, obj_end, "resolve_ms", &p->resolve_ms);
+		if (json_number(obj, obj_end, "peak_bytes", &value))
+			p->peak_bytes = (size_t)value;
+		
+		++num_points;
+		s = obj_end + 1;
+	}
+	
+	free(data);
+	return num_points;
+}
+
+// returns false if any phase got slower than the baseline by more than tolerance
+static bool compare_results(const bench_point* points, int num_points, const bench_point* base, int num_base, double tolerance) {
+	bool ok = true;
+	
+	printf("\ncompared to the baseline (new / old):\n");
+	printf("%6s %10s %10s %10s %10s\n", "scale", "scan", "parse", "resolve", "peak");
+	
+	for (int i = 0; i < num_points; ++i) {
+		const bench_point* b = NULL;
+		for (int j = 0; j < num_base; ++j) {
+			if (base[j].scale == points[i].scale) {
+				b = &base[j];
+				break;
+			}
+		}
+		if (b == NULL)
+			continue;
+		
+		printf("%6d", points[i].scale);
+		for (int k = 0; k < NUM_PHASES; ++k) {
+			double old_ms = phase_ms(b, k), new_ms = phase_ms(&points[i], k);
+			double ratio = old_ms > 0 ? new_ms / old_ms : 0;
+			
+			// times under a millisecond are mostly noise
+			bool slower = ratio > 1 + tolerance && new_ms - old_ms > 1.0;
+			if (slower)
+				ok = false;
+			printf(" %9.2f%s", ratio, slower ? "!" : " ");
+		}
+		printf(" %9.2f", b->peak_bytes > 0 ? (double)points[i].peak_bytes / b->peak_bytes : 0);
+		
+		if (b->tokens != points[i].tokens)
+			printf("  (shape differs)");
+		printf("\n");
+	}
+	
+	if (!ok)
+		printf("\nslower than the baseline by more than %.0f%%\n", tolerance * 100);
+	
+	return ok;
+}
+
+/*
+ *
+ * Main
+ *
+ */
+
+static void usage(const char* name) {
+	fprintf(stderr,
+			"usage: %s [options]\n"
+			"  --funcs N        functions at scale 1, including overloads (default 200)\n"
+			"  --classes N      classes at scale 1 (default 20)\n"
+			"  --globals N      global variables at scale 1 (default 50)\n"
+			"  --stmts N        let statements in each function body (default 8)\n"
+			"  --depth N        depth of the if/else blocks in each function body (default 2)\n"
+			"  --overloads N    overloads for each function name (default 2)\n"
+			"  --expr N         operands in each expression (default 4)\n"
+			"  --nmsp N         depth of the namespaces around each group of declarations (default 1)\n"
+			"  --fwd F          fraction of calls from initializers to later functions, 0 to 1 (default 0.25)\n"
+			"  --seed N         seed for the generator (default 1)\n"
+			"  --scale LIST     comma separated scales to measure (default 1,2,4,8,16)\n"
+			"  --reps N         runs for each scale, the fastest time is kept (default 3)\n"
+			"  -j N             threads for function bodies, 0 parses them lazily (default 1)\n"
+			"  --save FILE      write the results to FILE as a JSON baseline\n"
+			"  --baseline FILE  compare the results to a saved baseline\n"
+			"  --tolerance F    allowed slowdown compared to the baseline (default 0.1)\n"
+			"  --emit           print the program for the first scale and exit\n"
+			"  -v               show diagnostics from the compiler\n",
+			name);
+}
+
+static int parse_scales(const char* list, int* scales) {
+	int num_scales = 0;
+	
+	while (*list != '\0' && num_scales < BENCH_MAX_POINTS) {
+		char* end;
+		long scale = strtol(list, &end, 10);
+		if (end == list || scale < 1)
+			return -1;
+		scales[num_scales++] = (int)scale;
+		
+		list = end;
+		if (*list == ',')
+			++list;
+	}
+	
+	return num_scales;
+}
+
+int main(int argc, const char* argv[]) {
+	bench_shape shape = { 200, 20, 50, 8, 2, 2, 4, 1, 0.25, 1 };
+	
+	int scales[BENCH_MAX_POINTS] = { 1, 2, 4, 8, 16 };
+	int num_scales = 5;
+	int reps = 3;
+	int num_threads = 1;
+	const char* save_path = NULL;
+	const char* baseline_path = NULL;
+	double tolerance = 0.1;
+	bool emit = false;
+	bool verbose = false;
+	
+	for (int i = 1; i < argc; ++i) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+		
+		if (strcmp(arg, "--emit") == 0) {
+			emit = true;
+			continue;
+		} else if (strcmp(arg, "-v") == 0) {
+			verbose = true;
+			continue;
+		} else if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+			usage(argv[0]);
+			return 0;
+		}
+		
+		if (value == NULL) {
+			usage(argv[0]);
+			return 1;
+		}
+		++i;
+		
+		if (strcmp(arg, "--funcs") == 0) {
+			shape.num_funcs = atoi(value);
+		} else if (strcmp(arg, "--classes") == 0) {
+			shape.num_classes = atoi(value);
+		} else if (strcmp(arg, "--globals") == 0) {
+			shape.num_globals = atoi(value);
+		} else if (strcmp(arg, "--stmts") == 0) {
+			shape.num_stmts = atoi(value);
+		} else if (strcmp(arg, "--depth") == 0) {
+			shape.nest_depth = atoi(value);
+		} else if (strcmp(arg, "--overloads") == 0) {
+			shape.overloads = atoi(value);
+		} else if (strcmp(arg, "--expr") == 0) {
+			shape.expr_len = atoi(value);
+		} else if (strcmp(arg, "--nmsp") == 0) {
+			shape.nmsp_depth = atoi(value);
+		} else if (strcmp(arg, "--fwd") == 0) {
+			shape.fwd_refs = atof(value);
+		} else if (strcmp(arg, "--seed") == 0) {
+			shape.seed = (unsigned)strtoul(value, NULL, 10);
+		} else if (strcmp(arg, "--scale") == 0) {
+			num_scales = parse_scales(value, scales);
+		} else if (strcmp(arg, "--reps") == 0) {
+			reps = atoi(value);
+		} else if (strcmp(arg, "-j") == 0) {
+			num_threads = atoi(value);
+		} else if (strcmp(arg, "--save") == 0) {
+			save_path = value;
+		} else if (strcmp(arg, "--baseline") == 0) {
+			baseline_path = value;
+		} else if (strcmp(arg, "--tolerance") == 0) {
+			tolerance = atof(value);
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+	
+	if (num_scales < 1 || reps < 1 || num_threads < 0 || shape.num_funcs < 1 || shape.overloads < 1 ||
+		shape.expr_len < 1 || shape.num_stmts < 0 || shape.nest_depth < 0 || shape.nmsp_depth < 0 ||
+		shape.num_classes < 0 || shape.num_globals < 0) {
+		usage(argv[0]);
+		return 1;
+	}
+	
+	if (emit) {
+		gen_program(stdout, &shape, scales[0]);
+		return 0;
+	}
+	
+	bench_point points[BENCH_MAX_POINTS];
+	for (int i = 0; i < num_scales; ++i) {
+		bench_point_run(&points[i], &shape, scales[i], reps, num_threads, verbose);
+		
+		// the times would only measure how fast errors are found, so they can't be compared or saved
+		if (!points[i].parsed || !points[i].resolved) {
+			fprintf(stderr, "error: the program at scale %d failed to %s, run with -v to see the errors\n",
+					scales[i], !points[i].parsed ? "parse" : "resolve");
+			return 1;
+		}
+		
+		fprintf(stderr, "scale %d done\n", scales[i]);
+	}
+	
+	print_results(points, num_scales);
+	
+	if (save_path != NULL && !save_results(save_path, &shape, num_threads, points, num_scales))
+		return 1;
+	
+	if (baseline_path != NULL) {
+		bench_point base[BENCH_MAX_POINTS];
+		int num_base = load_results(baseline_path, base);
+		if (num_base < 0)
+			return 1;
+		if (!compare_results(points, num_scales, base, num_base, tolerance))
+			return 1;
+	}
+	
+	return 0;
+}
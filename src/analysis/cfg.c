@@ -0,0 +1,196 @@
+//
+//  cfg.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "cfg.h"
+#include <stdio.h>
+#include "dom.h"
+#include "function.h"
+#include "print.h"
+#include "vec.h"
+#include "mem.h"
+
+static int cfg_add_block(heck_cfg* cfg, heck_cfg_end end) {
+	heck_cfg_block* block = vector_add_asg(&cfg->block_vec);
+	block->stmt_vec = vector_create();
+	block->condition = NULL;
+	block->end = end;
+	block->succ[0] = -1;
+	block->succ[1] = -1;
+	block->pred_vec = vector_create();
+	block->rpo = -1;
+	block->idom = -1;
+	block->dom_pre = -1;
+	block->dom_post = -1;
+	
+	return cfg_num_blocks(cfg) - 1;
+}
+
+static void cfg_add_edge(heck_cfg* cfg, int from, int to) {
+	heck_cfg_block* block = &cfg->block_vec[from];
+	block->succ[block->succ[0] == -1 ? 0 : 1] = to;
+	vector_add(&cfg->block_vec[to].pred_vec, from);
+}
+
+// adds the statements of a block starting in current, returns the block that control falls out of
+static int cfg_build_block(heck_cfg* cfg, heck_block* block, int current) {
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		switch (stmt->type) {
+			case STMT_BLOCK:
+				current = cfg_build_block(cfg, stmt->value.block, current);
+				break;
+			case STMT_IF: {
+				int join = cfg_add_block(cfg, CFG_JUMP);
+				
+				// each condition in the ladder is checked at the end of the block before it
+				for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next) {
+					if (node->condition == NULL) {
+						cfg_add_edge(cfg, cfg_build_block(cfg, node->code, current), join);
+						break;
+					}
+					
+					int then_block = cfg_add_block(cfg, CFG_JUMP);
+					int else_block = node->next != NULL ? cfg_add_block(cfg, CFG_JUMP) : join;
+					
+					cfg->block_vec[current].condition = node->condition;
+					cfg->block_vec[current].end = CFG_BRANCH;
+					cfg_add_edge(cfg, current, then_block);
+					cfg_add_edge(cfg, current, else_block);
+					
+					cfg_add_edge(cfg, cfg_build_block(cfg, node->code, then_block), join);
+					current = else_block;
+				}
+				
+				current = join;
+				break;
+			}
+			case STMT_RET:
+				vector_add(&cfg->block_vec[current].stmt_vec, stmt);
+				cfg->block_vec[current].end = CFG_RETURN;
+				cfg_add_edge(cfg, current, CFG_EXIT);
+				
+				// anything after the return can't be reached, but it is still kept in the graph
+				current = cfg_add_block(cfg, CFG_JUMP);
+				break;
+			default:
+				vector_add(&cfg->block_vec[current].stmt_vec, stmt);
+				break;
+		}
+	}
+	
+	return current;
+}
+
+static int cfg_succ(const void* graph, int node, int i) {
+	const heck_cfg* cfg = graph;
+	return i < 2 ? cfg->block_vec[node].succ[i] : -1;
+}
+
+static int cfg_pred(const void* graph, int node, int i) {
+	const heck_cfg* cfg = graph;
+	const heck_cfg_block* block = &cfg->block_vec[node];
+	return i < (int)vector_size(block->pred_vec) ? block->pred_vec[i] : -1;
+}
+
+// numbers the reachable blocks in reverse postorder and finds their dominators
+static void cfg_dominators(heck_cfg* cfg) {
+	heck_dom_graph graph = {
+		.graph = cfg,
+		.num_nodes = cfg_num_blocks(cfg),
+		.entry = CFG_ENTRY,
+		.tag = MEM_FLOW,
+		.succ = cfg_succ,
+		.pred = cfg_pred,
+	};
+	heck_dom_tree tree;
+	dom_solve(&graph, &tree);
+	
+	for (int i = 0; i < graph.num_nodes; ++i) {
+		heck_cfg_block* block = &cfg->block_vec[i];
+		block->rpo = tree.rpo[i];
+		block->idom = tree.idom[i];
+		block->dom_pre = tree.dom_pre[i];
+		block->dom_post = tree.dom_post[i];
+	}
+	
+	// the graph keeps the reverse postorder, the rest of the tree is copied into the blocks
+	cfg->rpo_vec = tree.rpo_vec;
+	mem_free(tree.rpo);
+}
+
+heck_cfg* cfg_build(heck_func* func) {
+	heck_cfg* cfg = mem_alloc(sizeof(heck_cfg), MEM_FLOW);
+	cfg->func = func;
+	cfg->block_vec = vector_create();
+	cfg->num_slots = (int)vector_size(func->param_vec) + func->num_locals;
+	
+	cfg_add_block(cfg, CFG_JUMP);
+	cfg_add_block(cfg, CFG_NONE);
+	
+	// falling out of the body returns too
+	int last = cfg_build_block(cfg, func->code, CFG_ENTRY);
+	cfg_add_edge(cfg, last, CFG_EXIT);
+	
+	cfg_dominators(cfg);
+	
+	return cfg;
+}
+
+void cfg_free(heck_cfg* cfg) {
+	int num_blocks = cfg_num_blocks(cfg);
+	for (int i = 0; i < num_blocks; ++i) {
+		vector_free(cfg->block_vec[i].stmt_vec);
+		vector_free(cfg->block_vec[i].pred_vec);
+	}
+	vector_free(cfg->block_vec);
+	vector_free(cfg->rpo_vec);
+	mem_free(cfg);
+}
+
+bool cfg_dominates(const heck_cfg* cfg, int a, int b) {
+	const heck_cfg_block* block_a = &cfg->block_vec[a];
+	const heck_cfg_block* block_b = &cfg->block_vec[b];
+	if (block_a->rpo < 0 || block_b->rpo < 0)
+		return false;
+	return block_a->dom_pre <= block_b->dom_pre && block_b->dom_pre <= block_a->dom_post;
+}
+
+void print_cfg(const heck_cfg* cfg) {
+	int num_blocks = cfg_num_blocks(cfg);
+	for (int i = 0; i < num_blocks; ++i) {
+		const heck_cfg_block* block = &cfg->block_vec[i];
+		printf("block %i", i);
+		if (block->rpo < 0)
+			printf(" (unreachable)");
+		else if (block->idom >= 0)
+			printf(" (idom %i)", block->idom);
+		printf(":\n");
+		
+		vec_size_t num_stmts = vector_size(block->stmt_vec);
+		for (vec_size_t j = 0; j < num_stmts; ++j)
+			print_stmt(block->stmt_vec[j], 1);
+		
+		print_indent(1);
+		switch (block->end) {
+			case CFG_JUMP:
+				printf("jump %i\n", block->succ[0]);
+				break;
+			case CFG_BRANCH:
+				printf("branch ");
+				print_expr(block->condition);
+				printf(" ? %i : %i\n", block->succ[0], block->succ[1]);
+				break;
+			case CFG_RETURN:
+				printf("return to %i\n", block->succ[0]);
+				break;
+			case CFG_NONE:
+				printf("exit\n");
+				break;
+		}
+	}
+}
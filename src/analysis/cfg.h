@@ -0,0 +1,65 @@
+//
+//  cfg.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Control flow graph of a resolved function body. Each basic block holds the statements that
+//	run one after another, and the block it ends on decides where control goes next.
+//
+
+#ifndef cfg_h
+#define cfg_h
+
+#include <stdbool.h>
+#include "statement.h"
+#include "declarations.h"
+
+#define CFG_ENTRY 0
+#define CFG_EXIT 1
+
+typedef enum heck_cfg_end {
+	CFG_JUMP,	// goes to succ[0]
+	CFG_BRANCH,	// goes to succ[0] if the condition is truthy, otherwise succ[1]
+	CFG_RETURN,	// the last statement is a return, succ[0] is the exit block
+	CFG_NONE,	// the exit block
+} heck_cfg_end;
+
+typedef struct heck_cfg_block {
+	heck_stmt** stmt_vec; // expression, let, and return statements
+	heck_expr* condition; // evaluated after the statements if the block ends on a branch
+	heck_cfg_end end;
+	int succ[2]; // -1 if unused
+	int* pred_vec;
+	
+	int rpo; // index in the reverse postorder, -1 if the block is unreachable
+	int idom; // immediate dominator, -1 for the entry block and unreachable blocks
+	int dom_pre, dom_post; // the block's interval in the dominator tree
+} heck_cfg_block;
+
+typedef struct heck_cfg {
+	heck_func* func;
+	heck_cfg_block* block_vec; // the entry and exit blocks come first
+	int* rpo_vec; // the reachable blocks in reverse postorder
+	int num_slots; // the parameters and locals in the function's frame
+} heck_cfg;
+
+// the body must be resolved, statements that come after a return are put in blocks that can't be reached.
+// loops and switches will need their own case here, the rest of the analyses work on any graph.
+heck_cfg* cfg_build(heck_func* func);
+void cfg_free(heck_cfg* cfg);
+
+static inline int cfg_num_blocks(const heck_cfg* cfg) {
+	return (int)vector_size(cfg->block_vec);
+}
+
+static inline bool cfg_reachable(const heck_cfg* cfg, int block) {
+	return cfg->block_vec[block].rpo >= 0;
+}
+
+// true if every path from the entry to b goes through a, a block dominates itself
+bool cfg_dominates(const heck_cfg* cfg, int a, int b);
+
+void print_cfg(const heck_cfg* cfg);
+
+#endif /* cfg_h */
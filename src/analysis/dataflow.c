@@ -0,0 +1,420 @@
+//
+//  dataflow.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "dataflow.h"
+#include <stdio.h>
+#include "function.h"
+#include "resolver.h"
+#include "vec.h"
+#include "mem.h"
+
+heck_flow* flow_create(const heck_cfg* cfg, heck_flow_dir dir, heck_flow_meet meet, int num_bits) {
+	heck_flow* flow = mem_alloc(sizeof(heck_flow), MEM_FLOW);
+	flow->dir = dir;
+	flow->meet = meet;
+	flow->num_bits = num_bits;
+	flow->num_words = bitset_words(num_bits);
+	flow->num_blocks = cfg_num_blocks(cfg);
+	
+	// gen, kill, in, and out are stored one after another in the same array
+	size_t set_words = (size_t)flow->num_blocks * flow->num_words;
+	flow->gen = bitset_create(flow->num_blocks * 4, flow->num_words);
+	flow->kill = flow->gen + set_words;
+	flow->in = flow->kill + set_words;
+	flow->out = flow->in + set_words;
+	
+	return flow;
+}
+
+void flow_free(heck_flow* flow) {
+	bitset_free(flow->gen);
+	mem_free(flow);
+}
+
+void flow_solve(heck_flow* flow, const heck_cfg* cfg, const heck_bits* boundary) {
+	int num_words = flow->num_words;
+	bool forward = flow->dir == FLOW_FORWARD;
+	
+	// sets that are met with others start out as the identity of the meet
+	heck_bits* met = forward ? flow->out : flow->in;
+	for (int i = 0; i < flow->num_blocks; ++i) {
+		if (flow->meet == FLOW_INTERSECT)
+			bitset_fill(flow_set(flow, met, i), flow->num_bits);
+		else
+			bitset_clear(flow_set(flow, met, i), num_words);
+	}
+	
+	// blocks are visited in reverse postorder for forward problems and postorder for backward ones,
+	// so most blocks only need to be visited once. pending holds indices in that order
+	int num_reachable = (int)vector_size(cfg->rpo_vec);
+	heck_bits* pending = bitset_create(1, bitset_words(num_reachable));
+	bitset_fill(pending, num_reachable);
+	
+	int i = bitset_next(pending, 0, num_reachable);
+	while (i >= 0) {
+		bitset_reset(pending, i);
+		
+		int b = cfg->rpo_vec[forward ? i : num_reachable - 1 - i];
+		const heck_cfg_block* block = &cfg->block_vec[b];
+		heck_bits* in = flow_set(flow, flow->in, b);
+		heck_bits* out = flow_set(flow, flow->out, b);
+		
+		if (forward) {
+			if (b == CFG_ENTRY) {
+				if (boundary != NULL)
+					bitset_copy(in, boundary, num_words);
+				else
+					bitset_clear(in, num_words);
+			} else {
+				if (flow->meet == FLOW_INTERSECT)
+					bitset_fill(in, flow->num_bits);
+				else
+					bitset_clear(in, num_words);
+				
+				vec_size_t num_preds = vector_size(block->pred_vec);
+				for (vec_size_t j = 0; j < num_preds; ++j) {
+					int pred = block->pred_vec[j];
+					if (!cfg_reachable(cfg, pred))
+						continue;
+					if (flow->meet == FLOW_INTERSECT)
+						bitset_intersect(in, flow_set(flow, flow->out, pred), num_words);
+					else
+						bitset_union(in, flow_set(flow, flow->out, pred), num_words);
+				}
+			}
+			
+			if (bitset_transfer(out, in, flow_set(flow, flow->gen, b), flow_set(flow, flow->kill, b), num_words)) {
+				for (int j = 0; j < 2; ++j) {
+					if (block->succ[j] >= 0)
+						bitset_set(pending, cfg->block_vec[block->succ[j]].rpo);
+				}
+			}
+		} else {
+			if (b == CFG_EXIT) {
+				if (boundary != NULL)
+					bitset_copy(out, boundary, num_words);
+				else
+					bitset_clear(out, num_words);
+			} else {
+				if (flow->meet == FLOW_INTERSECT)
+					bitset_fill(out, flow->num_bits);
+				else
+					bitset_clear(out, num_words);
+				
+				for (int j = 0; j < 2; ++j) {
+					int succ = block->succ[j];
+					if (succ < 0)
+						continue;
+					if (flow->meet == FLOW_INTERSECT)
+						bitset_intersect(out, flow_set(flow, flow->in, succ), num_words);
+					else
+						bitset_union(out, flow_set(flow, flow->in, succ), num_words);
+				}
+			}
+			
+			if (bitset_transfer(in, out, flow_set(flow, flow->gen, b), flow_set(flow, flow->kill, b), num_words)) {
+				vec_size_t num_preds = vector_size(block->pred_vec);
+				for (vec_size_t j = 0; j < num_preds; ++j) {
+					int pred = block->pred_vec[j];
+					if (cfg_reachable(cfg, pred))
+						bitset_set(pending, num_reachable - 1 - cfg->block_vec[pred].rpo);
+				}
+			}
+		}
+		
+		// keep going in order, then start over for the blocks that changed behind us
+		int next = bitset_next(pending, i + 1, num_reachable);
+		i = next >= 0 ? next : bitset_next(pending, 0, num_reachable);
+	}
+	
+	bitset_free(pending);
+}
+
+/*
+ *	Variable accesses
+ */
+
+static void flow_walk(heck_expr* expr, flow_visit visit, void* ctx, bool maybe);
+
+static void flow_walk_value(heck_expr* expr, heck_expr* site, flow_visit visit, void* ctx, heck_flow_access access) {
+	if (expr->type != EXPR_VALUE)
+		return;
+	
+	const heck_expr_value* value = &expr->value.value;
+	if (value->slot >= 0 && value->depth == 0)
+		visit(ctx, site, value, value->slot, access);
+}
+
+static void flow_walk(heck_expr* expr, flow_visit visit, void* ctx, bool maybe) {
+	heck_flow_access write = maybe ? FLOW_MAYBE_WRITE : FLOW_WRITE;
+	
+	switch (expr->type) {
+		case EXPR_VALUE:
+			flow_walk_value(expr, expr, visit, ctx, FLOW_READ);
+			break;
+		case EXPR_BINARY: {
+			heck_expr_binary* binary = &expr->value.binary;
+			if (expr->vtable == &expr_vtable_asg) {
+				flow_walk(binary->right, visit, ctx, maybe);
+				if (binary->operator == TK_OP_ASG) {
+					flow_walk_value(binary->left, binary->right, visit, ctx, write);
+				} else {
+					flow_walk_value(binary->left, expr, visit, ctx, FLOW_READ);
+					flow_walk_value(binary->left, expr, visit, ctx, write);
+				}
+			} else {
+				// the right side of && and || is skipped if the left side decides the result
+				bool short_circuit = expr->vtable == &expr_vtable_and || expr->vtable == &expr_vtable_or;
+				flow_walk(binary->left, visit, ctx, maybe);
+				flow_walk(binary->right, visit, ctx, maybe || short_circuit);
+			}
+			break;
+		}
+		case EXPR_UNARY: {
+			heck_expr* operand = expr->value.unary.expr;
+			if (expr->vtable == &expr_vtable_pre_incr || expr->vtable == &expr_vtable_pre_decr ||
+				expr->vtable == &expr_vtable_post_incr || expr->vtable == &expr_vtable_post_decr) {
+				flow_walk_value(operand, expr, visit, ctx, FLOW_READ);
+				flow_walk_value(operand, expr, visit, ctx, write);
+			} else {
+				flow_walk(operand, visit, ctx, maybe);
+			}
+			break;
+		}
+		case EXPR_TERNARY:
+			flow_walk(expr->value.ternary.condition, visit, ctx, maybe);
+			flow_walk(expr->value.ternary.value_a, visit, ctx, true);
+			flow_walk(expr->value.ternary.value_b, visit, ctx, true);
+			break;
+		case EXPR_CALL: {
+			heck_expr_call* call = &expr->value.call;
+			flow_walk(call->operand, visit, ctx, maybe);
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				flow_walk(call->arg_vec[i], visit, ctx, maybe);
+			break;
+		}
+		case EXPR_CAST:
+			flow_walk(expr->value.expr, visit, ctx, maybe);
+			break;
+		default:
+			break;
+	}
+}
+
+void flow_walk_expr(heck_expr* expr, flow_visit visit, void* ctx) {
+	flow_walk(expr, visit, ctx, false);
+}
+
+void flow_walk_stmt(heck_stmt* stmt, flow_visit visit, void* ctx) {
+	switch (stmt->type) {
+		case STMT_EXPR:
+			flow_walk(stmt->value.expr, visit, ctx, false);
+			break;
+		case STMT_LET: {
+			heck_stmt_let* let_stmt = stmt->value.let_stmt;
+			
+			// a variable declared without a value has a placeholder with its type
+			if (let_stmt->value->type == EXPR_RES_TYPE || let_stmt->slot < 0)
+				break;
+			flow_walk(let_stmt->value, visit, ctx, false);
+			visit(ctx, let_stmt->value, NULL, let_stmt->slot, FLOW_WRITE);
+			break;
+		}
+		case STMT_RET:
+			if (stmt->value.expr != NULL)
+				flow_walk(stmt->value.expr, visit, ctx, false);
+			break;
+		default:
+			break;
+	}
+}
+
+void flow_walk_block(const heck_cfg_block* block, flow_visit visit, void* ctx) {
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i)
+		flow_walk_stmt(block->stmt_vec[i], visit, ctx);
+	if (block->condition != NULL)
+		flow_walk(block->condition, visit, ctx, false);
+}
+
+/*
+ *	Analyses
+ */
+
+typedef struct flow_block_ctx {
+	heck_flow* flow;
+	heck_bits* gen;
+	heck_bits* kill;
+} flow_block_ctx;
+
+static void liveness_visit(void* ctx, heck_expr* site, const heck_expr_value* value, int slot, heck_flow_access access) {
+	flow_block_ctx* block = ctx;
+	if (access == FLOW_READ) {
+		// only reads that come before a write in the same block make the variable live at the start
+		if (!bitset_test(block->kill, slot))
+			bitset_set(block->gen, slot);
+	} else if (access == FLOW_WRITE) {
+		bitset_set(block->kill, slot);
+	}
+}
+
+heck_flow* flow_liveness(const heck_cfg* cfg) {
+	heck_flow* flow = flow_create(cfg, FLOW_BACKWARD, FLOW_UNION, cfg->num_slots);
+	
+	int num_blocks = cfg_num_blocks(cfg);
+	for (int i = 0; i < num_blocks; ++i) {
+		flow_block_ctx ctx = { flow, flow_set(flow, flow->gen, i), flow_set(flow, flow->kill, i) };
+		flow_walk_block(&cfg->block_vec[i], liveness_visit, &ctx);
+	}
+	
+	flow_solve(flow, cfg, NULL);
+	return flow;
+}
+
+static void assigned_visit(void* ctx, heck_expr* site, const heck_expr_value* value, int slot, heck_flow_access access) {
+	flow_block_ctx* block = ctx;
+	if (access == FLOW_WRITE)
+		bitset_set(block->gen, slot);
+}
+
+heck_flow* flow_assigned(const heck_cfg* cfg) {
+	heck_flow* flow = flow_create(cfg, FLOW_FORWARD, FLOW_INTERSECT, cfg->num_slots);
+	
+	int num_blocks = cfg_num_blocks(cfg);
+	for (int i = 0; i < num_blocks; ++i) {
+		flow_block_ctx ctx = { flow, flow_set(flow, flow->gen, i), flow_set(flow, flow->kill, i) };
+		flow_walk_block(&cfg->block_vec[i], assigned_visit, &ctx);
+	}
+	
+	// parameters take the first slots
+	heck_bits* params = bitset_create(1, flow->num_words);
+	for (vec_size_t i = 0; i < vector_size(cfg->func->param_vec); ++i)
+		bitset_set(params, (int)i);
+	
+	flow_solve(flow, cfg, params);
+	bitset_free(params);
+	return flow;
+}
+
+typedef struct reaching_defs_ctx {
+	heck_reaching_defs* defs;
+	int block;
+	int next_def; // definitions are visited in the same order they were added
+	heck_bits* gen;
+	heck_bits* kill;
+} reaching_defs_ctx;
+
+static void reaching_defs_add(void* ctx, heck_expr* site, const heck_expr_value* value, int slot, heck_flow_access access) {
+	reaching_defs_ctx* defs_ctx = ctx;
+	if (access != FLOW_READ)
+		vector_add(&defs_ctx->defs->def_vec, ((heck_flow_def){ site, slot, defs_ctx->block }));
+}
+
+static void reaching_defs_visit(void* ctx, heck_expr* site, const heck_expr_value* value, int slot, heck_flow_access access) {
+	reaching_defs_ctx* defs_ctx = ctx;
+	if (access == FLOW_READ)
+		return;
+	
+	heck_reaching_defs* defs = defs_ctx->defs;
+	int def = defs_ctx->next_def++;
+	
+	// a write that always happens replaces every earlier definition of the variable
+	if (access == FLOW_WRITE) {
+		heck_bits* slot_defs = flow_set(defs->flow, defs->slot_defs, slot);
+		bitset_union(defs_ctx->kill, slot_defs, defs->flow->num_words);
+		bitset_subtract(defs_ctx->gen, slot_defs, defs->flow->num_words);
+	}
+	bitset_set(defs_ctx->gen, def);
+}
+
+heck_reaching_defs* flow_reaching_defs(const heck_cfg* cfg) {
+	heck_reaching_defs* defs = mem_alloc(sizeof(heck_reaching_defs), MEM_FLOW);
+	defs->def_vec = vector_create();
+	
+	int num_params = (int)vector_size(cfg->func->param_vec);
+	for (int i = 0; i < num_params; ++i)
+		vector_add(&defs->def_vec, ((heck_flow_def){ NULL, i, CFG_ENTRY }));
+	
+	int num_blocks = cfg_num_blocks(cfg);
+	reaching_defs_ctx ctx = { defs };
+	for (int i = 0; i < num_blocks; ++i) {
+		ctx.block = i;
+		flow_walk_block(&cfg->block_vec[i], reaching_defs_add, &ctx);
+	}
+	
+	int num_defs = (int)vector_size(defs->def_vec);
+	heck_flow* flow = flow_create(cfg, FLOW_FORWARD, FLOW_UNION, num_defs);
+	defs->flow = flow;
+	
+	defs->slot_defs = bitset_create(cfg->num_slots, flow->num_words);
+	for (int i = 0; i < num_defs; ++i)
+		bitset_set(flow_set(flow, defs->slot_defs, defs->def_vec[i].slot), i);
+	
+	ctx.next_def = num_params;
+	for (int i = 0; i < num_blocks; ++i) {
+		ctx.block = i;
+		ctx.gen = flow_set(flow, flow->gen, i);
+		ctx.kill = flow_set(flow, flow->kill, i);
+		flow_walk_block(&cfg->block_vec[i], reaching_defs_visit, &ctx);
+	}
+	
+	heck_bits* params = bitset_create(1, flow->num_words);
+	for (int i = 0; i < num_params; ++i)
+		bitset_set(params, i);
+	
+	flow_solve(flow, cfg, params);
+	bitset_free(params);
+	return defs;
+}
+
+void reaching_defs_free(heck_reaching_defs* defs) {
+	flow_free(defs->flow);
+	vector_free(defs->def_vec);
+	bitset_free(defs->slot_defs);
+	mem_free(defs);
+}
+
+typedef struct assigned_check_ctx {
+	heck_bits* assigned;
+	heck_bits* reported; // each variable is only reported once
+	bool success;
+} assigned_check_ctx;
+
+static void assigned_check_visit(void* ctx, heck_expr* site, const heck_expr_value* value, int slot, heck_flow_access access) {
+	assigned_check_ctx* check = ctx;
+	if (access == FLOW_WRITE) {
+		bitset_set(check->assigned, slot);
+	} else if (access == FLOW_READ && !bitset_test(check->assigned, slot) && !bitset_test(check->reported, slot)) {
+		bitset_set(check->reported, slot);
+		check->success = false;
+		
+		FILE* err = resolve_err();
+		fprintf(err, "error: ");
+		fprint_idf(err, value->name);
+		fprintf(err, " may be used before it's assigned a value\n");
+	}
+}
+
+bool flow_check_assigned(const heck_cfg* cfg) {
+	heck_flow* flow = flow_assigned(cfg);
+	
+	heck_bits* sets = bitset_create(2, flow->num_words);
+	assigned_check_ctx ctx = { sets, sets + flow->num_words, true };
+	
+	// statements that can't be reached aren't checked
+	vec_size_t num_reachable = vector_size(cfg->rpo_vec);
+	for (vec_size_t i = 0; i < num_reachable; ++i) {
+		int b = cfg->rpo_vec[i];
+		bitset_copy(ctx.assigned, flow_set(flow, flow->in, b), flow->num_words);
+		flow_walk_block(&cfg->block_vec[b], assigned_check_visit, &ctx);
+	}
+	
+	bitset_free(sets);
+	flow_free(flow);
+	return ctx.success;
+}
@@ -0,0 +1,105 @@
+//
+//  dataflow.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	A worklist solver for gen/kill dataflow problems over a control flow graph.
+//	Every set of a problem lives in one bitset array, so a pass over the graph only touches
+//	a few contiguous arrays no matter how many blocks or variables there are.
+//
+
+#ifndef dataflow_h
+#define dataflow_h
+
+#include <stdbool.h>
+#include "cfg.h"
+#include "bitset.h"
+
+typedef enum heck_flow_dir {
+	FLOW_FORWARD,	// in is the meet of the predecessors' out sets
+	FLOW_BACKWARD,	// out is the meet of the successors' in sets
+} heck_flow_dir;
+
+typedef enum heck_flow_meet {
+	FLOW_UNION,		// a fact holds if it holds on any path
+	FLOW_INTERSECT,	// a fact holds if it holds on every path
+} heck_flow_meet;
+
+typedef struct heck_flow {
+	heck_flow_dir dir;
+	heck_flow_meet meet;
+	int num_bits, num_words, num_blocks;
+	
+	// one set per block, use flow_set to get a block's set
+	heck_bits* gen;
+	heck_bits* kill;
+	heck_bits* in;
+	heck_bits* out;
+} heck_flow;
+
+static inline heck_bits* flow_set(const heck_flow* flow, heck_bits* sets, int block) {
+	return sets + (size_t)block * flow->num_words;
+}
+
+// creates a problem with empty gen and kill sets
+heck_flow* flow_create(const heck_cfg* cfg, heck_flow_dir dir, heck_flow_meet meet, int num_bits);
+void flow_free(heck_flow* flow);
+
+// solves out = gen | (in & ~kill) (or the reverse for backward problems) for every reachable block.
+// boundary is the in set of the entry block, or the out set of the exit block for backward problems
+void flow_solve(heck_flow* flow, const heck_cfg* cfg, const heck_bits* boundary);
+
+/*
+ *	Variable accesses
+ */
+
+typedef enum heck_flow_access {
+	FLOW_READ,
+	FLOW_WRITE,
+	FLOW_MAYBE_WRITE, // a write that's skipped on some paths through the statement, like the right side of &&
+} heck_flow_access;
+
+// site is the value expression for plain reads, and the value that's stored for plain writes.
+// compound assignments, ++, and -- read and write the variable with themselves as the site.
+// value is NULL for the variable that a let statement declares
+typedef void (*flow_visit)(void* ctx, heck_expr* site, const heck_expr_value* value, int slot, heck_flow_access access);
+
+// calls visit for each access to a local variable of the function, in the order they happen.
+// variables from enclosing functions are left out
+void flow_walk_stmt(heck_stmt* stmt, flow_visit visit, void* ctx);
+void flow_walk_expr(heck_expr* expr, flow_visit visit, void* ctx);
+
+// walks the statements of a block and then its condition
+void flow_walk_block(const heck_cfg_block* block, flow_visit visit, void* ctx);
+
+/*
+ *	Analyses
+ */
+
+// variables that may be read before they're written again. the bits are frame slots
+heck_flow* flow_liveness(const heck_cfg* cfg);
+
+// variables that are written on every path, parameters are written at the entry. the bits are frame slots
+heck_flow* flow_assigned(const heck_cfg* cfg);
+
+typedef struct heck_flow_def {
+	heck_expr* site; // the site of the write, NULL for parameters
+	int slot;
+	int block;
+} heck_flow_def;
+
+typedef struct heck_reaching_defs {
+	heck_flow* flow; // the bits are indices in def_vec
+	heck_flow_def* def_vec; // parameters come first
+	heck_bits* slot_defs; // a set of definitions for each slot
+} heck_reaching_defs;
+
+// the definitions of each variable that may reach each block
+heck_reaching_defs* flow_reaching_defs(const heck_cfg* cfg);
+void reaching_defs_free(heck_reaching_defs* defs);
+
+// reports reads of variables that aren't assigned on every path to them, returns false if there were any
+bool flow_check_assigned(const heck_cfg* cfg);
+
+#endif /* dataflow_h */
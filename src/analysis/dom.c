@@ -0,0 +1,159 @@
+//
+//  dom.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "dom.h"
+#include "vec.h"
+
+// numbers the reachable nodes in reverse postorder
+static void dom_order(const heck_dom_graph* graph, heck_dom_tree* tree) {
+	int* post_vec = vector_create();
+	
+	// each entry is a node and the index of the next successor to visit
+	int* stack = vector_create();
+	bool* visited = mem_calloc(graph->num_nodes, sizeof(bool), graph->tag);
+	
+	visited[graph->entry] = true;
+	vector_add(&stack, graph->entry);
+	vector_add(&stack, 0);
+	while (vector_size(stack) > 0) {
+		vec_size_t top = vector_size(stack) - 2;
+		int n = stack[top];
+		int succ = graph->succ(graph->graph, n, stack[top + 1]);
+		
+		if (succ >= 0) {
+			++stack[top + 1];
+			if (!visited[succ]) {
+				visited[succ] = true;
+				vector_add(&stack, succ);
+				vector_add(&stack, 0);
+			}
+		} else {
+			vector_add(&post_vec, n);
+			vector_remove(stack, top + 1);
+			vector_remove(stack, top);
+		}
+	}
+	
+	int num_reachable = (int)vector_size(post_vec);
+	tree->rpo_vec = vector_create();
+	vector_reserve(&tree->rpo_vec, num_reachable);
+	for (int i = num_reachable - 1; i >= 0; --i) {
+		tree->rpo[post_vec[i]] = (int)vector_size(tree->rpo_vec);
+		vector_add(&tree->rpo_vec, post_vec[i]);
+	}
+	
+	mem_free(visited);
+	vector_free(stack);
+	vector_free(post_vec);
+}
+
+static int dom_intersect(const heck_dom_tree* tree, int a, int b) {
+	while (a != b) {
+		while (tree->rpo[a] > tree->rpo[b])
+			a = tree->idom[a];
+		while (tree->rpo[b] > tree->rpo[a])
+			b = tree->idom[b];
+	}
+	return a;
+}
+
+// Cooper, Harvey, and Kennedy's iterative algorithm, which settles in a couple of passes over the reverse postorder
+static void dom_idoms(const heck_dom_graph* graph, heck_dom_tree* tree) {
+	int num_reachable = (int)vector_size(tree->rpo_vec);
+	tree->idom[graph->entry] = graph->entry;
+	
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = 1; i < num_reachable; ++i) {
+			int n = tree->rpo_vec[i];
+			
+			int idom = -1;
+			int pred;
+			for (int j = 0; (pred = graph->pred(graph->graph, n, j)) >= 0; ++j) {
+				if (tree->idom[pred] == -1)
+					continue; // unreachable, or not visited yet
+				idom = idom == -1 ? pred : dom_intersect(tree, pred, idom);
+			}
+			
+			if (tree->idom[n] != idom) {
+				tree->idom[n] = idom;
+				changed = true;
+			}
+		}
+	}
+	tree->idom[graph->entry] = -1;
+}
+
+// lists the children of each node and numbers the tree so dominance can be checked by comparing intervals
+static void dom_number(const heck_dom_graph* graph, heck_dom_tree* tree) {
+	int num_nodes = graph->num_nodes;
+	int num_reachable = (int)vector_size(tree->rpo_vec);
+	for (int i = 1; i < num_reachable; ++i)
+		++tree->child_start[tree->idom[tree->rpo_vec[i]] + 1];
+	for (int i = 0; i < num_nodes; ++i)
+		tree->child_start[i + 1] += tree->child_start[i];
+	
+	// children are added in reverse postorder, pos counts them for each parent
+	int* pos = mem_calloc(num_nodes, sizeof(int), graph->tag);
+	for (int i = 1; i < num_reachable; ++i) {
+		int parent = tree->idom[tree->rpo_vec[i]];
+		tree->children[tree->child_start[parent] + pos[parent]++] = tree->rpo_vec[i];
+	}
+	
+	// pos is reused for the next child to visit
+	for (int i = 0; i < num_nodes; ++i)
+		pos[i] = tree->child_start[i];
+	
+	int* stack = vector_create();
+	int counter = 0;
+	vector_add(&stack, graph->entry);
+	tree->dom_pre[graph->entry] = counter++;
+	while (vector_size(stack) > 0) {
+		int n = stack[vector_size(stack) - 1];
+		if (pos[n] < tree->child_start[n + 1]) {
+			int child = tree->children[pos[n]++];
+			tree->dom_pre[child] = counter++;
+			vector_add(&stack, child);
+		} else {
+			tree->dom_post[n] = counter - 1;
+			vector_remove(stack, vector_size(stack) - 1);
+		}
+	}
+	
+	vector_free(stack);
+	mem_free(pos);
+}
+
+void dom_solve(const heck_dom_graph* graph, heck_dom_tree* tree) {
+	int num_nodes = graph->num_nodes;
+	
+	// the arrays share one allocation
+	tree->rpo = mem_alloc((num_nodes * 6 + 1) * sizeof(int), graph->tag);
+	tree->idom = tree->rpo + num_nodes;
+	tree->child_start = tree->idom + num_nodes;
+	tree->children = tree->child_start + num_nodes + 1;
+	tree->dom_pre = tree->children + num_nodes;
+	tree->dom_post = tree->dom_pre + num_nodes;
+	for (int i = 0; i < num_nodes; ++i) {
+		tree->rpo[i] = -1;
+		tree->idom[i] = -1;
+		tree->dom_pre[i] = -1;
+		tree->dom_post[i] = -1;
+	}
+	for (int i = 0; i <= num_nodes; ++i)
+		tree->child_start[i] = 0;
+	
+	dom_order(graph, tree);
+	dom_idoms(graph, tree);
+	dom_number(graph, tree);
+}
+
+void dom_tree_free(heck_dom_tree* tree) {
+	vector_free(tree->rpo_vec);
+	mem_free(tree->rpo);
+}
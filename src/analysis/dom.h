@@ -0,0 +1,51 @@
+//
+//  dom.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	The reverse postorder and dominator tree of any graph with a single entry. Both the syntax tree's
+//	control flow graphs and the ir use it, they only differ in how they look up a node's edges.
+//
+
+#ifndef dom_h
+#define dom_h
+
+#include <stdbool.h>
+#include "mem.h"
+
+// nodes are numbered from 0 up to num_nodes, and nodes that are numbered but not in the graph are fine
+typedef struct heck_dom_graph {
+	const void* graph;
+	int num_nodes;
+	int entry;
+	heck_mem_tag tag; // what the arrays are counted as
+	
+	// the i-th successor or predecessor of node, -1 after the last one
+	int (*succ)(const void* graph, int node, int i);
+	int (*pred)(const void* graph, int node, int i);
+} heck_dom_graph;
+
+typedef struct heck_dom_tree {
+	int* rpo_vec; // the reachable nodes in reverse postorder, starting with the entry
+	
+	// these are indexed by node
+	int* rpo; // the node's index in rpo_vec, -1 if it is unreachable
+	int* idom; // -1 for the entry and unreachable nodes
+	int* child_start; // the children of n in the dominator tree are children[child_start[n]] up to child_start[n + 1]
+	int* children; // each node's children are in reverse postorder
+	int* dom_pre;
+	int* dom_post; // the node's interval in the dominator tree
+} heck_dom_tree;
+
+void dom_solve(const heck_dom_graph* graph, heck_dom_tree* tree);
+void dom_tree_free(heck_dom_tree* tree);
+
+// true if every path from the entry to b goes through a, a node dominates itself
+static inline bool dom_dominates(const heck_dom_tree* tree, int a, int b) {
+	if (tree->rpo[a] < 0 || tree->rpo[b] < 0)
+		return false;
+	return tree->dom_pre[a] <= tree->dom_pre[b] && tree->dom_pre[b] <= tree->dom_post[a];
+}
+
+#endif /* dom_h */
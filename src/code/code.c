@@ -11,10 +11,14 @@
 #include "str.h"
 #include "print.h"
 #include <stdio.h>
+#include "mem.h"
 
 heck_code* heck_create() {
-	heck_code* c = malloc(sizeof(heck_code));
+	heck_code* c = mem_alloc(sizeof(heck_code), MEM_AST);
 	c->token_vec = vector_create();
+	c->prev_token_vec = NULL;
+	c->body_vec = NULL;
+	c->deps = dep_graph_create();
 	
 	heck_scope* block_scope = scope_create(NULL);
 	block_scope->namespace = block_scope; // global namespace = global scope
@@ -25,20 +29,25 @@ heck_code* heck_create() {
 	return c;
 }
 
-void free_tokens(heck_code* c) {
-	size_t num_tokens = vector_size(c->token_vec);
+void heck_free_token_vec(heck_token** token_vec) {
+	size_t num_tokens = vector_size(token_vec);
 	for (int i = 0; i < num_tokens; ++i) {
-		heck_free_token_data(c->token_vec[i]);
-		free(c->token_vec[i]);
+		heck_free_token_data(token_vec[i]);
+		mem_free(token_vec[i]);
 	}
+	vector_free(token_vec);
 }
 
 void heck_free(heck_code* c) {
-	free_tokens(c);
-	vector_free(c->token_vec);
+	heck_free_token_vec(c->token_vec);
+	if (c->prev_token_vec != NULL)
+		heck_free_token_vec(c->prev_token_vec);
+	if (c->body_vec != NULL)
+		vector_free(c->body_vec);
+	dep_graph_free(c->deps);
 	str_table_free(c->strings);
 	type_table_free(c->types);
-	free(c);
+	mem_free(c);
 }
 
 void heck_print_tokens(heck_code* c) {
@@ -73,6 +82,24 @@ void heck_print_tokens(heck_code* c) {
 	printf("\n");
 }
 
+void heck_print_tree(heck_code* c) {
+	printf("global ");
+	print_block(c->global, 0);
+}
+
+size_t heck_num_tokens(heck_code* c) {
+	return vector_size(c->token_vec);
+}
+
+int heck_num_lines(heck_code* c) {
+	size_t num_tokens = vector_size(c->token_vec);
+	if (num_tokens == 0)
+		return 0;
+	
+	// the last token is always TK_EOF
+	return c->token_vec[num_tokens - 1]->ln;
+}
+
 bool heck_add_token(heck_code* c, heck_token* tk) {
 	
 	vector_add(&c->token_vec, tk);
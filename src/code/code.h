@@ -14,10 +14,25 @@
 
 typedef struct heck_code heck_code;
 
+// a range of tokens that changed between two scans of the same code.
+// tokens [start, end) of the new tokens replaced tokens [start, old_end) of the previous ones
+typedef struct heck_token_edit {
+	int start;
+	int end;
+	int old_end;
+} heck_token_edit;
+
 heck_code* heck_create(void);
 
 void heck_free(heck_code* c);
 
 void heck_print_tokens(heck_code* c);
 
+// prints the syntax tree for the global block
+void heck_print_tree(heck_code* c);
+
+// only valid after the code has been scanned
+size_t heck_num_tokens(heck_code* c);
+int heck_num_lines(heck_code* c);
+
 #endif /* code_h */
@@ -18,14 +18,20 @@
 #include "vec.h"
 #include "str_table.h"
 #include "type_table.h"
+#include "dep_graph.h"
 
 struct heck_code {
 	heck_token** token_vec; // token vector
+	heck_token** prev_token_vec; // the tokens from before heck_rescan, NULL once the code is reparsed
 	heck_block* global; // code/syntax tree
+	heck_func** body_vec; // functions with bodies from the last parse in source order, reused by heck_reparse
+	heck_dep_graph* deps; // what the global declarations read, kept between parses
 	
 	// these tables could be joined technically, but it might be better to separate them
 	type_table* types; // all unique data types
 	str_table* strings; // all unique strings and identifiers
 };
 
+void heck_free_token_vec(heck_token** token_vec);
+
 #endif /* code_impl_h */
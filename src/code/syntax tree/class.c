@@ -9,18 +9,199 @@
 #include "scope.h"
 #include "overload.h"
 #include "print.h"
+#include "mem.h"
+#include "resolver.h"
+#include <string.h>
+
+// values of depth for classes that aren't encoded
+#define CLASS_UNENCODED	-1
+#define CLASS_VISITING	-2
+#define CLASS_INVALID	-3
 
 heck_class* class_create() {
-	heck_class* c = malloc(sizeof(heck_class));
+	heck_class* c = mem_alloc(sizeof(heck_class), MEM_AST);
 	
 	// TODO: make these empty
 	c->friend_vec = vector_create(); // empty list of friends :(
 	c->parent_vec = vector_create(); // empty list of friends :(
 	c->op_overloads = vector_create();
 	
+	c->resolved = false;
+	c->parents = NULL;
+	c->depth = CLASS_UNENCODED;
+	c->display = NULL;
+	c->bit = -1;
+	c->ancestor_bits = NULL;
+	c->live = false;
+	
 	return c;
 }
 
+// collects the names of every class in a scope and its child scopes
+static void collect_classes(str_entry key, void* value, void* user_ptr) {
+	heck_name* name = value;
+	heck_name*** class_vec = user_ptr;
+	
+	if (name->type == IDF_CLASS && name->value.class_value != NULL)
+		vector_add(class_vec, name);
+	
+	// nested classes and namespaces
+	if (name->child_scope != NULL && name->child_scope->names != NULL)
+		idf_map_iterate(name->child_scope->names, collect_classes, user_ptr);
+}
+
+static bool class_resolve_parents(heck_class* class, heck_scope* parent) {
+	if (class->resolved)
+		return true;
+	class->resolved = true;
+	class->parents = vector_create();
+	
+	bool result = true;
+	vec_size_t num_parents = vector_size(class->parent_vec);
+	for (vec_size_t i = 0; i < num_parents; ++i) {
+		heck_name* parent_name = scope_resolve_idf(class->parent_vec[i], parent);
+		if (parent_name == NULL || parent_name->type != IDF_CLASS) {
+			FILE* err = resolve_err();
+			fprintf(err, "error: ");
+			fprint_idf(err, class->parent_vec[i]);
+			fprintf(err, parent_name == NULL ? " is undeclared\n" : " is not a class\n");
+			result = false;
+			continue;
+		}
+		
+		vector_add(&class->parents, parent_name->value.class_value);
+	}
+	
+	return result;
+}
+
+/*
+ *	classes with single inheritance get a Cohen display, the list of their ancestors by depth.
+ *	b is an ancestor of a if a's display has b at b's depth.
+ *	classes with multiple inheritance can't have a display, so they get a bit vector of their
+ *	ancestors instead. only classes that are ancestors of these get a bit, so the vectors stay short.
+ */
+static bool class_encode(heck_class* class, heck_class*** order_vec) {
+	if (class->depth != CLASS_UNENCODED)
+		return class->depth >= 0;
+	class->depth = CLASS_VISITING;
+	
+	int depth = 0;
+	vec_size_t num_parents = vector_size(class->parents);
+	bool single = num_parents <= 1;
+	for (vec_size_t i = 0; i < num_parents; ++i) {
+		heck_class* parent = class->parents[i];
+		if (parent->depth == CLASS_VISITING) {
+			FILE* err = resolve_err();
+			fprintf(err, "error: circular inheritance from ");
+			fprint_idf(err, class->parent_vec[i]);
+			fprintf(err, "\n");
+		}
+		
+		if (!class_encode(parent, order_vec)) {
+			class->depth = CLASS_INVALID;
+			return false;
+		}
+		
+		if (parent->depth >= depth)
+			depth = parent->depth + 1;
+		if (parent->display == NULL)
+			single = false;
+	}
+	
+	class->depth = depth;
+	if (single) {
+		class->display = mem_alloc(sizeof(heck_class*) * (depth + 1), MEM_AST);
+		if (depth > 0)
+			memcpy(class->display, class->parents[0]->display, sizeof(heck_class*) * depth);
+		class->display[depth] = class;
+	}
+	
+	// parents always come before their children
+	vector_add(order_vec, class);
+	return true;
+}
+
+static void class_assign_bit(heck_class* class, int* num_bits) {
+	if (class->bit >= 0)
+		return;
+	
+	class->bit = (*num_bits)++;
+	vec_size_t num_parents = vector_size(class->parents);
+	for (vec_size_t i = 0; i < num_parents; ++i)
+		class_assign_bit(class->parents[i], num_bits);
+}
+
+bool class_hierarchy_build(heck_scope* global) {
+	if (global->names == NULL)
+		return true;
+	
+	heck_name** class_vec = vector_create();
+	idf_map_iterate(global->names, collect_classes, &class_vec);
+	
+	bool result = true;
+	vec_size_t num_classes = vector_size(class_vec);
+	for (vec_size_t i = 0; i < num_classes; ++i)
+		result = class_resolve_parents(class_vec[i]->value.class_value, class_vec[i]->parent) && result;
+	
+	heck_class** order_vec = vector_create();
+	for (vec_size_t i = 0; i < num_classes; ++i)
+		result = class_encode(class_vec[i]->value.class_value, &order_vec) && result;
+	
+	int num_bits = 0;
+	vec_size_t num_encoded = vector_size(order_vec);
+	for (vec_size_t i = 0; i < num_encoded; ++i) {
+		if (order_vec[i]->display == NULL)
+			class_assign_bit(order_vec[i], &num_bits);
+	}
+	
+	size_t num_words = (num_bits + 63) / 64;
+	for (vec_size_t i = 0; i < num_encoded; ++i) {
+		heck_class* class = order_vec[i];
+		if (class->display != NULL)
+			continue;
+		
+		uint64_t* bits = mem_calloc(num_words, sizeof(uint64_t), MEM_AST);
+		bits[class->bit / 64] |= (uint64_t)1 << (class->bit % 64);
+		
+		// parents were encoded first
+		vec_size_t num_parents = vector_size(class->parents);
+		for (vec_size_t j = 0; j < num_parents; ++j) {
+			heck_class* parent = class->parents[j];
+			if (parent->ancestor_bits != NULL) {
+				for (size_t k = 0; k < num_words; ++k)
+					bits[k] |= parent->ancestor_bits[k];
+			} else {
+				for (int k = 0; k <= parent->depth; ++k)
+					bits[parent->display[k]->bit / 64] |= (uint64_t)1 << (parent->display[k]->bit % 64);
+			}
+		}
+		
+		class->ancestor_bits = bits;
+	}
+	
+	vector_free(order_vec);
+	vector_free(class_vec);
+	
+	return result;
+}
+
+bool class_is_subtype(const heck_class* a, const heck_class* b) {
+	if (a == b)
+		return true;
+	
+	if (b->depth < 0)
+		return false;
+	
+	if (a->display != NULL)
+		return b->depth <= a->depth && a->display[b->depth] == b;
+	
+	if (a->ancestor_bits == NULL || b->bit < 0)
+		return false;
+	
+	return (a->ancestor_bits[b->bit / 64] >> (b->bit % 64)) & 1;
+}
+
 //heck_scope* class_create_name(heck_idf name, heck_scope* parent) {
 //	
 //	heck_scope* child = scope_get_child(parent, name);
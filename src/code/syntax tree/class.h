@@ -29,7 +29,17 @@ typedef struct heck_class {
 	heck_idf* parent_vec; // parent classes
 	// TODO: add type parameter/argument
 	
-	bool resolved;
+	bool resolved; // true once the parents are resolved
+	
+	// the hierarchy is encoded by class_hierarchy_build so subtype checks take constant time.
+	// it can also be used for runtime type tests in generated code
+	heck_class** parents; // the classes from parent_vec
+	int depth; // the longest path to a class without parents, negative until the class is encoded
+	heck_class** display; // only with single inheritance, every ancestor by depth, display[depth] is this class
+	int bit; // index into ancestor_bits, -1 unless this class is an ancestor of a class with multiple inheritance
+	uint64_t* ancestor_bits; // only with multiple inheritance, has the bit of every ancestor and this class
+	
+	bool live; // set by heck_shake if the global code can reach the class
 	
 	// overloads
 	heck_op_overload* op_overloads;
@@ -42,6 +52,14 @@ heck_class* class_create(void);
 // creates a heck_name for a class
 heck_scope* class_create_name(heck_idf name, heck_scope* parent);
 
+// resolves the parents of every class that can be reached from global and encodes the hierarchy.
+// returns false if a parent isn't a class or a class inherits from itself
+bool class_hierarchy_build(heck_scope* global);
+
+// true if a is b or inherits from b, in constant time. classes that weren't
+// encoded (e.g. classes in function bodies) are only subtypes of themselves
+bool class_is_subtype(const heck_class* a, const heck_class* b);
+
 // just prints operator overloads, friends, etc
 void print_class(heck_name* class_name, const char* name, int indent);
 
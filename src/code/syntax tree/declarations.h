@@ -11,6 +11,7 @@
 #define declarations_h
 
 typedef struct heck_scope			heck_scope;
+typedef struct heck_name			heck_name;
 typedef struct heck_expr			heck_expr;
 typedef struct heck_stmt			heck_stmt;
 typedef struct heck_nmsp			heck_nmsp;
@@ -19,5 +20,15 @@ typedef struct heck_func_list		heck_func_list;
 typedef struct heck_class			heck_class;
 typedef struct heck_op_overload		heck_op_overload;
 typedef enum heck_idf_type			heck_idf_type;
+typedef struct heck_dep_node		heck_dep_node;
+
+// declarations are resolved the first time they are needed.
+// needing a declaration again while it is still active means it depends on itself
+typedef enum heck_resolve_status {
+	RESOLVE_PENDING,
+	RESOLVE_ACTIVE,
+	RESOLVE_DONE,
+	RESOLVE_FAILED,
+} heck_resolve_status;
 
 #endif /* declarations_h */
@@ -10,18 +10,28 @@
 #include <stdio.h>
 #include "scope.h"
 #include "function.h"
+#include "mem.h"
+#include "resolver.h"
 
 inline heck_expr* create_expr(heck_expr_type expr_type, const expr_vtable* vtable) {
-	heck_expr* e = malloc(sizeof(heck_expr));
+	heck_expr* e = mem_alloc(sizeof(heck_expr), MEM_AST);
 	e->type = expr_type;
 	e->vtable = vtable;
 	e->data_type = NULL; // or make TYPE_UNKNOWN
 	return e;
 }
 
-heck_expr* create_expr_literal(heck_literal* value) {
+heck_expr* create_expr_res_type(const heck_data_type* type) {
+	heck_expr* e = create_expr(EXPR_RES_TYPE, &expr_vtable_res_type);
+	e->data_type = type;
+	e->value.expr = NULL;
+	
+	return e;
+}
+
+heck_expr* create_expr_literal(const heck_literal* value) {
 	heck_expr* e = create_expr(EXPR_LITERAL, &expr_vtable_literal);
-	e->value.literal = value;
+	e->value.literal = *value;
 	e->data_type = value->data_type;
 	
 	return e;
@@ -37,78 +47,101 @@ heck_expr* create_expr_cast(const heck_data_type* type, heck_expr* expr) {
 heck_expr* create_expr_binary(heck_expr* left, heck_tk_type operator, heck_expr* right, const expr_vtable* vtable) {
 	heck_expr* e = create_expr(EXPR_BINARY, vtable);
 	
-	heck_expr_binary* binary = malloc(sizeof(heck_expr_binary));
+	heck_expr_binary* binary = &e->value.binary;
 	binary->left = left;
 	binary->operator = operator;
 	binary->right = right;
 	
-	e->value.binary = binary;
-	
 	return e;
 }
 
 heck_expr* create_expr_unary(heck_expr* expr, heck_tk_type operator, const expr_vtable* vtable) {
 	heck_expr* e = create_expr(EXPR_UNARY, vtable);
 	
-	heck_expr_unary* unary = malloc(sizeof(heck_expr_unary));
+	heck_expr_unary* unary = &e->value.unary;
 	unary->expr = expr;
 	unary->operator = operator;
 	
-	e->value.unary = unary;
-	
 	return e;
 }
 
 heck_expr* create_expr_value(heck_idf name, idf_context context) {
 	heck_expr* e = create_expr(EXPR_VALUE, &expr_vtable_value);
 	
-	heck_expr_value* value = malloc(sizeof(heck_expr_value));
+	// value :)
+	heck_expr_value* value = &e->value.value;
 	value->name = name;
 	value->context = context;
-	
-	// value :)
-	e->value.value = value;
+	value->resolved = NULL;
+	value->depth = 0;
+	value->slot = -1;
 	
 	return e;
 }
 
+// calls are allocated with room for a few arguments right after the expression
+typedef struct heck_expr_call_alloc {
+	heck_expr expr;
+	vector_small_storage(heck_expr*, 4) arg_storage;
+} heck_expr_call_alloc;
+
 heck_expr* create_expr_call(heck_expr* operand) {
-	heck_expr* e = create_expr(EXPR_CALL, &expr_vtable_call);
+	heck_expr_call_alloc* alloc = mem_alloc(sizeof(heck_expr_call_alloc), MEM_AST);
+	heck_expr* e = &alloc->expr;
+	e->type = EXPR_CALL;
+	e->vtable = &expr_vtable_call;
+	e->data_type = NULL;
 	
-	heck_expr_call* call = malloc(sizeof(heck_expr_call));
+	heck_expr_call* call = &e->value.call;
 //	call->name.name = name;
 //	call->name.context = context;
 	call->operand = operand;
-	call->arg_vec = vector_create();
+	call->arg_vec = vector_create_small(&alloc->arg_storage);
 	call->type_arg_vec = NULL;
-	
-	e->value.call = call;
+	call->func = NULL;
 	
 	return e;
 }
 
-heck_expr* create_expr_asg(heck_expr* left, heck_expr* right) {
+void move_expr(heck_expr* dest, heck_expr* src) {
+	*dest = *src;
+	
+	// the arguments can be in the storage right after src, which dest doesn't have
+	if (src->type == EXPR_CALL) {
+		heck_expr** src_args = src->value.call.arg_vec;
+		vec_size_t num_args = vector_size(src_args);
+		
+		heck_expr** arg_vec = vector_create();
+		vector_reserve(&arg_vec, num_args);
+		for (vec_size_t i = 0; i < num_args; ++i)
+			vector_add(&arg_vec, src_args[i]);
+		
+		dest->value.call.arg_vec = arg_vec;
+		vector_free(src_args);
+		src->value.call.arg_vec = vector_create();
+	}
+}
+
+// operator is TK_OP_ASG or one of the compound assignment operators (+=, -=, etc.)
+heck_expr* create_expr_asg(heck_expr* left, heck_tk_type operator, heck_expr* right) {
 	heck_expr* e = create_expr(EXPR_BINARY, &expr_vtable_asg);
 	
-	heck_expr_binary* asg = malloc(sizeof(heck_expr_binary));
+	heck_expr_binary* asg = &e->value.binary;
 	asg->left = left;
+	asg->operator = operator;
 	asg->right = right;
 	
-	e->value.binary = asg;
-	
 	return e;
 }
 
 heck_expr* create_expr_ternary(heck_expr* condition, heck_expr* value_a, heck_expr* value_b) {
 	heck_expr* e = create_expr(EXPR_TERNARY, &expr_vtable_ternary);
 	
-	heck_expr_ternary* ternary = malloc(sizeof(heck_expr_ternary));
+	heck_expr_ternary* ternary = &e->value.ternary;
 	ternary->condition = condition;
 	ternary->value_a = value_a;
 	ternary->value_b = value_b;
 	
-	e->value.ternary = ternary;
-	
 	return e;
 }
 
@@ -167,7 +200,7 @@ heck_expr* create_expr_err() {
 //
 bool resolve_expr_binary(heck_expr* expr, heck_scope* parent, heck_scope* global);
 inline bool resolve_expr_binary(heck_expr* expr, heck_scope* parent, heck_scope* global) {
-	heck_expr_binary* binary = expr->value.binary;
+	heck_expr_binary* binary = &expr->value.binary;
 	return (
 		  binary->left->vtable->resolve(binary->left, parent, global) &&
 		  binary->right->vtable->resolve(binary->right, parent, global)
@@ -184,6 +217,12 @@ void print_expr_binary(heck_expr* expr);
 void free_expr_unary(heck_expr* expr);
 void print_expr_unary(heck_expr* expr);
 
+// resolved type (always resolves to true)
+bool resolve_expr_res_type(heck_expr* expr, heck_scope* parent, heck_scope* global);
+void free_expr_res_type(heck_expr* expr);
+void print_expr_res_type(heck_expr* expr);
+const expr_vtable expr_vtable_res_type = { resolve_expr_res_type, free_expr_res_type, print_expr_res_type };
+
 /*
  * precedence 1
  */
@@ -265,12 +304,15 @@ const expr_vtable expr_vtable_cast = { resolve_expr_cast, free_expr_cast, print_
  * precedence 3
  */
 
-// the basic operators (*, /, %, +, -) share a resolve function currently
+// the basic operators (**, *, /, %, +, -) share a resolve function currently
 
 // multiplication
 bool resolve_expr_mult(heck_expr* expr, heck_scope* parent, heck_scope* global);
 const expr_vtable expr_vtable_mult = { resolve_expr_mult, free_expr_binary, print_expr_binary };
 
+// exponent, binds tighter than the other operators in this group
+const expr_vtable expr_vtable_exp = { resolve_expr_mult, free_expr_binary, print_expr_binary };
+
 // division
 bool resolve_expr_div(heck_expr* expr, heck_scope* parent, heck_scope* global);
 const expr_vtable expr_vtable_div = { resolve_expr_mult, free_expr_binary, print_expr_binary };
@@ -410,80 +452,256 @@ inline bool resolve_expr(heck_expr* expr, heck_scope* parent, heck_scope* global
 	return expr->vtable->resolve(expr, parent, global);
 }
 
+bool resolve_expr_res_type(heck_expr* expr, heck_scope* parent, heck_scope* global) { return true; }
+
 // precedence 1
 bool resolve_expr_err(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
 // literals are always resolved immediatley during scanning
 bool resolve_expr_literal(heck_expr* expr, heck_scope* parent, heck_scope* global) { return true; }
 bool resolve_expr_value(heck_expr* expr, heck_scope* parent, heck_scope* global) {
 	// try to find the identifier
-	heck_name* name = scope_resolve_value(expr->value.value, parent, global);
+	heck_expr_value* value = &expr->value.value;
+	heck_name* name = scope_resolve_value(value, parent, global);
 	
 	if (name == NULL) {
-		fprintf(stderr, "error: use of undeclared identifier\n");
+		FILE* err = resolve_err();
+		fprintf(err, "error: use of undeclared identifier ");
+		fprint_idf(err, value->name);
+		fprintf(err, "\n");
 		return false;
 	}
 	
 	if (name->type == IDF_VARIABLE) {
-		if (name->value.var_value->data_type == NULL) {
-			fprintf(stderr, "error: use of invalid variable\n");
-			return false;
+		FILE* err = resolve_err();
+		switch (var_resolve(name, global)) {
+			case RESOLVE_DONE:
+				expr->data_type = name->value.var_value->data_type;
+				return true;
+			case RESOLVE_ACTIVE:
+				// the variable is still being resolved further up the stack
+				fprintf(err, "error: the value of ");
+				fprint_idf(err, value->name);
+				fprintf(err, " depends on itself\n");
+				return false;
+			default:
+				fprintf(err, "error: use of invalid variable ");
+				fprint_idf(err, value->name);
+				fprintf(err, "\n");
+				return false;
 		}
-		return true;
 	}
 	
 	
 	return false;
 }
-bool resolve_expr_callback(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_unary(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_post_incr(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_post_decr(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_call(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+/*
+ *	operators constrain the types of their operands. an operand whose type isn't known yet
+ *	is unified with the other operand or the type the operator needs, so it's inferred from how it's used.
+ */
+
+// the type of an arithmetic operation, NULL if the operands can't be used together
+const heck_data_type* arithmetic_type(const heck_data_type* left, const heck_data_type* right, bool int_only) {
+	if (!data_type_is_known(left) || !data_type_is_known(right)) {
+		if (!data_type_unify(left, right) || (int_only && !data_type_unify(left, data_type_int)))
+			return NULL;
+		
+		// the unified type might already be known from an earlier constraint
+		return !data_type_is_known(left) || data_type_is_numeric(left) ? left : NULL;
+	}
+	
+	if (int_only)
+		return data_type_cmp(left, data_type_int) && data_type_cmp(right, data_type_int) ? data_type_int : NULL;
+	
+	if (!data_type_is_numeric(left) || !data_type_is_numeric(right))
+		return NULL;
+	
+	// int and float give a float
+	if (data_type_cmp(left, data_type_float) || data_type_cmp(right, data_type_float))
+		return data_type_float;
+	return data_type_int;
+}
+
+bool resolve_arithmetic(heck_expr* expr, heck_scope* parent, heck_scope* global, bool int_only) {
+	if (!resolve_expr_binary(expr, parent, global))
+		return false;
+	
+	heck_expr_binary* binary = &expr->value.binary;
+	if (binary->left->data_type == NULL || binary->right->data_type == NULL)
+		return false;
+	
+	// TODO: check for operator overloads
+	expr->data_type = arithmetic_type(binary->left->data_type, binary->right->data_type, int_only);
+	if (expr->data_type == NULL) {
+		fprintf(resolve_err(), int_only ? "error: invalid operands, expected integers\n" : "error: invalid operands, expected numbers\n");
+		return false;
+	}
 	
-	heck_expr_call* func_call  = expr->value.call;
+	return true;
+}
+
+bool resolve_comparison(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	if (!resolve_arithmetic(expr, parent, global, false))
+		return false;
 	
-	// find function
-	//heck_scope* func_scope = scope_resolve_value(&func_call->name, parent, global);
+	expr->data_type = data_type_bool;
+	return true;
+}
+
+bool resolve_equality(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	heck_expr_binary* eq_expr = &expr->value.binary;
 	
-//	if (func_scope == NULL)
-//		return false;
+	if (!resolve_expr(eq_expr->left, parent, global) || !resolve_expr(eq_expr->right, parent, global))
+		return false;
 	
-	if (!resolve_expr(func_call->operand, parent, global))
+	// TODO: support casting and overloaded comparison operators
+	expr->data_type = data_type_bool;
+	if (!data_type_unify(eq_expr->left->data_type, eq_expr->right->data_type)) {
+		fprintf(resolve_err(), "error: unable to compare values of different types\n");
 		return false;
+	}
+	
+	return true;
+}
+
+// increments and decrements
+bool resolve_step(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	heck_expr* operand = expr->value.unary.expr;
+	if (!resolve_expr(operand, parent, global))
+		return false;
+	
+	if (operand->type != EXPR_VALUE || (data_type_is_known(operand->data_type) && !data_type_is_numeric(operand->data_type))) {
+		fprintf(resolve_err(), "error: only numeric variables can be incremented or decremented\n");
+		return false;
+	}
+	
+	expr->data_type = operand->data_type;
+	return true;
+}
+
+bool resolve_expr_callback(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_unary(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_post_incr(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_step(expr, parent, global);
+}
+bool resolve_expr_post_decr(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_step(expr, parent, global);
+}
+bool resolve_expr_call(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	
+	heck_expr_call* func_call  = &expr->value.call;
+	
+	// the argument types are needed to pick an overload
+	bool result = true;
+	vec_size_t num_args = vector_size(func_call->arg_vec);
+	for (vec_size_t i = 0; i < num_args; ++i) {
+		if (!resolve_expr(func_call->arg_vec[i], parent, global) || func_call->arg_vec[i]->data_type == NULL)
+			result = false;
+	}
 	
 	/*
 	 *	TODO: check if it's a function type
 	 *	then check if it's a callback
-	 *	if not, locate the correct overload for the regular function
 	 */
+	if (func_call->operand->type != EXPR_VALUE)
+		return false;
 	
-	// just return false for now
-	return false;
+	heck_expr_value* value = &func_call->operand->value.value;
+	heck_name* func_name = scope_resolve_value(value, parent, global);
 	
-//	// locate correct overload
-//	func_call->func = func_match_def(func_scope, func_call);
-//
-//
-//	if (func_call->func == NULL)
-//		return false;
-//
-//
-//	// TODO: resolve func return type
-//
-//	// this will do for now
-//	expr->data_type = func_call->func->return_type;
-//
-//	return true;
+	if (func_name == NULL || func_name->type != IDF_FUNCTION) {
+		FILE* err = resolve_err();
+		fprintf(err, "error: ");
+		fprint_idf(err, value->name);
+		fprintf(err, func_name == NULL ? " is undeclared\n" : " is not a function\n");
+		return false;
+	}
+	
+	if (!result)
+		return false;
+	
+	// locate correct overload, only once for each call
+	if (func_call->func == NULL) {
+		heck_func* func = NULL;
+		
+		bool args_known = true;
+		for (vec_size_t i = 0; i < num_args; ++i)
+			args_known = args_known && data_type_is_known(func_call->arg_vec[i]->data_type);
+		
+		if (args_known) {
+			func = func_match_def(&func_name->value.func_value, func_call);
+		} else if ((func = func_infer_def(&func_name->value.func_value, func_call)) == NULL) {
+			FILE* err = resolve_err();
+			fprintf(err, "error: unable to infer the argument types for ");
+			fprint_idf(err, value->name);
+			fprintf(err, "\n");
+			return false;
+		}
+		
+		// generic functions are resolved once for each list of argument types
+		if (func != NULL && func->generic)
+			func = func_gen_instance(func, func_call);
+		
+		func_call->func = func;
+	}
+	
+	if (func_call->func == NULL) {
+		FILE* err = resolve_err();
+		fprintf(err, "error: no overload of ");
+		fprint_idf(err, value->name);
+		fprintf(err, " matches the arguments\n");
+		return false;
+	}
+	
+	// the function is resolved the first time it is called
+	if (!func_def_resolve(func_call->func, global))
+		return false;
+	
+	expr->data_type = func_call->func->return_type;
+	
+	return true;
 	
 }
 bool resolve_expr_arr_access(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
 
 // precedence 2
-bool resolve_expr_pre_incr(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_pre_decr(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_unary_minus(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_not(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_bw_not(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_pre_incr(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_step(expr, parent, global);
+}
+bool resolve_expr_pre_decr(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_step(expr, parent, global);
+}
+bool resolve_expr_unary_minus(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	heck_expr* operand = expr->value.unary.expr;
+	if (!resolve_expr(operand, parent, global))
+		return false;
+	
+	// an unknown operand stays unknown, it could be an int or a float
+	if (data_type_is_known(operand->data_type) && !data_type_is_numeric(operand->data_type)) {
+		fprintf(resolve_err(), "error: invalid operand, expected a number\n");
+		return false;
+	}
+	
+	expr->data_type = operand->data_type;
+	return true;
+}
+bool resolve_expr_not(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	// values can be truthy or falsy as long as they can be resolved
+	expr->data_type = data_type_bool;
+	return resolve_expr(expr->value.unary.expr, parent, global);
+}
+bool resolve_expr_bw_not(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	heck_expr* operand = expr->value.unary.expr;
+	if (!resolve_expr(operand, parent, global))
+		return false;
+	
+	if (!data_type_unify(operand->data_type, data_type_int)) {
+		fprintf(resolve_err(), "error: invalid operand, expected an integer\n");
+		return false;
+	}
+	
+	expr->data_type = data_type_int;
+	return true;
+}
 bool resolve_expr_cast(heck_expr* expr, heck_scope* parent, heck_scope* global) {
 	if (!resolve_expr(expr->value.expr, parent, global))
 		return false;
@@ -493,116 +711,155 @@ bool resolve_expr_cast(heck_expr* expr, heck_scope* parent, heck_scope* global)
 		return true;
 	
 	// TODO: check if types are convertable
-	fputs("error: unable to resolve type cast", stderr);
+	fputs("error: unable to resolve type cast", resolve_err());
 	
 	return false;
 }
 
 // precedence 3
 bool resolve_expr_mult(heck_expr* expr, heck_scope* parent, heck_scope* global) {
-	if (!resolve_expr_binary(expr, parent, global))
-		return false;
-	
-	heck_expr_binary* binary = expr->value.binary;
-
-	// check if types are numeric
-	if (data_type_is_numeric(binary->left->data_type) && data_type_is_numeric(binary->right->data_type)) {
-		expr->data_type = binary->left->data_type;
-		return true;
-	}
-	// TODO: check for operator overloads
-	
-	return false;
-	
+	return resolve_arithmetic(expr, parent, global, false);
+}
+bool resolve_expr_div(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, false);
+}
+bool resolve_expr_mod(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, true);
 }
-bool resolve_expr_div(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_mod(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
 
 // precedence 4
-bool resolve_expr_add(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_sub(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_add(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, false);
+}
+bool resolve_expr_sub(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, false);
+}
 
 // precedence 5
-bool resolve_expr_shift_l(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_shift_r(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_shift_l(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, true);
+}
+bool resolve_expr_shift_r(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, true);
+}
 
 // precedence 6
-bool resolve_expr_bw_and(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_bw_and(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, true);
+}
 
 // precedence 7
-bool resolve_expr_bw_xor(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_bw_xor(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, true);
+}
 
 // precedence 8
-bool resolve_expr_bw_or(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_bw_or(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_arithmetic(expr, parent, global, true);
+}
 
 // precedence 9
-bool resolve_expr_less(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_less_eq(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_gtr(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-bool resolve_expr_gtr_eq(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_less(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_comparison(expr, parent, global);
+}
+bool resolve_expr_less_eq(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_comparison(expr, parent, global);
+}
+bool resolve_expr_gtr(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_comparison(expr, parent, global);
+}
+bool resolve_expr_gtr_eq(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_comparison(expr, parent, global);
+}
 
 // precedence 10
 bool resolve_expr_eq(heck_expr* expr, heck_scope* parent, heck_scope* global) {
-	heck_expr_binary* eq_expr = expr->value.binary;
-	
-	if (!resolve_expr(eq_expr->left, parent, global) || !resolve_expr(eq_expr->right, parent, global))
-		return false;
-	
-	// TODO: support casting and overloaded asg operators
-	return eq_expr->left->data_type == eq_expr->right->data_type;
+	return resolve_equality(expr, parent, global);
+}
+bool resolve_expr_n_eq(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_equality(expr, parent, global);
 }
-bool resolve_expr_n_eq(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
 
 // precedence 11
 bool resolve_expr_and(heck_expr* expr, heck_scope* parent, heck_scope* global) {
-	heck_expr_binary* or_expr = expr->value.binary;
+	heck_expr_binary* or_expr = &expr->value.binary;
 	
 	// values can be truthy or falsy as long as they can be resolved (unless operator bool() is deleted)
+	expr->data_type = data_type_bool;
 	return resolve_expr(or_expr->left, parent, global) && resolve_expr(or_expr->right, parent, global);
 }
 
 // precedence 12
-bool resolve_expr_xor(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_xor(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_expr_and(expr, parent, global);
+}
 
 // precedence 13
-bool resolve_expr_or(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_expr_or(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	return resolve_expr_and(expr, parent, global);
+}
 
 // precedence 14
-bool resolve_expr_ternary(heck_expr* expr, heck_scope* parent, heck_scope* global) { return false; }
-
-// precedence 15
-bool resolve_expr_asg(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+bool resolve_expr_ternary(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	heck_expr_ternary* ternary = &expr->value.ternary;
 	
-	heck_expr_binary* asg = expr->value.binary;
-	
-	/*
-	 *	TODO: check if it's a expr_value
-	 *	otherwise, check if the data type is a temporary reference
-	 */
+	// the condition can be truthy or falsy as long as it can be resolved, like the operands of &&
+	bool result = resolve_expr(ternary->condition, parent, global);
+	result = resolve_expr(ternary->value_a, parent, global) && result;
+	result = resolve_expr(ternary->value_b, parent, global) && result;
+	if (!result)
+		return false;
 	
-	// for now, just return false
-	return false;
+	// either value can be the result, so they must have the same type
+	if (!data_type_unify(ternary->value_a->data_type, ternary->value_b->data_type)) {
+		fprintf(resolve_err(), "error: the values of a ternary expression have different types\n");
+		return false;
+	}
 	
-	/*heck_scope* left = scope_resolve_value(asg->name, parent, global);
+	expr->data_type = ternary->value_a->data_type;
+	return true;
+}
+
+// precedence 15
+bool resolve_expr_asg(heck_expr* expr, heck_scope* parent, heck_scope* global) {
+	heck_expr_binary* asg = &expr->value.binary;
 	
-	if (left == NULL || left->type != IDF_VARIABLE)
+	if (!resolve_expr_binary(expr, parent, global))
 		return false;
 	
-	// find the type of the left operand
-	const heck_data_type* type = ((heck_expr*)left->value)->data_type;
-	// TODO: should an erroneous type be NULL, TYPE_ERR, or is either ok
-	if (type == NULL || type->type_name == TYPE_ERR) {
-		// TODO: line number
-		fprintf(stderr, "error: unable to assign to variable of unknown type\n");
+	// TODO: assign to members, array elements, and temporary references
+	if (asg->left->type != EXPR_VALUE) {
+		fprintf(resolve_err(), "error: unable to assign to an expression that isn't a variable\n");
 		return false;
 	}
 	
-	if (!resolve_expr(asg->value, parent, global))
-		return false;
+	const heck_data_type* type = asg->right->data_type;
+	switch (asg->operator) {
+		case TK_OP_ASG:
+			break;
+		case TK_OP_BW_AND_ASG:
+		case TK_OP_BW_OR_ASG:
+		case TK_OP_BW_XOR_ASG:
+		case TK_OP_BW_NOT_ASG:
+		case TK_OP_MOD_ASG:
+			type = arithmetic_type(asg->left->data_type, type, true);
+			break;
+		default:
+			type = arithmetic_type(asg->left->data_type, type, false);
+			break;
+	}
 	
-	return type == asg->value->data_type;
-	 */
+	// a variable without a value gets its type from the first assignment
+	if (type == NULL || !data_type_unify(asg->left->data_type, type)) {
+		FILE* err = resolve_err();
+		fprintf(err, "error: unable to assign a value of a different type to ");
+		fprint_idf(err, asg->left->value.value.name);
+		fprintf(err, "\n");
+		return false;
+	}
 	
+	expr->data_type = asg->left->data_type;
+	return true;
 }
 
 //
@@ -613,6 +870,8 @@ inline void free_expr(heck_expr* expr) {
 	expr->vtable->free(expr);
 }
 
+void free_expr_res_type(heck_expr* expr) {}
+
 void free_expr_err(heck_expr* expr) {}
 
 void free_expr_literal(heck_expr* expr) {}
@@ -637,12 +896,18 @@ inline void print_expr(heck_expr* expr) {
 	expr->vtable->print(expr);
 }
 
+void print_expr_res_type(heck_expr* expr) {
+	fputs("<", stdout);
+	print_data_type(expr->data_type);
+	fputs(">", stdout);
+}
+
 void print_expr_err(heck_expr* expr) {
 	fputs("@error", stdout);
 }
 
 void print_expr_literal(heck_expr* expr) {
-	print_literal(expr->value.literal);
+	print_literal(&expr->value.literal);
 }
 
 void print_value_idf(heck_expr_value* value) {
@@ -656,12 +921,12 @@ void print_value_idf(heck_expr_value* value) {
 
 void print_expr_value(heck_expr* expr) {
 	fputs("[", stdout);
-	print_value_idf(expr->value.value);
+	print_value_idf(&expr->value.value);
 	fputs("]", stdout);
 }
 
 void print_expr_call(heck_expr* expr) {
-	heck_expr_call* call = expr->value.call;
+	heck_expr_call* call = &expr->value.call;
 	putc('[', stdout);
 	print_expr(call->operand);
 	putc('(', stdout);
@@ -680,7 +945,7 @@ void print_expr_call(heck_expr* expr) {
 }
 
 void print_expr_arr_access(heck_expr* expr) {
-	heck_expr_arr_access* arr_access = expr->value.arr_access;
+	heck_expr_arr_access* arr_access = &expr->value.arr_access;
 	print_expr(arr_access->operand);
 	putc('[', stdout);
 	print_expr(arr_access->value);
@@ -696,7 +961,7 @@ void print_expr_cast(heck_expr* expr) {
 
 void print_expr_binary(heck_expr* expr) {
 	fputs("(", stdout);
-	heck_expr_binary* binary = expr->value.binary;
+	heck_expr_binary* binary = &expr->value.binary;
 	print_expr(binary->left);
 	fputs(" @op ", stdout);
 	print_expr(binary->right);
@@ -705,21 +970,21 @@ void print_expr_binary(heck_expr* expr) {
 
 void print_expr_unary(heck_expr* expr) {
 	fputs("(@op", stdout);
-	heck_expr_unary* unary = expr->value.unary;
+	heck_expr_unary* unary = &expr->value.unary;
 	print_expr(unary->expr);
 	fputs(")", stdout);
 }
 
 void print_expr_asg(heck_expr* expr) {
-	heck_expr_binary* asg = expr->value.binary;
+	heck_expr_binary* asg = &expr->value.binary;
 	fputs("[", stdout);
 	print_expr(asg->left);
-	fputs("] = ", stdout);
+	fputs(asg->operator == TK_OP_ASG ? "] = " : "] @op= ", stdout);
 	print_expr(asg->right);
 }
 
 void print_expr_ternary(heck_expr* expr) {
-	heck_expr_ternary* ternary = expr->value.ternary;
+	heck_expr_ternary* ternary = &expr->value.ternary;
 	fputs("[", stdout);
 	print_expr(ternary->condition);
 	fputs("] ? [", stdout);
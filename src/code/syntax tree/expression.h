@@ -31,6 +31,7 @@ enum heck_expr_type {
 	EXPR_ASG,
 	EXPR_TERNARY,
 	EXPR_CAST,
+	EXPR_RES_TYPE,	// placeholder for a value that only has a resolved type
 	EXPR_ERR		// error parsing
 };
 
@@ -48,9 +49,9 @@ struct expr_vtable {
 	expr_print print;
 };
 
-heck_expr* create_expr_res_type(heck_data_type* type);
+heck_expr* create_expr_res_type(const heck_data_type* type);
 
-heck_expr* create_expr_literal(heck_literal* value);
+heck_expr* create_expr_literal(const heck_literal* value);
 
 heck_expr* create_expr_cast(const heck_data_type* type, heck_expr* expr);
 
@@ -72,6 +73,11 @@ heck_expr* create_expr_unary(heck_expr* expr, heck_tk_type operator, const expr_
 typedef struct heck_expr_value {
 	heck_idf name;
 	idf_context context;
+	
+	// cached by scope_resolve_value so the scope chain is only searched once
+	heck_name* resolved; // NULL until resolved
+	int depth; // function frames between the expression and a local variable, 0 for the same function
+	int slot; // the local variable's index in its function's frame, -1 if it isn't a local
 } heck_expr_value;
 heck_expr* create_expr_value(heck_idf name, idf_context context);
 
@@ -102,7 +108,7 @@ typedef struct heck_expr_arr_access {
 //	heck_expr_value* name;
 //	heck_expr* value;
 //} heck_expr_asg;
-heck_expr* create_expr_asg(heck_expr* left, heck_expr* right);
+heck_expr* create_expr_asg(heck_expr* left, heck_tk_type operator, heck_expr* right);
 
 typedef struct heck_expr_ternary {
 	heck_expr* condition;
@@ -111,18 +117,20 @@ typedef struct heck_expr_ternary {
 } heck_expr_ternary;
 heck_expr* create_expr_ternary(heck_expr* condition, heck_expr* value_a, heck_expr* value_b);
 
+// payloads are stored by value so each expression is a single allocation
+// (and usually a single cache line) instead of a header pointing to a payload
 struct heck_expr {
 	heck_expr_type type;
 	const heck_data_type* data_type;
 	const expr_vtable* vtable; // resolve callback
 	union {
-		heck_expr_unary* unary;
-		heck_expr_binary* binary;
-		heck_expr_ternary* ternary;
-		heck_expr_call* call;
-		heck_expr_arr_access* arr_access;
-		heck_expr_value* value;
-		heck_literal* literal;
+		heck_expr_unary unary;
+		heck_expr_binary binary;
+		heck_expr_ternary ternary;
+		heck_expr_call call;
+		heck_expr_arr_access arr_access;
+		heck_expr_value value;
+		heck_literal literal;
 		heck_expr* expr; // used for cast expression, cast type is stored in parent ^^
 	} value;
 };
@@ -131,12 +139,18 @@ heck_expr* create_expr_err(void);
 
 void free_expr(heck_expr* expr);
 
+// replaces dest with src in place, so whatever pointed to dest now sees src.
+// src must not be used afterwards, its children belong to dest now
+void move_expr(heck_expr* dest, heck_expr* src);
+
 void print_expr(heck_expr* expr);
 
 bool resolve_expr(heck_expr* expr, heck_scope* parent, heck_scope* global);
 
 heck_expr* create_expr(heck_expr_type expr_type, const expr_vtable* vtable);
 
+extern const expr_vtable expr_vtable_res_type;
+
 // precedence 1
 extern const expr_vtable expr_vtable_err;
 extern const expr_vtable expr_vtable_literal;
@@ -156,6 +170,7 @@ extern const expr_vtable expr_vtable_bw_not;
 extern const expr_vtable expr_vtable_cast;
 
 // precedence 3
+extern const expr_vtable expr_vtable_exp;
 extern const expr_vtable expr_vtable_mult;
 extern const expr_vtable expr_vtable_div;
 extern const expr_vtable expr_vtable_mod;
@@ -0,0 +1,360 @@
+//
+//  flat_tree.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "flat_tree.h"
+#include "scope.h"
+#include "function.h"
+#include <stdio.h>
+#include <string.h>
+#include "mem.h"
+
+static heck_flat_tree* flat_tree_alloc(void) {
+	heck_flat_tree* t = mem_alloc(sizeof(heck_flat_tree), MEM_AST);
+	
+	t->tag_vec = vector_create();
+	t->payload_vec = vector_create();
+	t->type_vec = vector_create();
+	
+	t->binary_vec = vector_create();
+	t->unary_vec = vector_create();
+	t->ternary_vec = vector_create();
+	t->call_vec = vector_create();
+	t->literal_vec = vector_create();
+	t->value_vec = vector_create();
+	t->let_vec = vector_create();
+	t->if_vec = vector_create();
+	t->block_vec = vector_create();
+	t->decl_vec = vector_create();
+	
+	t->list_vec = vector_create();
+	
+	t->root = FLAT_NULL_IDX;
+	
+	return t;
+}
+
+void flat_tree_free(heck_flat_tree* t) {
+	vector_free(t->tag_vec);
+	vector_free(t->payload_vec);
+	vector_free(t->type_vec);
+	
+	vector_free(t->binary_vec);
+	vector_free(t->unary_vec);
+	vector_free(t->ternary_vec);
+	vector_free(t->call_vec);
+	vector_free(t->literal_vec);
+	vector_free(t->value_vec);
+	vector_free(t->let_vec);
+	vector_free(t->if_vec);
+	vector_free(t->block_vec);
+	vector_free(t->decl_vec);
+	
+	vector_free(t->list_vec);
+	
+	mem_free(t);
+}
+
+inline uint32_t flat_tree_num_nodes(const heck_flat_tree* t) {
+	return (uint32_t)vector_size(t->tag_vec);
+}
+
+// appends a node and returns its index
+static heck_node_idx add_node(heck_flat_tree* t, heck_flat_tag tag, heck_node_idx payload, const heck_data_type* type) {
+	heck_node_idx idx = flat_tree_num_nodes(t);
+	vector_add(&t->tag_vec, (uint8_t)tag);
+	vector_add(&t->payload_vec, payload);
+	vector_add(&t->type_vec, type);
+	return idx;
+}
+
+// copies a list of children into list_vec and returns the index of the first one
+static heck_node_idx add_list(heck_flat_tree* t, heck_node_idx* children) {
+	heck_node_idx first = (heck_node_idx)vector_size(t->list_vec);
+	vec_size_t size = vector_size(children);
+	for (vec_size_t i = 0; i < size; ++i) {
+		vector_add(&t->list_vec, children[i]);
+	}
+	return first;
+}
+
+/*
+ *
+ * Building the tree
+ *
+ */
+
+static heck_node_idx flatten_block(heck_flat_tree* t, heck_block* block);
+
+static heck_node_idx flatten_expr(heck_flat_tree* t, heck_expr* expr) {
+	
+	if (expr == NULL)
+		return FLAT_NULL_IDX;
+	
+	switch (expr->type) {
+		case EXPR_BINARY: {
+			// children come first
+			heck_flat_binary binary = {
+				.left = flatten_expr(t, expr->value.binary.left),
+				.right = flatten_expr(t, expr->value.binary.right),
+				.operator = expr->value.binary.operator
+			};
+			heck_node_idx payload = (heck_node_idx)vector_size(t->binary_vec);
+			vector_add(&t->binary_vec, binary);
+			return add_node(t, FLAT_EXPR_BINARY, payload, expr->data_type);
+		}
+		case EXPR_UNARY: {
+			heck_flat_unary unary = {
+				.expr = flatten_expr(t, expr->value.unary.expr),
+				.operator = expr->value.unary.operator
+			};
+			heck_node_idx payload = (heck_node_idx)vector_size(t->unary_vec);
+			vector_add(&t->unary_vec, unary);
+			return add_node(t, FLAT_EXPR_UNARY, payload, expr->data_type);
+		}
+		case EXPR_LITERAL: {
+			heck_node_idx payload = (heck_node_idx)vector_size(t->literal_vec);
+			vector_add(&t->literal_vec, expr->value.literal);
+			return add_node(t, FLAT_EXPR_LITERAL, payload, expr->data_type);
+		}
+		case EXPR_VALUE: {
+			heck_node_idx payload = (heck_node_idx)vector_size(t->value_vec);
+			vector_add(&t->value_vec, expr->value.value);
+			return add_node(t, FLAT_EXPR_VALUE, payload, expr->data_type);
+		}
+		case EXPR_CALL: {
+			heck_expr_call* call = &expr->value.call;
+			heck_node_idx callee = FLAT_NULL_IDX;
+			if (call->operand->type == EXPR_VALUE) {
+				callee = (heck_node_idx)vector_size(t->value_vec);
+				vector_add(&t->value_vec, call->operand->value.value);
+			}
+			
+			// flatten every argument before copying their indices,
+			// otherwise nested calls would interleave their own arguments
+			heck_node_idx* arg_vec = vector_create();
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i) {
+				vector_add(&arg_vec, flatten_expr(t, call->arg_vec[i]));
+			}
+			
+			heck_flat_call flat_call = {
+				.callee = callee,
+				.first_arg = add_list(t, arg_vec),
+				.num_args = (uint32_t)num_args
+			};
+			vector_free(arg_vec);
+			
+			heck_node_idx payload = (heck_node_idx)vector_size(t->call_vec);
+			vector_add(&t->call_vec, flat_call);
+			return add_node(t, FLAT_EXPR_CALL, payload, expr->data_type);
+		}
+		case EXPR_TERNARY: {
+			heck_flat_ternary ternary = {
+				.condition = flatten_expr(t, expr->value.ternary.condition),
+				.value_a = flatten_expr(t, expr->value.ternary.value_a),
+				.value_b = flatten_expr(t, expr->value.ternary.value_b)
+			};
+			heck_node_idx payload = (heck_node_idx)vector_size(t->ternary_vec);
+			vector_add(&t->ternary_vec, ternary);
+			return add_node(t, FLAT_EXPR_TERNARY, payload, expr->data_type);
+		}
+		case EXPR_CAST: {
+			heck_node_idx operand = flatten_expr(t, expr->value.expr);
+			return add_node(t, FLAT_EXPR_CAST, operand, expr->data_type);
+		}
+		case EXPR_RES_TYPE:
+			return add_node(t, FLAT_EXPR_RES_TYPE, FLAT_NULL_IDX, expr->data_type);
+		default:
+			return add_node(t, FLAT_EXPR_ERR, FLAT_NULL_IDX, NULL);
+	}
+}
+
+static heck_node_idx flatten_if(heck_flat_tree* t, heck_stmt_if* if_stmt) {
+	
+	heck_node_idx* ladder_vec = vector_create();
+	for (heck_if_node* node = if_stmt->contents; node != NULL; node = node->next) {
+		vector_add(&ladder_vec, flatten_expr(t, node->condition));
+		vector_add(&ladder_vec, flatten_block(t, node->code));
+	}
+	
+	heck_flat_if flat_if = {
+		.type = if_stmt->type,
+		.first_node = add_list(t, ladder_vec),
+		.num_nodes = (uint32_t)vector_size(ladder_vec) / 2
+	};
+	vector_free(ladder_vec);
+	
+	heck_node_idx payload = (heck_node_idx)vector_size(t->if_vec);
+	vector_add(&t->if_vec, flat_if);
+	return add_node(t, FLAT_STMT_IF, payload, NULL);
+}
+
+static heck_node_idx flatten_stmt(heck_flat_tree* t, heck_stmt* stmt) {
+	switch (stmt->type) {
+		case STMT_EXPR: {
+			heck_node_idx expr = flatten_expr(t, stmt->value.expr);
+			return add_node(t, FLAT_STMT_EXPR, expr, NULL);
+		}
+		case STMT_LET: {
+			heck_flat_let let = {
+				.name = stmt->value.let_stmt->name,
+				.value = flatten_expr(t, stmt->value.let_stmt->value)
+			};
+			heck_node_idx payload = (heck_node_idx)vector_size(t->let_vec);
+			vector_add(&t->let_vec, let);
+			return add_node(t, FLAT_STMT_LET, payload, NULL);
+		}
+		case STMT_IF:
+			return flatten_if(t, stmt->value.if_stmt);
+		case STMT_RET: {
+			heck_node_idx expr = flatten_expr(t, stmt->value.expr);
+			return add_node(t, FLAT_STMT_RET, expr, NULL);
+		}
+		case STMT_BLOCK:
+			// a block statement is just the block itself
+			return flatten_block(t, stmt->value.block);
+		case STMT_CLASS: {
+			heck_node_idx payload = (heck_node_idx)vector_size(t->decl_vec);
+			vector_add(&t->decl_vec, (void*)stmt->value.class_stmt->class_scope);
+			return add_node(t, FLAT_STMT_CLASS, payload, NULL);
+		}
+		case STMT_FUNC: {
+			heck_node_idx payload = (heck_node_idx)vector_size(t->decl_vec);
+			vector_add(&t->decl_vec, (void*)stmt->value.func_stmt->func);
+			return add_node(t, FLAT_STMT_FUNC, payload, NULL);
+		}
+		default:
+			return add_node(t, FLAT_STMT_ERR, FLAT_NULL_IDX, NULL);
+	}
+}
+
+static heck_node_idx flatten_block(heck_flat_tree* t, heck_block* block) {
+	
+	// blocks are stored before their contents so linear passes can enter their scope
+	heck_node_idx payload = (heck_node_idx)vector_size(t->block_vec);
+	heck_node_idx idx = add_node(t, FLAT_BLOCK, payload, NULL);
+	vector_add_asg(&t->block_vec); // filled in below
+	
+	heck_node_idx* stmt_vec = vector_create();
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		vector_add(&stmt_vec, flatten_stmt(t, block->stmt_vec[i]));
+	}
+	
+	heck_flat_block* flat_block = &t->block_vec[payload];
+	flat_block->scope = block->scope;
+	flat_block->type = block->type;
+	flat_block->first_stmt = add_list(t, stmt_vec);
+	flat_block->num_stmts = (uint32_t)num_stmts;
+	flat_block->end = flat_tree_num_nodes(t);
+	vector_free(stmt_vec);
+	
+	return idx;
+}
+
+heck_flat_tree* flat_tree_create(heck_block* block) {
+	heck_flat_tree* t = flat_tree_alloc();
+	t->root = flatten_block(t, block);
+	return t;
+}
+
+/*
+ *
+ * Serialization
+ *
+ */
+
+// every array in the order it is serialized
+#define FLAT_TREE_NUM_ARRAYS 14
+#define FLAT_TREE_ARRAYS(t) { \
+	(void**)&(t)->tag_vec,		(void**)&(t)->payload_vec,	(void**)&(t)->type_vec,		\
+	(void**)&(t)->binary_vec,	(void**)&(t)->unary_vec,	(void**)&(t)->ternary_vec,	\
+	(void**)&(t)->call_vec,		(void**)&(t)->literal_vec,	(void**)&(t)->value_vec,	\
+	(void**)&(t)->let_vec,		(void**)&(t)->if_vec,		(void**)&(t)->block_vec,	\
+	(void**)&(t)->decl_vec,		(void**)&(t)->list_vec										\
+}
+static const size_t flat_tree_elem_sizes[FLAT_TREE_NUM_ARRAYS] = {
+	sizeof(uint8_t),			sizeof(heck_node_idx),		sizeof(heck_data_type*),
+	sizeof(heck_flat_binary),	sizeof(heck_flat_unary),	sizeof(heck_flat_ternary),
+	sizeof(heck_flat_call),		sizeof(heck_literal),		sizeof(heck_expr_value),
+	sizeof(heck_flat_let),		sizeof(heck_flat_if),		sizeof(heck_flat_block),
+	sizeof(void*),				sizeof(heck_node_idx)
+};
+
+typedef struct flat_tree_header {
+	uint64_t counts[FLAT_TREE_NUM_ARRAYS];
+	heck_node_idx root;
+} flat_tree_header;
+
+// keeps every array in the buffer aligned for its element type
+#define FLAT_TREE_ALIGN(size) (((size) + 7) & ~(size_t)7)
+
+size_t flat_tree_size(const heck_flat_tree* t) {
+	void** arrays[FLAT_TREE_NUM_ARRAYS] = FLAT_TREE_ARRAYS((heck_flat_tree*)t);
+	size_t size = 0;
+	for (int i = 0; i < FLAT_TREE_NUM_ARRAYS; ++i) {
+		size += vector_size(*arrays[i]) * flat_tree_elem_sizes[i];
+	}
+	return size;
+}
+
+void* flat_tree_serialize(const heck_flat_tree* t, size_t* size) {
+	void** arrays[FLAT_TREE_NUM_ARRAYS] = FLAT_TREE_ARRAYS((heck_flat_tree*)t);
+	
+	flat_tree_header header;
+	header.root = t->root;
+	
+	size_t total = FLAT_TREE_ALIGN(sizeof(flat_tree_header));
+	for (int i = 0; i < FLAT_TREE_NUM_ARRAYS; ++i) {
+		header.counts[i] = vector_size(*arrays[i]);
+		total += FLAT_TREE_ALIGN(header.counts[i] * flat_tree_elem_sizes[i]);
+	}
+	
+	char* data = mem_alloc(total, MEM_AST);
+	memcpy(data, &header, sizeof(flat_tree_header));
+	
+	size_t pos = FLAT_TREE_ALIGN(sizeof(flat_tree_header));
+	for (int i = 0; i < FLAT_TREE_NUM_ARRAYS; ++i) {
+		size_t bytes = header.counts[i] * flat_tree_elem_sizes[i];
+		memcpy(&data[pos], *arrays[i], bytes);
+		pos += FLAT_TREE_ALIGN(bytes);
+	}
+	
+	*size = total;
+	return data;
+}
+
+heck_flat_tree* flat_tree_deserialize(const void* data, size_t size) {
+	if (size < sizeof(flat_tree_header))
+		return NULL;
+	
+	flat_tree_header header;
+	memcpy(&header, data, sizeof(flat_tree_header));
+	
+	heck_flat_tree* t = flat_tree_alloc();
+	t->root = header.root;
+	
+	void** arrays[FLAT_TREE_NUM_ARRAYS] = FLAT_TREE_ARRAYS(t);
+	
+	size_t pos = FLAT_TREE_ALIGN(sizeof(flat_tree_header));
+	for (int i = 0; i < FLAT_TREE_NUM_ARRAYS; ++i) {
+		size_t bytes = header.counts[i] * flat_tree_elem_sizes[i];
+		if (pos + bytes > size) {
+			flat_tree_free(t);
+			return NULL;
+		}
+		
+		// grow the vector to the right length, then copy everything at once
+		for (uint64_t j = 0; j < header.counts[i]; ++j) {
+			_vector_add(arrays[i], flat_tree_elem_sizes[i]);
+		}
+		memcpy(*arrays[i], &((const char*)data)[pos], bytes);
+		pos += FLAT_TREE_ALIGN(bytes);
+	}
+	
+	return t;
+}
@@ -0,0 +1,135 @@
+//
+//  flat_tree.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	A flat copy of the syntax tree, stored as a tag array plus one payload array per node kind.
+//	Nodes refer to each other with 32-bit indices instead of pointers, so the whole tree
+//	lives in a handful of contiguous arrays and can be copied or written out with memcpy.
+//
+//	Expressions and statements are stored in post-order (children before their parent),
+//	so passes that work bottom-up can simply iterate over the nodes from first to last.
+//	Blocks are the exception: a block node comes before its statements and stores the index
+//	one past its last descendant, so a linear pass can keep track of the current scope.
+//
+
+#ifndef flat_tree_h
+#define flat_tree_h
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "statement.h"
+
+typedef uint32_t heck_node_idx;
+#define FLAT_NULL_IDX UINT32_MAX // used for optional children that don't exist
+
+typedef enum heck_flat_tag {
+	FLAT_EXPR_ERR,
+	FLAT_EXPR_LITERAL,		// payload: literal_vec
+	FLAT_EXPR_VALUE,		// payload: value_vec
+	FLAT_EXPR_BINARY,		// payload: binary_vec (includes assignment)
+	FLAT_EXPR_UNARY,		// payload: unary_vec
+	FLAT_EXPR_CALL,			// payload: call_vec
+	FLAT_EXPR_TERNARY,		// payload: ternary_vec
+	FLAT_EXPR_CAST,			// payload: index of the operand, cast type is stored in type_vec
+	FLAT_EXPR_RES_TYPE,		// payload: none, the value only has the type in type_vec
+	
+	FLAT_STMT_EXPR,			// payload: index of the expression
+	FLAT_STMT_LET,			// payload: let_vec
+	FLAT_STMT_IF,			// payload: if_vec
+	FLAT_STMT_RET,			// payload: index of the return value or FLAT_NULL_IDX
+	FLAT_STMT_CLASS,		// payload: decl_vec
+	FLAT_STMT_FUNC,			// payload: decl_vec
+	FLAT_STMT_ERR,
+	FLAT_BLOCK,				// payload: block_vec, also used for block statements
+} heck_flat_tag;
+
+typedef struct heck_flat_binary {
+	heck_node_idx left;
+	heck_node_idx right;
+	heck_tk_type operator;
+} heck_flat_binary;
+
+typedef struct heck_flat_unary {
+	heck_node_idx expr;
+	heck_tk_type operator;
+} heck_flat_unary;
+
+typedef struct heck_flat_ternary {
+	heck_node_idx condition;
+	heck_node_idx value_a;
+	heck_node_idx value_b;
+} heck_flat_ternary;
+
+// arguments are stored contiguously in list_vec. functions can only be called by name so far,
+// so the name is stored in the call instead of being a node of its own
+typedef struct heck_flat_call {
+	heck_node_idx callee; // index into value_vec, FLAT_NULL_IDX if the operand isn't a name
+	heck_node_idx first_arg;
+	uint32_t num_args;
+} heck_flat_call;
+
+typedef struct heck_flat_let {
+	str_entry name;
+	heck_node_idx value; // FLAT_NULL_IDX if there is no initializer
+} heck_flat_let;
+
+// statements are stored contiguously in list_vec
+typedef struct heck_flat_block {
+	heck_scope* scope;
+	heck_block_type type;
+	heck_node_idx first_stmt;
+	uint32_t num_stmts;
+	heck_node_idx end; // one past the last node in the block
+} heck_flat_block;
+
+// the if/else ladder is stored in list_vec as (condition, block) pairs
+// the condition is FLAT_NULL_IDX for an "else" block
+typedef struct heck_flat_if {
+	heck_block_type type;
+	heck_node_idx first_node;
+	uint32_t num_nodes;
+} heck_flat_if;
+
+typedef struct heck_flat_tree {
+	// one entry per node
+	uint8_t* tag_vec;
+	heck_node_idx* payload_vec; // index into the array for the node's tag
+	const heck_data_type** type_vec; // NULL until an expression is resolved
+	
+	// payload arrays, grouped by node kind
+	heck_flat_binary* binary_vec;
+	heck_flat_unary* unary_vec;
+	heck_flat_ternary* ternary_vec;
+	heck_flat_call* call_vec;
+	heck_literal* literal_vec;
+	heck_expr_value* value_vec;
+	heck_flat_let* let_vec;
+	heck_flat_if* if_vec;
+	heck_flat_block* block_vec;
+	void** decl_vec; // heck_func* or heck_scope* for declaration statements
+	
+	// variable length children (call arguments, block statements, if/else ladders)
+	heck_node_idx* list_vec;
+	
+	heck_node_idx root; // the outermost block
+} heck_flat_tree;
+
+// builds a flat copy of a block and everything inside of it
+// strings, identifiers, scopes, and data types are shared with the original tree
+heck_flat_tree* flat_tree_create(heck_block* block);
+void flat_tree_free(heck_flat_tree* tree);
+
+uint32_t flat_tree_num_nodes(const heck_flat_tree* tree);
+
+// the number of bytes used by the arrays of the tree
+size_t flat_tree_size(const heck_flat_tree* tree);
+
+// writes the whole tree into a single buffer that can be memcpy'd or saved.
+// only the indices are position independent; strings, scopes, and types are still pointers
+// into the heck_code that built the tree, so a buffer must only be loaded while that code is alive.
+void* flat_tree_serialize(const heck_flat_tree* tree, size_t* size);
+heck_flat_tree* flat_tree_deserialize(const void* data, size_t size);
+
+#endif /* flat_tree_h */
@@ -8,9 +8,16 @@
 #include "function.h"
 #include "scope.h"
 #include "print.h"
+#include "parser.h"
+#include "resolver.h"
+#include "dep_graph.h"
+#include "dataflow.h"
+#include "mem.h"
+#include "type_table.h"
+#include <pthread.h>
 
 heck_param* param_create(str_entry name) {
-	heck_param* param = malloc(sizeof(heck_param));
+	heck_param* param = mem_alloc(sizeof(heck_param), MEM_AST);
 	
 	param->name = name;
 	param->def_val = NULL;
@@ -21,33 +28,182 @@ heck_param* param_create(str_entry name) {
 }
 
 heck_func* func_create(heck_scope* parent, bool declared) {
-	heck_func* func = malloc(sizeof(heck_func));
+	heck_func* func = mem_alloc(sizeof(heck_func), MEM_AST);
 	func->declared = declared;
-	func->param_vec = vector_create();
+	func->generic = false;
+	func->value.gen_cache = NULL;
+	func->param_vec = vector_create_small(&func->param_storage);
 	
 	heck_scope* block_scope = scope_create(parent);
+	block_scope->func = func;
 	func->code = block_create(block_scope);
+	func->body_code = NULL;
+	func->body_pos = -1;
+	func->body_parsed = true; // nothing to parse yet
+	func->body_valid = true;
+	func->num_locals = 0;
+	func->has_nested = false;
+	func->live = false;
+	func->status = RESOLVE_PENDING;
+	func->opt_status = RESOLVE_PENDING;
 	func->return_type = NULL; // unknown
+	func->dep = NULL;
+	func->read_vec = vector_create();
 	
 	return func;
 }
 
 void func_free(heck_func* func) {
 	vector_free(func->param_vec);
+	vector_free(func->read_vec);
 	block_free(func->code);
-	if (func->return_type != NULL)
-		free_data_type(func->return_type);
 	// TODO: free func->value
 }
 
-bool func_add_overload(heck_func_list* list, heck_func* func) {
-	if (!func_overload_exists(list, func))  {
-		vector_add(&list->func_vec, func);
-		return true;
+int func_add_local(heck_func* func) {
+	return vector_size(func->param_vec) + func->num_locals++;
+}
+
+heck_block* func_get_code(heck_func* func) {
+	// bodies are usually parsed while they're resolved, so the errors go with the resolver's
+	if (!func->body_parsed)
+		heck_parse_func_body(func->body_code, func, resolve_err());
+	return func->code;
+}
+
+/*
+ *	lists with enough overloads are indexed by a hash of the arity and parameter types,
+ *	so a call with an exact match is found without comparing every overload.
+ *	overloads with generic or class parameters are also kept by arity, because those are the
+ *	only other overloads a call can match.
+ */
+#define FUNC_INDEX_MIN_OVERLOADS 4
+
+typedef struct func_index_entry {
+	heck_func* func; // NULL for an empty entry
+	uint32_t hash;
+} func_index_entry;
+
+struct heck_func_index {
+	func_index_entry* entries;
+	uint32_t capacity;
+	uint32_t count;
+	heck_func*** fallback_vec; // overloads with generic or class parameters by arity, NULL for arities without any
+};
+
+static uint32_t hash_combine(uint32_t hash, uint32_t value) {
+	return (hash ^ value) * 16777619;
+}
+
+static uint32_t func_params_hash(const heck_func* func) {
+	vec_size_t num_params = vector_size(func->param_vec);
+	uint32_t hash = hash_combine(TABLE_HASH_INIT, num_params);
+	for (vec_size_t i = 0; i < num_params; ++i)
+		hash = hash_combine(hash, hash_data_type(func->param_vec[i]->type));
+	return hash;
+}
+
+static uint32_t call_args_hash(const heck_expr_call* call) {
+	vec_size_t num_args = vector_size(call->arg_vec);
+	uint32_t hash = hash_combine(TABLE_HASH_INIT, num_args);
+	for (vec_size_t i = 0; i < num_args; ++i)
+		hash = hash_combine(hash, hash_data_type(call->arg_vec[i]->data_type));
+	return hash;
+}
+
+// true if a call can match the function without having the exact parameter types
+static bool func_params_inexact(const heck_func* func) {
+	vec_size_t num_params = vector_size(func->param_vec);
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		heck_type_name type_name = func->param_vec[i]->type->type_name;
+		if (type_name == TYPE_GEN || type_name == TYPE_CLASS)
+			return true;
 	}
 	return false;
 }
 
+static void index_put(heck_func_index* index, heck_func* func, uint32_t hash) {
+	uint32_t i = hash % index->capacity;
+	while (index->entries[i].func != NULL)
+		i = (i + 1) % index->capacity;
+	
+	index->entries[i].func = func;
+	index->entries[i].hash = hash;
+}
+
+static void index_add(heck_func_index* index, heck_func* func) {
+	if (index->count + 1 > TABLE_MAX_LOAD * index->capacity) {
+		func_index_entry* old_entries = index->entries;
+		uint32_t old_capacity = index->capacity;
+		
+		index->capacity *= TABLE_RESIZE_FACTOR;
+		index->entries = mem_calloc(index->capacity, sizeof(func_index_entry), MEM_SCOPES);
+		for (uint32_t i = 0; i < old_capacity; ++i) {
+			if (old_entries[i].func != NULL)
+				index_put(index, old_entries[i].func, old_entries[i].hash);
+		}
+		
+		mem_free(old_entries);
+	}
+	
+	index_put(index, func, func_params_hash(func));
+	++index->count;
+	
+	if (func_params_inexact(func)) {
+		vec_size_t arity = vector_size(func->param_vec);
+		while (vector_size(index->fallback_vec) <= arity)
+			vector_add(&index->fallback_vec, NULL);
+		
+		if (index->fallback_vec[arity] == NULL)
+			index->fallback_vec[arity] = vector_create();
+		vector_add(&index->fallback_vec[arity], func);
+	}
+}
+
+static heck_func_index* index_create(heck_func** func_vec) {
+	heck_func_index* index = mem_alloc(sizeof(heck_func_index), MEM_SCOPES);
+	index->capacity = TABLE_DEFAULT_CAPACITY;
+	index->entries = mem_calloc(index->capacity, sizeof(func_index_entry), MEM_SCOPES);
+	index->count = 0;
+	index->fallback_vec = vector_create();
+	
+	vec_size_t num_funcs = vector_size(func_vec);
+	for (vec_size_t i = 0; i < num_funcs; ++i)
+		index_add(index, func_vec[i]);
+	
+	return index;
+}
+
+static void index_free(heck_func_index* index) {
+	vec_size_t num_arities = vector_size(index->fallback_vec);
+	for (vec_size_t i = 0; i < num_arities; ++i) {
+		if (index->fallback_vec[i] != NULL)
+			vector_free(index->fallback_vec[i]);
+	}
+	vector_free(index->fallback_vec);
+	mem_free(index->entries);
+	mem_free(index);
+}
+
+void func_list_init(heck_func_list* list) {
+	list->func_vec = vector_create(); // stores overloads/definitions
+	list->index = NULL;
+}
+
+bool func_add_overload(heck_func_list* list, heck_func* func) {
+	if (func_overload_exists(list, func))
+		return false;
+	
+	vector_add(&list->func_vec, func);
+	
+	if (list->index != NULL)
+		index_add(list->index, func);
+	else if (vector_size(list->func_vec) >= FUNC_INDEX_MIN_OVERLOADS)
+		list->index = index_create(list->func_vec);
+	
+	return true;
+}
+
 
 //heck_scope* scope_add_func(heck_scope* scope, heck_func* func, heck_idf idf) {
 //	
@@ -90,56 +246,413 @@ bool func_add_overload(heck_func_list* list, heck_func* func) {
 //	
 //}
 //
-///*	calls are matched with definitions/overloads based on a score system.
-//	for each parameter:
-//		an exact match with the corresponding call argument type gives 3 points
-//		a parameter with a generic type (any argument type will work) gives 2 points
-//		a possible cast from the argument to the corresponding parameter type gives 1 point
-//	the definition/overload with the hightes score gets returned*/
-//heck_func* func_match_def(heck_scope* scope, heck_expr_call* call) {
-//	// temporary reference to a vector. DO NOT ADD ELEMENTS TO def_vec
-//	heck_func** def_vec = scope->value.func_value.func_vec;
-//	vec_size_t def_count = vector_size(def_vec);
-//	vec_size_t param_count = vector_size(call->arg_vec);
-//	
-//	heck_func* best_match = NULL;
-//	int best_score = 0;
-//	for (vec_size_t i = 0; i < def_count; ++i) {
-//		if (param_count != vector_size(def_vec[i]->param_vec))
-//			continue;
-//		
-//		bool match = true;
-//		int current_score = 0;
-//		
-//		for (vec_size_t j = 0; j < param_count; j++) {
-//			// check for matching parameter types
-//			if (data_type_cmp(def_vec[i]->param_vec[j]->type, call->arg_vec[j]->data_type)) {
-//				current_score += 3;
-//			
-//			// check for generic param
-//			} else if (call->arg_vec[i]->data_type->type_name == TYPE_GEN) {
-//				current_score += 2;
-//				
-//			// TODO: check for possible cast
-////			} else if (/*arg can be cast to param type*/) {
-////				current_score += 1;
-//				
-//			} else {
-//				match = false;
-//				break;
-//			}
-//		}
-//		
-//		if (match && current_score > best_score) {
-//			best_score = current_score;
-//			best_match = def_vec[i];
-//		}
-//	}
-//	
-//	return best_match;
-//}
+/*	calls are matched with definitions/overloads based on a score system.
+	for each parameter:
+		an exact match with the corresponding call argument type gives 3 points
+		a parameter with a generic type (any argument type will work) gives 2 points
+		a possible cast from the argument to the corresponding parameter type gives 1 point,
+		so far the only casts are from a class to one of its ancestors
+	the definition/overload with the hightes score gets returned,
+	or the most derived one if several have the same score */
+
+// true if every parameter type of a is the same as or a subtype of the parameter type of b
+static bool func_more_derived(const heck_func* a, const heck_func* b) {
+	vec_size_t num_params = vector_size(a->param_vec);
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		const heck_data_type* type_a = a->param_vec[i]->type;
+		const heck_data_type* type_b = b->param_vec[i]->type;
+		if (!data_type_cmp(type_a, type_b) && !data_type_is_subtype(type_a, type_b))
+			return false;
+	}
+	return true;
+}
+
+static heck_func* match_best_score(heck_func** def_vec, heck_expr_call* call) {
+	vec_size_t def_count = vector_size(def_vec);
+	vec_size_t param_count = vector_size(call->arg_vec);
+	
+	heck_func* best_match = NULL;
+	int best_score = -1;
+	for (vec_size_t i = 0; i < def_count; ++i) {
+		if (param_count != vector_size(def_vec[i]->param_vec))
+			continue;
+		
+		bool match = true;
+		int current_score = 0;
+		
+		for (vec_size_t j = 0; j < param_count; j++) {
+			const heck_data_type* param_type = def_vec[i]->param_vec[j]->type;
+			
+			// check for matching parameter types
+			if (data_type_cmp(param_type, call->arg_vec[j]->data_type)) {
+				current_score += 3;
+			
+			// check for generic param
+			} else if (param_type->type_name == TYPE_GEN) {
+				current_score += 2;
+				
+			// check for possible cast
+			} else if (data_type_is_subtype(call->arg_vec[j]->data_type, param_type)) {
+				current_score += 1;
+				
+			} else {
+				match = false;
+				break;
+			}
+		}
+		
+		if (match && (current_score > best_score || (current_score == best_score && func_more_derived(def_vec[i], best_match)))) {
+			best_score = current_score;
+			best_match = def_vec[i];
+		}
+	}
+	
+	return best_match;
+}
+
+// compares the types of a definition's parameters with the types of the arguments of a call
+static bool match_exact(const heck_func* func, const heck_expr_call* call) {
+	vec_size_t num_params = vector_size(func->param_vec);
+	if (num_params != vector_size(call->arg_vec))
+		return false;
+	
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		if (!data_type_cmp(func->param_vec[i]->type, call->arg_vec[i]->data_type))
+			return false;
+	}
+	
+	return true;
+}
+
+heck_func* func_match_def(heck_func_list* list, heck_expr_call* call) {
+	heck_func_index* index = list->index;
+	if (index == NULL)
+		return match_best_score(list->func_vec, call);
+	
+	// an exact match always has the best score
+	uint32_t hash = call_args_hash(call);
+	for (uint32_t i = hash % index->capacity; index->entries[i].func != NULL; i = (i + 1) % index->capacity) {
+		if (index->entries[i].hash == hash && match_exact(index->entries[i].func, call))
+			return index->entries[i].func;
+	}
+	
+	// the only other overloads that can match have generic or class parameters
+	vec_size_t arity = vector_size(call->arg_vec);
+	if (arity >= vector_size(index->fallback_vec) || index->fallback_vec[arity] == NULL)
+		return NULL;
+	
+	return match_best_score(index->fallback_vec[arity], call);
+}
+
+heck_func* func_infer_def(heck_func_list* list, heck_expr_call* call) {
+	vec_size_t num_args = vector_size(call->arg_vec);
+	
+	heck_func* def = NULL;
+	vec_size_t num_defs = vector_size(list->func_vec);
+	for (vec_size_t i = 0; i < num_defs; ++i) {
+		if (vector_size(list->func_vec[i]->param_vec) != num_args)
+			continue;
+		
+		// the argument types can't be picked between several overloads
+		if (def != NULL)
+			return NULL;
+		def = list->func_vec[i];
+	}
+	
+	if (def == NULL)
+		return NULL;
+	
+	for (vec_size_t i = 0; i < num_args; ++i) {
+		const heck_data_type* param_type = def->param_vec[i]->type;
+		const heck_data_type* arg_type = call->arg_vec[i]->data_type;
+		
+		// generic parameters get their type from the argument
+		if (param_type->type_name == TYPE_GEN) {
+			if (!data_type_is_known(arg_type))
+				return NULL;
+		} else if (!data_type_unify(param_type, arg_type) && !data_type_is_subtype(arg_type, param_type)) {
+			return NULL;
+		}
+	}
+	
+	return def;
+}
+
+/*
+ *	generic functions get a copy for each list of argument types they are called with.
+ *	the copies are cached by a hash of the types, so calls with the same types share one
+ *	instance, which is only resolved (and compiled) once.
+ */
+struct heck_func_gen_cache {
+	heck_func_gen_inst** entries; // open addressing, NULL for an empty entry
+	uint32_t capacity;
+	uint32_t count;
+};
+
+// calls to generic functions can be resolved on any thread
+static pthread_mutex_t gen_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t gen_args_hash(const heck_func* func, const heck_expr_call* call) {
+	uint32_t hash = TABLE_HASH_INIT;
+	vec_size_t num_params = vector_size(func->param_vec);
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		if (func->param_vec[i]->type->type_name == TYPE_GEN)
+			hash = hash_combine(hash, hash_data_type(call->arg_vec[i]->data_type));
+	}
+	return hash;
+}
+
+static bool gen_args_match(const heck_func_gen_inst* inst, const heck_func* func, const heck_expr_call* call) {
+	vec_size_t num_params = vector_size(func->param_vec);
+	vec_size_t num_type_args = 0;
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		if (func->param_vec[i]->type->type_name != TYPE_GEN)
+			continue;
+		if (!data_type_cmp(inst->type_args.type_vec[num_type_args++], call->arg_vec[i]->data_type))
+			return false;
+	}
+	return true;
+}
+
+static void gen_cache_put(heck_func_gen_cache* cache, heck_func_gen_inst* inst) {
+	uint32_t i = inst->hash % cache->capacity;
+	while (cache->entries[i] != NULL)
+		i = (i + 1) % cache->capacity;
+	cache->entries[i] = inst;
+}
+
+static void gen_cache_add(heck_func_gen_cache* cache, heck_func_gen_inst* inst) {
+	if (cache->count + 1 > TABLE_MAX_LOAD * cache->capacity) {
+		heck_func_gen_inst** old_entries = cache->entries;
+		uint32_t old_capacity = cache->capacity;
+		
+		cache->capacity *= TABLE_RESIZE_FACTOR;
+		cache->entries = mem_calloc(cache->capacity, sizeof(heck_func_gen_inst*), MEM_AST);
+		for (uint32_t i = 0; i < old_capacity; ++i) {
+			if (old_entries[i] != NULL)
+				gen_cache_put(cache, old_entries[i]);
+		}
+		
+		mem_free(old_entries);
+	}
+	
+	gen_cache_put(cache, inst);
+	++cache->count;
+}
+
+// copies a generic function, using the argument types of the call for the generic parameters
+static heck_func_gen_inst* gen_inst_create(heck_func* func, heck_expr_call* call, uint32_t hash) {
+	heck_func_gen_inst* inst = mem_alloc(sizeof(heck_func_gen_inst), MEM_AST);
+	inst->type_args.type_vec = vector_create();
+	inst->hash = hash;
+	inst->func_code = NULL;
+	
+	heck_func* inst_func = func_create(func->code->scope->parent, func->declared);
+	vec_size_t num_params = vector_size(func->param_vec);
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		heck_param* param = func->param_vec[i];
+		heck_param* inst_param = param_create(param->name);
+		inst_param->obj_type = param->obj_type;
+		inst_param->def_val = param->def_val;
+		inst_param->type = param->type;
+		
+		if (param->type->type_name == TYPE_GEN) {
+			inst_param->type = (heck_data_type*)data_type_find(call->arg_vec[i]->data_type);
+			vector_add(&inst->type_args.type_vec, inst_param->type);
+		}
+		
+		vector_add(&inst_func->param_vec, inst_param);
+	}
+	
+	// the body is parsed again from the same tokens, so each instance has its own tree to resolve
+	if (func->body_pos >= 0 && func->body_valid) {
+		inst_func->body_code = func->body_code;
+		inst_func->body_pos = func->body_pos;
+		inst_func->body_parsed = false;
+	}
+	inst_func->body_valid = func->body_valid;
+	
+	inst->func = inst_func;
+	return inst;
+}
+
+heck_func* func_gen_instance(heck_func* func, heck_expr_call* call) {
+	uint32_t hash = gen_args_hash(func, call);
+	
+	pthread_mutex_lock(&gen_cache_lock);
+	
+	heck_func_gen_cache* cache = func->value.gen_cache;
+	if (cache == NULL) {
+		cache = mem_alloc(sizeof(heck_func_gen_cache), MEM_AST);
+		cache->capacity = TABLE_DEFAULT_CAPACITY;
+		cache->entries = mem_calloc(cache->capacity, sizeof(heck_func_gen_inst*), MEM_AST);
+		cache->count = 0;
+		func->value.gen_cache = cache;
+		
+		// syntax errors in the body are reported once, instances aren't made from an invalid body
+		func_get_code(func);
+	}
+	
+	heck_func_gen_inst* inst = NULL;
+	for (uint32_t i = hash % cache->capacity; cache->entries[i] != NULL; i = (i + 1) % cache->capacity) {
+		if (cache->entries[i]->hash == hash && gen_args_match(cache->entries[i], func, call)) {
+			inst = cache->entries[i];
+			break;
+		}
+	}
+	
+	if (inst == NULL) {
+		inst = gen_inst_create(func, call, hash);
+		gen_cache_add(cache, inst);
+	}
+	
+	pthread_mutex_unlock(&gen_cache_lock);
+	
+	return inst->func;
+}
+
+void func_gen_instances(heck_func* func, heck_func*** inst_vec) {
+	heck_func_gen_cache* cache = func->value.gen_cache;
+	if (cache == NULL)
+		return;
+	
+	for (uint32_t i = 0; i < cache->capacity; ++i) {
+		if (cache->entries[i] != NULL)
+			vector_add(inst_vec, cache->entries[i]->func);
+	}
+}
+
+// frees the instances that aren't live and puts the rest back, returns true if any are left
+static bool gen_cache_remove_dead(heck_func_gen_cache* cache) {
+	heck_func_gen_inst** old_entries = cache->entries;
+	cache->entries = mem_calloc(cache->capacity, sizeof(heck_func_gen_inst*), MEM_AST);
+	cache->count = 0;
+	
+	for (uint32_t i = 0; i < cache->capacity; ++i) {
+		heck_func_gen_inst* inst = old_entries[i];
+		if (inst == NULL)
+			continue;
+		
+		if (inst->func->live) {
+			gen_cache_put(cache, inst);
+			++cache->count;
+		} else {
+			func_free(inst->func);
+			vector_free(inst->type_args.type_vec);
+			mem_free(inst);
+		}
+	}
+	
+	mem_free(old_entries);
+	return cache->count > 0;
+}
+
+void func_list_remove_dead(heck_func_list* list, heck_func*** dead_vec) {
+	vec_size_t num_funcs = vector_size(list->func_vec);
+	vec_size_t num_live = 0;
+	for (vec_size_t i = 0; i < num_funcs; ++i) {
+		heck_func* func = list->func_vec[i];
+		if (func->generic && func->value.gen_cache != NULL && gen_cache_remove_dead(func->value.gen_cache))
+			func->live = true;
+		
+		if (func->live) {
+			list->func_vec[num_live++] = func;
+		} else {
+			vector_add(dead_vec, func);
+		}
+	}
+	
+	if (num_live == num_funcs)
+		return;
+	vector_erase(list->func_vec, num_live, num_funcs - num_live);
+	
+	// the index can't remove entries, so it's made again if there are still enough overloads
+	if (list->index != NULL) {
+		index_free(list->index);
+		list->index = num_live >= FUNC_INDEX_MIN_OVERLOADS ? index_create(list->func_vec) : NULL;
+	}
+}
+
+bool func_def_resolve(heck_func* func, heck_scope* global) {
+	switch (resolve_claim(&func->status)) {
+		case RESOLVE_DONE:
+			return true;
+		case RESOLVE_FAILED:
+			return false;
+		case RESOLVE_ACTIVE:
+			// recursive call, the return type is inferred from the rest of the body
+			return true;
+		case RESOLVE_PENDING:
+			break;
+	}
+	
+	if (func->return_type == NULL)
+		func->return_type = create_type_var();
+	
+	// functions declared in a body can only be called from it, so what they read is read by the body
+	bool nested = func->code->scope->parent->func != NULL;
+	heck_dep_node*** prev_reads = nested ? NULL : dep_begin(func->dep != NULL ? &func->read_vec : NULL);
+	
+	heck_block* code = func_get_code(func);
+	heck_scope* scope = code->scope;
+	bool success = func->body_valid;
+	
+	// parameters are variables that take the first slots in the frame
+	if (scope->names == NULL)
+		scope->names = idf_map_create();
+	vec_size_t num_params = vector_size(func->param_vec);
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		heck_param* param = func->param_vec[i];
+		
+		heck_name* variable = name_create(IDF_VARIABLE, scope);
+		variable->value.var_value = create_expr_res_type(param->type);
+		variable->status = RESOLVE_DONE;
+		variable->slot = (int)i;
+		idf_map_set(scope->names, param->name, variable);
+	}
+	
+	success = resolve_block(code, global) && success;
+	
+	// a variable declared without a value has to be assigned on every path to where it's read
+	if (success) {
+		heck_cfg* cfg = cfg_build(func);
+		success = flow_check_assigned(cfg);
+		cfg_free(cfg);
+	}
+	
+	// no return statements with a value that has a known type
+	if (!data_type_is_known(func->return_type))
+		data_type_unify(func->return_type, data_type_void);
+	
+	if (!nested)
+		dep_end(prev_reads);
+	
+	resolve_finish(&func->status, success);
+	return success;
+}
 
 bool func_overload_exists(heck_func_list* list, heck_func* func) {
+	heck_func_index* index = list->index;
+	if (index != NULL) {
+		uint32_t hash = func_params_hash(func);
+		for (uint32_t i = hash % index->capacity; index->entries[i].func != NULL; i = (i + 1) % index->capacity) {
+			if (index->entries[i].hash != hash)
+				continue;
+			
+			const heck_func* def = index->entries[i].func;
+			vec_size_t param_count = vector_size(func->param_vec);
+			if (param_count != vector_size(def->param_vec))
+				continue;
+			
+			vec_size_t j = 0;
+			while (j < param_count && data_type_cmp(def->param_vec[j]->type, func->param_vec[j]->type))
+				++j;
+			if (j == param_count)
+				return true;
+		}
+		return false;
+	}
+	
 	vec_size_t def_count = vector_size(list->func_vec);
 	vec_size_t param_count = vector_size(func->param_vec);
 	
@@ -192,7 +705,8 @@ void print_func_defs(heck_func_list* list, const char* name, int indent) {
 			}
 		}
 		
-		printf(") -> %i ", func->code->type);
-		print_block(func->code, indent);
+		heck_block* code = func_get_code(func);
+		printf(") -> %i ", code->type);
+		print_block(code, indent);
 	}
 }
@@ -16,21 +16,27 @@
 
 typedef struct heck_scope heck_scope;
 
+typedef struct heck_func_index heck_func_index;
+
 // list of overloads for a function with a given name
 typedef struct heck_func_list {
 	heck_func** func_vec;
+	heck_func_index* index; // NULL until there are enough overloads to make it worth it
 } heck_func_list;
 
-// TODO: rename
 // instance of a generic function
-typedef struct heck_func_gen_list {
-	heck_type_arg_list type_args;
+typedef struct heck_func_gen_inst {
+	heck_type_arg_list type_args; // the types of the arguments for the generic parameters, in order
+	uint32_t hash;
+	heck_func* func; // copy of the generic function with type_args as its parameter types
 	void* func_code; // the code produced from compiling the function using the types from call
 } heck_func_gen_inst;
 
-// use call_gen_vec for generic functions, use func_type for functions with set parameter types
+typedef struct heck_func_gen_cache heck_func_gen_cache;
+
+// use gen_cache for generic functions, use func_type for functions with set parameter types
 typedef union heck_func_value {
-	heck_func_gen_inst** gen_inst_vec;
+	heck_func_gen_cache* gen_cache; // NULL until the function is first called
 	void* func_type;
 } heck_func_value;
 
@@ -49,32 +55,74 @@ heck_param* param_create(str_entry name);
 typedef struct heck_func {
 	// TODO: bitmask these bois
 	bool declared; // heck_func implied definition, so we just need to check if there is a declaration
-	bool generic; // if it's generic, use value.gen_inst_vec
+	bool generic; // if it's generic, use value.gen_cache
 	
 	// if param types are generic, a new overload is added to the function's scope
 	// each time the function is compiled
 	heck_param** param_vec;
+	vector_small_storage(heck_param*, 4) param_storage;
 	
 	heck_func_value value;
 	
-	heck_block* code;
+	heck_block* code; // use func_get_code, the body may not have been parsed yet
+	
+	// bodies are skipped during parsing and parsed the first time they are needed
+	struct heck_code* body_code;
+	int body_pos; // index of the body's '{' token, -1 if there is no body
+	bool body_parsed;
+	bool body_valid; // false if the body has syntax errors
 	
-	heck_data_type* return_type;
+	int num_locals; // local variables in the frame, not counting the parameters
+	bool has_nested; // functions are declared in the body, they can read and write its locals
+	bool live; // set by heck_shake if the global code can reach the function
+	
+	_Atomic heck_resolve_status status; // functions are resolved the first time they are called
+	heck_resolve_status opt_status; // heck_optimize works on callees first, RESOLVE_ACTIVE while it's on this one
+	const heck_data_type* return_type; // inferred from the return statements, NULL until the function is resolved
+	
+	heck_dep_node* dep; // NULL unless the function is declared in the global scope
+	heck_dep_node** read_vec; // the global declarations the body read, until they're added to dep
 } heck_func;
 heck_func* func_create(heck_scope* parent, bool declared);
 void func_free(heck_func* func);
 
+// parses the function body if it hasn't been parsed yet
+heck_block* func_get_code(heck_func* func);
+
+// reserves a frame slot for a local variable, parameters have the first slots
+int func_add_local(heck_func* func);
+
+void func_list_init(heck_func_list* list);
+
+// returns false if there is already an overload with the same parameter types
 bool func_add_overload(heck_func_list* list, heck_func* func);
 heck_scope* scope_add_func(heck_scope* scope, heck_func* func, heck_idf name);
 
-// finds the correct definition/overload for a given call
-heck_func* func_match_def(heck_scope* scope, heck_expr_call* call);
+// removes the overloads that heck_shake didn't mark as live and adds them to dead_vec. generic functions
+// are kept if any of their instances are live, the instances that aren't are freed
+void func_list_remove_dead(heck_func_list* list, heck_func*** dead_vec);
+
+// finds the correct definition/overload for a given call, the arguments must be resolved
+heck_func* func_match_def(heck_func_list* list, heck_expr_call* call);
+
+// used instead of func_match_def when some argument types aren't known yet. if only one definition has the
+// right number of parameters, the unknown types are unified with its parameter types and it is returned
+heck_func* func_infer_def(heck_func_list* list, heck_expr_call* call);
 
 // checks if a definition matches a given argument list
 // finds the best match with the precedence exact=>generic=>castable
 bool func_overload_exists(heck_func_list* list, heck_func* func);
 
-bool func_def_resolve(heck_func* func);
+// returns the instance of a generic function for the argument types of a call, the arguments must be resolved.
+// each list of argument types gets one instance, which is resolved like any other function
+heck_func* func_gen_instance(heck_func* func, heck_expr_call* call);
+
+// adds the instances of a generic function to inst_vec, once nothing is being resolved
+void func_gen_instances(heck_func* func, heck_func*** inst_vec);
+
+// resolves the parameters and body the first time it is called, then returns the same result.
+// recursive calls get the return type as a type variable, which the return statements are unified with
+bool func_def_resolve(heck_func* func, heck_scope* global);
 
 // prints all definitions/declarations for a given function
 void print_func_defs(heck_func_list* list, const char* name, int indent);
@@ -21,16 +21,16 @@ typedef struct heck_literal {
 	} value;
 } heck_literal;
 
-heck_literal* create_literal_int(int val);
+// literals are small enough to be stored by value in tokens and expressions.
+// string literals only store the str_entry, which is interned in the str_table.
+heck_literal create_literal_int(int val);
 
-heck_literal* create_literal_float(float val);
+heck_literal create_literal_float(float val);
 
-heck_literal* create_literal_bool(bool val);
+heck_literal create_literal_bool(bool val);
 
-heck_literal* create_literal_string(str_entry val);
+heck_literal create_literal_string(str_entry val);
 
-void print_literal(heck_literal* value);
-
-void free_literal(heck_literal* value);
+void print_literal(const heck_literal* value);
 
 #endif /* literal_h */
@@ -43,9 +43,9 @@ bool add_op_overload(heck_class* class, heck_op_overload_type* type, heck_func*
 	// if there is no match, create one
 	heck_op_overload* temp = vector_add_asg(&class->op_overloads);
 	temp->type = *type;
-	temp->overloads.func_vec = vector_create();
+	func_list_init(&temp->overloads);
 	// we can just add the function because there are no other overloads
-	vector_add(&temp->overloads.func_vec, func);
+	func_add_overload(&temp->overloads, func);
 	// don't use temp because its lifetime is limited
 	temp = NULL;
 	
@@ -10,22 +10,30 @@
 #include "class.h"
 #include "print.h"
 #include <stdio.h>
+#include "mem.h"
+#include "resolver.h"
+#include "dep_graph.h"
 
 heck_name* name_create(heck_idf_type type, heck_scope* parent) {
 	
-	heck_name* name = malloc(sizeof(heck_name));
+	heck_name* name = mem_alloc(sizeof(heck_name), MEM_SCOPES);
 	
 	name->type = type;
+	name->access = ACCESS_PUBLIC; // access modifiers aren't parsed yet
 	name->value.class_value = NULL; // will set all fields to NULL
 	name->parent = parent;
 	name->child_scope = NULL;
+	name->slot = -1;
+	name->status = RESOLVE_PENDING;
+	name->fold_status = RESOLVE_PENDING;
+	name->dep = NULL;
 	
 	return name;
 }
 
 heck_scope* scope_create(heck_scope* parent) {
 	
-	heck_scope* scope = malloc(sizeof(heck_scope));
+	heck_scope* scope = mem_alloc(sizeof(heck_scope), MEM_SCOPES);
 	scope->names = NULL;
 	scope->decl_vec = NULL;
 	
@@ -33,9 +41,11 @@ heck_scope* scope_create(heck_scope* parent) {
 	if (parent == NULL) {
 		scope->namespace = NULL;
 		scope->class = NULL;
+		scope->func = NULL;
 	} else {
 		scope->namespace = parent->namespace;
 		scope->class = parent->class;
+		scope->func = parent->func;
 	}
 	
 	return scope;
@@ -45,6 +55,73 @@ void scope_free(heck_scope* scope) {
 	// TODO: free the scope
 }
 
+typedef struct scope_inherit {
+	heck_name* old_class;
+	heck_name* new_class;
+	heck_scope* old_nmsp;
+	heck_scope* new_nmsp;
+	heck_func* old_func;
+	heck_func* new_func;
+} scope_inherit;
+
+void scope_inherit_block(heck_block* block, const scope_inherit* inherit);
+void scope_inherit_scope(heck_scope* scope, const scope_inherit* inherit);
+
+void scope_inherit_name(str_entry key, void* value, void* user_ptr) {
+	heck_name* name = value;
+	const scope_inherit* inherit = user_ptr;
+	
+	if (name->type == IDF_FUNCTION) {
+		vec_size_t num_funcs = vector_size(name->value.func_value.func_vec);
+		for (vec_size_t i = 0; i < num_funcs; ++i)
+			scope_inherit_block(name->value.func_value.func_vec[i]->code, inherit);
+	}
+	
+	if (name->child_scope != NULL)
+		scope_inherit_scope(name->child_scope, inherit);
+}
+
+void scope_inherit_scope(heck_scope* scope, const scope_inherit* inherit) {
+	if (scope->class == inherit->old_class)
+		scope->class = inherit->new_class;
+	if (scope->namespace == inherit->old_nmsp)
+		scope->namespace = inherit->new_nmsp;
+	if (scope->func == inherit->old_func)
+		scope->func = inherit->new_func;
+	
+	if (scope->names != NULL)
+		idf_map_iterate(scope->names, scope_inherit_name, (void*)inherit);
+}
+
+void scope_inherit_block(heck_block* block, const scope_inherit* inherit) {
+	scope_inherit_scope(block->scope, inherit);
+	
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		if (stmt->type == STMT_BLOCK) {
+			scope_inherit_block(stmt->value.block, inherit);
+		} else if (stmt->type == STMT_IF) {
+			for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next)
+				scope_inherit_block(node->code, inherit);
+		}
+	}
+}
+
+void block_reparent(heck_block* block, heck_scope* parent, heck_func* func) {
+	scope_inherit inherit = {
+		.old_class = block->scope->class,
+		.new_class = parent->class,
+		.old_nmsp = block->scope->namespace,
+		.new_nmsp = parent->namespace,
+		.old_func = block->scope->func,
+		.new_func = func != NULL ? func : parent->func
+	};
+	
+	block->scope->parent = parent;
+	scope_inherit_block(block, &inherit);
+}
+
 // use this function only when parsing a declaration or definition
 // finds a child of a scope, possibly multiple levels deep.
 // if the child cannot be found, it may be implicitly declared.
@@ -136,7 +213,7 @@ heck_name* scope_resolve_idf(heck_idf idf, const heck_scope* parent) {
 	
 	// find the parent of the idf
 	heck_name* name;
-	while (!idf_map_get(parent->names, idf[0], (void*)&name)) {
+	while (parent->names == NULL || !idf_map_get(parent->names, idf[0], (void*)&name)) {
 		
 		// we have likely reached the global scope if parent->parent == NULL
 		if (parent->parent == NULL)
@@ -152,7 +229,7 @@ heck_name* scope_resolve_idf(heck_idf idf, const heck_scope* parent) {
 		// keep track of child's child_scope as the parent of
 		heck_scope* child_scope = name->child_scope;
 		
-		if (child_scope == NULL)
+		if (child_scope == NULL || child_scope->names == NULL)
 			return NULL;
 		
 		if (idf_map_get(child_scope->names, idf[i], (void*)&name)) {
@@ -166,20 +243,51 @@ heck_name* scope_resolve_idf(heck_idf idf, const heck_scope* parent) {
 		i++;
 	}
 	
+	dep_record(name);
 	return name;
 }
 
+// the number of function bodies that are entered going from ancestor down to scope
+static int scope_frame_depth(const heck_scope* scope, const heck_scope* ancestor) {
+	int depth = 0;
+	for (; scope != ancestor && scope->parent != NULL; scope = scope->parent) {
+		if (scope->func != scope->parent->func)
+			++depth;
+	}
+	return depth;
+}
+
 heck_name* scope_resolve_value(heck_expr_value* value, const heck_scope* parent, const heck_scope* global) {
+	if (value->resolved != NULL)
+		return value->resolved;
+	
+	heck_name* name = NULL;
 	switch (value->context) {
 		case CONTEXT_LOCAL:
-			return scope_resolve_idf(value->name, parent);
+			name = scope_resolve_idf(value->name, parent);
+			break;
 		case CONTEXT_THIS:
 			if (parent->class == NULL || parent->class->child_scope == NULL)
 				return NULL;
-			return scope_resolve_idf(value->name, parent->class->child_scope);
+			name = scope_resolve_idf(value->name, parent->class->child_scope);
+			break;
 		case CONTEXT_GLOBAL:
-			return scope_resolve_idf(value->name, global);
+			name = scope_resolve_idf(value->name, global);
+			break;
 	}
+	
+	if (name == NULL)
+		return NULL;
+	
+	value->resolved = name;
+	
+	// locals can only be found from inside of the scope they were declared in
+	if (name->type == IDF_VARIABLE && name->slot >= 0 && value->context == CONTEXT_LOCAL) {
+		value->depth = scope_frame_depth(parent, name->parent);
+		value->slot = name->slot;
+	}
+	
+	return name;
 }
 
 void scope_add_decl(heck_scope* scope, heck_stmt* decl) {
@@ -207,6 +315,60 @@ heck_scope* add_nmsp_idf(heck_scope* scope, heck_scope* child, heck_idf name) {
 //	return NULL;
 //}
 
+heck_name* scope_add_var(heck_scope* scope, str_entry name, heck_expr* value) {
+	heck_name* variable = NULL;
+	if (scope->names == NULL) {
+		scope->names = idf_map_create();
+	} else if (idf_map_get(scope->names, name, (void*)&variable)) {
+		fprintf(resolve_err(), "error: %s was already declared in this scope\n", name->value);
+		return NULL;
+	}
+	
+	variable = name_create(IDF_VARIABLE, scope);
+	variable->value.var_value = value;
+	if (scope->func != NULL)
+		variable->slot = func_add_local(scope->func);
+	
+	idf_map_set(scope->names, name, variable);
+	
+	return variable;
+}
+
+heck_resolve_status var_resolve(heck_name* var, heck_scope* global) {
+	// locals can only be reached from the body they're in, so they don't need to be claimed
+	bool shared = var->parent->func == NULL;
+	
+	heck_resolve_status status = var->status;
+	if (shared) {
+		status = resolve_claim(&var->status);
+	} else if (status == RESOLVE_PENDING) {
+		var->status = RESOLVE_ACTIVE;
+	}
+	if (status != RESOLVE_PENDING)
+		return status;
+	
+	// locals are read by the body they're in, so only shared variables record their own reads
+	heck_dep_node*** prev_reads = shared ? dep_begin(var->dep != NULL ? &var->dep->read_vec : NULL) : NULL;
+	
+	heck_expr* value = var->value.var_value;
+	bool success = value != NULL && resolve_expr(value, var->parent, global) && value->data_type != NULL;
+	
+	// bodies on other threads could infer the type of a shared variable in any order
+	if (success && shared && !data_type_is_known(value->data_type)) {
+		FILE* err = resolve_err();
+		fprintf(err, "error: unable to infer the type of a shared variable from its value\n");
+		success = false;
+	}
+	
+	if (shared) {
+		dep_end(prev_reads);
+		resolve_finish(&var->status, success);
+	} else {
+		var->status = success ? RESOLVE_DONE : RESOLVE_FAILED;
+	}
+	return success ? RESOLVE_DONE : RESOLVE_FAILED;
+}
+
 heck_name* scope_add_class(heck_scope* parent, heck_idf idf) {
 	heck_name* child = scope_get_child(parent, idf);
 	if (child == NULL)
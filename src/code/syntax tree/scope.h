@@ -56,6 +56,14 @@ typedef struct heck_name {
 	} value;
 	
 	struct heck_scope* child_scope; // optional, might be null
+	
+	int slot; // for variables declared in a function, the index in the function's frame, otherwise -1
+	_Atomic heck_resolve_status status; // variables are resolved the first time they are used
+	
+	// for shared variables, the value is folded by heck_optimize the first time it's read.
+	// RESOLVE_FAILED if the variable is assigned after it's declared, so reads keep the variable
+	heck_resolve_status fold_status;
+	heck_dep_node* dep; // for functions and variables in the global scope, otherwise NULL
 } heck_name;
 heck_name* name_create(heck_idf_type type, heck_scope* parent);
 void name_free(heck_name* name);
@@ -64,6 +72,7 @@ typedef struct heck_scope {
 	struct heck_scope* parent;
 	struct heck_name* class;
 	struct heck_scope* namespace;
+	heck_func* func; // the function whose body the scope is in, NULL outside of functions
 	
 	// map of heck_name*s, NULL if empty
 	idf_map* names;
@@ -72,12 +81,18 @@ typedef struct heck_scope {
 } heck_scope;
 heck_scope* scope_create(heck_scope* parent);
 void scope_free(heck_scope* scope);
+
+// moves a block from an older syntax tree into a new parent scope.
+// child scopes that inherited their class, namespace, or function from the old parent are updated too.
+// func is the function that owns the block now if it is a function body, otherwise NULL
+void block_reparent(heck_block* block, heck_scope* parent, heck_func* func);
 heck_name* scope_get_child(heck_scope* scope, heck_idf idf);
 
 // parent is the scope you are referring from, child is the parent of name, and name is name
 bool name_accessible(const heck_scope* parent, const heck_scope* child, const heck_name* name);
 // returns null if the scope couldn't be resolved or access wasn't allowed
 heck_name* scope_resolve_idf(heck_idf idf, const heck_scope* parent);
+// the result is cached on value along with the frame coordinate for local variables
 heck_name* scope_resolve_value(heck_expr_value* value, const heck_scope* parent, const heck_scope* global);
 
 // add a declaration statement (class members, classes, or functions that belong to the scope)
@@ -85,6 +100,13 @@ void scope_add_decl(heck_scope* scope, heck_stmt* decl);
 
 // vvv TYPES OF CHILD NAMES vvv
 
+// VARIABLE
+// declares a variable with an unresolved value, returns NULL if the name is already taken
+heck_name* scope_add_var(heck_scope* scope, str_entry name, heck_expr* value);
+// resolves the variable's value the first time it is needed, then returns RESOLVE_DONE or RESOLVE_FAILED.
+// returns RESOLVE_ACTIVE without an error message if the value depends on the variable itself
+heck_resolve_status var_resolve(heck_name* var, heck_scope* global);
+
 // NAMESPACE
 heck_name* create_nmsp(void);
 heck_name* add_nmsp_idf(heck_scope* scope, heck_scope* child, heck_idf class_idf);
@@ -10,9 +10,11 @@
 #include "function.h"
 #include "print.h"
 #include <stdio.h>
+#include "mem.h"
+#include "resolver.h"
 
 heck_stmt* create_stmt_expr(heck_expr* expr) {
-	heck_stmt* s = malloc(sizeof(heck_stmt));
+	heck_stmt* s = mem_alloc(sizeof(heck_stmt), MEM_AST);
 	s->type = STMT_EXPR;
 	s->vtable = &stmt_vtable_expr;
 	s->value.expr = expr;
@@ -20,20 +22,21 @@ heck_stmt* create_stmt_expr(heck_expr* expr) {
 }
 
 heck_stmt* create_stmt_let(str_entry name, heck_expr* value) {
-	heck_stmt* s = malloc(sizeof(heck_stmt));
+	heck_stmt* s = mem_alloc(sizeof(heck_stmt), MEM_AST);
 	s->type = STMT_LET;
 	s->vtable = &stmt_vtable_let;
 	
-	heck_stmt_let* let_stmt = malloc(sizeof(heck_stmt_let));
+	heck_stmt_let* let_stmt = mem_alloc(sizeof(heck_stmt_let), MEM_AST);
 	let_stmt->name = name;
 	let_stmt->value = value;
+	let_stmt->slot = -1;
 	
 	s->value.let_stmt = let_stmt;
 	return s;
 }
 
 heck_if_node* create_if_node(heck_expr* condition, heck_scope* parent) {
-	heck_if_node* node = malloc(sizeof(heck_if_node));
+	heck_if_node* node = mem_alloc(sizeof(heck_if_node), MEM_AST);
 	
 	node->condition = condition;
 	node->next = NULL;
@@ -45,11 +48,11 @@ heck_if_node* create_if_node(heck_expr* condition, heck_scope* parent) {
 	return node;
 }
 heck_stmt* create_stmt_if(heck_if_node* contents) {
-	heck_stmt* s = malloc(sizeof(heck_stmt));
+	heck_stmt* s = mem_alloc(sizeof(heck_stmt), MEM_AST);
 	s->type = STMT_IF;
 	s->vtable = &stmt_vtable_if;
 	
-	heck_stmt_if* if_stmt = malloc(sizeof(heck_stmt_if));
+	heck_stmt_if* if_stmt = mem_alloc(sizeof(heck_stmt_if), MEM_AST);
 	if_stmt->type = BLOCK_DEFAULT;
 	if_stmt->contents = contents;
 	
@@ -58,11 +61,11 @@ heck_stmt* create_stmt_if(heck_if_node* contents) {
 }
 
 heck_stmt* create_stmt_class(heck_scope* class_scope) {
-	heck_stmt* s = malloc(sizeof(heck_stmt));
+	heck_stmt* s = mem_alloc(sizeof(heck_stmt), MEM_AST);
 	s->type = STMT_CLASS;
 	s->vtable = &stmt_vtable_class;
 	
-	heck_stmt_class* class_stmt = malloc(sizeof(heck_stmt_class));
+	heck_stmt_class* class_stmt = mem_alloc(sizeof(heck_stmt_class), MEM_AST);
 	class_stmt->class_scope = class_scope;
 	//class_stmt->name = name;
 	
@@ -71,11 +74,11 @@ heck_stmt* create_stmt_class(heck_scope* class_scope) {
 }
 
 heck_stmt* create_stmt_func(heck_func* func) {
-	heck_stmt* s = malloc(sizeof(heck_stmt));
+	heck_stmt* s = mem_alloc(sizeof(heck_stmt), MEM_AST);
 	s->type = STMT_FUNC;
 	s->vtable = &stmt_vtable_func;
 	
-	heck_stmt_func* func_stmt = malloc(sizeof(heck_stmt_func));
+	heck_stmt_func* func_stmt = mem_alloc(sizeof(heck_stmt_func), MEM_AST);
 	func_stmt->func = func;
 	//func_stmt->name = name;
 	
@@ -84,7 +87,7 @@ heck_stmt* create_stmt_func(heck_func* func) {
 }
 
 heck_stmt* create_stmt_ret(heck_expr* expr) {
-	heck_stmt* s = malloc(sizeof(heck_stmt));
+	heck_stmt* s = mem_alloc(sizeof(heck_stmt), MEM_AST);
 	s->type = STMT_RET;
 	s->vtable = &stmt_vtable_ret;
 	
@@ -94,8 +97,8 @@ heck_stmt* create_stmt_ret(heck_expr* expr) {
 }
 
 heck_block* block_create(heck_scope* child) {
-	heck_block* block_stmt = malloc(sizeof(heck_block));
-	block_stmt->stmt_vec = vector_create();
+	heck_block* block_stmt = mem_alloc(sizeof(heck_block), MEM_AST);
+	block_stmt->stmt_vec = vector_create_small(&block_stmt->stmt_storage);
 	block_stmt->scope = child;
 	block_stmt->type = BLOCK_DEFAULT;
 	
@@ -113,12 +116,12 @@ void block_free(heck_block* block) {
 	
 	scope_free(block->scope);
 	
-	free(block);
+	mem_free(block);
 }
 
 heck_stmt* create_stmt_block(struct heck_block* block) {
 	
-	heck_stmt* s = malloc(sizeof(heck_stmt));
+	heck_stmt* s = mem_alloc(sizeof(heck_stmt), MEM_AST);
 	s->type = STMT_BLOCK;
 	s->vtable = &stmt_vtable_block;
 	
@@ -128,7 +131,7 @@ heck_stmt* create_stmt_block(struct heck_block* block) {
 }
 
 heck_stmt* create_stmt_err(void) {
-	heck_stmt* s = malloc(sizeof(heck_stmt));
+	heck_stmt* s = mem_alloc(sizeof(heck_stmt), MEM_AST);
 	s->type = STMT_ERR;
 	s->vtable = &stmt_vtable_err;
 	s->value.expr = NULL; // sets all types to null, obviously
@@ -138,18 +141,16 @@ heck_stmt* create_stmt_err(void) {
 
 bool resolve_block(heck_block* block, heck_scope* global) {
 	// store status in bool so we can continue resolving even when we come across an error
-	//bool result = resolve_scope(block->scope, global);
+	bool result = true;
 	
 	vec_size_t size = vector_size(block->stmt_vec);
 	for (vec_size_t i = 0; i < size; ++i) {
 		heck_stmt* current = block->stmt_vec[i];
 		if (!current->vtable->resolve(current, block->scope, global))
-			return false;
-			//result = false;
+			result = false;
 	}
 	
-	return true;
-	//return result;
+	return result;
 }
 
 void print_block(heck_block* block, int indent) {
@@ -173,7 +174,7 @@ inline bool resolve_stmt(heck_stmt* stmt, heck_scope* parent, heck_scope* global
 }
 inline void free_stmt(heck_stmt* stmt) {
 	stmt->vtable->free(stmt);
-	free(stmt);
+	mem_free(stmt);
 }
 inline void print_stmt(heck_stmt* stmt, int indent) {
 	
@@ -238,21 +239,23 @@ void print_stmt_expr(heck_stmt* stmt, int indent) {
 bool resolve_stmt_let(heck_stmt* stmt, heck_scope* parent, heck_scope* global) {
 	heck_stmt_let* let_stmt = stmt->value.let_stmt;
 	
-	// check for variable in current scope
-	heck_scope* child = NULL; // essentially useless
-	if (idf_map_get(parent->names, let_stmt->name, (void*)&child)) {
-		fprintf(stderr, "error: variable %s was already declared in this scope\n", let_stmt->name->value);
-		return false;
+	// variables in global and namespace blocks are declared ahead of time
+	heck_name* variable = NULL;
+	if (parent->names != NULL && idf_map_get(parent->names, let_stmt->name, (void*)&variable)) {
+		if (variable->type != IDF_VARIABLE || variable->value.var_value != let_stmt->value) {
+			// the declaration pass already reported duplicates outside of functions
+			if (parent->func != NULL)
+				fprintf(resolve_err(), "error: %s was already declared in this scope\n", let_stmt->name->value);
+			return false;
+		}
+	} else {
+		variable = scope_add_var(parent, let_stmt->name, let_stmt->value);
+		if (variable == NULL)
+			return false;
 	}
+	let_stmt->slot = variable->slot;
 	
-	// create the new variable
-	heck_name* variable = name_create(IDF_VARIABLE, parent);
-	variable->value.var_value = let_stmt->value;
-	
-	idf_map_set(parent->names, let_stmt->name, variable);
-	
-	return resolve_expr(let_stmt->value, parent, global);
-		
+	return var_resolve(variable, global) == RESOLVE_DONE;
 }
 void free_stmt_let(heck_stmt* stmt) {
 	
@@ -277,7 +280,19 @@ void print_stmt_block(heck_stmt* stmt, int indent) {
 	print_block(stmt->value.block, indent);
 }
 
-bool resolve_stmt_if(heck_stmt* stmt, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_stmt_if(heck_stmt* stmt, heck_scope* parent, heck_scope* global) {
+	bool result = true;
+	
+	for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next) {
+		// values can be truthy or falsy as long as they can be resolved
+		if (node->condition != NULL && !resolve_expr(node->condition, parent, global))
+			result = false;
+		if (!resolve_block(node->code, global))
+			result = false;
+	}
+	
+	return result;
+}
 void free_stmt_if(heck_stmt* stmt) {
 	
 }
@@ -310,7 +325,28 @@ void print_stmt_if(heck_stmt* stmt, int indent) {
 	}
 }
 
-bool resolve_stmt_ret(heck_stmt* stmt, heck_scope* parent, heck_scope* global) { return false; }
+bool resolve_stmt_ret(heck_stmt* stmt, heck_scope* parent, heck_scope* global) {
+	heck_func* func = parent->func; // the parser only allows return statements in functions
+	
+	const heck_data_type* type = data_type_void;
+	if (stmt->value.expr != NULL) {
+		if (!resolve_expr(stmt->value.expr, parent, global))
+			return false;
+		type = stmt->value.expr->data_type;
+		if (type == NULL)
+			return false;
+	}
+	
+	// every return statement must have the same type
+	if (func->return_type == NULL) {
+		func->return_type = type;
+	} else if (!data_type_unify(func->return_type, type)) {
+		fprintf(resolve_err(), "error: return type doesn't match an earlier return statement\n");
+		return false;
+	}
+	
+	return true;
+}
 void free_stmt_ret(heck_stmt* stmt) {
 	
 }
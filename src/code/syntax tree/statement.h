@@ -54,6 +54,7 @@ heck_stmt* create_stmt_expr(heck_expr* expr);
 typedef struct heck_stmt_let {
 	str_entry name;
 	heck_expr* value;
+	int slot; // the variable's frame slot once it's resolved, -1 outside of functions
 } heck_stmt_let;
 heck_stmt* create_stmt_let(str_entry name, heck_expr* value);
 
@@ -64,6 +65,7 @@ typedef struct heck_block {
 	heck_block_type type;
 	struct heck_scope* scope;
 	heck_stmt** stmt_vec;
+	vector_small_storage(heck_stmt*, 4) stmt_storage; // most blocks only have a few statements
 } heck_block;
 heck_block* block_create(heck_scope* child);
 void block_free(heck_block* block);
@@ -9,15 +9,105 @@
 #include <stdlib.h>
 #include "vec.h"
 #include "scope.h"
+#include "mem.h"
+#include "resolver.h"
+#include "class.h"
+#include <pthread.h>
 
 heck_data_type* create_data_type(heck_type_name name) {
-	heck_data_type* t = malloc(sizeof(heck_data_type));
+	heck_data_type* t = mem_alloc(sizeof(heck_data_type), MEM_TYPES);
 	t->type_name = name;
 	
 	return t;
 }
 
+/*
+ *	type variables are kept in a union-find forest. unifying two variables links the root of the
+ *	smaller tree to the other root, and unifying a variable with a real type binds its root to it.
+ *	paths are compressed every time a root is found, so each constraint takes nearly constant time.
+ */
+
+// return types are shared between bodies, which can be resolved on different threads
+static pthread_mutex_t type_var_lock = PTHREAD_MUTEX_INITIALIZER;
+
+heck_data_type* create_type_var(void) {
+	heck_data_type* t = create_data_type(TYPE_UNKNOWN);
+	t->vtable = &type_vtable_var;
+	t->type_value.var_type.bound = NULL;
+	t->type_value.var_type.rank = 0;
+	return t;
+}
+
+// must be called with type_var_lock
+static const heck_data_type* type_var_root(const heck_data_type* type) {
+	const heck_data_type* root = type;
+	while (root->type_name == TYPE_UNKNOWN && root->type_value.var_type.bound != NULL)
+		root = root->type_value.var_type.bound;
+	
+	// point everything on the path straight to the root
+	while (type != root) {
+		heck_data_type* var = (heck_data_type*)type;
+		type = var->type_value.var_type.bound;
+		var->type_value.var_type.bound = root;
+	}
+	
+	return root;
+}
+
+const heck_data_type* data_type_find(const heck_data_type* type) {
+	if (type->type_name != TYPE_UNKNOWN)
+		return type;
+	
+	pthread_mutex_lock(&type_var_lock);
+	type = type_var_root(type);
+	pthread_mutex_unlock(&type_var_lock);
+	
+	return type;
+}
+
+bool data_type_unify(const heck_data_type* a, const heck_data_type* b) {
+	if (a->type_name != TYPE_UNKNOWN && b->type_name != TYPE_UNKNOWN)
+		return data_type_cmp(a, b);
+	
+	pthread_mutex_lock(&type_var_lock);
+	a = type_var_root(a);
+	b = type_var_root(b);
+	
+	// already unified, binding a root to itself would make a cycle
+	bool var_a = a != b && a->type_name == TYPE_UNKNOWN;
+	bool var_b = a != b && b->type_name == TYPE_UNKNOWN;
+	if (var_a && var_b) {
+		heck_type_var* a_var = &((heck_data_type*)a)->type_value.var_type;
+		heck_type_var* b_var = &((heck_data_type*)b)->type_value.var_type;
+		if (a_var->rank < b_var->rank) {
+			a_var->bound = b;
+		} else {
+			b_var->bound = a;
+			if (a_var->rank == b_var->rank)
+				++a_var->rank;
+		}
+	} else if (var_a) {
+		((heck_data_type*)a)->type_value.var_type.bound = b;
+	} else if (var_b) {
+		((heck_data_type*)b)->type_value.var_type.bound = a;
+	}
+	pthread_mutex_unlock(&type_var_lock);
+	
+	// both roots are real types
+	if (!var_a && !var_b)
+		return data_type_cmp(a, b);
+	
+	return true;
+}
+
+bool data_type_is_known(const heck_data_type* type) {
+	return data_type_find(type)->type_name != TYPE_UNKNOWN;
+}
+
 bool data_type_cmp(const heck_data_type* a, const heck_data_type* b) {
+	a = data_type_find(a);
+	b = data_type_find(b);
+	if (a == b) return true;
 	if (a->type_name != b->type_name) return false;
 	
 	switch (a->type_name) {
@@ -63,7 +153,28 @@ bool data_type_cmp(const heck_data_type* a, const heck_data_type* b) {
 	}
 }
 
+bool data_type_is_subtype(const heck_data_type* a, const heck_data_type* b) {
+	a = data_type_find(a);
+	b = data_type_find(b);
+	if (a->type_name != TYPE_CLASS || b->type_name != TYPE_CLASS)
+		return false;
+	
+	const heck_class_type* class_a = &a->type_value.class_type;
+	const heck_class_type* class_b = &b->type_value.class_type;
+	
+	heck_name* name_a = scope_resolve_idf(class_a->value.name, class_a->parent);
+	if (name_a == NULL || name_a->type != IDF_CLASS)
+		return false;
+	
+	heck_name* name_b = scope_resolve_idf(class_b->value.name, class_b->parent);
+	if (name_b == NULL || name_b->type != IDF_CLASS)
+		return false;
+	
+	return class_is_subtype(name_a->value.class_value, name_b->value.class_value);
+}
+
 inline bool data_type_is_numeric(const heck_data_type* type) {
+	type = data_type_find(type);
 	return type->type_name == TYPE_INT || type->type_name == TYPE_FLOAT;
 }
 
@@ -88,6 +199,7 @@ const heck_data_type val_data_type_int		= { TYPE_INT,		&type_vtable_int,		NULL }
 const heck_data_type val_data_type_float	= { TYPE_FLOAT, 	&type_vtable_float,		NULL };
 const heck_data_type val_data_type_bool		= { TYPE_BOOL,		&type_vtable_bool,		NULL };
 const heck_data_type val_data_type_string	= { TYPE_STRING,	&type_vtable_string,	NULL };
+const heck_data_type val_data_type_void		= { TYPE_VOID,		&type_vtable_void,		NULL };
 
 
 // primitives are already resolved, resolve methods return true
@@ -97,6 +209,10 @@ void free_type_prim(heck_data_type* type);
 heck_data_type* resolve_type_err(heck_data_type* type, heck_scope* parent, heck_scope* global);
 void print_type_err(const heck_data_type* type);
 const type_vtable type_vtable_err = { resolve_type_err, free_type_prim, print_type_err };
+// type variable
+void free_type_var(heck_data_type* type);
+void print_type_var(const heck_data_type* type);
+const type_vtable type_vtable_var = { resolve_type_err, free_type_var, print_type_var };
 // generic
 void print_type_gen(const heck_data_type* type);
 const type_vtable type_vtable_gen = { resolve_type_err, free_type_prim, print_type_gen };
@@ -112,6 +228,9 @@ const type_vtable type_vtable_bool = { resolve_type_prim, free_type_prim, print_
 // string
 void print_type_string(const heck_data_type* type);
 const type_vtable type_vtable_string = { resolve_type_prim, free_type_prim, print_type_string };
+// void
+void print_type_void(const heck_data_type* type);
+const type_vtable type_vtable_void = { resolve_type_prim, free_type_prim, print_type_void };
 // array
 heck_data_type* resolve_type_arr(heck_data_type* type, heck_scope* parent, heck_scope* global);
 void free_type_arr(heck_data_type* type);
@@ -145,12 +264,12 @@ heck_data_type* resolve_type_class(heck_data_type* type, heck_scope* parent, hec
 	
 	// TODO: line numbers in error messages
 	if (n == NULL) {
-		fprintf(stderr, "error: unable to resolve identifier\n");
+		fprintf(resolve_err(), "error: unable to resolve identifier\n");
 		return NULL;
 	}
 	
 	if (n->type != IDF_CLASS) {
-		fprintf(stderr, "error: not a class\n");
+		fprintf(resolve_err(), "error: not a class\n");
 	}
 	
 	class_type->value.class = n->value.class_value;
@@ -171,7 +290,7 @@ heck_data_type* resolve_type_class_args(heck_data_type* type, heck_scope* parent
 	for (vec_size_t i = 0; i < size; i++) {
 		heck_data_type* current_type = resolve_data_type(class_type->type_args.type_vec[i], parent, global);
 		if (current_type == NULL) {
-			fprintf(stderr, "error: invalid type argument\n");
+			fprintf(resolve_err(), "error: invalid type argument\n");
 			return NULL;
 		}
 		class_type->type_args.type_vec[i] = current_type;
@@ -185,27 +304,42 @@ void free_type_prim(heck_data_type* type) {
 	// free(hong kong)
 }
 
+void free_type_var(heck_data_type* type) {
+	mem_free(type);
+}
+
 // assumes there are no type arguments
 void free_type_class(heck_data_type* type) {
-	free(type);
+	mem_free(type);
 }
 
 void free_type_class_args(heck_data_type* type) {
-	free(type);
+	mem_free(type);
 	vector_free(type->type_value.class_type.type_args.type_vec);
 }
 
 void free_type_arr(heck_data_type* type) {
-	free(type);
+	mem_free(type);
 	free_data_type(type->type_value.arr_type);
 }
 
 void print_type_err(const heck_data_type* type) {
 	fputs("@error", stdout);
 }
+void print_type_var(const heck_data_type* type) {
+	const heck_data_type* root = data_type_find(type);
+	if (root->type_name == TYPE_UNKNOWN) {
+		fputs("unknown", stdout);
+	} else {
+		print_data_type(root);
+	}
+}
 void print_type_gen(const heck_data_type* type) {
 	fputs("generic", stdout);
 }
+void print_type_void(const heck_data_type* type) {
+	fputs("void", stdout);
+}
 void print_type_int(const heck_data_type* type) {
 	fputs("int", stdout);
 }
@@ -9,6 +9,7 @@
 #define types_h
 
 #include "identifier.h"
+#include "vec.h"
 #include "declarations.h"
 
 /*
@@ -48,9 +49,12 @@ typedef enum heck_type_name {
 
 typedef struct heck_data_type heck_data_type;
 
+// most types have no type arguments, so the list is always allocated out of line.
+// types are interned and never copied by value, copying one would share its type_vec
 typedef struct heck_type_arg_list {
 	heck_data_type** type_vec;
 } heck_type_arg_list;
+_Static_assert(sizeof(heck_type_arg_list) == sizeof(heck_data_type**), "type argument lists must not have inline storage");
 
 typedef struct heck_class_type {
 	union {
@@ -61,6 +65,12 @@ typedef struct heck_class_type {
 	heck_scope* parent; // this is used with name to find the correct class during resolve time
 } heck_class_type;
 
+// a TYPE_UNKNOWN type is a variable for type inference, it is unified with other types as they are resolved
+typedef struct heck_type_var {
+	const heck_data_type* bound; // a type this was unified with, NULL if nothing is known about it yet
+	int rank;
+} heck_type_var;
+
 typedef struct type_vtable type_vtable;
 struct heck_data_type {
 	heck_type_name type_name;
@@ -69,6 +79,7 @@ struct heck_data_type {
 		heck_class_type class_type;
 		heck_data_type* arr_type; // recursive structure
 		const heck_data_type* prim_arr_type;
+		heck_type_var var_type;
 	} type_value;
 };
 // resolve callback
@@ -86,11 +97,13 @@ heck_data_type* resolve_data_type(heck_data_type* type, heck_scope* parent, heck
 void free_data_type(heck_data_type* type);
 
 extern const type_vtable type_vtable_err;
+extern const type_vtable type_vtable_var;
 extern const type_vtable type_vtable_gen;
 extern const type_vtable type_vtable_int;
 extern const type_vtable type_vtable_float;
 extern const type_vtable type_vtable_bool;
 extern const type_vtable type_vtable_string;
+extern const type_vtable type_vtable_void;
 extern const type_vtable type_vtable_arr;
 extern const type_vtable type_vtable_class;
 // class with a type argument list
@@ -104,14 +117,28 @@ extern const heck_data_type val_data_type_int;
 extern const heck_data_type val_data_type_float;
 extern const heck_data_type val_data_type_bool;
 extern const heck_data_type val_data_type_string;
+extern const heck_data_type val_data_type_void;
 #define data_type_err		&val_data_type_err
 #define data_type_gen		&val_data_type_gen
 #define data_type_int		&val_data_type_int
 #define data_type_float		&val_data_type_float
 #define data_type_bool		&val_data_type_bool
 #define data_type_string	&val_data_type_string
+#define data_type_void		&val_data_type_void
+
+// a new TYPE_UNKNOWN type that can be unified with other types
+heck_data_type* create_type_var(void);
+// the type a type variable was unified with, or the variable that represents everything it was unified with.
+// other types are returned as they are
+const heck_data_type* data_type_find(const heck_data_type* type);
+// makes two types the same if either of them is a type variable, otherwise compares them
+bool data_type_unify(const heck_data_type* a, const heck_data_type* b);
+// false for type variables that haven't been unified with a real type
+bool data_type_is_known(const heck_data_type* type);
 
 bool data_type_cmp(const heck_data_type* a, const heck_data_type* b);
+// true if a and b are class types and a's class is or inherits from b's class, type arguments aren't checked
+bool data_type_is_subtype(const heck_data_type* a, const heck_data_type* b);
 bool data_type_is_numeric(const heck_data_type* type);
 /*
 typedef enum heck_literal_type {
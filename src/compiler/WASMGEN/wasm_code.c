@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <memory.h>
 #include <stdio.h>
+#include "mem.h"
 
 #define CODE_MIN_BYTES 1024
 #define REALLOC_FACTOR 1.5
@@ -20,8 +21,8 @@ struct wasm_code {
 };
 
 wasm_code* wasm_code_create(void) {
-	wasm_code* code = malloc(sizeof(wasm_code));
-	code->bytes = malloc(CODE_MIN_BYTES);
+	wasm_code* code = mem_alloc(sizeof(wasm_code), MEM_CODEGEN);
+	code->bytes = mem_alloc(CODE_MIN_BYTES, MEM_CODEGEN);
 	code->alloc = CODE_MIN_BYTES;
 	code->pos = 0;
 	
@@ -31,14 +32,59 @@ wasm_code* wasm_code_create(void) {
 void wasm_code_add(wasm_code* code, char* bytes, size_t count) {
 	size_t new_pos = code->pos + count;
 	
-	if (new_pos >= code->alloc)
-		code->bytes = realloc(code->bytes, new_pos * REALLOC_FACTOR); // guaranteed to fit new bytes
+	if (new_pos >= code->alloc) {
+		code->alloc = new_pos * REALLOC_FACTOR; // guaranteed to fit new bytes
+		code->bytes = mem_realloc(code->bytes, code->alloc, MEM_CODEGEN);
+	}
 	
 	memcpy(&code->bytes[code->pos], bytes, count);
 	
 	code->pos = new_pos;
 }
 
+void wasm_code_free(wasm_code* code) {
+	mem_free(code->bytes);
+	mem_free(code);
+}
+
+void wasm_code_byte(wasm_code* code, uint8_t byte) {
+	wasm_code_add(code, (char*)&byte, 1);
+}
+
+void wasm_code_uleb(wasm_code* code, uint32_t value) {
+	do {
+		uint8_t byte = value & 0x7F;
+		value >>= 7;
+		wasm_code_byte(code, value != 0 ? byte | 0x80 : byte);
+	} while (value != 0);
+}
+
+void wasm_code_sleb(wasm_code* code, int32_t value) {
+	bool more = true;
+	while (more) {
+		uint8_t byte = value & 0x7F;
+		value >>= 7; // arithmetic shift, so the sign is kept
+		more = !((value == 0 && !(byte & 0x40)) || (value == -1 && (byte & 0x40)));
+		wasm_code_byte(code, more ? byte | 0x80 : byte);
+	}
+}
+
+void wasm_code_f32(wasm_code* code, float value) {
+	// wasm is little endian
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	for (int i = 0; i < 4; ++i)
+		wasm_code_byte(code, (bits >> (i * 8)) & 0xFF);
+}
+
+void wasm_code_append(wasm_code* code, const wasm_code* other) {
+	wasm_code_add(code, other->bytes, other->pos);
+}
+
+size_t wasm_code_size(const wasm_code* code) {
+	return code->pos;
+}
+
 void wasm_code_print(wasm_code* code) {
 	
 	printf("offset: 00 01 02 03 04 05 06 07 08 09 0A 0B 0C 0D 0E 0F\n");
@@ -47,7 +93,7 @@ void wasm_code_print(wasm_code* code) {
 	for (size_t i = 0; i < code->pos; ++i) {
 		if (i % 0x10 == 0)
 			printf("\n%06zX: ", i - i % 0x10);
-		printf("%02X ", code->bytes[i]);
+		printf("%02X ", (unsigned char)code->bytes[i]);
 	}
 	
 	printf("\n");
@@ -60,8 +106,8 @@ bool wasm_code_output(wasm_code* code, const char* output) {
 	if (!f)
 		return false;
 	
-	fwrite(code->bytes, code->pos, 1, f);
+	bool success = fwrite(code->bytes, 1, code->pos, f) == code->pos;
 	
-	return true;
+	return fclose(f) == 0 && success;
 	
 }
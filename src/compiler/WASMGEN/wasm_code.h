@@ -10,6 +10,7 @@
 
 #include "wasm_macros.h"
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 // evaluates args for nested expressions
@@ -28,8 +29,23 @@ typedef struct wasm_code wasm_code;
 
 wasm_code* wasm_code_create(void);
 
+void wasm_code_free(wasm_code* code);
+
 void wasm_code_add(wasm_code* code, char* bytes, size_t count);
 
+// opcodes above 0x7F don't fit in $wasm's char arrays
+void wasm_code_byte(wasm_code* code, uint8_t byte);
+
+// LEB128, used for every integer in the binary format
+void wasm_code_uleb(wasm_code* code, uint32_t value);
+void wasm_code_sleb(wasm_code* code, int32_t value);
+
+void wasm_code_f32(wasm_code* code, float value);
+
+void wasm_code_append(wasm_code* code, const wasm_code* other);
+
+size_t wasm_code_size(const wasm_code* code);
+
 void wasm_code_print(wasm_code* code);
 
 bool wasm_code_output(wasm_code* code, const char* filename);
@@ -0,0 +1,278 @@
+//
+//  wasm_emit.c
+//  WASMGEN
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "wasm_module_impl.h"
+#include "vec.h"
+#include "mem.h"
+
+/*
+ *	Function bodies are emitted straight from the IR. Every value that is used gets a local,
+ *	except constants, which are emitted again wherever they're used, and a phi is assigned at
+ *	the end of each predecessor. Wasm only has structured control flow, so the blocks are nested
+ *	following the dominator tree, the way Norman Ramsey describes in "Beyond Relooper":
+ *	a block with several predecessors is placed right after a wasm block that contains
+ *	everything that branches to it, so the branches can break out to it.
+ */
+
+typedef struct emit_ctx {
+	wasm_module* module;
+	wasm_code* code;
+	const heck_ir_dom* dom;
+	int* local_map; // the local each instruction's value is stored in, by id
+	const heck_ir_block** label_vec; // what a br to each enclosing label goes to, the innermost label is last. NULL for ifs
+} emit_ctx;
+
+// constants don't need a local
+static bool emit_stored(const heck_ir_inst* inst) {
+	return inst->op != IR_CONST && inst->type != IR_VOID && inst->uses != NULL;
+}
+
+static void emit_locals(emit_ctx* ctx, const heck_ir_func* ir) {
+	heck_ir_type* type_vec = vector_create();
+	int num_reachable = (int)vector_size(ctx->dom->rpo_vec);
+	for (int i = 0; i < num_reachable; ++i) {
+		for (const heck_ir_inst* inst = ctx->dom->rpo_vec[i]->first; inst != NULL; inst = inst->next) {
+			if (inst->op == IR_PARAM) {
+				ctx->local_map[inst->id] = inst->value.index;
+			} else if (emit_stored(inst)) {
+				ctx->local_map[inst->id] = ir->num_params + (int)vector_size(type_vec);
+				vector_add(&type_vec, inst->type);
+			}
+		}
+	}
+	
+	// locals are declared in runs of the same type
+	int num_locals = (int)vector_size(type_vec);
+	int num_runs = 0;
+	for (int i = 0; i < num_locals; ++i)
+		num_runs += i == 0 || (type_vec[i] == IR_FLOAT) != (type_vec[i - 1] == IR_FLOAT);
+	
+	wasm_code_uleb(ctx->code, num_runs);
+	for (int i = 0; i < num_locals;) {
+		int end = i + 1;
+		while (end < num_locals && (type_vec[end] == IR_FLOAT) == (type_vec[i] == IR_FLOAT))
+			++end;
+		wasm_code_uleb(ctx->code, end - i);
+		wasm_code_byte(ctx->code, type_vec[i] == IR_FLOAT ? $f32 : $i32);
+		i = end;
+	}
+	
+	vector_free(type_vec);
+}
+
+static void emit_get(emit_ctx* ctx, const heck_ir_inst* value) {
+	if (value->op != IR_CONST) {
+		wasm_code_byte(ctx->code, $local_get);
+		wasm_code_uleb(ctx->code, ctx->local_map[value->id]);
+	} else if (value->type == IR_FLOAT) {
+		wasm_code_byte(ctx->code, $f32_const);
+		wasm_code_f32(ctx->code, value->value.literal.value.float_value);
+	} else {
+		wasm_code_byte(ctx->code, $i32_const);
+		wasm_code_sleb(ctx->code, value->type == IR_BOOL ? value->value.literal.value.bool_value : value->value.literal.value.int_value);
+	}
+}
+
+static void emit_operands(emit_ctx* ctx, const heck_ir_inst* inst) {
+	for (int i = 0; i < inst->num_operands; ++i)
+		emit_get(ctx, inst->operands[i].value);
+}
+
+static uint8_t emit_binary_opcode(heck_tk_type operator, bool is_float) {
+	switch (operator) {
+		case TK_OP_ADD:		return is_float ? $f32_add : $i32_add;
+		case TK_OP_SUB:		return is_float ? $f32_sub : $i32_sub;
+		case TK_OP_MULT:	return is_float ? $f32_mul : $i32_mul;
+		case TK_OP_DIV:		return is_float ? $f32_div : $i32_div_s;
+		case TK_OP_MOD:		return $i32_rem_s;
+		case TK_OP_SHFT_L:	return $i32_shl;
+		case TK_OP_SHFT_R:	return $i32_shr_s;
+		case TK_OP_BW_AND:	return $i32_and;
+		case TK_OP_BW_OR:	return $i32_or;
+		case TK_OP_BW_XOR:	return $i32_xor;
+		case TK_OP_LESS:	return is_float ? $f32_lt : $i32_lt_s;
+		case TK_OP_LESS_EQ:	return is_float ? $f32_le : $i32_le_s;
+		case TK_OP_GTR:		return is_float ? $f32_gt : $i32_gt_s;
+		case TK_OP_GTR_EQ:	return is_float ? $f32_ge : $i32_ge_s;
+		case TK_OP_EQ:		return is_float ? $f32_eq : $i32_eq;
+		default:			return is_float ? $f32_ne : $i32_ne;
+	}
+}
+
+static void emit_inst(emit_ctx* ctx, const heck_ir_inst* inst) {
+	// values that aren't used are only computed if computing them does something
+	if (inst->uses == NULL && !ir_has_effects(inst))
+		return;
+	
+	wasm_code* code = ctx->code;
+	switch (inst->op) {
+		case IR_GLOBAL_GET:
+			wasm_code_byte(code, $global_get);
+			wasm_code_uleb(code, wasm_module_global_index(ctx->module, inst->value.global.var, inst->type));
+			break;
+		case IR_GLOBAL_SET:
+			emit_operands(ctx, inst);
+			wasm_code_byte(code, $global_set);
+			wasm_code_uleb(code, wasm_module_global_index(ctx->module, inst->value.global.var, inst->operands[0].value->type));
+			break;
+		case IR_CALL:
+			emit_operands(ctx, inst);
+			wasm_code_byte(code, $call);
+			wasm_code_uleb(code, wasm_module_func_index(ctx->module, inst->value.call.func, inst->value.call.name));
+			break;
+		case IR_BINARY:
+			emit_operands(ctx, inst);
+			if (inst->value.operator == TK_OP_EXP) {
+				wasm_code_byte(code, $call);
+				wasm_code_uleb(code, wasm_module_pow_index(ctx->module));
+			} else {
+				wasm_code_byte(code, emit_binary_opcode(inst->value.operator, inst->operands[0].value->type == IR_FLOAT));
+			}
+			break;
+		case IR_NEG:
+			if (inst->type == IR_FLOAT) {
+				emit_operands(ctx, inst);
+				wasm_code_byte(code, $f32_neg);
+			} else {
+				$wasm(code, $i32_const, 0x00);
+				emit_operands(ctx, inst);
+				wasm_code_byte(code, $i32_sub);
+			}
+			break;
+		case IR_BW_NOT:
+			emit_operands(ctx, inst);
+			$wasm(code, $i32_const, 0x7F, $i32_xor); // -1
+			break;
+		case IR_NOT:
+			emit_operands(ctx, inst);
+			wasm_code_byte(code, $i32_eqz);
+			break;
+		case IR_TO_FLOAT:
+			emit_operands(ctx, inst);
+			wasm_code_byte(code, $f32_convert_i32_s);
+			break;
+		default:
+			return; // parameters, constants, and phis are already where they need to be
+	}
+	
+	if (emit_stored(inst)) {
+		wasm_code_byte(code, $local_set);
+		wasm_code_uleb(code, ctx->local_map[inst->id]);
+	} else if (inst->type != IR_VOID) {
+		wasm_code_byte(code, $drop);
+	}
+}
+
+// the phis of a block are all assigned at once, so a phi can be an operand of another one
+static void emit_phi_copies(emit_ctx* ctx, const heck_ir_block* from, const heck_ir_block* to) {
+	int pred = ir_pred_index(to, from);
+	const heck_ir_inst* last = NULL;
+	for (const heck_ir_inst* phi = to->first; phi != NULL && phi->op == IR_PHI; phi = phi->next) {
+		if (emit_stored(phi))
+			emit_get(ctx, phi->operands[pred].value);
+		last = phi;
+	}
+	
+	for (const heck_ir_inst* phi = last; phi != NULL; phi = phi->prev) {
+		if (emit_stored(phi)) {
+			wasm_code_byte(ctx->code, $local_set);
+			wasm_code_uleb(ctx->code, ctx->local_map[phi->id]);
+		}
+	}
+}
+
+static void emit_tree(emit_ctx* ctx, const heck_ir_block* block);
+
+static void emit_branch(emit_ctx* ctx, const heck_ir_block* from, const heck_ir_block* to) {
+	emit_phi_copies(ctx, from, to);
+	
+	// a block with one predecessor is emitted in place, others come after the end of their label
+	if (vector_size(to->pred_vec) == 1) {
+		emit_tree(ctx, to);
+		return;
+	}
+	
+	int num_labels = (int)vector_size(ctx->label_vec);
+	int depth = 0;
+	while (ctx->label_vec[num_labels - 1 - depth] != to)
+		++depth;
+	wasm_code_byte(ctx->code, $br);
+	wasm_code_uleb(ctx->code, depth);
+}
+
+// merge_vec holds the children of the block in the dominator tree that have several predecessors,
+// the ones that come later in reverse postorder first, so they get the outer labels
+static void emit_within(emit_ctx* ctx, const heck_ir_block* block, const heck_ir_block** merge_vec, int index) {
+	if (index < (int)vector_size(merge_vec)) {
+		const heck_ir_block* merge = merge_vec[index];
+		$wasm(ctx->code, $block, $void);
+		vector_add(&ctx->label_vec, merge);
+		emit_within(ctx, block, merge_vec, index + 1);
+		vector_remove(ctx->label_vec, vector_size(ctx->label_vec) - 1);
+		wasm_code_byte(ctx->code, $end);
+		
+		emit_tree(ctx, merge);
+		return;
+	}
+	
+	for (const heck_ir_inst* inst = block->first; inst != block->last; inst = inst->next)
+		emit_inst(ctx, inst);
+	
+	const heck_ir_inst* end = block->last;
+	switch (end->op) {
+		case IR_JUMP:
+			emit_branch(ctx, block, block->succ[0]);
+			break;
+		case IR_BRANCH:
+			emit_operands(ctx, end);
+			$wasm(ctx->code, $if, $void);
+			vector_add(&ctx->label_vec, NULL);
+			emit_branch(ctx, block, block->succ[0]);
+			wasm_code_byte(ctx->code, $else);
+			emit_branch(ctx, block, block->succ[1]);
+			vector_remove(ctx->label_vec, vector_size(ctx->label_vec) - 1);
+			wasm_code_byte(ctx->code, $end);
+			break;
+		default:
+			emit_operands(ctx, end);
+			wasm_code_byte(ctx->code, $return);
+			break;
+	}
+}
+
+static void emit_tree(emit_ctx* ctx, const heck_ir_block* block) {
+	const heck_ir_dom* dom = ctx->dom;
+	const heck_ir_block** merge_vec = vector_create();
+	for (int i = dom->tree.child_start[block->id + 1] - 1; i >= dom->tree.child_start[block->id]; --i) {
+		if (vector_size(dom->children[i]->pred_vec) > 1)
+			vector_add(&merge_vec, dom->children[i]);
+	}
+	
+	emit_within(ctx, block, merge_vec, 0);
+	vector_free(merge_vec);
+}
+
+void wasm_emit_func(wasm_module* module, wasm_code* code, const heck_ir_func* ir, const heck_ir_dom* dom) {
+	emit_ctx ctx = {
+		.module = module,
+		.code = code,
+		.dom = dom,
+		.local_map = mem_alloc((ir->num_inst_ids + 1) * sizeof(int), MEM_CODEGEN),
+		.label_vec = vector_create(),
+	};
+	
+	emit_locals(&ctx, ir);
+	emit_tree(&ctx, dom->rpo_vec[0]);
+	
+	// every path returns, but wasm still checks the end of the body for the result
+	if (ir->return_type != IR_VOID)
+		wasm_code_byte(code, $unreachable);
+	wasm_code_byte(code, $end);
+	
+	vector_free(ctx.label_vec);
+	mem_free(ctx.local_map);
+}
@@ -16,21 +16,72 @@
 #define $f32		0x7D
 #define $f64		0x7C
 
-#define $i32_add	0x6A
-
 #define $func		0x60
+#define $void		0x40 // the block type of a block without a result
 
 #define $sec_type	0x01
 #define $sec_func	0x03
 #define $sec_mem	0x05
+#define $sec_global	0x06
 #define $sec_export	0x07
+#define $sec_start	0x08
 #define $sec_code	0x0A
 
-#define $end		0x0B
+// control
+#define $unreachable	0x00
+#define $block			0x02
+#define $loop			0x03
+#define $if				0x04
+#define $else			0x05
+#define $end			0x0B
+#define $br				0x0C
+#define $br_if			0x0D
+#define $return			0x0F
+#define $call			0x10
+#define $drop			0x1A
 
+// variables
 #define $local_get	0x20
+#define $local_set	0x21
+#define $global_get	0x23
+#define $global_set	0x24
+
+#define $i32_const	0x41
+#define $f32_const	0x43
+
+// i32
+#define $i32_eqz	0x45
+#define $i32_eq		0x46
+#define $i32_ne		0x47
+#define $i32_lt_s	0x48
+#define $i32_gt_s	0x4A
+#define $i32_le_s	0x4C
+#define $i32_ge_s	0x4E
+#define $i32_add	0x6A
+#define $i32_sub	0x6B
+#define $i32_mul	0x6C
+#define $i32_div_s	0x6D
+#define $i32_rem_s	0x6F
+#define $i32_and	0x71
+#define $i32_or		0x72
+#define $i32_xor	0x73
+#define $i32_shl	0x74
+#define $i32_shr_s	0x75
+#define $i32_shr_u	0x76
+
+// f32
+#define $f32_eq		0x5B
+#define $f32_ne		0x5C
+#define $f32_lt		0x5D
+#define $f32_gt		0x5E
+#define $f32_le		0x5F
+#define $f32_ge		0x60
+#define $f32_neg	0x8C
+#define $f32_add	0x92
+#define $f32_sub	0x93
+#define $f32_mul	0x94
+#define $f32_div	0x95
 
-#define $if			0x04
-#define $else		0x05
+#define $f32_convert_i32_s	0xB2
 
 #endif /* wasm_macros_h */
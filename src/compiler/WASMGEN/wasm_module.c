@@ -0,0 +1,233 @@
+//
+//  wasm_module.c
+//  WASMGEN
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "wasm_module_impl.h"
+#include "ptr_map.h"
+#include "vec.h"
+#include "mem.h"
+
+typedef struct wasm_func_entry {
+	heck_func* func; // NULL for the global code and helper functions
+	str_entry name;
+	heck_ir_type* param_types;
+	int num_params;
+	heck_ir_type return_type;
+	wasm_code* body; // NULL until the function is added
+} wasm_func_entry;
+
+struct wasm_module {
+	wasm_func_entry* func_vec;
+	heck_ir_type* global_vec; // the type of each global variable
+	ptr_map func_map;
+	ptr_map global_map;
+	int next_func; // the functions before this one were handed out by wasm_module_next_func
+	int start; // the global code, -1 until it is added
+	int pow; // -1 until it is needed
+};
+
+/*
+ *	Functions and Globals
+ */
+
+wasm_module* wasm_module_create(void) {
+	wasm_module* module = mem_alloc(sizeof(wasm_module), MEM_CODEGEN);
+	module->func_vec = vector_create();
+	module->global_vec = vector_create();
+	ptr_map_init(&module->func_map, MEM_CODEGEN);
+	ptr_map_init(&module->global_map, MEM_CODEGEN);
+	module->next_func = 0;
+	module->start = -1;
+	module->pow = -1;
+	
+	return module;
+}
+
+void wasm_module_free(wasm_module* module) {
+	vec_size_t num_funcs = vector_size(module->func_vec);
+	for (vec_size_t i = 0; i < num_funcs; ++i) {
+		mem_free(module->func_vec[i].param_types);
+		if (module->func_vec[i].body != NULL)
+			wasm_code_free(module->func_vec[i].body);
+	}
+	vector_free(module->func_vec);
+	vector_free(module->global_vec);
+	ptr_map_free(&module->func_map);
+	ptr_map_free(&module->global_map);
+	mem_free(module);
+}
+
+static int wasm_module_add_entry(wasm_module* module, heck_func* func, str_entry name) {
+	wasm_func_entry* entry = vector_add_asg(&module->func_vec);
+	entry->func = func;
+	entry->name = name;
+	entry->param_types = NULL;
+	entry->num_params = 0;
+	entry->return_type = IR_VOID;
+	entry->body = NULL;
+	
+	return (int)vector_size(module->func_vec) - 1;
+}
+
+int wasm_module_func_index(wasm_module* module, heck_func* func, str_entry name) {
+	int index = ptr_map_get(&module->func_map, func);
+	if (index == -1) {
+		index = wasm_module_add_entry(module, func, name);
+		ptr_map_set(&module->func_map, func, index);
+	}
+	return index;
+}
+
+int wasm_module_global_index(wasm_module* module, heck_name* var, heck_ir_type type) {
+	int index = ptr_map_get(&module->global_map, var);
+	if (index == -1) {
+		index = (int)vector_size(module->global_vec);
+		vector_add(&module->global_vec, type);
+		ptr_map_set(&module->global_map, var, index);
+	}
+	return index;
+}
+
+static void wasm_module_set_type(wasm_module* module, int index, const heck_ir_type* param_types, int num_params, heck_ir_type return_type) {
+	wasm_func_entry* entry = &module->func_vec[index];
+	entry->num_params = num_params;
+	entry->return_type = return_type;
+	entry->param_types = mem_alloc(num_params * sizeof(heck_ir_type) + 1, MEM_CODEGEN);
+	for (int i = 0; i < num_params; ++i)
+		entry->param_types[i] = param_types[i];
+}
+
+int wasm_module_pow_index(wasm_module* module) {
+	if (module->pow != -1)
+		return module->pow;
+	
+	module->pow = wasm_module_add_entry(module, NULL, NULL);
+	const heck_ir_type param_types[] = { IR_INT, IR_INT };
+	wasm_module_set_type(module, module->pow, param_types, 2, IR_INT);
+	
+	// exponentiation by squaring, like the folded version.
+	// params: 0 is the base, 1 is the exponent, local 2 is the result
+	wasm_code* code = wasm_code_create();
+	$wasm(code, 0x01, 0x01, $i32);
+	$wasm(code, $i32_const, 0x01, $local_set, 0x02);
+	$wasm(code, $block, $void, $loop, $void);
+	$wasm(code, $local_get, 0x01, $i32_eqz, $br_if, 0x01);
+	$wasm(code, $local_get, 0x01, $i32_const, 0x01, $i32_and);
+	$wasm(code, $if, $void, $local_get, 0x02, $local_get, 0x00, $i32_mul, $local_set, 0x02, $end);
+	$wasm(code, $local_get, 0x00, $local_get, 0x00, $i32_mul, $local_set, 0x00);
+	$wasm(code, $local_get, 0x01, $i32_const, 0x01, $i32_shr_u, $local_set, 0x01);
+	$wasm(code, $br, 0x00, $end, $end);
+	$wasm(code, $local_get, 0x02, $end);
+	module->func_vec[module->pow].body = code;
+	
+	return module->pow;
+}
+
+void wasm_module_add_func(wasm_module* module, const heck_ir_func* ir, const heck_ir_dom* dom) {
+	int index;
+	if (ir->func != NULL) {
+		index = wasm_module_func_index(module, ir->func, ir->name);
+	} else {
+		index = module->start = wasm_module_add_entry(module, NULL, NULL);
+	}
+	wasm_module_set_type(module, index, ir->param_types, ir->num_params, ir->return_type);
+	
+	// the body can add functions, so the entry is only looked up again afterwards
+	wasm_code* body = wasm_code_create();
+	wasm_emit_func(module, body, ir, dom);
+	module->func_vec[index].body = body;
+}
+
+heck_func* wasm_module_next_func(wasm_module* module) {
+	while (module->next_func < (int)vector_size(module->func_vec)) {
+		wasm_func_entry* entry = &module->func_vec[module->next_func++];
+		if (entry->func != NULL && entry->body == NULL)
+			return entry->func;
+	}
+	return NULL;
+}
+
+/*
+ *	Binary Format
+ */
+
+static uint8_t wasm_type(heck_ir_type type) {
+	return type == IR_FLOAT ? $f32 : $i32;
+}
+
+// sections start with their size, so their contents are written separately first
+static void wasm_section(wasm_code* code, uint8_t id, wasm_code* contents) {
+	wasm_code_byte(code, id);
+	wasm_code_uleb(code, (uint32_t)wasm_code_size(contents));
+	wasm_code_append(code, contents);
+	wasm_code_free(contents);
+}
+
+wasm_code* wasm_module_build(wasm_module* module) {
+	wasm_code* code = wasm_code_create();
+	$wasm(code, $magic, $version);
+	
+	// every function gets its own type, in the same order
+	uint32_t num_funcs = (uint32_t)vector_size(module->func_vec);
+	wasm_code* types = wasm_code_create();
+	wasm_code_uleb(types, num_funcs);
+	for (uint32_t i = 0; i < num_funcs; ++i) {
+		const wasm_func_entry* entry = &module->func_vec[i];
+		wasm_code_byte(types, $func);
+		wasm_code_uleb(types, entry->num_params);
+		for (int j = 0; j < entry->num_params; ++j)
+			wasm_code_byte(types, wasm_type(entry->param_types[j]));
+		if (entry->return_type == IR_VOID) {
+			wasm_code_uleb(types, 0);
+		} else {
+			wasm_code_uleb(types, 1);
+			wasm_code_byte(types, wasm_type(entry->return_type));
+		}
+	}
+	wasm_section(code, $sec_type, types);
+	
+	wasm_code* funcs = wasm_code_create();
+	wasm_code_uleb(funcs, num_funcs);
+	for (uint32_t i = 0; i < num_funcs; ++i)
+		wasm_code_uleb(funcs, i);
+	wasm_section(code, $sec_func, funcs);
+	
+	// global variables start out as 0 until the global code assigns them
+	uint32_t num_globals = (uint32_t)vector_size(module->global_vec);
+	if (num_globals > 0) {
+		wasm_code* globals = wasm_code_create();
+		wasm_code_uleb(globals, num_globals);
+		for (uint32_t i = 0; i < num_globals; ++i) {
+			wasm_code_byte(globals, wasm_type(module->global_vec[i]));
+			wasm_code_byte(globals, 0x01); // mutable
+			if (module->global_vec[i] == IR_FLOAT) {
+				wasm_code_byte(globals, $f32_const);
+				wasm_code_f32(globals, 0);
+			} else {
+				$wasm(globals, $i32_const, 0x00);
+			}
+			wasm_code_byte(globals, $end);
+		}
+		wasm_section(code, $sec_global, globals);
+	}
+	
+	if (module->start != -1) {
+		wasm_code* start = wasm_code_create();
+		wasm_code_uleb(start, module->start);
+		wasm_section(code, $sec_start, start);
+	}
+	
+	wasm_code* bodies = wasm_code_create();
+	wasm_code_uleb(bodies, num_funcs);
+	for (uint32_t i = 0; i < num_funcs; ++i) {
+		const wasm_code* body = module->func_vec[i].body;
+		wasm_code_uleb(bodies, (uint32_t)wasm_code_size(body));
+		wasm_code_append(bodies, body);
+	}
+	wasm_section(code, $sec_code, bodies);
+	
+	return code;
+}
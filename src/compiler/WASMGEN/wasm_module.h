@@ -0,0 +1,35 @@
+//
+//  wasm_module.h
+//  WASMGEN
+//
+//  Created by agent on 10/19/26.
+//
+//	A wasm module built from IR functions. Functions and global variables get an index the first time
+//	they're referenced, and the functions that were called but not compiled yet are handed out
+//	one at a time, so only the code the global code can reach ends up in the module.
+//
+
+#ifndef wasm_module_h
+#define wasm_module_h
+
+#include <stdbool.h>
+#include "wasm_code.h"
+#include "ir.h"
+#include "ir_dom.h"
+
+typedef struct wasm_module wasm_module;
+
+wasm_module* wasm_module_create(void);
+void wasm_module_free(wasm_module* module);
+
+// emits the body of a lowered function, the global code becomes the start function.
+// the IR isn't needed afterwards
+void wasm_module_add_func(wasm_module* module, const heck_ir_func* ir, const heck_ir_dom* dom);
+
+// a function that was called by the code added so far and hasn't been added yet, NULL if there are none left
+heck_func* wasm_module_next_func(wasm_module* module);
+
+// the binary format of the module, every function that was called has to be added first
+wasm_code* wasm_module_build(wasm_module* module);
+
+#endif /* wasm_module_h */
@@ -0,0 +1,24 @@
+//
+//  wasm_module_impl.h
+//  WASMGEN
+//
+//  Created by agent on 10/19/26.
+//
+
+#ifndef wasm_module_impl_h
+#define wasm_module_impl_h
+
+// the parts of the module that the function body emitter needs, don't include this anywhere else
+
+#include "wasm_module.h"
+
+// the index of a function, which is queued to be compiled the first time it is referenced
+int wasm_module_func_index(wasm_module* module, heck_func* func, str_entry name);
+int wasm_module_global_index(wasm_module* module, heck_name* var, heck_ir_type type);
+// i32 ** i32 doesn't have an instruction, so it calls a function that is only added if it is used
+int wasm_module_pow_index(wasm_module* module);
+
+// writes the locals and instructions of a function's body, without the size that comes before it
+void wasm_emit_func(wasm_module* module, wasm_code* code, const heck_ir_func* ir, const heck_ir_dom* dom);
+
+#endif /* wasm_module_impl_h */
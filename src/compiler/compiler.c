@@ -6,112 +6,51 @@
 //
 
 #include "compiler.h"
-#include "types.h"
-#include "scope.h"
-#include "function.h"
-#include "statement.h"
-#include "code_impl.h"
-#include "wasm_code.h"
 #include <stdio.h>
-/*
-// forward declaration
-heck_data_type* compile_func_call(heck_code* c, heck_expr_call* call);
+#include "code_impl.h"
+#include "ir_program.h"
+#include "pass_manager.h"
+#include "wasm_module.h"
 
-heck_data_type* compile_expr(heck_code* c, heck_expr* expr) {
-	
-	switch (expr->type) {
-		case EXPR_ERR:
-			return create_data_type(TYPE_ERR);
-			break;
-		case EXPR_CALL:
-			return compile_func_call(c, expr->expr);
-			break;
-		case EXPR_VALUE:
-			break;
-		case EXPR_TERNARY: {
-			heck_data_type* type = compile_expr(c, ((heck_expr_ternary*)expr->expr)->value_a);
-			if (type == NULL)
-				return create_data_type(TYPE_ERR);
-			
-			if (data_type_cmp(type, compile_expr(c, ((heck_expr_ternary*)expr->expr)->value_b))) {
-				return type;
-			} else {
-				return create_data_type(TYPE_ERR);
-			}
-			break;
-		}
-		case EXPR_BINARY: {
-			heck_data_type* type = compile_expr(c, ((heck_expr_binary*)expr->expr)->left);
-			if (type == NULL)
-				return create_data_type(TYPE_ERR);
-			
-			if (data_type_cmp(type, compile_expr(c, ((heck_expr_binary*)expr->expr)->right))) {
-				return type;
-			} else {
-				return create_data_type(TYPE_ERR);
-			}
-			break;
-		}
-		case EXPR_UNARY:
-			return create_data_type(TYPE_BOOL);
-			break;
-		case EXPR_LITERAL: {
-			
-			return create_data_type(((heck_literal*)expr->expr)->type);
-			break;
-		}
-		case EXPR_ASG:
-			return compile_expr(c, ((heck_expr_asg*)expr->expr)->value);
-			break;
-		default:
-			return create_data_type(TYPE_ERR);
-			break;
-	}
-	
-	return create_data_type(TYPE_ERR);
+// optimizes a lowered function and adds it to the module
+static void compile_ir(heck_pass_manager* pm, wasm_module* module, heck_ir_func* ir, bool print_ir) {
+	pass_manager_run(pm, ir);
+	if (print_ir)
+		print_ir_func(ir);
+	
+	wasm_module_add_func(module, ir, pass_manager_get(pm, ir, IR_ANALYSIS_DOM));
+	pass_manager_release(ir);
+	ir_func_free(ir);
 }
 
-// gets return type from a function call
-heck_data_type* compile_func_call(heck_code* c, heck_expr_call* call) {
-	// find function in syntax tree
-	heck_scope* s;
-	idf_map_get(c->global->map, call->name.name[0], (void*)&s);
-	if (s && s->type == IDF_FUNCTION) {
-		
-		heck_func* f = s->value;
-		
-		if (f->code->type == BLOCK_MAY_RETURN) {
-			fprintf(stderr, "error: function only returns in some cases\n");
-			return create_data_type(TYPE_ERR);
+bool heck_compile(heck_code* c, const char* output, int opt_level, bool print_ir) {
+	heck_ir_program* program = ir_program_lower(c->global);
+	if (program == NULL)
+		return false;
+	
+	heck_pass_manager* pm = pass_manager_create(opt_level);
+	wasm_module* module = wasm_module_create();
+	
+	// functions are added the first time the code that was added before them calls them,
+	// so the ones whose calls were optimized away are left out
+	compile_ir(pm, module, ir_program_take(program, NULL), print_ir);
+	heck_func* func;
+	while ((func = wasm_module_next_func(module)) != NULL)
+		compile_ir(pm, module, ir_program_take(program, func), print_ir);
+	
+	bool success = true;
+	if (output != NULL) {
+		wasm_code* code = wasm_module_build(module);
+		if (!wasm_code_output(code, output)) {
+			fprintf(stderr, "error: unable to write %s\n", output);
+			success = false;
 		}
-		
-		if (f->code->type != BLOCK_RETURNS) // block doesn't return
-			return create_data_type(TYPE_VOID);
-		
-		// begin traversing child scopes 
-			
-		
+		wasm_code_free(code);
 	}
 	
+	wasm_module_free(module);
+	pass_manager_free(pm);
+	ir_program_free(program);
 	
-	return create_data_type(TYPE_ERR);
-}
-
-bool heck_compile(heck_code* c) {
-	
-	wasm_code* code = wasm_code_create();
-	
-	$wasm(code, $magic, $version);
-	
-	unsigned long num_stmts = vector_size(c->syntax_tree_vec);
-	for (unsigned long i = 0; i < num_stmts; ++i) {
-		if (c->syntax_tree_vec[i]->type == STMT_EXPR) {
-			print_data_type(compile_expr(c, c->syntax_tree_vec[i]->value));
-			printf("\n");
-		}
-		
-	}
-	
-	return true;
+	return success;
 }
-*/
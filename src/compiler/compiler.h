@@ -8,12 +8,13 @@
 #ifndef compiler_h
 #define compiler_h
 
+#include <stdbool.h>
 #include "code.h"
 
-
-// resolves & compiles everything.
-// if the syntax tree ends up being too simple for compiling, resolving can be moved elsewhere
-
-bool heck_compile(heck_code* c);
+// compiles resolved code to a wasm module, starting from the global code, which runs when the module starts.
+// every function the global code can reach is lowered to the IR, then each one is optimized at opt_level (0 to 2)
+// before it is emitted.
+// the module is written to output unless it is NULL, print_ir prints each function's optimized IR
+bool heck_compile(heck_code* c, const char* output, int opt_level, bool print_ir);
 
 #endif /* compiler_h */
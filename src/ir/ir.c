@@ -0,0 +1,429 @@
+//
+//  ir.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "ir.h"
+#include <stdio.h>
+#include "mem.h"
+
+heck_ir_func* ir_func_create(heck_func* func, str_entry name, heck_ir_type return_type, int num_params) {
+	heck_ir_func* ir = mem_alloc(sizeof(heck_ir_func), MEM_IR);
+	ir->func = func;
+	ir->name = name;
+	ir->return_type = return_type;
+	ir->num_params = num_params;
+	ir->block_vec = vector_create();
+	ir->num_block_ids = 0;
+	ir->num_inst_ids = 0;
+	ir->arena = arena_create(MEM_IR);
+	ir->param_types = arena_alloc(ir->arena, num_params * sizeof(heck_ir_type));
+	for (int i = 0; i < IR_MAX_ANALYSES; ++i)
+		ir->analyses[i] = NULL;
+	
+	return ir;
+}
+
+void ir_func_free(heck_ir_func* ir) {
+	int num_blocks = ir_num_blocks(ir);
+	for (int i = 0; i < num_blocks; ++i)
+		vector_free(ir->block_vec[i]->pred_vec);
+	vector_free(ir->block_vec);
+	arena_free(ir->arena);
+	mem_free(ir);
+}
+
+/*
+ *	Uses
+ */
+
+static void use_link(heck_ir_use* use, heck_ir_inst* value) {
+	use->value = value;
+	use->next = value->uses;
+	use->prev = &value->uses;
+	if (value->uses != NULL)
+		value->uses->prev = &use->next;
+	value->uses = use;
+}
+
+// the use keeps its value so it can be linked again
+static void use_unlink(heck_ir_use* use) {
+	*use->prev = use->next;
+	if (use->next != NULL)
+		use->next->prev = use->prev;
+}
+
+void ir_set_operand(heck_ir_inst* inst, int index, heck_ir_inst* value) {
+	heck_ir_use* use = &inst->operands[index];
+	if (use->value != NULL)
+		use_unlink(use);
+	use_link(use, value);
+}
+
+static void ir_drop_operands(heck_ir_inst* inst) {
+	for (int i = 0; i < inst->num_operands; ++i)
+		use_unlink(&inst->operands[i]);
+	inst->num_operands = 0;
+}
+
+static void ir_remove_operand(heck_ir_inst* inst, int index) {
+	// the operands after index move down, so their uses are linked again in their new place
+	for (int i = index; i < inst->num_operands; ++i)
+		use_unlink(&inst->operands[i]);
+	for (int i = index + 1; i < inst->num_operands; ++i)
+		use_link(&inst->operands[i - 1], inst->operands[i].value);
+	--inst->num_operands;
+}
+
+void ir_replace_uses(heck_ir_inst* inst, heck_ir_inst* value) {
+	while (inst->uses != NULL) {
+		heck_ir_use* use = inst->uses;
+		use_unlink(use);
+		use_link(use, value);
+	}
+}
+
+void ir_make_const(heck_ir_inst* inst, heck_literal literal) {
+	ir_drop_operands(inst);
+	inst->op = IR_CONST;
+	inst->value.literal = literal;
+}
+
+bool ir_has_effects(const heck_ir_inst* inst) {
+	switch (inst->op) {
+		case IR_GLOBAL_SET:
+		case IR_CALL:
+			return true;
+		case IR_BINARY: {
+			if (inst->type != IR_INT || (inst->value.operator != TK_OP_DIV && inst->value.operator != TK_OP_MOD))
+				return false;
+			const heck_ir_inst* divisor = inst->operands[1].value;
+			return divisor->op != IR_CONST || divisor->value.literal.value.int_value == 0 ||
+				divisor->value.literal.value.int_value == -1; // INT_MIN / -1 overflows
+		}
+		default:
+			return ir_is_terminator(inst);
+	}
+}
+
+/*
+ *	Instructions
+ */
+
+heck_ir_inst* ir_inst_create(heck_ir_func* ir, heck_ir_op op, heck_ir_type type, int num_operands) {
+	heck_ir_inst* inst = arena_alloc(ir->arena, sizeof(heck_ir_inst));
+	inst->op = op;
+	inst->type = type;
+	inst->id = ir->num_inst_ids++;
+	inst->block = NULL;
+	inst->prev = NULL;
+	inst->next = NULL;
+	inst->uses = NULL;
+	inst->operands = num_operands > 0 ? arena_calloc(ir->arena, num_operands * sizeof(heck_ir_use)) : NULL;
+	inst->num_operands = num_operands;
+	for (int i = 0; i < num_operands; ++i)
+		inst->operands[i].user = inst;
+	
+	return inst;
+}
+
+heck_ir_inst* ir_const_create(heck_ir_func* ir, heck_literal literal) {
+	heck_ir_type type;
+	switch (literal.data_type->type_name) {
+		case TYPE_BOOL:
+			type = IR_BOOL;
+			break;
+		case TYPE_FLOAT:
+			type = IR_FLOAT;
+			break;
+		default:
+			type = IR_INT;
+			break;
+	}
+	
+	heck_ir_inst* inst = ir_inst_create(ir, IR_CONST, type, 0);
+	inst->value.literal = literal;
+	return inst;
+}
+
+void ir_append(heck_ir_block* block, heck_ir_inst* inst) {
+	inst->block = block;
+	inst->prev = block->last;
+	inst->next = NULL;
+	if (block->last != NULL) {
+		block->last->next = inst;
+	} else {
+		block->first = inst;
+	}
+	block->last = inst;
+}
+
+void ir_prepend(heck_ir_block* block, heck_ir_inst* inst) {
+	inst->block = block;
+	inst->prev = NULL;
+	inst->next = block->first;
+	if (block->first != NULL) {
+		block->first->prev = inst;
+	} else {
+		block->last = inst;
+	}
+	block->first = inst;
+}
+
+static void ir_unlink(heck_ir_inst* inst) {
+	heck_ir_block* block = inst->block;
+	if (inst->prev != NULL) {
+		inst->prev->next = inst->next;
+	} else {
+		block->first = inst->next;
+	}
+	if (inst->next != NULL) {
+		inst->next->prev = inst->prev;
+	} else {
+		block->last = inst->prev;
+	}
+	inst->block = NULL;
+}
+
+void ir_inst_remove(heck_ir_inst* inst) {
+	ir_drop_operands(inst);
+	ir_unlink(inst);
+}
+
+/*
+ *	Blocks
+ */
+
+heck_ir_block* ir_block_create(heck_ir_func* ir) {
+	heck_ir_block* block = arena_alloc(ir->arena, sizeof(heck_ir_block));
+	block->id = ir->num_block_ids++;
+	block->first = NULL;
+	block->last = NULL;
+	block->pred_vec = vector_create();
+	block->succ[0] = NULL;
+	block->succ[1] = NULL;
+	vector_add(&ir->block_vec, block);
+	
+	return block;
+}
+
+void ir_block_remove(heck_ir_func* ir, heck_ir_block* block) {
+	for (int i = 0; i < 2; ++i) {
+		heck_ir_block* succ = block->succ[i];
+		if (succ != NULL)
+			ir_remove_pred(succ, ir_pred_index(succ, block));
+	}
+	
+	// instructions in other removed blocks may still use these, the arena keeps them valid until then
+	for (heck_ir_inst* inst = block->first; inst != NULL; inst = inst->next)
+		ir_drop_operands(inst);
+	
+	int num_blocks = ir_num_blocks(ir);
+	for (int i = 0; i < num_blocks; ++i) {
+		if (ir->block_vec[i] == block) {
+			vector_remove(ir->block_vec, i);
+			break;
+		}
+	}
+	vector_free(block->pred_vec);
+}
+
+void ir_add_edge(heck_ir_block* from, heck_ir_block* to) {
+	from->succ[from->succ[0] == NULL ? 0 : 1] = to;
+	vector_add(&to->pred_vec, from);
+}
+
+int ir_pred_index(const heck_ir_block* block, const heck_ir_block* pred) {
+	int num_preds = (int)vector_size(block->pred_vec);
+	for (int i = 0; i < num_preds; ++i) {
+		if (block->pred_vec[i] == pred)
+			return i;
+	}
+	return -1;
+}
+
+void ir_remove_pred(heck_ir_block* block, int index) {
+	vector_remove(block->pred_vec, index);
+	for (heck_ir_inst* inst = block->first; inst != NULL && inst->op == IR_PHI; inst = inst->next)
+		ir_remove_operand(inst, index);
+}
+
+void ir_make_jump(heck_ir_block* block, int taken) {
+	heck_ir_block* other = block->succ[!taken];
+	ir_remove_pred(other, ir_pred_index(other, block));
+	
+	ir_drop_operands(block->last);
+	block->last->op = IR_JUMP;
+	block->succ[0] = block->succ[taken];
+	block->succ[1] = NULL;
+}
+
+void ir_merge_blocks(heck_ir_func* ir, heck_ir_block* block, heck_ir_block* succ) {
+	// with one predecessor, each phi only has one value
+	while (succ->first != NULL && succ->first->op == IR_PHI) {
+		heck_ir_inst* phi = succ->first;
+		ir_replace_uses(phi, phi->operands[0].value);
+		ir_inst_remove(phi);
+	}
+	
+	ir_inst_remove(block->last);
+	while (succ->first != NULL) {
+		heck_ir_inst* inst = succ->first;
+		ir_unlink(inst);
+		ir_append(block, inst);
+	}
+	
+	block->succ[0] = succ->succ[0];
+	block->succ[1] = succ->succ[1];
+	for (int i = 0; i < 2; ++i) {
+		heck_ir_block* next = block->succ[i];
+		if (next != NULL)
+			next->pred_vec[ir_pred_index(next, succ)] = block;
+	}
+	
+	succ->first = NULL;
+	succ->last = NULL;
+	succ->succ[0] = NULL;
+	succ->succ[1] = NULL;
+	ir_block_remove(ir, succ);
+}
+
+/*
+ *	Printing
+ */
+
+static const char* ir_type_name(heck_ir_type type) {
+	switch (type) {
+		case IR_BOOL:	return "bool";
+		case IR_INT:	return "int";
+		case IR_FLOAT:	return "float";
+		default:		return "void";
+	}
+}
+
+static const char* ir_operator_name(heck_tk_type operator) {
+	switch (operator) {
+		case TK_OP_EXP:		return "pow";
+		case TK_OP_MULT:	return "mul";
+		case TK_OP_DIV:		return "div";
+		case TK_OP_MOD:		return "mod";
+		case TK_OP_ADD:		return "add";
+		case TK_OP_SUB:		return "sub";
+		case TK_OP_SHFT_L:	return "shl";
+		case TK_OP_SHFT_R:	return "shr";
+		case TK_OP_BW_AND:	return "and";
+		case TK_OP_BW_XOR:	return "xor";
+		case TK_OP_BW_OR:	return "or";
+		case TK_OP_LESS:	return "lt";
+		case TK_OP_LESS_EQ:	return "le";
+		case TK_OP_GTR:		return "gt";
+		case TK_OP_GTR_EQ:	return "ge";
+		case TK_OP_EQ:		return "eq";
+		case TK_OP_N_EQ:	return "ne";
+		default:			return "?";
+	}
+}
+
+static void print_ir_operands(const heck_ir_inst* inst) {
+	for (int i = 0; i < inst->num_operands; ++i)
+		printf("%s%%%i", i == 0 ? " " : ", ", inst->operands[i].value->id);
+}
+
+static void print_ir_inst(const heck_ir_inst* inst) {
+	printf("\t");
+	if (inst->type != IR_VOID)
+		printf("%%%i = ", inst->id);
+	
+	switch (inst->op) {
+		case IR_CONST:
+			printf("const ");
+			print_literal(&inst->value.literal);
+			break;
+		case IR_PARAM:
+			printf("param %s %i", ir_type_name(inst->type), inst->value.index);
+			break;
+		case IR_PHI:
+			printf("phi %s", ir_type_name(inst->type));
+			print_ir_operands(inst);
+			break;
+		case IR_GLOBAL_GET:
+			printf("get %s [%s]", ir_type_name(inst->type), inst->value.global.name->value);
+			break;
+		case IR_GLOBAL_SET:
+			printf("set [%s]", inst->value.global.name->value);
+			print_ir_operands(inst);
+			break;
+		case IR_CALL:
+			printf("call %s [%s]", ir_type_name(inst->type), inst->value.call.name->value);
+			if (inst->value.call.memory == IR_MEMORY_NONE)
+				printf(" pure");
+			else if (inst->value.call.memory == IR_MEMORY_READ)
+				printf(" reads");
+			print_ir_operands(inst);
+			break;
+		case IR_BINARY:
+			printf("%s %s", ir_operator_name(inst->value.operator), ir_type_name(inst->operands[0].value->type));
+			print_ir_operands(inst);
+			break;
+		case IR_NEG:
+			printf("neg %s", ir_type_name(inst->type));
+			print_ir_operands(inst);
+			break;
+		case IR_BW_NOT:
+			printf("not %s", ir_type_name(inst->type));
+			print_ir_operands(inst);
+			break;
+		case IR_NOT:
+			printf("not bool");
+			print_ir_operands(inst);
+			break;
+		case IR_TO_FLOAT:
+			printf("float");
+			print_ir_operands(inst);
+			break;
+		case IR_JUMP:
+			printf("jump block %i", inst->block->succ[0]->id);
+			break;
+		case IR_BRANCH:
+			printf("branch");
+			print_ir_operands(inst);
+			printf(", block %i, block %i", inst->block->succ[0]->id, inst->block->succ[1]->id);
+			break;
+		case IR_RETURN:
+			printf("return");
+			print_ir_operands(inst);
+			break;
+	}
+	printf("\n");
+}
+
+void print_ir_func(const heck_ir_func* ir) {
+	if (ir->name != NULL) {
+		printf("func %s(", ir->name->value);
+		for (int i = 0; i < ir->num_params; ++i)
+			printf("%s%s", i == 0 ? "" : ", ", ir_type_name(ir->param_types[i]));
+		printf(") -> %s\n", ir_type_name(ir->return_type));
+	} else {
+		printf("global code\n");
+	}
+	
+	int num_blocks = ir_num_blocks(ir);
+	for (int i = 0; i < num_blocks; ++i) {
+		const heck_ir_block* block = ir->block_vec[i];
+		printf("block %i", block->id);
+		
+		int num_preds = (int)vector_size(block->pred_vec);
+		if (num_preds > 0) {
+			printf(" (preds");
+			for (int j = 0; j < num_preds; ++j)
+				printf(" %i", block->pred_vec[j]->id);
+			printf(")");
+		}
+		printf(":\n");
+		
+		for (const heck_ir_inst* inst = block->first; inst != NULL; inst = inst->next)
+			print_ir_inst(inst);
+	}
+}
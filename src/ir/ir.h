@@ -0,0 +1,178 @@
+//
+//  ir.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	The mid-level IR that code is lowered to after it is resolved. Each function is a graph of basic
+//	blocks holding typed instructions in SSA form: every instruction defines at most one value, and
+//	values that depend on the path taken meet in phis. Every value keeps a list of its uses, so
+//	passes can replace it without searching the function. Everything is allocated in the function's
+//	arena, except the predecessor vectors, and it is freed with the function.
+//
+
+#ifndef ir_h
+#define ir_h
+
+#include <stdbool.h>
+#include "literal.h"
+#include "token.h"
+#include "str.h"
+#include "vec.h"
+#include "declarations.h"
+#include "arena.h"
+
+// the pass manager caches at most this many analyses in each function
+#define IR_MAX_ANALYSES 4
+
+typedef enum heck_ir_type {
+	IR_VOID, // the instruction doesn't produce a value
+	IR_BOOL,
+	IR_INT,
+	IR_FLOAT,
+} heck_ir_type;
+
+// what a call can do to global variables
+typedef enum heck_ir_memory {
+	IR_MEMORY_NONE,
+	IR_MEMORY_READ,
+	IR_MEMORY_WRITE,
+} heck_ir_memory;
+
+typedef enum heck_ir_op {
+	IR_CONST,		// value.literal
+	IR_PARAM,		// value.index is the parameter's position
+	IR_PHI,			// one operand for each predecessor of the block, in the same order
+	IR_GLOBAL_GET,	// value.global
+	IR_GLOBAL_SET,	// operand 0 is stored in value.global
+	IR_CALL,		// value.call is called with the operands as arguments
+	IR_BINARY,		// value.operator on operands 0 and 1, which have the same type
+	IR_NEG,
+	IR_BW_NOT,
+	IR_NOT,			// the operand is a bool
+	IR_TO_FLOAT,	// the operand is an int
+	
+	// every block ends with exactly one of these
+	IR_JUMP,		// goes to succ[0]
+	IR_BRANCH,		// goes to succ[0] if operand 0 is true, otherwise to succ[1]
+	IR_RETURN,		// operand 0 is returned if the function returns a value
+} heck_ir_op;
+
+typedef struct heck_ir_inst heck_ir_inst;
+typedef struct heck_ir_block heck_ir_block;
+
+// an operand of user, which is linked into the use list of value
+typedef struct heck_ir_use {
+	heck_ir_inst* value;
+	heck_ir_inst* user;
+	struct heck_ir_use* next;
+	struct heck_ir_use** prev; // the pointer to this use, either in value->uses or in the previous use
+} heck_ir_use;
+
+struct heck_ir_inst {
+	heck_ir_op op;
+	heck_ir_type type;
+	int id; // unique in the function, ids aren't reused
+	
+	heck_ir_block* block; // NULL once the instruction is removed
+	heck_ir_inst* prev;
+	heck_ir_inst* next;
+	
+	heck_ir_use* uses; // the instructions that use this one
+	heck_ir_use* operands;
+	int num_operands;
+	
+	union {
+		heck_literal literal;
+		int index;
+		heck_tk_type operator;
+		
+		// the names are only kept for printing
+		struct {
+			heck_name* var;
+			str_entry name;
+		} global;
+		struct {
+			heck_func* func;
+			str_entry name;
+			heck_ir_memory memory; // IR_MEMORY_WRITE until ir_program_lower looks at the callee
+		} call;
+	} value;
+};
+
+struct heck_ir_block {
+	int id; // unique in the function, ids aren't reused
+	heck_ir_inst* first; // phis come first
+	heck_ir_inst* last; // the terminator, once the block is finished
+	heck_ir_block** pred_vec;
+	heck_ir_block* succ[2]; // NULL if unused
+};
+
+typedef struct heck_ir_func {
+	heck_func* func; // NULL for the global code
+	str_entry name; // NULL for the global code
+	heck_ir_type return_type;
+	heck_ir_type* param_types;
+	int num_params;
+	
+	heck_ir_block** block_vec; // the entry block comes first
+	int num_block_ids;
+	int num_inst_ids;
+	
+	heck_arena* arena;
+	void* analyses[IR_MAX_ANALYSES]; // owned by the pass manager
+} heck_ir_func;
+
+// func and name are NULL for the global code, which takes no parameters and returns nothing
+heck_ir_func* ir_func_create(heck_func* func, str_entry name, heck_ir_type return_type, int num_params);
+// the pass manager's analyses have to be freed first
+void ir_func_free(heck_ir_func* ir);
+
+heck_ir_block* ir_block_create(heck_ir_func* ir);
+// the block must not be used anymore, its instructions are removed and it is taken out of its successors' preds.
+// when several blocks are removed together, the edges between them have to be cleared first
+void ir_block_remove(heck_ir_func* ir, heck_ir_block* block);
+
+// adds an edge from the end of from to the start of to, phis in to must not exist yet
+void ir_add_edge(heck_ir_block* from, heck_ir_block* to);
+int ir_pred_index(const heck_ir_block* block, const heck_ir_block* pred);
+// removes an incoming edge and the phi operands that come with it
+void ir_remove_pred(heck_ir_block* block, int index);
+// turns the branch at the end of a block into a jump to succ[taken], the other edge is removed
+void ir_make_jump(heck_ir_block* block, int taken);
+
+// moves the code of succ to the end of block, which has to end with a jump to succ, its only predecessor.
+// succ is removed afterwards
+void ir_merge_blocks(heck_ir_func* ir, heck_ir_block* block, heck_ir_block* succ);
+
+// the operands have to be set before the instruction is used
+heck_ir_inst* ir_inst_create(heck_ir_func* ir, heck_ir_op op, heck_ir_type type, int num_operands);
+heck_ir_inst* ir_const_create(heck_ir_func* ir, heck_literal literal);
+void ir_set_operand(heck_ir_inst* inst, int index, heck_ir_inst* value);
+
+void ir_append(heck_ir_block* block, heck_ir_inst* inst);
+// phis are prepended so they stay before the rest of the block
+void ir_prepend(heck_ir_block* block, heck_ir_inst* inst);
+// removes the instruction from its block and from the use lists of its operands, it must have no uses left
+void ir_inst_remove(heck_ir_inst* inst);
+
+// makes every use of inst use value instead
+void ir_replace_uses(heck_ir_inst* inst, heck_ir_inst* value);
+// turns an instruction into a constant in place, so its uses don't have to change
+void ir_make_const(heck_ir_inst* inst, heck_literal literal);
+
+static inline bool ir_is_terminator(const heck_ir_inst* inst) {
+	return inst->op >= IR_JUMP;
+}
+
+// true if removing the instruction could change what the program does, even if nothing uses its value.
+// integer division traps when it divides by zero, so it counts unless the divisor is known
+bool ir_has_effects(const heck_ir_inst* inst);
+
+static inline int ir_num_blocks(const heck_ir_func* ir) {
+	return (int)vector_size(ir->block_vec);
+}
+
+void print_ir_func(const heck_ir_func* ir);
+
+#endif /* ir_h */
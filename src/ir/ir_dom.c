@@ -0,0 +1,62 @@
+//
+//  ir_dom.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "ir_dom.h"
+#include "mem.h"
+
+// the solver walks block ids, so blocks are looked up by id
+static int dom_succ(const void* graph, int node, int i) {
+	heck_ir_block* const* blocks = graph;
+	return i < 2 && blocks[node]->succ[i] != NULL ? blocks[node]->succ[i]->id : -1;
+}
+
+static int dom_pred(const void* graph, int node, int i) {
+	heck_ir_block* const* blocks = graph;
+	return i < (int)vector_size(blocks[node]->pred_vec) ? blocks[node]->pred_vec[i]->id : -1;
+}
+
+heck_ir_dom* ir_dom_compute(heck_ir_func* ir) {
+	int num_ids = ir->num_block_ids;
+	heck_ir_dom* dom = mem_alloc(sizeof(heck_ir_dom), MEM_IR);
+	
+	// ids of removed blocks stay NULL, nothing points to them anymore
+	heck_ir_block** blocks = mem_calloc(num_ids, sizeof(heck_ir_block*), MEM_IR);
+	int num_blocks = ir_num_blocks(ir);
+	for (int i = 0; i < num_blocks; ++i)
+		blocks[ir->block_vec[i]->id] = ir->block_vec[i];
+	
+	heck_dom_graph graph = {
+		.graph = blocks,
+		.num_nodes = num_ids,
+		.entry = ir->block_vec[0]->id,
+		.tag = MEM_IR,
+		.succ = dom_succ,
+		.pred = dom_pred,
+	};
+	dom_solve(&graph, &dom->tree);
+	
+	int num_reachable = (int)vector_size(dom->tree.rpo_vec);
+	dom->rpo_vec = vector_create();
+	vector_reserve(&dom->rpo_vec, num_reachable);
+	for (int i = 0; i < num_reachable; ++i)
+		vector_add(&dom->rpo_vec, blocks[dom->tree.rpo_vec[i]]);
+	
+	// every reachable block but the entry is somebody's child
+	dom->children = mem_alloc((num_reachable > 1 ? num_reachable - 1 : 1) * sizeof(heck_ir_block*), MEM_IR);
+	for (int i = 0; i < num_reachable - 1; ++i)
+		dom->children[i] = blocks[dom->tree.children[i]];
+	
+	mem_free(blocks);
+	return dom;
+}
+
+void ir_dom_free(heck_ir_dom* dom) {
+	dom_tree_free(&dom->tree);
+	vector_free(dom->rpo_vec);
+	mem_free(dom->children);
+	mem_free(dom);
+}
@@ -0,0 +1,35 @@
+//
+//  ir_dom.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	The reverse postorder and dominator tree of an IR function. The pass manager caches them,
+//	and passes that change the edges between blocks have to say they don't preserve them.
+//
+
+#ifndef ir_dom_h
+#define ir_dom_h
+
+#include "ir.h"
+#include "dom.h"
+
+typedef struct heck_ir_dom {
+	heck_dom_tree tree; // the nodes are block ids
+	heck_ir_block** rpo_vec; // the reachable blocks in reverse postorder, starting with the entry block
+	heck_ir_block** children; // the blocks in tree.children
+} heck_ir_dom;
+
+heck_ir_dom* ir_dom_compute(heck_ir_func* ir);
+void ir_dom_free(heck_ir_dom* dom);
+
+static inline bool ir_reachable(const heck_ir_dom* dom, const heck_ir_block* block) {
+	return dom->tree.rpo[block->id] >= 0;
+}
+
+// true if every path from the entry to b goes through a, a block dominates itself
+static inline bool ir_dominates(const heck_ir_dom* dom, const heck_ir_block* a, const heck_ir_block* b) {
+	return dom_dominates(&dom->tree, a->id, b->id);
+}
+
+#endif /* ir_dom_h */
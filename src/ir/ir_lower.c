@@ -0,0 +1,682 @@
+//
+//  ir_lower.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "ir_lower.h"
+#include <stdio.h>
+#include "function.h"
+#include "scope.h"
+#include "mem.h"
+
+typedef struct lower_ctx {
+	heck_ir_func* ir;
+	heck_ir_block* block; // where instructions are added, NULL after a return until the code can be reached again
+	heck_ir_inst*** def_vec; // for each block, the value each local has at the end of it, NULL until it is known
+	int num_slots;
+	bool failed;
+} lower_ctx;
+
+static heck_ir_inst* lower_fail(lower_ctx* ctx, const char* what) {
+	if (!ctx->failed)
+		fprintf(stderr, "error: unable to compile %s yet\n", what);
+	ctx->failed = true;
+	return NULL;
+}
+
+// -1 if the IR can't represent the type
+static int lower_type(const heck_data_type* type) {
+	if (type == NULL)
+		return -1;
+	
+	switch (data_type_find(type)->type_name) {
+		case TYPE_INT:
+			return IR_INT;
+		case TYPE_FLOAT:
+			return IR_FLOAT;
+		case TYPE_BOOL:
+			return IR_BOOL;
+		case TYPE_VOID:
+			return IR_VOID;
+		default:
+			return -1;
+	}
+}
+
+static heck_literal lower_zero(heck_ir_type type) {
+	switch (type) {
+		case IR_FLOAT:
+			return create_literal_float(0);
+		case IR_BOOL:
+			return create_literal_bool(false);
+		default:
+			return create_literal_int(0);
+	}
+}
+
+static heck_ir_block* lower_block_create(lower_ctx* ctx) {
+	heck_ir_block* block = ir_block_create(ctx->ir);
+	heck_ir_inst** defs = ctx->num_slots > 0 ? arena_calloc(ctx->ir->arena, ctx->num_slots * sizeof(heck_ir_inst*)) : NULL;
+	vector_add(&ctx->def_vec, defs);
+	
+	return block;
+}
+
+static heck_ir_inst* lower_add(lower_ctx* ctx, heck_ir_op op, heck_ir_type type, int num_operands) {
+	heck_ir_inst* inst = ir_inst_create(ctx->ir, op, type, num_operands);
+	ir_append(ctx->block, inst);
+	return inst;
+}
+
+static heck_ir_inst* lower_const(lower_ctx* ctx, heck_literal literal) {
+	heck_ir_inst* inst = ir_const_create(ctx->ir, literal);
+	ir_append(ctx->block, inst);
+	return inst;
+}
+
+static void lower_jump(lower_ctx* ctx, heck_ir_block* target) {
+	lower_add(ctx, IR_JUMP, IR_VOID, 0);
+	ir_add_edge(ctx->block, target);
+}
+
+// ints are the only values that are converted implicitly
+static heck_ir_inst* lower_convert(lower_ctx* ctx, heck_ir_inst* value, heck_ir_type type) {
+	if (value->type != IR_INT || type != IR_FLOAT)
+		return value;
+	
+	heck_ir_inst* inst = lower_add(ctx, IR_TO_FLOAT, IR_FLOAT, 1);
+	ir_set_operand(inst, 0, value);
+	return inst;
+}
+
+static heck_ir_inst* lower_truthy(lower_ctx* ctx, heck_ir_inst* value) {
+	if (value->type == IR_BOOL)
+		return value;
+	
+	heck_ir_inst* zero = lower_const(ctx, lower_zero(value->type));
+	heck_ir_inst* inst = lower_add(ctx, IR_BINARY, IR_BOOL, 2);
+	inst->value.operator = TK_OP_N_EQ;
+	ir_set_operand(inst, 0, value);
+	ir_set_operand(inst, 1, zero);
+	return inst;
+}
+
+// the operands are converted to type first
+static heck_ir_inst* lower_op(lower_ctx* ctx, heck_tk_type operator, heck_ir_inst* a, heck_ir_inst* b, heck_ir_type type, heck_ir_type result) {
+	a = lower_convert(ctx, a, type);
+	b = lower_convert(ctx, b, type);
+	
+	heck_ir_inst* inst = lower_add(ctx, IR_BINARY, result, 2);
+	inst->value.operator = operator;
+	ir_set_operand(inst, 0, a);
+	ir_set_operand(inst, 1, b);
+	return inst;
+}
+
+/*
+ *	Variables
+ */
+
+// the value a local has at the end of a block. the block's predecessors are always finished,
+// so a phi gets all of its operands when it is created, and it isn't created if they're all the same
+static heck_ir_inst* lower_read(lower_ctx* ctx, heck_ir_block* block, int slot, heck_ir_type type) {
+	heck_ir_inst* def = ctx->def_vec[block->id][slot];
+	if (def != NULL)
+		return def;
+	
+	int num_preds = (int)vector_size(block->pred_vec);
+	if (num_preds == 0) {
+		// locals are always assigned before they are read, but there has to be a value anyway
+		def = ir_const_create(ctx->ir, lower_zero(type));
+		ir_prepend(block, def);
+	} else if (num_preds == 1) {
+		def = lower_read(ctx, block->pred_vec[0], slot, type);
+	} else {
+		def = lower_read(ctx, block->pred_vec[0], slot, type);
+		bool same = true;
+		for (int i = 1; i < num_preds && same; ++i)
+			same = lower_read(ctx, block->pred_vec[i], slot, type) == def;
+		
+		if (!same) {
+			// the predecessors' values were just read, so reading them again doesn't search anything
+			heck_ir_inst* phi = ir_inst_create(ctx->ir, IR_PHI, type, num_preds);
+			for (int i = 0; i < num_preds; ++i)
+				ir_set_operand(phi, i, lower_read(ctx, block->pred_vec[i], slot, type));
+			ir_prepend(block, phi);
+			def = phi;
+		}
+	}
+	
+	ctx->def_vec[block->id][slot] = def;
+	return def;
+}
+
+// a local in the function's frame, or a variable outside of every function
+typedef struct lower_var {
+	int slot; // -1 for global variables
+	heck_name* global;
+	str_entry name;
+} lower_var;
+
+static bool lower_find_var(lower_ctx* ctx, const heck_expr_value* value, lower_var* var) {
+	heck_name* name = value->resolved;
+	if (name == NULL || name->type != IDF_VARIABLE || value->context == CONTEXT_THIS) {
+		lower_fail(ctx, "member variables");
+		return false;
+	}
+	
+	if (value->slot >= 0) {
+		if (value->depth > 0) {
+			lower_fail(ctx, "variables from enclosing functions");
+			return false;
+		}
+		var->slot = value->slot;
+		return true;
+	}
+	
+	if (name->parent->func != NULL || scope_is_class(name->parent)) {
+		lower_fail(ctx, "member variables");
+		return false;
+	}
+	
+	int last = 0;
+	while (value->name[last + 1] != NULL)
+		++last;
+	
+	var->slot = -1;
+	var->global = name;
+	var->name = value->name[last];
+	return true;
+}
+
+static heck_ir_inst* lower_get(lower_ctx* ctx, const lower_var* var, heck_ir_type type) {
+	if (var->slot >= 0)
+		return lower_read(ctx, ctx->block, var->slot, type);
+	
+	heck_ir_inst* inst = lower_add(ctx, IR_GLOBAL_GET, type, 0);
+	inst->value.global.var = var->global;
+	inst->value.global.name = var->name;
+	return inst;
+}
+
+static void lower_set(lower_ctx* ctx, const lower_var* var, heck_ir_inst* value) {
+	if (var->slot >= 0) {
+		ctx->def_vec[ctx->block->id][var->slot] = value;
+		return;
+	}
+	
+	heck_ir_inst* inst = lower_add(ctx, IR_GLOBAL_SET, IR_VOID, 1);
+	inst->value.global.var = var->global;
+	inst->value.global.name = var->name;
+	ir_set_operand(inst, 0, value);
+}
+
+/*
+ *	Expressions
+ */
+
+static heck_ir_inst* lower_expr(lower_ctx* ctx, heck_expr* expr);
+
+// && and || only evaluate the right side if the left side doesn't decide the result,
+// and when it does the left side is the result
+static heck_ir_inst* lower_logical(lower_ctx* ctx, heck_expr_binary* binary) {
+	heck_ir_inst* left = lower_expr(ctx, binary->left);
+	if (left == NULL)
+		return NULL;
+	left = lower_truthy(ctx, left);
+	
+	heck_ir_block* right_block = lower_block_create(ctx);
+	heck_ir_block* join = lower_block_create(ctx);
+	
+	heck_ir_inst* branch = lower_add(ctx, IR_BRANCH, IR_VOID, 1);
+	ir_set_operand(branch, 0, left);
+	if (binary->operator == TK_OP_AND) {
+		ir_add_edge(ctx->block, right_block);
+		ir_add_edge(ctx->block, join);
+	} else {
+		ir_add_edge(ctx->block, join);
+		ir_add_edge(ctx->block, right_block);
+	}
+	
+	ctx->block = right_block;
+	heck_ir_inst* right = lower_expr(ctx, binary->right);
+	if (right == NULL)
+		return NULL;
+	right = lower_truthy(ctx, right);
+	lower_jump(ctx, join);
+	
+	// the left side's block was the first predecessor
+	ctx->block = join;
+	heck_ir_inst* phi = ir_inst_create(ctx->ir, IR_PHI, IR_BOOL, 2);
+	ir_set_operand(phi, 0, left);
+	ir_set_operand(phi, 1, right);
+	ir_prepend(join, phi);
+	return phi;
+}
+
+// only the value that the condition picks is evaluated
+static heck_ir_inst* lower_ternary(lower_ctx* ctx, heck_expr* expr) {
+	heck_expr_ternary* ternary = &expr->value.ternary;
+	int type = lower_type(expr->data_type);
+	if (type == -1 || type == IR_VOID)
+		return lower_fail(ctx, "values of this type");
+	
+	heck_ir_inst* condition = lower_expr(ctx, ternary->condition);
+	if (condition == NULL)
+		return NULL;
+	condition = lower_truthy(ctx, condition);
+	
+	heck_ir_block* block_a = lower_block_create(ctx);
+	heck_ir_block* block_b = lower_block_create(ctx);
+	heck_ir_block* join = lower_block_create(ctx);
+	
+	heck_ir_inst* branch = lower_add(ctx, IR_BRANCH, IR_VOID, 1);
+	ir_set_operand(branch, 0, condition);
+	ir_add_edge(ctx->block, block_a);
+	ir_add_edge(ctx->block, block_b);
+	
+	ctx->block = block_a;
+	heck_ir_inst* value_a = lower_expr(ctx, ternary->value_a);
+	if (value_a == NULL)
+		return NULL;
+	value_a = lower_convert(ctx, value_a, type);
+	lower_jump(ctx, join);
+	
+	ctx->block = block_b;
+	heck_ir_inst* value_b = lower_expr(ctx, ternary->value_b);
+	if (value_b == NULL)
+		return NULL;
+	value_b = lower_convert(ctx, value_b, type);
+	lower_jump(ctx, join);
+	
+	// the first value's block was the first predecessor
+	ctx->block = join;
+	heck_ir_inst* phi = ir_inst_create(ctx->ir, IR_PHI, type, 2);
+	ir_set_operand(phi, 0, value_a);
+	ir_set_operand(phi, 1, value_b);
+	ir_prepend(join, phi);
+	return phi;
+}
+
+static heck_ir_inst* lower_binary(lower_ctx* ctx, heck_expr* expr) {
+	heck_expr_binary* binary = &expr->value.binary;
+	if (binary->operator == TK_OP_AND || binary->operator == TK_OP_OR)
+		return lower_logical(ctx, binary);
+	
+	heck_ir_inst* left = lower_expr(ctx, binary->left);
+	heck_ir_inst* right = left != NULL ? lower_expr(ctx, binary->right) : NULL;
+	if (right == NULL)
+		return NULL;
+	
+	// comparisons convert an int to a float if the other side is a float
+	heck_ir_type numeric = left->type == IR_FLOAT || right->type == IR_FLOAT ? IR_FLOAT : left->type;
+	switch (binary->operator) {
+		case TK_OP_XOR:
+			left = lower_truthy(ctx, left);
+			right = lower_truthy(ctx, right);
+			return lower_op(ctx, TK_OP_N_EQ, left, right, IR_BOOL, IR_BOOL);
+		case TK_OP_EQ:
+		case TK_OP_N_EQ:
+		case TK_OP_LESS:
+		case TK_OP_LESS_EQ:
+		case TK_OP_GTR:
+		case TK_OP_GTR_EQ:
+			return lower_op(ctx, binary->operator, left, right, numeric, IR_BOOL);
+		default: {
+			int type = lower_type(expr->data_type);
+			if (type != IR_INT && type != IR_FLOAT)
+				return lower_fail(ctx, "this operator");
+			if (binary->operator == TK_OP_EXP && type == IR_FLOAT)
+				return lower_fail(ctx, "float exponents");
+			return lower_op(ctx, binary->operator, left, right, type, type);
+		}
+	}
+}
+
+static heck_tk_type lower_asg_operator(heck_tk_type operator) {
+	switch (operator) {
+		case TK_OP_MULT_ASG:	return TK_OP_MULT;
+		case TK_OP_DIV_ASG:		return TK_OP_DIV;
+		case TK_OP_MOD_ASG:		return TK_OP_MOD;
+		case TK_OP_ADD_ASG:		return TK_OP_ADD;
+		case TK_OP_SUB_ASG:		return TK_OP_SUB;
+		case TK_OP_BW_AND_ASG:	return TK_OP_BW_AND;
+		case TK_OP_BW_OR_ASG:	return TK_OP_BW_OR;
+		case TK_OP_BW_XOR_ASG:	return TK_OP_BW_XOR;
+		case TK_OP_SHFT_L_ASG:	return TK_OP_SHFT_L;
+		case TK_OP_SHFT_R_ASG:	return TK_OP_SHFT_R;
+		default:				return operator;
+	}
+}
+
+static heck_ir_inst* lower_asg(lower_ctx* ctx, heck_expr* expr) {
+	heck_expr_binary* asg = &expr->value.binary;
+	int type = lower_type(expr->data_type);
+	if (type == -1 || type == IR_VOID)
+		return lower_fail(ctx, "assignments of this type");
+	
+	lower_var var;
+	if (!lower_find_var(ctx, &asg->left->value.value, &var))
+		return NULL;
+	
+	heck_ir_inst* value = lower_expr(ctx, asg->right);
+	if (value == NULL)
+		return NULL;
+	
+	if (asg->operator != TK_OP_ASG) {
+		heck_tk_type operator = lower_asg_operator(asg->operator);
+		if (operator == asg->operator || (operator == TK_OP_EXP && type == IR_FLOAT))
+			return lower_fail(ctx, "this operator");
+		
+		heck_ir_inst* current = lower_get(ctx, &var, type);
+		value = lower_op(ctx, operator, current, value, type, type);
+	}
+	
+	value = lower_convert(ctx, value, type);
+	lower_set(ctx, &var, value);
+	return value;
+}
+
+static heck_ir_inst* lower_step(lower_ctx* ctx, heck_expr* expr) {
+	int type = lower_type(expr->data_type);
+	if (type != IR_INT && type != IR_FLOAT)
+		return lower_fail(ctx, "this operator");
+	
+	lower_var var;
+	if (!lower_find_var(ctx, &expr->value.unary.expr->value.value, &var))
+		return NULL;
+	
+	heck_ir_inst* current = lower_get(ctx, &var, type);
+	heck_ir_inst* one = lower_const(ctx, type == IR_INT ? create_literal_int(1) : create_literal_float(1));
+	bool incr = expr->vtable == &expr_vtable_pre_incr || expr->vtable == &expr_vtable_post_incr;
+	heck_ir_inst* value = lower_op(ctx, incr ? TK_OP_ADD : TK_OP_SUB, current, one, type, type);
+	lower_set(ctx, &var, value);
+	
+	bool pre = expr->vtable == &expr_vtable_pre_incr || expr->vtable == &expr_vtable_pre_decr;
+	return pre ? value : current;
+}
+
+static heck_ir_inst* lower_unary(lower_ctx* ctx, heck_expr* expr) {
+	heck_expr_unary* unary = &expr->value.unary;
+	if (unary->operator == TK_OP_INCR || unary->operator == TK_OP_DECR)
+		return lower_step(ctx, expr);
+	
+	heck_ir_inst* operand = lower_expr(ctx, unary->expr);
+	if (operand == NULL)
+		return NULL;
+	
+	heck_ir_inst* inst;
+	switch (unary->operator) {
+		case TK_OP_NOT:
+			operand = lower_truthy(ctx, operand);
+			inst = lower_add(ctx, IR_NOT, IR_BOOL, 1);
+			break;
+		case TK_OP_SUB:
+			if (operand->type != IR_INT && operand->type != IR_FLOAT)
+				return lower_fail(ctx, "this operator");
+			inst = lower_add(ctx, IR_NEG, operand->type, 1);
+			break;
+		case TK_OP_BW_NOT:
+			if (operand->type != IR_INT)
+				return lower_fail(ctx, "this operator");
+			inst = lower_add(ctx, IR_BW_NOT, IR_INT, 1);
+			break;
+		default:
+			return lower_fail(ctx, "this operator");
+	}
+	
+	ir_set_operand(inst, 0, operand);
+	return inst;
+}
+
+static heck_ir_inst* lower_call(lower_ctx* ctx, heck_expr* expr) {
+	heck_expr_call* call = &expr->value.call;
+	heck_func* callee = call->func;
+	if (callee == NULL || callee->code == NULL || call->operand->type != EXPR_VALUE)
+		return lower_fail(ctx, "this call");
+	
+	// methods need an object and nested functions need their parent's frame
+	heck_scope* scope = callee->code->scope;
+	if (scope->class != NULL)
+		return lower_fail(ctx, "method calls");
+	if (scope->parent->func != NULL)
+		return lower_fail(ctx, "calls to nested functions");
+	
+	int type = lower_type(callee->return_type);
+	if (type == -1)
+		return lower_fail(ctx, "functions that return this type");
+	
+	int num_args = (int)vector_size(call->arg_vec);
+	heck_ir_inst** args = arena_alloc(ctx->ir->arena, num_args * sizeof(heck_ir_inst*));
+	for (int i = 0; i < num_args; ++i) {
+		int param_type = lower_type(callee->param_vec[i]->type);
+		if (param_type == -1 || param_type == IR_VOID)
+			return lower_fail(ctx, "parameters of this type");
+		
+		args[i] = lower_expr(ctx, call->arg_vec[i]);
+		if (args[i] == NULL)
+			return NULL;
+		args[i] = lower_convert(ctx, args[i], param_type);
+	}
+	
+	heck_idf name = call->operand->value.value.name;
+	int last = 0;
+	while (name[last + 1] != NULL)
+		++last;
+	
+	heck_ir_inst* inst = lower_add(ctx, IR_CALL, type, num_args);
+	inst->value.call.func = callee;
+	inst->value.call.name = name[last];
+	inst->value.call.memory = IR_MEMORY_WRITE;
+	for (int i = 0; i < num_args; ++i)
+		ir_set_operand(inst, i, args[i]);
+	return inst;
+}
+
+static heck_ir_inst* lower_expr(lower_ctx* ctx, heck_expr* expr) {
+	switch (expr->type) {
+		case EXPR_LITERAL:
+			if (lower_type(expr->value.literal.data_type) == -1)
+				return lower_fail(ctx, "strings");
+			return lower_const(ctx, expr->value.literal);
+		case EXPR_VALUE: {
+			int type = lower_type(expr->data_type);
+			if (type == -1 || type == IR_VOID)
+				return lower_fail(ctx, "variables of this type");
+			
+			lower_var var;
+			if (!lower_find_var(ctx, &expr->value.value, &var))
+				return NULL;
+			return lower_get(ctx, &var, type);
+		}
+		case EXPR_BINARY:
+			if (expr->vtable == &expr_vtable_asg)
+				return lower_asg(ctx, expr);
+			return lower_binary(ctx, expr);
+		case EXPR_UNARY:
+			return lower_unary(ctx, expr);
+		case EXPR_TERNARY:
+			return lower_ternary(ctx, expr);
+		case EXPR_CALL:
+			return lower_call(ctx, expr);
+		case EXPR_CAST:
+			// casts are only resolved between identical types for now
+			return lower_expr(ctx, expr->value.expr);
+		default:
+			return lower_fail(ctx, "this expression");
+	}
+}
+
+/*
+ *	Statements
+ */
+
+static void lower_block(lower_ctx* ctx, heck_block* block);
+
+static void lower_let(lower_ctx* ctx, heck_block* block, heck_stmt_let* let_stmt) {
+	// a variable without a value is assigned before it is read
+	if (let_stmt->value == NULL || let_stmt->value->type == EXPR_RES_TYPE)
+		return;
+	
+	heck_ir_inst* value = lower_expr(ctx, let_stmt->value);
+	if (value == NULL)
+		return;
+	
+	lower_var var = { .slot = let_stmt->slot, .global = NULL, .name = let_stmt->name };
+	if (var.slot < 0 && (block->scope->names == NULL || !idf_map_get(block->scope->names, let_stmt->name, (void*)&var.global))) {
+		lower_fail(ctx, "this declaration");
+		return;
+	}
+	lower_set(ctx, &var, value);
+}
+
+static void lower_if(lower_ctx* ctx, heck_stmt_if* if_stmt) {
+	heck_ir_block* join = lower_block_create(ctx);
+	
+	// each condition in the ladder is checked at the end of the block before it
+	for (heck_if_node* node = if_stmt->contents; node != NULL; node = node->next) {
+		if (node->condition == NULL) {
+			lower_block(ctx, node->code);
+			if (ctx->block != NULL)
+				lower_jump(ctx, join);
+			break;
+		}
+		
+		heck_ir_inst* condition = lower_expr(ctx, node->condition);
+		if (condition == NULL)
+			return;
+		condition = lower_truthy(ctx, condition);
+		
+		heck_ir_block* then_block = lower_block_create(ctx);
+		heck_ir_block* else_block = node->next != NULL ? lower_block_create(ctx) : join;
+		
+		heck_ir_inst* branch = lower_add(ctx, IR_BRANCH, IR_VOID, 1);
+		ir_set_operand(branch, 0, condition);
+		ir_add_edge(ctx->block, then_block);
+		ir_add_edge(ctx->block, else_block);
+		
+		ctx->block = then_block;
+		lower_block(ctx, node->code);
+		if (ctx->failed)
+			return;
+		if (ctx->block != NULL)
+			lower_jump(ctx, join);
+		
+		ctx->block = else_block;
+	}
+	
+	// every branch returned
+	if (vector_size(join->pred_vec) == 0) {
+		ir_block_remove(ctx->ir, join);
+		ctx->block = NULL;
+	} else {
+		ctx->block = join;
+	}
+}
+
+static void lower_stmt(lower_ctx* ctx, heck_block* block, heck_stmt* stmt) {
+	switch (stmt->type) {
+		case STMT_EXPR:
+			lower_expr(ctx, stmt->value.expr);
+			break;
+		case STMT_LET:
+			lower_let(ctx, block, stmt->value.let_stmt);
+			break;
+		case STMT_IF:
+			lower_if(ctx, stmt->value.if_stmt);
+			break;
+		case STMT_RET: {
+			heck_ir_inst* value = NULL;
+			if (stmt->value.expr != NULL && (value = lower_expr(ctx, stmt->value.expr)) == NULL)
+				return;
+			
+			heck_ir_inst* inst = lower_add(ctx, IR_RETURN, IR_VOID, value != NULL);
+			if (value != NULL)
+				ir_set_operand(inst, 0, lower_convert(ctx, value, ctx->ir->return_type));
+			ctx->block = NULL;
+			break;
+		}
+		case STMT_BLOCK:
+			lower_block(ctx, stmt->value.block);
+			break;
+		case STMT_CLASS:
+		case STMT_FUNC:
+			break; // declarations don't run anything
+		default:
+			lower_fail(ctx, "this statement");
+			break;
+	}
+}
+
+static void lower_block(lower_ctx* ctx, heck_block* block) {
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts && ctx->block != NULL && !ctx->failed; ++i)
+		lower_stmt(ctx, block, block->stmt_vec[i]);
+}
+
+static heck_ir_func* lower_finish(lower_ctx* ctx, heck_block* body) {
+	lower_block(ctx, body);
+	
+	// falling out of the body returns too
+	if (ctx->block != NULL && !ctx->failed) {
+		heck_ir_type type = ctx->ir->return_type;
+		heck_ir_inst* inst = lower_add(ctx, IR_RETURN, IR_VOID, type != IR_VOID);
+		if (type != IR_VOID)
+			ir_set_operand(inst, 0, lower_const(ctx, lower_zero(type)));
+	}
+	
+	vector_free(ctx->def_vec);
+	if (ctx->failed) {
+		ir_func_free(ctx->ir);
+		return NULL;
+	}
+	
+	return ctx->ir;
+}
+
+heck_ir_func* ir_lower_func(heck_func* func, str_entry name) {
+	int return_type = lower_type(func->return_type);
+	if (return_type == -1) {
+		fprintf(stderr, "error: unable to compile functions that return this type yet\n");
+		return NULL;
+	}
+	
+	int num_params = (int)vector_size(func->param_vec);
+	lower_ctx ctx = {
+		.ir = ir_func_create(func, name, return_type, num_params),
+		.def_vec = vector_create(),
+		.num_slots = num_params + func->num_locals,
+		.failed = false,
+	};
+	ctx.block = lower_block_create(&ctx);
+	
+	// the parameters have the first slots
+	for (int i = 0; i < num_params; ++i) {
+		int type = lower_type(func->param_vec[i]->type);
+		if (type == -1 || type == IR_VOID) {
+			lower_fail(&ctx, "parameters of this type");
+			break;
+		}
+		
+		ctx.ir->param_types[i] = type;
+		heck_ir_inst* param = lower_add(&ctx, IR_PARAM, type, 0);
+		param->value.index = i;
+		ctx.def_vec[0][i] = param;
+	}
+	
+	return lower_finish(&ctx, func->code);
+}
+
+heck_ir_func* ir_lower_global(heck_block* global) {
+	lower_ctx ctx = {
+		.ir = ir_func_create(NULL, NULL, IR_VOID, 0),
+		.def_vec = vector_create(),
+		.num_slots = 0,
+		.failed = false,
+	};
+	ctx.block = lower_block_create(&ctx);
+	
+	return lower_finish(&ctx, global);
+}
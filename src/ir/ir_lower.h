@@ -0,0 +1,27 @@
+//
+//  ir_lower.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Lowering from the resolved syntax tree to the IR. Local variables become SSA values as the
+//	blocks are built, with phis where different definitions meet, so they never need memory.
+//	The language has no loops yet, so every predecessor of a block is finished before the block is,
+//	and a phi always knows all of its operands when it is created.
+//
+
+#ifndef ir_lower_h
+#define ir_lower_h
+
+#include "ir.h"
+#include "statement.h"
+
+// lowers the body of a resolved function, the name is only used for printing.
+// returns NULL and prints an error if the body uses something the IR can't represent yet,
+// like strings, classes, or the variables of an enclosing function
+heck_ir_func* ir_lower_func(heck_func* func, str_entry name);
+
+// the global code is lowered as a function that takes no parameters and runs when the program starts
+heck_ir_func* ir_lower_global(heck_block* global);
+
+#endif /* ir_lower_h */
@@ -0,0 +1,443 @@
+//
+//  ir_opt.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "ir_opt.h"
+#include <string.h>
+#include "ir_dom.h"
+#include "fold.h"
+#include "table.h"
+#include "mem.h"
+
+/*
+ *	Folding
+ */
+
+static bool ir_literal_equal(const heck_literal* a, const heck_literal* b) {
+	switch (a->data_type->type_name) {
+		case TYPE_FLOAT:
+			return a->value.float_value == b->value.float_value;
+		case TYPE_BOOL:
+			return a->value.bool_value == b->value.bool_value;
+		default:
+			return a->value.int_value == b->value.int_value;
+	}
+}
+
+static bool ir_is_const(const heck_ir_inst* inst, int operand) {
+	return inst->operands[operand].value->op == IR_CONST;
+}
+
+static const heck_literal* ir_operand_literal(const heck_ir_inst* inst, int operand) {
+	return &inst->operands[operand].value->value.literal;
+}
+
+// the value of the instruction if its operands are constants and it can be evaluated at compile time
+static bool fold_inst(const heck_ir_inst* inst, heck_literal* result) {
+	for (int i = 0; i < inst->num_operands; ++i) {
+		if (!ir_is_const(inst, i))
+			return false;
+	}
+	
+	switch (inst->op) {
+		case IR_BINARY: {
+			const heck_literal* a = ir_operand_literal(inst, 0);
+			const heck_literal* b = ir_operand_literal(inst, 1);
+			if (inst->value.operator == TK_OP_EQ || inst->value.operator == TK_OP_N_EQ) {
+				*result = create_literal_bool(ir_literal_equal(a, b) == (inst->value.operator == TK_OP_EQ));
+				return true;
+			}
+			return fold_numeric(inst->value.operator, a, b, result);
+		}
+		case IR_NEG: {
+			const heck_literal* operand = ir_operand_literal(inst, 0);
+			if (inst->type == IR_FLOAT)
+				*result = create_literal_float(-operand->value.float_value);
+			else
+				*result = create_literal_int((int)(0u - (uint32_t)operand->value.int_value));
+			return true;
+		}
+		case IR_BW_NOT:
+			*result = create_literal_int(~ir_operand_literal(inst, 0)->value.int_value);
+			return true;
+		case IR_NOT:
+			*result = create_literal_bool(!ir_operand_literal(inst, 0)->value.bool_value);
+			return true;
+		case IR_TO_FLOAT:
+			*result = create_literal_float((float)ir_operand_literal(inst, 0)->value.int_value);
+			return true;
+		default:
+			return false;
+	}
+}
+
+// the value every operand of the phi has, NULL if they're different
+static heck_ir_inst* phi_value(const heck_ir_inst* phi) {
+	heck_ir_inst* value = phi->operands[0].value;
+	for (int i = 1; i < phi->num_operands; ++i) {
+		if (phi->operands[i].value != value)
+			return NULL;
+	}
+	return value;
+}
+
+static unsigned fold_run(heck_pass_manager* pm, heck_ir_func* ir) {
+	heck_ir_dom* dom = pass_manager_get(pm, ir, IR_ANALYSIS_DOM);
+	bool changed = false;
+	bool cfg_changed = false;
+	
+	// operands come before their uses in reverse postorder, so chains of constants fold in one pass
+	int num_reachable = (int)vector_size(dom->rpo_vec);
+	for (int i = 0; i < num_reachable; ++i) {
+		heck_ir_block* block = dom->rpo_vec[i];
+		heck_ir_inst* next;
+		for (heck_ir_inst* inst = block->first; inst != NULL; inst = next) {
+			next = inst->next;
+			
+			heck_literal literal;
+			if (inst->op == IR_PHI) {
+				heck_ir_inst* value = phi_value(inst);
+				if (value != NULL) {
+					ir_replace_uses(inst, value);
+					ir_inst_remove(inst);
+					changed = true;
+				}
+			} else if (inst->op == IR_BRANCH) {
+				if (ir_is_const(inst, 0)) {
+					ir_make_jump(block, !ir_operand_literal(inst, 0)->value.bool_value);
+					cfg_changed = true;
+				}
+			} else if (fold_inst(inst, &literal)) {
+				ir_make_const(inst, literal);
+				changed = true;
+			}
+		}
+	}
+	
+	// folding instructions doesn't change the graph
+	if (cfg_changed)
+		return IR_PRESERVE_NONE;
+	return changed ? IR_PRESERVE(IR_ANALYSIS_DOM) : IR_PRESERVE_ALL;
+}
+
+const heck_ir_pass ir_pass_fold = { "fold", IR_PRESERVE(IR_ANALYSIS_DOM), fold_run };
+
+/*
+ *	Control Flow Simplification
+ */
+
+static unsigned simplify_cfg_run(heck_pass_manager* pm, heck_ir_func* ir) {
+	heck_ir_dom* dom = pass_manager_get(pm, ir, IR_ANALYSIS_DOM);
+	bool changed = false;
+	
+	int num_reachable = (int)vector_size(dom->rpo_vec);
+	for (int i = 0; i < num_reachable; ++i) {
+		heck_ir_block* block = dom->rpo_vec[i];
+		
+		// blocks that were merged into an earlier block are left empty
+		if (block->last == NULL)
+			continue;
+		
+		while (block->last->op == IR_JUMP) {
+			heck_ir_block* succ = block->succ[0];
+			if (vector_size(succ->pred_vec) != 1 || succ == ir->block_vec[0])
+				break;
+			
+			ir_merge_blocks(ir, block, succ);
+			changed = true;
+		}
+	}
+	
+	return changed ? IR_PRESERVE_NONE : IR_PRESERVE_ALL;
+}
+
+const heck_ir_pass ir_pass_simplify_cfg = { "simplify-cfg", IR_PRESERVE(IR_ANALYSIS_DOM), simplify_cfg_run };
+
+/*
+ *	Dead Code Elimination
+ */
+
+static unsigned dce_run(heck_pass_manager* pm, heck_ir_func* ir) {
+	heck_ir_dom* dom = pass_manager_get(pm, ir, IR_ANALYSIS_DOM);
+	bool changed = false;
+	
+	// the edges between unreachable blocks are cleared first so they can be removed in any order
+	int num_blocks = ir_num_blocks(ir);
+	heck_ir_block** dead_vec = vector_create();
+	for (int i = 0; i < num_blocks; ++i) {
+		heck_ir_block* block = ir->block_vec[i];
+		if (ir_reachable(dom, block))
+			continue;
+		
+		for (int j = 0; j < 2; ++j) {
+			if (block->succ[j] != NULL && !ir_reachable(dom, block->succ[j]))
+				block->succ[j] = NULL;
+		}
+		vector_add(&dead_vec, block);
+	}
+	
+	int num_dead = (int)vector_size(dead_vec);
+	for (int i = 0; i < num_dead; ++i)
+		ir_block_remove(ir, dead_vec[i]);
+	vector_free(dead_vec);
+	changed = num_dead > 0;
+	
+	// uses come after their values in reverse postorder, so going backwards
+	// removes every instruction that only dead instructions used in one pass
+	for (int i = (int)vector_size(dom->rpo_vec) - 1; i >= 0; --i) {
+		heck_ir_block* block = dom->rpo_vec[i];
+		heck_ir_inst* prev;
+		for (heck_ir_inst* inst = block->last; inst != NULL; inst = prev) {
+			prev = inst->prev;
+			if (inst->uses == NULL && !ir_has_effects(inst)) {
+				ir_inst_remove(inst);
+				changed = true;
+			}
+		}
+	}
+	
+	// the reachable blocks and their edges are the same
+	return changed ? IR_PRESERVE(IR_ANALYSIS_DOM) : IR_PRESERVE_ALL;
+}
+
+const heck_ir_pass ir_pass_dce = { "dce", IR_PRESERVE(IR_ANALYSIS_DOM), dce_run };
+
+/*
+ *	Global Value Numbering
+ */
+
+#define GVN_MIN_BUCKETS 16
+
+// instructions with equal keys compute the same value. their operands have been numbered already,
+// so the first instruction with a key can stand in for the ones that come after it
+typedef struct gvn_key {
+	heck_ir_op op; // global sets are keyed like the get that would read the value back
+	heck_ir_type type;
+	uintptr_t value; // the bits of the literal, the operator, the global, the callee, or the block of a phi
+	int memory; // the state of the global variables the instruction reads, 0 if it doesn't read them
+	const heck_ir_use* operands;
+	int num_operands;
+} gvn_key;
+
+typedef struct gvn_entry {
+	gvn_key key;
+	uint32_t hash;
+	heck_ir_block* block; // the key is only available in the blocks this one dominates
+	heck_ir_inst* leader;
+	int next; // the next entry in the same bucket, -1 at the end
+} gvn_entry;
+
+typedef struct gvn_ctx {
+	const heck_ir_dom* dom;
+	gvn_entry* entry_vec;
+	int* buckets;
+	int num_buckets; // always a power of 2
+	int num_states; // each store or call that can change a global variable starts a new state
+} gvn_ctx;
+
+static uint32_t gvn_mix(uint32_t hash, uint32_t word) {
+	return (hash ^ word) * 16777619u;
+}
+
+static uint32_t gvn_hash(const gvn_key* key) {
+	uint32_t hash = TABLE_HASH_INIT;
+	hash = gvn_mix(hash, key->op);
+	hash = gvn_mix(hash, key->type);
+	hash = gvn_mix(hash, (uint32_t)key->value);
+	hash = gvn_mix(hash, (uint32_t)((uint64_t)key->value >> 32));
+	hash = gvn_mix(hash, key->memory);
+	for (int i = 0; i < key->num_operands; ++i)
+		hash = gvn_mix(hash, key->operands[i].value->id);
+	return hash ^ (hash >> 16); // the bucket only uses the low bits
+}
+
+static bool gvn_key_equal(const gvn_key* a, const gvn_key* b) {
+	if (a->op != b->op || a->type != b->type || a->value != b->value ||
+		a->memory != b->memory || a->num_operands != b->num_operands)
+		return false;
+	
+	for (int i = 0; i < a->num_operands; ++i) {
+		if (a->operands[i].value != b->operands[i].value)
+			return false;
+	}
+	return true;
+}
+
+// floats are compared by their bits so 0.0 and -0.0 stay apart
+static uintptr_t gvn_literal_bits(const heck_ir_inst* inst) {
+	switch (inst->type) {
+		case IR_FLOAT: {
+			uint32_t bits;
+			memcpy(&bits, &inst->value.literal.value.float_value, sizeof(bits));
+			return bits;
+		}
+		case IR_BOOL:
+			return inst->value.literal.value.bool_value;
+		default:
+			return (uint32_t)inst->value.literal.value.int_value;
+	}
+}
+
+static bool gvn_commutes(heck_tk_type operator) {
+	switch (operator) {
+		case TK_OP_MULT:
+		case TK_OP_ADD:
+		case TK_OP_BW_AND:
+		case TK_OP_BW_XOR:
+		case TK_OP_BW_OR:
+		case TK_OP_EQ:
+		case TK_OP_N_EQ:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// false if the instruction doesn't get a value number, memory is the current state of the global variables
+static bool gvn_make_key(heck_ir_inst* inst, int memory, gvn_key* key) {
+	key->op = inst->op;
+	key->type = inst->type;
+	key->value = 0;
+	key->memory = 0;
+	key->operands = inst->operands;
+	key->num_operands = inst->num_operands;
+	
+	switch (inst->op) {
+		case IR_CONST:
+			key->value = gvn_literal_bits(inst);
+			return true;
+		case IR_PHI:
+			key->value = (uintptr_t)inst->block;
+			return true;
+		case IR_GLOBAL_GET:
+			key->value = (uintptr_t)inst->value.global.var;
+			key->memory = memory;
+			return true;
+		case IR_CALL:
+			if (inst->value.call.memory == IR_MEMORY_WRITE)
+				return false;
+			key->value = (uintptr_t)inst->value.call.func;
+			if (inst->value.call.memory == IR_MEMORY_READ)
+				key->memory = memory;
+			return true;
+		case IR_BINARY:
+			// operands of commutative operators are put in order so a + b and b + a get the same key
+			if (gvn_commutes(inst->value.operator) && inst->operands[0].value->id > inst->operands[1].value->id) {
+				heck_ir_inst* left = inst->operands[0].value;
+				ir_set_operand(inst, 0, inst->operands[1].value);
+				ir_set_operand(inst, 1, left);
+			}
+			key->value = inst->value.operator;
+			return true;
+		case IR_NEG:
+		case IR_BW_NOT:
+		case IR_NOT:
+		case IR_TO_FLOAT:
+			return true;
+		default:
+			return false;
+	}
+}
+
+// the leader of an equal key that is available in block, NULL if there isn't one
+static heck_ir_inst* gvn_find(const gvn_ctx* ctx, const gvn_key* key, uint32_t hash, const heck_ir_block* block) {
+	for (int i = ctx->buckets[hash & (ctx->num_buckets - 1)]; i != -1; i = ctx->entry_vec[i].next) {
+		const gvn_entry* entry = &ctx->entry_vec[i];
+		if (entry->hash == hash && gvn_key_equal(&entry->key, key) && ir_dominates(ctx->dom, entry->block, block))
+			return entry->leader;
+	}
+	return NULL;
+}
+
+static void gvn_add(gvn_ctx* ctx, const gvn_key* key, uint32_t hash, heck_ir_block* block, heck_ir_inst* leader) {
+	int bucket = hash & (ctx->num_buckets - 1);
+	gvn_entry* entry = vector_add_asg(&ctx->entry_vec);
+	entry->key = *key;
+	entry->hash = hash;
+	entry->block = block;
+	entry->leader = leader;
+	entry->next = ctx->buckets[bucket];
+	ctx->buckets[bucket] = (int)vector_size(ctx->entry_vec) - 1;
+}
+
+// numbers the instructions of a block, returns the state of the global variables at its end
+static int gvn_block(gvn_ctx* ctx, heck_ir_block* block, int memory, bool* changed) {
+	heck_ir_inst* next;
+	for (heck_ir_inst* inst = block->first; inst != NULL; inst = next) {
+		next = inst->next;
+		
+		if (inst->op == IR_GLOBAL_SET) {
+			// later reads get the stored value until something else might change it
+			memory = ++ctx->num_states;
+			heck_ir_inst* stored = inst->operands[0].value;
+			gvn_key key = { IR_GLOBAL_GET, stored->type, (uintptr_t)inst->value.global.var, memory, NULL, 0 };
+			gvn_add(ctx, &key, gvn_hash(&key), block, stored);
+			continue;
+		}
+		if (inst->op == IR_CALL && inst->value.call.memory == IR_MEMORY_WRITE)
+			memory = ++ctx->num_states;
+		
+		gvn_key key;
+		if (!gvn_make_key(inst, memory, &key))
+			continue;
+		
+		uint32_t hash = gvn_hash(&key);
+		heck_ir_inst* leader = gvn_find(ctx, &key, hash, block);
+		if (leader == NULL) {
+			gvn_add(ctx, &key, hash, block, inst);
+		} else {
+			// the leader dominates inst, so if it trapped inst is never reached
+			ir_replace_uses(inst, leader);
+			ir_inst_remove(inst);
+			*changed = true;
+		}
+	}
+	return memory;
+}
+
+static unsigned gvn_run(heck_pass_manager* pm, heck_ir_func* ir) {
+	heck_ir_dom* dom = pass_manager_get(pm, ir, IR_ANALYSIS_DOM);
+	
+	gvn_ctx ctx;
+	ctx.dom = dom;
+	ctx.entry_vec = vector_create();
+	ctx.num_buckets = GVN_MIN_BUCKETS;
+	while (ctx.num_buckets < ir->num_inst_ids)
+		ctx.num_buckets *= 2;
+	ctx.buckets = mem_alloc(ctx.num_buckets * sizeof(int), MEM_IR);
+	for (int i = 0; i < ctx.num_buckets; ++i)
+		ctx.buckets[i] = -1;
+	ctx.num_states = 0;
+	
+	int* memory_out = mem_alloc(ir->num_block_ids * sizeof(int), MEM_IR);
+	bool changed = false;
+	
+	// blocks come after the blocks that dominate them in reverse postorder, and so do the operands of each
+	// instruction, so every operand has its final number before it is part of a key
+	int num_reachable = (int)vector_size(dom->rpo_vec);
+	for (int i = 0; i < num_reachable; ++i) {
+		heck_ir_block* block = dom->rpo_vec[i];
+		
+		// a block with one predecessor can only be reached from the end of that block,
+		// the globals are in an unknown state where paths meet
+		int memory;
+		if (vector_size(block->pred_vec) == 1)
+			memory = memory_out[block->pred_vec[0]->id];
+		else
+			memory = ++ctx.num_states;
+		
+		memory_out[block->id] = gvn_block(&ctx, block, memory, &changed);
+	}
+	
+	mem_free(memory_out);
+	mem_free(ctx.buckets);
+	vector_free(ctx.entry_vec);
+	
+	// only instructions were removed
+	return changed ? IR_PRESERVE(IR_ANALYSIS_DOM) : IR_PRESERVE_ALL;
+}
+
+const heck_ir_pass ir_pass_gvn = { "gvn", IR_PRESERVE(IR_ANALYSIS_DOM), gvn_run };
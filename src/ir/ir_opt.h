@@ -0,0 +1,29 @@
+//
+//  ir_opt.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Optimization passes over the IR, scheduled by the pass manager.
+//
+
+#ifndef ir_opt_h
+#define ir_opt_h
+
+#include "pass_manager.h"
+
+// evaluates instructions with constant operands, removes phis that only have one value,
+// and turns branches on constants into jumps
+extern const heck_ir_pass ir_pass_fold;
+
+// merges blocks with the block they jump to when it has no other predecessors
+extern const heck_ir_pass ir_pass_simplify_cfg;
+
+// removes blocks that can't be reached and instructions whose values aren't used
+extern const heck_ir_pass ir_pass_dce;
+
+// replaces instructions that compute a value an instruction that dominates them already computed.
+// reads of global variables and calls that only read them are reused until something might change them
+extern const heck_ir_pass ir_pass_gvn;
+
+#endif /* ir_opt_h */
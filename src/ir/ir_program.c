@@ -0,0 +1,138 @@
+//
+//  ir_program.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "ir_program.h"
+#include "ir_lower.h"
+#include "ptr_map.h"
+#include "vec.h"
+#include "mem.h"
+
+struct heck_ir_program {
+	heck_ir_func** func_vec; // the global code comes first, functions are NULL once they're taken
+	ptr_map func_map; // the index of each function in func_vec
+};
+
+// lowers the functions the code calls that haven't been lowered yet
+static bool program_add_callees(heck_ir_program* program, const heck_ir_func* ir) {
+	int num_blocks = ir_num_blocks(ir);
+	for (int i = 0; i < num_blocks; ++i) {
+		for (heck_ir_inst* inst = ir->block_vec[i]->first; inst != NULL; inst = inst->next) {
+			if (inst->op != IR_CALL || ptr_map_get(&program->func_map, inst->value.call.func) != -1)
+				continue;
+			
+			heck_ir_func* callee = ir_lower_func(inst->value.call.func, inst->value.call.name);
+			if (callee == NULL)
+				return false;
+			
+			ptr_map_set(&program->func_map, inst->value.call.func, (int)vector_size(program->func_vec));
+			vector_add(&program->func_vec, callee);
+		}
+	}
+	return true;
+}
+
+// what the function does to global variables itself, not counting its calls
+static heck_ir_memory func_memory(const heck_ir_func* ir) {
+	heck_ir_memory memory = IR_MEMORY_NONE;
+	int num_blocks = ir_num_blocks(ir);
+	for (int i = 0; i < num_blocks; ++i) {
+		for (heck_ir_inst* inst = ir->block_vec[i]->first; inst != NULL; inst = inst->next) {
+			if (inst->op == IR_GLOBAL_SET)
+				return IR_MEMORY_WRITE;
+			if (inst->op == IR_GLOBAL_GET)
+				memory = IR_MEMORY_READ;
+		}
+	}
+	return memory;
+}
+
+// a function does the most any of its calls does. everything starts with what it does itself, and the
+// calls are added until nothing changes, which handles recursion without finding the cycles first
+static void program_mark_calls(heck_ir_program* program) {
+	int num_funcs = (int)vector_size(program->func_vec);
+	heck_ir_memory* memory = mem_alloc(num_funcs * sizeof(heck_ir_memory), MEM_IR);
+	for (int i = 0; i < num_funcs; ++i)
+		memory[i] = func_memory(program->func_vec[i]);
+	
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int i = 0; i < num_funcs; ++i) {
+			const heck_ir_func* ir = program->func_vec[i];
+			int num_blocks = ir_num_blocks(ir);
+			for (int j = 0; j < num_blocks && memory[i] != IR_MEMORY_WRITE; ++j) {
+				for (heck_ir_inst* inst = ir->block_vec[j]->first; inst != NULL; inst = inst->next) {
+					if (inst->op != IR_CALL)
+						continue;
+					
+					heck_ir_memory callee = memory[ptr_map_get(&program->func_map, inst->value.call.func)];
+					if (callee > memory[i]) {
+						memory[i] = callee;
+						changed = true;
+					}
+				}
+			}
+		}
+	}
+	
+	for (int i = 0; i < num_funcs; ++i) {
+		const heck_ir_func* ir = program->func_vec[i];
+		int num_blocks = ir_num_blocks(ir);
+		for (int j = 0; j < num_blocks; ++j) {
+			for (heck_ir_inst* inst = ir->block_vec[j]->first; inst != NULL; inst = inst->next) {
+				if (inst->op == IR_CALL)
+					inst->value.call.memory = memory[ptr_map_get(&program->func_map, inst->value.call.func)];
+			}
+		}
+	}
+	
+	mem_free(memory);
+}
+
+heck_ir_program* ir_program_lower(heck_block* global) {
+	heck_ir_func* global_ir = ir_lower_global(global);
+	if (global_ir == NULL)
+		return NULL;
+	
+	heck_ir_program* program = mem_alloc(sizeof(heck_ir_program), MEM_IR);
+	program->func_vec = vector_create();
+	ptr_map_init(&program->func_map, MEM_IR);
+	vector_add(&program->func_vec, global_ir);
+	
+	// func_vec grows as the loop goes, so every function that can be called is reached
+	for (vec_size_t i = 0; i < vector_size(program->func_vec); ++i) {
+		if (!program_add_callees(program, program->func_vec[i])) {
+			ir_program_free(program);
+			return NULL;
+		}
+	}
+	
+	program_mark_calls(program);
+	
+	return program;
+}
+
+void ir_program_free(heck_ir_program* program) {
+	vec_size_t num_funcs = vector_size(program->func_vec);
+	for (vec_size_t i = 0; i < num_funcs; ++i) {
+		if (program->func_vec[i] != NULL)
+			ir_func_free(program->func_vec[i]);
+	}
+	vector_free(program->func_vec);
+	ptr_map_free(&program->func_map);
+	mem_free(program);
+}
+
+heck_ir_func* ir_program_take(heck_ir_program* program, heck_func* func) {
+	int index = func == NULL ? 0 : ptr_map_get(&program->func_map, func);
+	if (index == -1)
+		return NULL;
+	
+	heck_ir_func* ir = program->func_vec[index];
+	program->func_vec[index] = NULL;
+	return ir;
+}
@@ -0,0 +1,29 @@
+//
+//  ir_program.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	The global code and every function it can call, lowered before any of them are optimized.
+//	Having the whole program lets each call be marked with what its callee can do to global
+//	variables, so the passes can treat calls that don't change them like any other value.
+//
+
+#ifndef ir_program_h
+#define ir_program_h
+
+#include "ir.h"
+#include "statement.h"
+
+typedef struct heck_ir_program heck_ir_program;
+
+// returns NULL and prints an error if any function the global code can reach can't be lowered
+heck_ir_program* ir_program_lower(heck_block* global);
+// frees the functions that weren't taken
+void ir_program_free(heck_ir_program* program);
+
+// hands a lowered function over to the caller, func is NULL for the global code.
+// returns NULL if the function was never called or was already taken
+heck_ir_func* ir_program_take(heck_ir_program* program, heck_func* func);
+
+#endif /* ir_program_h */
@@ -0,0 +1,95 @@
+//
+//  pass_manager.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "pass_manager.h"
+#include "ir_dom.h"
+#include "ir_opt.h"
+#include "mem.h"
+
+// passes are repeated this many times at most, in case they keep enabling each other
+#define PASS_MAX_ROUNDS 8
+
+typedef struct ir_analysis_info {
+	void* (*compute)(heck_ir_func* ir);
+	void (*free)(void* result);
+} ir_analysis_info;
+
+static void* analysis_dom_compute(heck_ir_func* ir) {
+	return ir_dom_compute(ir);
+}
+static void analysis_dom_free(void* result) {
+	ir_dom_free(result);
+}
+
+static const ir_analysis_info analysis_table[IR_NUM_ANALYSES] = {
+	[IR_ANALYSIS_DOM] = { analysis_dom_compute, analysis_dom_free },
+};
+
+static const heck_ir_pass* const pipeline[] = {
+	&ir_pass_fold,
+	&ir_pass_simplify_cfg,
+	&ir_pass_gvn,
+	&ir_pass_dce, // cleans up after the others
+};
+
+struct heck_pass_manager {
+	const heck_ir_pass* const* pass_vec;
+	int num_passes;
+	int max_rounds;
+};
+
+heck_pass_manager* pass_manager_create(int opt_level) {
+	heck_pass_manager* pm = mem_alloc(sizeof(heck_pass_manager), MEM_IR);
+	pm->pass_vec = pipeline;
+	pm->num_passes = opt_level > 0 ? sizeof(pipeline) / sizeof(*pipeline) : 0;
+	pm->max_rounds = opt_level > 1 ? PASS_MAX_ROUNDS : 1;
+	
+	return pm;
+}
+
+void pass_manager_free(heck_pass_manager* pm) {
+	mem_free(pm);
+}
+
+void* pass_manager_get(heck_pass_manager* pm, heck_ir_func* ir, heck_ir_analysis analysis) {
+	if (ir->analyses[analysis] == NULL)
+		ir->analyses[analysis] = analysis_table[analysis].compute(ir);
+	return ir->analyses[analysis];
+}
+
+static void pass_manager_invalidate(heck_ir_func* ir, unsigned preserved) {
+	for (int i = 0; i < IR_NUM_ANALYSES; ++i) {
+		if (ir->analyses[i] != NULL && !(preserved & IR_PRESERVE(i))) {
+			analysis_table[i].free(ir->analyses[i]);
+			ir->analyses[i] = NULL;
+		}
+	}
+}
+
+void pass_manager_release(heck_ir_func* ir) {
+	pass_manager_invalidate(ir, IR_PRESERVE_NONE);
+}
+
+void pass_manager_run(heck_pass_manager* pm, heck_ir_func* ir) {
+	for (int round = 0; round < pm->max_rounds; ++round) {
+		bool changed = false;
+		for (int i = 0; i < pm->num_passes; ++i) {
+			const heck_ir_pass* pass = pm->pass_vec[i];
+			for (int j = 0; j < IR_NUM_ANALYSES; ++j) {
+				if (pass->requires & IR_PRESERVE(j))
+					pass_manager_get(pm, ir, j);
+			}
+			
+			unsigned preserved = pass->run(pm, ir);
+			changed = changed || preserved != IR_PRESERVE_ALL;
+			pass_manager_invalidate(ir, preserved);
+		}
+		
+		if (!changed)
+			break;
+	}
+}
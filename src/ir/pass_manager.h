@@ -0,0 +1,46 @@
+//
+//  pass_manager.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Runs optimization passes over IR functions. Analyses are computed the first time a pass needs
+//	them and cached in the function until a pass changes something they depend on. Each pass says
+//	which analyses it leaves valid, and everything else is thrown away after it runs.
+//
+
+#ifndef pass_manager_h
+#define pass_manager_h
+
+#include "ir.h"
+
+typedef enum heck_ir_analysis {
+	IR_ANALYSIS_DOM, // heck_ir_dom, the reverse postorder and dominator tree
+	IR_NUM_ANALYSES
+} heck_ir_analysis;
+
+#define IR_PRESERVE(analysis)	(1u << (analysis))
+#define IR_PRESERVE_NONE		0u
+#define IR_PRESERVE_ALL			(~0u) // nothing changed
+
+typedef struct heck_pass_manager heck_pass_manager;
+
+typedef struct heck_ir_pass {
+	const char* name;
+	unsigned requires; // the analyses that are computed before the pass runs, e.g. IR_PRESERVE(IR_ANALYSIS_DOM)
+	// returns the analyses that are still valid, or IR_PRESERVE_ALL if the pass didn't change anything
+	unsigned (*run)(heck_pass_manager* pm, heck_ir_func* ir);
+} heck_ir_pass;
+
+// -O0 runs nothing, -O1 runs each pass once, -O2 repeats them until they stop finding anything
+heck_pass_manager* pass_manager_create(int opt_level);
+void pass_manager_free(heck_pass_manager* pm);
+
+void pass_manager_run(heck_pass_manager* pm, heck_ir_func* ir);
+
+// computes the analysis if it isn't cached yet, it belongs to the function
+void* pass_manager_get(heck_pass_manager* pm, heck_ir_func* ir, heck_ir_analysis analysis);
+// frees the analyses cached in the function, this has to be done before the function is freed
+void pass_manager_release(heck_ir_func* ir);
+
+#endif /* pass_manager_h */
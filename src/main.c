@@ -12,11 +12,16 @@
 #include "parser.h"
 #include "resolver.h"
 #include "compiler.h"
+#include "optimize.h"
+#include "mem.h"
 
 #include <time.h>
 #include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
 
-// solve this problem in heck
+// the resolver reports "unable to infer the type of a shared variable from its value" here,
+// the return type of run depends on a, which depends on run
 /*
 let a = run()
 
@@ -24,6 +29,52 @@ func run() {
 	return a
 }*/
 
+// syntax checks each file without building a syntax tree, returns the exit code
+int check_files(int num_paths, const char* paths[]) {
+	int status = 0;
+	
+	for (int i = 0; i < num_paths; ++i) {
+		FILE* f = fopen(paths[i], "rb");
+		if (f == NULL) {
+			fprintf(stderr, "error: unable to open %s\n", paths[i]);
+			status = 1;
+			continue;
+		}
+		
+		heck_code* c = heck_create();
+		bool success = heck_scan(c, f);
+		success = heck_check(c) && success;
+		heck_free(c);
+		fclose(f);
+		
+		if (!success) {
+			fprintf(stderr, "%s: invalid syntax\n", paths[i]);
+			status = 1;
+		}
+	}
+	
+	return status;
+}
+
+static void usage(const char* name) {
+	fprintf(stderr,
+			"usage: %s [options] file\n"
+			"       %s --check files...\n"
+			"  --check        only check the syntax of each file, nothing is resolved\n"
+			"  -j N           threads for resolving function bodies (default: one for each core)\n"
+			"  --eager        parse every function body up front on the -j threads, instead of\n"
+			"                 parsing each one the first time it's needed\n"
+			"  --reparse OLD  parse and resolve OLD first, then reparse it as file, the output\n"
+			"                 should be the same as without this option\n"
+			"  -o FILE        compile the code to a wasm module\n"
+			"  -O0, -O1, -O2  optimization level for compiling (default 2)\n"
+			"  --print-ir     print the optimized IR of each function that is compiled\n"
+			"  --print-opt    print the tree again after the -O level's passes, before it's compiled\n"
+			"  --mem-stats    print memory use by subsystem, only in builds with HECK_MEM_STATS defined\n"
+			"  --version      print the version and exit\n",
+			name, name);
+}
+
 int main(int argc, const char * argv[]) {
 	// insert code here...
 	
@@ -32,29 +83,124 @@ int main(int argc, const char * argv[]) {
 		return 0;
 	}
 	
+	if (argc == 2 && (strcmp(argv[1], "--help") == 0 || strcmp(argv[1], "-h") == 0)) {
+		usage(argv[0]);
+		return 0;
+	}
+	
+	// heck --check [files...]
+	if (argc >= 2 && strcmp(argv[1], "--check") == 0)
+		return check_files(argc - 2, &argv[2]);
+	
+	const char* path = "resolve_test2.heck";
+	const char* output = NULL; // nothing is compiled unless there's somewhere for it to go
+	int opt_level = 2;
+	bool mem_stats = false;
+	bool print_ir = false;
+	bool print_opt = false;
+	bool eager = false; // bodies are only parsed if something needs them unless this is set
+	const char* prev_path = NULL; // the code is reparsed from this file if it's set
+	
+	// resolve function bodies on every core by default
+	long num_threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (num_threads < 1)
+		num_threads = 1;
+	
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--mem-stats") == 0) {
+			mem_stats = true;
+		} else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+			num_threads = strtol(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+			output = argv[++i];
+		} else if (strcmp(argv[i], "-O0") == 0 || strcmp(argv[i], "-O1") == 0 || strcmp(argv[i], "-O2") == 0) {
+			opt_level = argv[i][2] - '0';
+		} else if (strcmp(argv[i], "--print-ir") == 0) {
+			print_ir = true;
+		} else if (strcmp(argv[i], "--print-opt") == 0) {
+			print_opt = true;
+		} else if (strcmp(argv[i], "--eager") == 0) {
+			eager = true;
+		} else if (strcmp(argv[i], "--reparse") == 0 && i + 1 < argc) {
+			prev_path = argv[++i];
+		} else {
+			path = argv[i];
+		}
+	}
+	
 	clock_t begin = clock();
+	int status = 0; // nonzero if the code has errors, like check_files
 
-	FILE* f = fopen("resolve_test2.heck", "rb");
+	FILE* f = fopen(path, "rb");
+	FILE* prev_f = NULL;
+	if (prev_path != NULL && (prev_f = fopen(prev_path, "rb")) == NULL) {
+		fprintf(stderr, "error: unable to open %s\n", prev_path);
+		if (f != NULL)
+			fclose(f);
+		f = NULL;
+	}
 
 	if (f) {
 
 		//printf("start.\n");
 		heck_code* c = heck_create();
-		heck_scan(c, f);
-		//heck_print_tokens(c);
-		heck_parse(c);
+		bool success;
+		if (prev_f != NULL) {
+			// only the errors in the new code count
+			heck_scan(c, prev_f);
+			heck_parse(c, eager ? (int)num_threads : 0);
+			heck_resolve(c, (int)num_threads);
+			fclose(prev_f);
+			
+			heck_token_edit edit;
+			heck_rescan(c, f, &edit);
+			success = heck_reparse(c, &edit, 1, eager ? (int)num_threads : 0);
+		} else {
+			heck_scan(c, f);
+			//heck_print_tokens(c);
+			success = heck_parse(c, eager ? (int)num_threads : 0);
+		}
+		
+		// resolve everything
+		success = heck_resolve(c, (int)num_threads) && success;
+		if (success) {
+			printf("successfully resolved!\n");
+		} else {
+			printf("failed to resolve :(\n");
+			status = 1;
+		}
+		
+		heck_print_tree(c);
 		//printf("done.\n");
-		//heck_compile(c);
+		
+		if (success && (output != NULL || print_ir || print_opt)) {
+			printf("\n");
+			heck_optimize(c, opt_level);
+			if (print_opt)
+				heck_print_tree(c);
+			if ((output != NULL || print_ir) && !heck_compile(c, output, opt_level, print_ir)) {
+				printf("failed to compile :(\n");
+				status = 1;
+			}
+		}
 		//printf("press ENTER to continue...");
 		//getchar();
+		
+		if (mem_stats) {
+			printf("\n");
+			mem_print_stats(stdout, heck_num_lines(c), heck_num_tokens(c));
+		}
+		
 		heck_free(c);
+		fclose(f);
+	} else {
+		fprintf(stderr, "error: unable to open %s\n", path);
+		status = 1;
 	}
 
-	fclose(f);
-
 	clock_t end = clock();
 	double time_spent = (double)(end - begin) / CLOCKS_PER_SEC;
 	printf("\nexecution time: %f seconds\n", time_spent);
 
-	return 0;
+	return status;
 }
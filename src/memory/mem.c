@@ -0,0 +1,181 @@
+//
+//  mem.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "mem.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#ifdef HECK_MEM_STATS
+
+// stored in front of every allocation, the size keeps the user data aligned
+typedef union mem_header {
+	struct {
+		size_t size;
+		heck_mem_tag tag;
+	} info;
+	max_align_t align;
+} mem_header;
+
+// atomic because function bodies are parsed on multiple threads
+typedef struct mem_tag_stats {
+	atomic_size_t current;
+	atomic_size_t peak;
+	atomic_size_t count; // total number of allocations
+} mem_tag_stats;
+
+// one bucket for each power of two
+#define MEM_NUM_BUCKETS (sizeof(size_t) * 8 + 1)
+
+static mem_tag_stats tag_stats[MEM_NUM_TAGS];
+static mem_tag_stats total_stats;
+static atomic_size_t size_histogram[MEM_NUM_BUCKETS];
+
+static const char* tag_names[MEM_NUM_TAGS] = {
+	"source", "tokens", "strings", "ast", "scopes", "types", "flow", "ir", "codegen", "vectors"
+};
+
+// the number of bits needed to store size, so bucket n holds sizes up to 2^n - 1
+static int mem_bucket(size_t size) {
+	int bucket = 0;
+	while (size != 0) {
+		size >>= 1;
+		++bucket;
+	}
+	return bucket;
+}
+
+static void mem_stats_add(mem_tag_stats* stats, size_t size) {
+	size_t current = atomic_fetch_add(&stats->current, size) + size;
+	atomic_fetch_add(&stats->count, 1);
+	
+	size_t peak = atomic_load(&stats->peak);
+	while (current > peak && !atomic_compare_exchange_weak(&stats->peak, &peak, current));
+}
+
+static void mem_track(size_t size, heck_mem_tag tag) {
+	mem_stats_add(&tag_stats[tag], size);
+	mem_stats_add(&total_stats, size);
+	atomic_fetch_add(&size_histogram[mem_bucket(size)], 1);
+}
+
+static void mem_untrack(size_t size, heck_mem_tag tag) {
+	atomic_fetch_sub(&tag_stats[tag].current, size);
+	atomic_fetch_sub(&total_stats.current, size);
+}
+
+void* _mem_alloc(size_t size, heck_mem_tag tag) {
+	mem_header* h = malloc(sizeof(mem_header) + size);
+	if (h == NULL)
+		return NULL;
+	
+	h->info.size = size;
+	h->info.tag = tag;
+	mem_track(size, tag);
+	
+	return &h[1];
+}
+
+void* _mem_calloc(size_t count, size_t size, heck_mem_tag tag) {
+	void* ptr = _mem_alloc(count * size, tag);
+	if (ptr != NULL)
+		memset(ptr, 0, count * size);
+	return ptr;
+}
+
+void* _mem_realloc(void* ptr, size_t size, heck_mem_tag tag) {
+	if (ptr == NULL)
+		return _mem_alloc(size, tag);
+	
+	mem_header* h = &((mem_header*)ptr)[-1];
+	size_t old_size = h->info.size;
+	tag = h->info.tag;
+	
+	h = realloc(h, sizeof(mem_header) + size);
+	if (h == NULL)
+		return NULL;
+	
+	mem_untrack(old_size, tag);
+	mem_track(size, tag);
+	h->info.size = size;
+	
+	return &h[1];
+}
+
+void _mem_free(void* ptr) {
+	if (ptr == NULL)
+		return;
+	
+	mem_header* h = &((mem_header*)ptr)[-1];
+	mem_untrack(h->info.size, h->info.tag);
+	free(h);
+}
+
+bool mem_stats_enabled(void) {
+	return true;
+}
+
+size_t mem_current_bytes(void) {
+	return atomic_load(&total_stats.current);
+}
+
+size_t mem_peak_bytes(void) {
+	return atomic_load(&total_stats.peak);
+}
+
+void mem_reset_peak(void) {
+	for (int i = 0; i < MEM_NUM_TAGS; ++i)
+		atomic_store(&tag_stats[i].peak, atomic_load(&tag_stats[i].current));
+	atomic_store(&total_stats.peak, atomic_load(&total_stats.current));
+}
+
+void mem_print_stats(FILE* f, size_t num_lines, size_t num_tokens) {
+	fprintf(f, "%-10s %12s %12s %12s\n", "tag", "current", "peak", "allocs");
+	for (int i = 0; i < MEM_NUM_TAGS; ++i) {
+		mem_tag_stats* stats = &tag_stats[i];
+		fprintf(f, "%-10s %12zu %12zu %12zu\n", tag_names[i], atomic_load(&stats->current), atomic_load(&stats->peak), atomic_load(&stats->count));
+	}
+	fprintf(f, "%-10s %12zu %12zu %12zu\n", "total", atomic_load(&total_stats.current), atomic_load(&total_stats.peak), atomic_load(&total_stats.count));
+	
+	// the peak for the whole compiler, not the sum of the peaks for each tag
+	if (num_lines > 0)
+		fprintf(f, "\npeak bytes per line: %.1f\n", (double)atomic_load(&total_stats.peak) / num_lines);
+	if (num_tokens > 0)
+		fprintf(f, "peak bytes per token: %.1f\n", (double)atomic_load(&total_stats.peak) / num_tokens);
+	
+	fprintf(f, "\nallocation sizes:\n");
+	for (int i = 0; i < MEM_NUM_BUCKETS; ++i) {
+		size_t count = atomic_load(&size_histogram[i]);
+		if (count == 0)
+			continue;
+		
+		size_t max_size = i == 0 ? 0 : ((size_t)1 << (i - 1)) * 2 - 1;
+		fprintf(f, "  <= %-10zu %zu\n", max_size, count);
+	}
+}
+
+#else
+
+bool mem_stats_enabled(void) {
+	return false;
+}
+
+size_t mem_current_bytes(void) {
+	return 0;
+}
+
+size_t mem_peak_bytes(void) {
+	return 0;
+}
+
+void mem_reset_peak(void) {}
+
+void mem_print_stats(FILE* f, size_t num_lines, size_t num_tokens) {
+	fprintf(f, "memory stats are disabled, rebuild with HECK_MEM_STATS defined\n");
+}
+
+#endif
@@ -0,0 +1,68 @@
+//
+//  mem.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Every allocation in the compiler goes through these macros so memory can be tracked
+//	by subsystem. Tracking is only compiled in when HECK_MEM_STATS is defined,
+//	otherwise the macros expand straight to malloc/calloc/realloc/free.
+//
+
+#ifndef mem_h
+#define mem_h
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+
+typedef enum heck_mem_tag {
+	MEM_SOURCE,		// source files loaded into memory
+	MEM_TOKENS,
+	MEM_STRINGS,	// strings, identifiers, and the string table
+	MEM_AST,		// statements, expressions, functions, and classes
+	MEM_SCOPES,		// scopes, names, and identifier maps
+	MEM_TYPES,		// data types and the type table
+	MEM_FLOW,		// control flow graphs and dataflow sets
+	MEM_IR,			// the mid-level ir and its analyses
+	MEM_CODEGEN,	// output buffers
+	MEM_VECTORS,	// vec buffers, regardless of what they store
+	MEM_NUM_TAGS
+} heck_mem_tag;
+
+#ifdef HECK_MEM_STATS
+
+void* _mem_alloc(size_t size, heck_mem_tag tag);
+void* _mem_calloc(size_t count, size_t size, heck_mem_tag tag);
+void* _mem_realloc(void* ptr, size_t size, heck_mem_tag tag); // keeps the original tag unless ptr is NULL
+void _mem_free(void* ptr);
+
+#define mem_alloc(size, tag)			_mem_alloc(size, tag)
+#define mem_calloc(count, size, tag)	_mem_calloc(count, size, tag)
+#define mem_realloc(ptr, size, tag)		_mem_realloc(ptr, size, tag)
+#define mem_free(ptr)					_mem_free(ptr)
+
+#else
+
+#define mem_alloc(size, tag)			malloc(size)
+#define mem_calloc(count, size, tag)	calloc(count, size)
+#define mem_realloc(ptr, size, tag)		realloc(ptr, size)
+#define mem_free(ptr)					free(ptr)
+
+#endif
+
+// false unless the compiler was built with HECK_MEM_STATS
+bool mem_stats_enabled(void);
+
+// the total number of bytes allocated right now and the most that was allocated at once,
+// both are 0 unless the compiler was built with HECK_MEM_STATS
+size_t mem_current_bytes(void);
+size_t mem_peak_bytes(void);
+
+// lowers the peak to the current usage so the peak of a single phase can be measured
+void mem_reset_peak(void);
+
+// lines and tokens are used to print the cost per line/token of the peak usage
+void mem_print_stats(FILE* f, size_t num_lines, size_t num_tokens);
+
+#endif /* mem_h */
@@ -0,0 +1,482 @@
+//
+//  fold.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "fold.h"
+#include <limits.h>
+#include "function.h"
+#include "scope.h"
+#include "statement.h"
+#include "dataflow.h"
+#include "vec.h"
+#include "mem.h"
+
+// 1 or 0 for values that are truthy or falsy, -1 if it isn't known until run time
+static int literal_truthy(const heck_literal* literal) {
+	switch (literal->data_type->type_name) {
+		case TYPE_BOOL:
+			return literal->value.bool_value;
+		case TYPE_INT:
+			return literal->value.int_value != 0;
+		case TYPE_FLOAT:
+			return literal->value.float_value != 0;
+		default:
+			return -1;
+	}
+}
+
+static bool literal_equal(const heck_literal* a, const heck_literal* b) {
+	if (a->data_type->type_name != b->data_type->type_name)
+		return false;
+	
+	switch (a->data_type->type_name) {
+		case TYPE_INT:
+			return a->value.int_value == b->value.int_value;
+		case TYPE_FLOAT:
+			return a->value.float_value == b->value.float_value;
+		case TYPE_BOOL:
+			return a->value.bool_value == b->value.bool_value;
+		case TYPE_STRING:
+			return a->value.str_value == b->value.str_value; // strings are interned
+		default:
+			return false;
+	}
+}
+
+static bool literal_is_numeric(const heck_literal* literal) {
+	return literal->data_type->type_name == TYPE_INT || literal->data_type->type_name == TYPE_FLOAT;
+}
+
+static float literal_float(const heck_literal* literal) {
+	return literal->data_type->type_name == TYPE_FLOAT ? literal->value.float_value : (float)literal->value.int_value;
+}
+
+static void expr_set_literal(heck_expr* expr, heck_literal literal) {
+	expr->type = EXPR_LITERAL;
+	expr->vtable = &expr_vtable_literal;
+	expr->value.literal = literal;
+	expr->data_type = literal.data_type;
+}
+
+bool fold_numeric(heck_tk_type operator, const heck_literal* a, const heck_literal* b, heck_literal* result) {
+	if (!literal_is_numeric(a) || !literal_is_numeric(b))
+		return false;
+	
+	if (a->data_type->type_name == TYPE_FLOAT || b->data_type->type_name == TYPE_FLOAT) {
+		float x = literal_float(a);
+		float y = literal_float(b);
+		switch (operator) {
+			case TK_OP_ADD:		*result = create_literal_float(x + y); return true;
+			case TK_OP_SUB:		*result = create_literal_float(x - y); return true;
+			case TK_OP_MULT:	*result = create_literal_float(x * y); return true;
+			case TK_OP_DIV:		*result = create_literal_float(x / y); return true;
+			case TK_OP_LESS:	*result = create_literal_bool(x < y); return true;
+			case TK_OP_LESS_EQ:	*result = create_literal_bool(x <= y); return true;
+			case TK_OP_GTR:		*result = create_literal_bool(x > y); return true;
+			case TK_OP_GTR_EQ:	*result = create_literal_bool(x >= y); return true;
+			default:
+				return false;
+		}
+	}
+	
+	int x = a->value.int_value;
+	int y = b->value.int_value;
+	uint32_t ux = (uint32_t)x;
+	uint32_t uy = (uint32_t)y;
+	switch (operator) {
+		case TK_OP_ADD:		*result = create_literal_int((int)(ux + uy)); return true;
+		case TK_OP_SUB:		*result = create_literal_int((int)(ux - uy)); return true;
+		case TK_OP_MULT:	*result = create_literal_int((int)(ux * uy)); return true;
+		case TK_OP_DIV:
+		case TK_OP_MOD:
+			// these trap at run time, so they're left for the program to report
+			if (y == 0 || (x == INT_MIN && y == -1))
+				return false;
+			*result = create_literal_int(operator == TK_OP_DIV ? x / y : x % y);
+			return true;
+		case TK_OP_EXP: {
+			if (y < 0)
+				return false;
+			uint32_t power = 1;
+			for (uint32_t base = ux; uy != 0; uy >>= 1, base *= base) {
+				if (uy & 1)
+					power *= base;
+			}
+			*result = create_literal_int((int)power);
+			return true;
+		}
+		// only the low 5 bits of the shift count are used
+		case TK_OP_SHFT_L:	*result = create_literal_int((int)(ux << (y & 31))); return true;
+		case TK_OP_SHFT_R:	*result = create_literal_int(x >> (y & 31)); return true;
+		case TK_OP_BW_AND:	*result = create_literal_int(x & y); return true;
+		case TK_OP_BW_OR:	*result = create_literal_int(x | y); return true;
+		case TK_OP_BW_XOR:	*result = create_literal_int(x ^ y); return true;
+		case TK_OP_LESS:	*result = create_literal_bool(x < y); return true;
+		case TK_OP_LESS_EQ:	*result = create_literal_bool(x <= y); return true;
+		case TK_OP_GTR:		*result = create_literal_bool(x > y); return true;
+		case TK_OP_GTR_EQ:	*result = create_literal_bool(x >= y); return true;
+		default:
+			return false;
+	}
+}
+
+static bool fold_binary(heck_expr* expr) {
+	heck_expr_binary* binary = &expr->value.binary;
+	bool left = fold_expr(binary->left);
+	
+	// the right side of && and || isn't evaluated if the left side decides the result
+	if (binary->operator == TK_OP_AND || binary->operator == TK_OP_OR) {
+		int truthy = left ? literal_truthy(&binary->left->value.literal) : -1;
+		if (truthy == (binary->operator == TK_OP_OR)) {
+			expr_set_literal(expr, create_literal_bool(truthy));
+			return true;
+		}
+		
+		if (!fold_expr(binary->right) || truthy == -1)
+			return false;
+		
+		truthy = literal_truthy(&binary->right->value.literal);
+		if (truthy == -1)
+			return false;
+		expr_set_literal(expr, create_literal_bool(truthy));
+		return true;
+	}
+	
+	bool right = fold_expr(binary->right);
+	if (!left || !right)
+		return false;
+	
+	const heck_literal* a = &binary->left->value.literal;
+	const heck_literal* b = &binary->right->value.literal;
+	heck_literal result;
+	switch (binary->operator) {
+		case TK_OP_XOR: {
+			int truthy_a = literal_truthy(a);
+			int truthy_b = literal_truthy(b);
+			if (truthy_a == -1 || truthy_b == -1)
+				return false;
+			result = create_literal_bool(truthy_a != truthy_b);
+			break;
+		}
+		case TK_OP_EQ:
+		case TK_OP_N_EQ:
+			if (a->data_type->type_name != b->data_type->type_name || a->data_type->type_name > TYPE_STRING)
+				return false;
+			result = create_literal_bool(literal_equal(a, b) == (binary->operator == TK_OP_EQ));
+			break;
+		default:
+			if (!fold_numeric(binary->operator, a, b, &result))
+				return false;
+			break;
+	}
+	
+	expr_set_literal(expr, result);
+	return true;
+}
+
+static bool fold_unary(heck_expr* expr) {
+	heck_expr_unary* unary = &expr->value.unary;
+	
+	// ++ and -- change a variable
+	if (unary->operator == TK_OP_INCR || unary->operator == TK_OP_DECR || !fold_expr(unary->expr))
+		return false;
+	
+	const heck_literal* operand = &unary->expr->value.literal;
+	heck_type_name type = operand->data_type->type_name;
+	switch (unary->operator) {
+		case TK_OP_NOT: {
+			int truthy = literal_truthy(operand);
+			if (truthy == -1)
+				return false;
+			expr_set_literal(expr, create_literal_bool(!truthy));
+			return true;
+		}
+		case TK_OP_SUB:
+			if (type == TYPE_INT)
+				expr_set_literal(expr, create_literal_int((int)(0u - (uint32_t)operand->value.int_value)));
+			else if (type == TYPE_FLOAT)
+				expr_set_literal(expr, create_literal_float(-operand->value.float_value));
+			else
+				return false;
+			return true;
+		case TK_OP_BW_NOT:
+			if (type != TYPE_INT)
+				return false;
+			expr_set_literal(expr, create_literal_int(~operand->value.int_value));
+			return true;
+		default:
+			return false;
+	}
+}
+
+// reads of shared variables that are never assigned are replaced with the value if it folds to a literal
+static bool fold_value(heck_expr* expr) {
+	heck_name* name = expr->value.value.resolved;
+	if (name == NULL || name->type != IDF_VARIABLE || name->parent->func != NULL || scope_is_class(name->parent))
+		return false;
+	
+	heck_expr* value = name->value.var_value;
+	if (name->fold_status == RESOLVE_PENDING) {
+		name->fold_status = RESOLVE_ACTIVE;
+		fold_expr(value);
+		name->fold_status = RESOLVE_DONE;
+	}
+	
+	if (name->fold_status != RESOLVE_DONE || value->type != EXPR_LITERAL)
+		return false;
+	expr_set_literal(expr, value->value.literal);
+	return true;
+}
+
+bool fold_expr(heck_expr* expr) {
+	switch (expr->type) {
+		case EXPR_LITERAL:
+			return true;
+		case EXPR_VALUE:
+			return fold_value(expr);
+		case EXPR_BINARY:
+			if (expr->vtable == &expr_vtable_asg) {
+				fold_expr(expr->value.binary.right);
+				return false;
+			}
+			return fold_binary(expr);
+		case EXPR_UNARY:
+			return fold_unary(expr);
+		case EXPR_TERNARY: {
+			heck_expr_ternary* ternary = &expr->value.ternary;
+			int truthy = fold_expr(ternary->condition) ? literal_truthy(&ternary->condition->value.literal) : -1;
+			if (truthy == -1) {
+				fold_expr(ternary->value_a);
+				fold_expr(ternary->value_b);
+				return false;
+			}
+			
+			// the branch that's taken replaces the ternary
+			heck_expr* value = truthy ? ternary->value_a : ternary->value_b;
+			bool literal = fold_expr(value);
+			move_expr(expr, value);
+			return literal;
+		}
+		case EXPR_CALL: {
+			heck_expr_call* call = &expr->value.call;
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				fold_expr(call->arg_vec[i]);
+			return false;
+		}
+		case EXPR_CAST:
+			// casts are only resolved between identical types for now
+			if (!fold_expr(expr->value.expr))
+				return false;
+			expr_set_literal(expr, expr->value.expr->value.literal);
+			return true;
+		default:
+			return false;
+	}
+}
+
+static void fold_stmt(heck_stmt* stmt) {
+	switch (stmt->type) {
+		case STMT_EXPR:
+			fold_expr(stmt->value.expr);
+			break;
+		case STMT_LET:
+			fold_expr(stmt->value.let_stmt->value);
+			break;
+		case STMT_RET:
+			if (stmt->value.expr != NULL)
+				fold_expr(stmt->value.expr);
+			break;
+		default:
+			break;
+	}
+}
+
+/*
+ *	Propagation
+ */
+
+typedef struct fold_ctx {
+	heck_reaching_defs* defs;
+	heck_bits* reaching; // the definitions that reach the statement being folded
+	int next_def;
+	bool propagate; // false if nested functions could change the locals
+} fold_ctx;
+
+static void fold_visit(void* ctx, heck_expr* site, const heck_expr_value* value, int slot, heck_flow_access access) {
+	fold_ctx* fold = ctx;
+	heck_reaching_defs* defs = fold->defs;
+	heck_bits* slot_defs = flow_set(defs->flow, defs->slot_defs, slot);
+	
+	if (access != FLOW_READ) {
+		if (access == FLOW_WRITE)
+			bitset_subtract(fold->reaching, slot_defs, defs->flow->num_words);
+		bitset_set(fold->reaching, fold->next_def++);
+		return;
+	}
+	
+	// compound assignments and steps read the variable in place
+	if (!fold->propagate || site->type != EXPR_VALUE)
+		return;
+	
+	const heck_literal* constant = NULL;
+	int num_defs = defs->flow->num_bits;
+	for (int def = bitset_next(slot_defs, 0, num_defs); def >= 0; def = bitset_next(slot_defs, def + 1, num_defs)) {
+		if (!bitset_test(fold->reaching, def))
+			continue;
+		
+		const heck_expr* stored = defs->def_vec[def].site;
+		if (stored == NULL || stored->type != EXPR_LITERAL)
+			return;
+		if (constant != NULL && !literal_equal(constant, &stored->value.literal))
+			return;
+		constant = &stored->value.literal;
+	}
+	
+	if (constant != NULL)
+		expr_set_literal(site, *constant);
+}
+
+// folds the statements of each block, replacing reads of constant variables first
+static void fold_cfg(heck_cfg* cfg, bool propagate) {
+	heck_reaching_defs* defs = flow_reaching_defs(cfg);
+	heck_flow* flow = defs->flow;
+	
+	// the definitions of a block are numbered in order, starting after the parameters
+	int num_blocks = cfg_num_blocks(cfg);
+	int* first_def = mem_alloc(num_blocks * sizeof(int), MEM_FLOW);
+	for (int i = num_blocks - 1; i >= 0; --i)
+		first_def[i] = -1;
+	int num_defs = (int)vector_size(defs->def_vec);
+	for (int i = (int)vector_size(cfg->func->param_vec); i < num_defs; ++i) {
+		if (first_def[defs->def_vec[i].block] == -1)
+			first_def[defs->def_vec[i].block] = i;
+	}
+	
+	fold_ctx ctx = { defs, bitset_create(1, flow->num_words), 0, propagate };
+	for (int b = 0; b < num_blocks; ++b) {
+		heck_cfg_block* block = &cfg->block_vec[b];
+		bool reachable = cfg_reachable(cfg, b);
+		if (reachable) {
+			bitset_copy(ctx.reaching, flow_set(flow, flow->in, b), flow->num_words);
+			ctx.next_def = first_def[b];
+		}
+		
+		// nothing reaches statements that can't be reached, so they're only folded
+		vec_size_t num_stmts = vector_size(block->stmt_vec);
+		for (vec_size_t i = 0; i < num_stmts; ++i) {
+			if (reachable)
+				flow_walk_stmt(block->stmt_vec[i], fold_visit, &ctx);
+			fold_stmt(block->stmt_vec[i]);
+		}
+		if (block->condition != NULL) {
+			if (reachable)
+				flow_walk_expr(block->condition, fold_visit, &ctx);
+			fold_expr(block->condition);
+		}
+	}
+	
+	bitset_free(ctx.reaching);
+	mem_free(first_def);
+	reaching_defs_free(defs);
+}
+
+/*
+ *	Pruning
+ */
+
+// true if the statement returns on every path through it
+static bool stmt_returns(const heck_stmt* stmt) {
+	switch (stmt->type) {
+		case STMT_RET:
+			return true;
+		case STMT_IF:
+			return stmt->value.if_stmt->type == BLOCK_RETURNS;
+		case STMT_BLOCK:
+			return stmt->value.block->type == BLOCK_RETURNS;
+		default:
+			return false;
+	}
+}
+
+// removes the branches of if statements that can't be taken, returns true if anything was removed
+static bool prune_block(heck_block* block) {
+	bool pruned = false;
+	
+	vec_size_t i = 0;
+	while (i < vector_size(block->stmt_vec)) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		if (stmt->type == STMT_BLOCK) {
+			pruned = prune_block(stmt->value.block) || pruned;
+			++i;
+			continue;
+		} else if (stmt->type != STMT_IF) {
+			++i;
+			continue;
+		}
+		
+		heck_stmt_if* if_stmt = stmt->value.if_stmt;
+		heck_if_node** link = &if_stmt->contents;
+		while (*link != NULL) {
+			heck_if_node* node = *link;
+			heck_expr* condition = node->condition;
+			int truthy = condition != NULL && condition->type == EXPR_LITERAL ? literal_truthy(&condition->value.literal) : -1;
+			
+			if (truthy == 0) {
+				*link = node->next;
+				pruned = true;
+				continue;
+			}
+			
+			// the rest of the ladder can't be reached
+			if (truthy == 1) {
+				node->condition = NULL;
+				node->next = NULL;
+				pruned = true;
+			}
+			
+			pruned = prune_block(node->code) || pruned;
+			link = &node->next;
+		}
+		
+		if (if_stmt->contents == NULL) {
+			vector_remove(block->stmt_vec, i);
+			continue;
+		}
+		
+		// only a block without a condition is left
+		if (if_stmt->contents->condition == NULL) {
+			stmt->type = STMT_BLOCK;
+			stmt->vtable = &stmt_vtable_block;
+			stmt->value.block = if_stmt->contents->code;
+		}
+		++i;
+	}
+	
+	// the statements after one that always returns can't be reached
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (i = 0; i + 1 < num_stmts; ++i) {
+		if (stmt_returns(block->stmt_vec[i])) {
+			vector_erase(block->stmt_vec, i + 1, num_stmts - i - 1);
+			pruned = true;
+			break;
+		}
+	}
+	
+	return pruned;
+}
+
+void fold_func(heck_func* func) {
+	// pruning takes definitions off of some paths, so the variables are propagated again
+	bool pruned = true;
+	while (pruned) {
+		heck_cfg* cfg = cfg_build(func);
+		fold_cfg(cfg, !func->has_nested);
+		cfg_free(cfg);
+		
+		pruned = prune_block(func->code);
+	}
+}
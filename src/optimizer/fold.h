@@ -0,0 +1,34 @@
+//
+//  fold.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Constant folding for resolved code. Subexpressions with constant operands are evaluated
+//	the same way they would be at run time and replaced with literals, branches with
+//	constant conditions are pruned, and so are statements that come after a return.
+//
+
+#ifndef fold_h
+#define fold_h
+
+#include <stdbool.h>
+#include "expression.h"
+#include "declarations.h"
+
+// evaluates an arithmetic operator or a comparison on numeric literals. an int and a float give a float,
+// ints wrap around on overflow like they do at run time. returns false if the operation has to be left
+// for run time, like a division by zero, which traps
+bool fold_numeric(heck_tk_type operator, const heck_literal* a, const heck_literal* b, heck_literal* result);
+
+// folds the constant subexpressions of a resolved expression, returns true if it became a literal.
+// shared variables are replaced with their values unless their fold_status was set to RESOLVE_FAILED
+// because they're assigned somewhere, so every assignment has to be found first
+bool fold_expr(heck_expr* expr);
+
+// folds the body of a resolved function. local variables are replaced with their values where every
+// definition that reaches them assigns the same constant, then if statements with constant conditions
+// and statements that can't be reached after a return are pruned
+void fold_func(heck_func* func);
+
+#endif /* fold_h */
@@ -0,0 +1,569 @@
+//
+//  inline.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "inline.h"
+#include <stdlib.h>
+#include <limits.h>
+#include "function.h"
+#include "scope.h"
+#include "statement.h"
+#include "vec.h"
+#include "mem.h"
+
+// what a call costs in expression nodes, counting the frame and the return
+#define INLINE_CALL_COST 8
+
+// a constant argument usually lets part of the inlined expression fold away
+#define INLINE_CONST_ARG_BONUS 4
+
+// callees with more nodes than this are never inlined
+#define INLINE_MAX_SIZE 32
+
+// a body can always grow by this many nodes, even if it's small
+#define INLINE_MIN_BUDGET 32
+
+/*
+ *	Expressions
+ */
+
+static int expr_size(const heck_expr* expr) {
+	switch (expr->type) {
+		case EXPR_BINARY:
+			return 1 + expr_size(expr->value.binary.left) + expr_size(expr->value.binary.right);
+		case EXPR_UNARY:
+			return 1 + expr_size(expr->value.unary.expr);
+		case EXPR_TERNARY: {
+			const heck_expr_ternary* ternary = &expr->value.ternary;
+			return 1 + expr_size(ternary->condition) + expr_size(ternary->value_a) + expr_size(ternary->value_b);
+		}
+		case EXPR_CALL: {
+			const heck_expr_call* call = &expr->value.call;
+			int size = 1 + expr_size(call->operand);
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				size += expr_size(call->arg_vec[i]);
+			return size;
+		}
+		case EXPR_CAST:
+			return 1 + expr_size(expr->value.expr);
+		default:
+			return 1;
+	}
+}
+
+static bool expr_is_step(const heck_expr* expr) {
+	return expr->vtable == &expr_vtable_pre_incr || expr->vtable == &expr_vtable_pre_decr ||
+		expr->vtable == &expr_vtable_post_incr || expr->vtable == &expr_vtable_post_decr;
+}
+
+// integer division traps if the divisor is 0, or if it's -1 and the quotient overflows
+static bool division_can_trap(const heck_expr* expr) {
+	if (expr->vtable != &expr_vtable_div && expr->vtable != &expr_vtable_mod)
+		return false;
+	
+	const heck_expr* divisor = expr->value.binary.right;
+	if (divisor->type != EXPR_LITERAL)
+		return true;
+	
+	const heck_literal* literal = &divisor->value.literal;
+	if (literal->data_type->type_name == TYPE_FLOAT)
+		return false;
+	return literal->data_type->type_name != TYPE_INT || literal->value.int_value == 0 || literal->value.int_value == -1;
+}
+
+// true if evaluating the expression can't change anything or trap, so it can be evaluated any number of times
+static bool expr_pure(const heck_expr* expr) {
+	switch (expr->type) {
+		case EXPR_LITERAL:
+		case EXPR_VALUE:
+			return true;
+		case EXPR_BINARY:
+			if (expr->vtable == &expr_vtable_asg || division_can_trap(expr))
+				return false;
+			return expr_pure(expr->value.binary.left) && expr_pure(expr->value.binary.right);
+		case EXPR_UNARY:
+			return !expr_is_step(expr) && expr_pure(expr->value.unary.expr);
+		case EXPR_TERNARY: {
+			const heck_expr_ternary* ternary = &expr->value.ternary;
+			return expr_pure(ternary->condition) && expr_pure(ternary->value_a) && expr_pure(ternary->value_b);
+		}
+		case EXPR_CAST:
+			return expr_pure(expr->value.expr);
+		default:
+			return false;
+	}
+}
+
+// true if the expression is pure and only reads parameters, so nothing else can change its value
+static bool expr_reads_params(const heck_expr* expr) {
+	switch (expr->type) {
+		case EXPR_LITERAL:
+			return true;
+		case EXPR_VALUE:
+			return expr->value.value.slot >= 0;
+		case EXPR_BINARY:
+			if (expr->vtable == &expr_vtable_asg || division_can_trap(expr))
+				return false;
+			return expr_reads_params(expr->value.binary.left) && expr_reads_params(expr->value.binary.right);
+		case EXPR_UNARY:
+			return !expr_is_step(expr) && expr_reads_params(expr->value.unary.expr);
+		case EXPR_TERNARY: {
+			const heck_expr_ternary* ternary = &expr->value.ternary;
+			return expr_reads_params(ternary->condition) && expr_reads_params(ternary->value_a) &&
+				expr_reads_params(ternary->value_b);
+		}
+		case EXPR_CAST:
+			return expr_reads_params(expr->value.expr);
+		default:
+			return false;
+	}
+}
+
+/*
+ *	Callees
+ */
+
+// the expression a call can be replaced with, NULL if the body is more than one expression.
+// the value of a call that is discarded can be replaced with an expression statement too
+static heck_expr* inline_body(heck_func* callee, bool discarded) {
+	heck_block* block = callee->code;
+	while (vector_size(block->stmt_vec) == 1) {
+		heck_stmt* stmt = block->stmt_vec[0];
+		switch (stmt->type) {
+			case STMT_RET:
+				return stmt->value.expr;
+			case STMT_EXPR:
+				return discarded ? stmt->value.expr : NULL;
+			case STMT_BLOCK:
+				block = stmt->value.block;
+				if (block->scope->names != NULL && idf_map_size(block->scope->names) > 0)
+					return NULL;
+				break;
+			default:
+				return NULL;
+		}
+	}
+	return NULL;
+}
+
+// true if the expression can be moved into another function. it can read and write names outside of
+// functions and classes, and read its parameters, which are the only locals the callee can have
+static bool callee_expr_valid(const heck_expr* expr, int num_params) {
+	switch (expr->type) {
+		case EXPR_LITERAL:
+			return true;
+		case EXPR_VALUE: {
+			const heck_expr_value* value = &expr->value.value;
+			if (value->resolved == NULL || value->context == CONTEXT_THIS)
+				return false;
+			if (value->slot >= 0)
+				return value->depth == 0 && value->slot < num_params;
+			
+			heck_scope* parent = value->resolved->parent;
+			return parent->func == NULL && !scope_is_class(parent);
+		}
+		case EXPR_BINARY: {
+			const heck_expr_binary* binary = &expr->value.binary;
+			
+			// a parameter would become the caller's argument, so it can't be assigned
+			if (expr->vtable == &expr_vtable_asg && binary->left->type == EXPR_VALUE && binary->left->value.value.slot >= 0)
+				return false;
+			return callee_expr_valid(binary->left, num_params) && callee_expr_valid(binary->right, num_params);
+		}
+		case EXPR_UNARY: {
+			const heck_expr* operand = expr->value.unary.expr;
+			if (expr_is_step(expr) && operand->type == EXPR_VALUE && operand->value.value.slot >= 0)
+				return false;
+			return callee_expr_valid(operand, num_params);
+		}
+		case EXPR_TERNARY: {
+			const heck_expr_ternary* ternary = &expr->value.ternary;
+			return callee_expr_valid(ternary->condition, num_params) && callee_expr_valid(ternary->value_a, num_params) &&
+				callee_expr_valid(ternary->value_b, num_params);
+		}
+		case EXPR_CALL: {
+			const heck_expr_call* call = &expr->value.call;
+			if (call->func == NULL || !callee_expr_valid(call->operand, num_params))
+				return false;
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i) {
+				if (!callee_expr_valid(call->arg_vec[i], num_params))
+					return false;
+			}
+			return true;
+		}
+		case EXPR_CAST:
+			return callee_expr_valid(expr->value.expr, num_params);
+		default:
+			return false;
+	}
+}
+
+/*
+ *	Substitution
+ */
+
+typedef struct inline_param {
+	heck_expr* value; // the argument, or the default value if the call doesn't have one
+	int uses; // how many times the callee reads the parameter
+	bool conditional; // one of the reads is skipped on some paths, by && || or ?:
+	bool moved; // the value is already in the tree, so the next reads use copies of it
+} inline_param;
+
+static void count_uses(const heck_expr* expr, inline_param* params, bool conditional) {
+	switch (expr->type) {
+		case EXPR_VALUE: {
+			int slot = expr->value.value.slot;
+			if (slot >= 0) {
+				params[slot].uses++;
+				params[slot].conditional = params[slot].conditional || conditional;
+			}
+			break;
+		}
+		case EXPR_BINARY: {
+			bool short_circuit = expr->vtable == &expr_vtable_and || expr->vtable == &expr_vtable_or;
+			count_uses(expr->value.binary.left, params, conditional);
+			count_uses(expr->value.binary.right, params, conditional || short_circuit);
+			break;
+		}
+		case EXPR_UNARY:
+			count_uses(expr->value.unary.expr, params, conditional);
+			break;
+		case EXPR_TERNARY:
+			count_uses(expr->value.ternary.condition, params, conditional);
+			count_uses(expr->value.ternary.value_a, params, true);
+			count_uses(expr->value.ternary.value_b, params, true);
+			break;
+		case EXPR_CALL: {
+			const heck_expr_call* call = &expr->value.call;
+			count_uses(call->operand, params, conditional);
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				count_uses(call->arg_vec[i], params, conditional);
+			break;
+		}
+		case EXPR_CAST:
+			count_uses(expr->value.expr, params, conditional);
+			break;
+		default:
+			break;
+	}
+}
+
+// copies an expression from the callee, with the parameters replaced with their values.
+// params is NULL for copies of the values, which are already in terms of the caller
+static heck_expr* inline_copy(const heck_expr* expr, inline_param* params) {
+	heck_expr* copy;
+	switch (expr->type) {
+		case EXPR_VALUE: {
+			const heck_expr_value* value = &expr->value.value;
+			if (params != NULL && value->slot >= 0) {
+				inline_param* param = &params[value->slot];
+				if (!param->moved) {
+					param->moved = true;
+					return param->value;
+				}
+				return inline_copy(param->value, NULL);
+			}
+			
+			copy = create_expr_value(value->name, value->context);
+			copy->value.value.resolved = value->resolved;
+			copy->value.value.depth = value->depth;
+			copy->value.value.slot = value->slot;
+			break;
+		}
+		case EXPR_LITERAL:
+			copy = create_expr_literal(&expr->value.literal);
+			break;
+		case EXPR_BINARY: {
+			const heck_expr_binary* binary = &expr->value.binary;
+			heck_expr* left = inline_copy(binary->left, params);
+			copy = create_expr_binary(left, binary->operator, inline_copy(binary->right, params), expr->vtable);
+			break;
+		}
+		case EXPR_UNARY:
+			copy = create_expr_unary(inline_copy(expr->value.unary.expr, params), expr->value.unary.operator, expr->vtable);
+			break;
+		case EXPR_TERNARY: {
+			const heck_expr_ternary* ternary = &expr->value.ternary;
+			heck_expr* condition = inline_copy(ternary->condition, params);
+			heck_expr* value_a = inline_copy(ternary->value_a, params);
+			copy = create_expr_ternary(condition, value_a, inline_copy(ternary->value_b, params));
+			break;
+		}
+		case EXPR_CALL: {
+			const heck_expr_call* call = &expr->value.call;
+			copy = create_expr_call(inline_copy(call->operand, params));
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				vector_add(&copy->value.call.arg_vec, inline_copy(call->arg_vec[i], params));
+			copy->value.call.type_arg_vec = call->type_arg_vec;
+			copy->value.call.func = call->func;
+			break;
+		}
+		case EXPR_CAST:
+			copy = create_expr_cast(expr->data_type, inline_copy(expr->value.expr, params));
+			break;
+		default:
+			// callee_expr_valid only lets the types above through
+			copy = create_expr_err();
+			break;
+	}
+	
+	copy->data_type = expr->data_type;
+	return copy;
+}
+
+/*
+ *	Call sites
+ */
+
+typedef struct inline_site {
+	heck_expr* expr; // the call
+	heck_expr* body; // the expression from the callee that replaces it
+	int score; // what inlining saves, minus roughly how much it grows the code
+	int order; // sites with the same score are inlined in the order they were found
+} inline_site;
+
+typedef struct inline_ctx {
+	heck_func* func;
+	inline_site* site_vec;
+	int size; // expression nodes in the body
+} inline_ctx;
+
+static int inline_site_cmp(const void* a, const void* b) {
+	const inline_site* site_a = a;
+	const inline_site* site_b = b;
+	if (site_a->score != site_b->score)
+		return site_a->score > site_b->score ? -1 : 1;
+	return site_a->order - site_b->order;
+}
+
+static void inline_find_site(inline_ctx* ctx, heck_expr* expr, bool discarded) {
+	heck_func* callee = expr->value.call.func;
+	if (callee == NULL || callee == ctx->func || callee->has_nested)
+		return;
+	
+	// a callee that is still being optimized is further up the call stack, so inlining it could go on forever
+	if (callee->opt_status == RESOLVE_ACTIVE)
+		return;
+	
+	// methods read the object they're called on and nested functions read their parent's frame
+	heck_scope* scope = callee->code->scope;
+	if (scope->class != NULL || scope->parent->func != NULL)
+		return;
+	
+	heck_expr* body = inline_body(callee, discarded);
+	if (body == NULL || !callee_expr_valid(body, (int)vector_size(callee->param_vec)))
+		return;
+	
+	int body_size = expr_size(body);
+	if (body_size > INLINE_MAX_SIZE)
+		return;
+	
+	// the arguments are already part of the caller, the body replaces the call and the operand
+	int score = INLINE_CALL_COST - (body_size - 2);
+	const heck_expr_call* call = &expr->value.call;
+	vec_size_t num_args = vector_size(call->arg_vec);
+	for (vec_size_t i = 0; i < num_args; ++i) {
+		if (call->arg_vec[i]->type == EXPR_LITERAL)
+			score += INLINE_CONST_ARG_BONUS;
+	}
+	
+	inline_site site = { expr, body, score, (int)vector_size(ctx->site_vec) };
+	vector_add(&ctx->site_vec, site);
+}
+
+// calls in the arguments are found before the calls they're passed to
+static void inline_find_sites(inline_ctx* ctx, heck_expr* expr, bool discarded) {
+	switch (expr->type) {
+		case EXPR_BINARY:
+			inline_find_sites(ctx, expr->value.binary.left, false);
+			inline_find_sites(ctx, expr->value.binary.right, false);
+			break;
+		case EXPR_UNARY:
+			inline_find_sites(ctx, expr->value.unary.expr, false);
+			break;
+		case EXPR_TERNARY:
+			inline_find_sites(ctx, expr->value.ternary.condition, false);
+			inline_find_sites(ctx, expr->value.ternary.value_a, false);
+			inline_find_sites(ctx, expr->value.ternary.value_b, false);
+			break;
+		case EXPR_CALL: {
+			heck_expr_call* call = &expr->value.call;
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				inline_find_sites(ctx, call->arg_vec[i], false);
+			inline_find_site(ctx, expr, discarded);
+			break;
+		}
+		case EXPR_CAST:
+			inline_find_sites(ctx, expr->value.expr, false);
+			break;
+		default:
+			break;
+	}
+}
+
+static void inline_find_root(inline_ctx* ctx, heck_expr* expr, bool discarded) {
+	ctx->size += expr_size(expr);
+	inline_find_sites(ctx, expr, discarded);
+}
+
+static void inline_find_block(inline_ctx* ctx, heck_block* block) {
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		switch (stmt->type) {
+			case STMT_EXPR:
+				inline_find_root(ctx, stmt->value.expr, true);
+				break;
+			case STMT_LET:
+				if (stmt->value.let_stmt->value != NULL)
+					inline_find_root(ctx, stmt->value.let_stmt->value, false);
+				break;
+			case STMT_RET:
+				if (stmt->value.expr != NULL)
+					inline_find_root(ctx, stmt->value.expr, false);
+				break;
+			case STMT_IF:
+				for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next) {
+					if (node->condition != NULL)
+						inline_find_root(ctx, node->condition, false);
+					inline_find_block(ctx, node->code);
+				}
+				break;
+			case STMT_BLOCK:
+				inline_find_block(ctx, stmt->value.block);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+// a value is stable if nothing the inlined expression does can change it
+static bool value_stable(const inline_ctx* ctx, const heck_expr* value) {
+	if (value->type == EXPR_LITERAL)
+		return true;
+	
+	// only nested functions could write the caller's locals during a call
+	return value->type == EXPR_VALUE && value->value.value.slot >= 0 && value->value.value.depth == 0 && !ctx->func->has_nested;
+}
+
+// checks that the arguments are evaluated the same number of times and in the same order as they would be
+// by the call, then returns how much the code grows, or INT_MAX if the call can't be inlined
+static int inline_growth(const inline_ctx* ctx, const inline_site* site, inline_param* params, vec_size_t num_params) {
+	bool body_pure = expr_pure(site->body);
+	
+	int growth = expr_size(site->body) - expr_size(site->expr);
+	int num_impure = 0;
+	int num_literals = 0;
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		const inline_param* param = &params[i];
+		const heck_expr* value = param->value;
+		growth += param->uses * (expr_size(value) - 1);
+		if (value->type == EXPR_LITERAL)
+			++num_literals;
+		
+		if (value_stable(ctx, value))
+			continue;
+		
+		// the callee could change a value that's read after the first thing it does
+		if (expr_pure(value)) {
+			if (param->uses > 0 && !body_pure)
+				return INT_MAX;
+			continue;
+		}
+		
+		// an argument with side effects has to be evaluated exactly once, before anything it could affect
+		if (param->uses != 1 || param->conditional)
+			return INT_MAX;
+		++num_impure;
+	}
+	
+	if (num_impure > 0 && (num_impure > 1 || num_literals < (int)num_params - 1 || !expr_reads_params(site->body)))
+		return INT_MAX;
+	
+	int benefit = INLINE_CALL_COST + INLINE_CONST_ARG_BONUS * num_literals;
+	return growth <= benefit ? growth : INT_MAX;
+}
+
+// the value of each parameter for a call, false if one of them isn't known or has the wrong type
+static bool inline_params(const heck_expr_call* call, inline_param* params) {
+	heck_func* callee = call->func;
+	vec_size_t num_args = vector_size(call->arg_vec);
+	vec_size_t num_params = vector_size(callee->param_vec);
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		heck_param* param = callee->param_vec[i];
+		
+		// default values belong to the callee, so they're always copied
+		if (i < num_args) {
+			params[i].value = call->arg_vec[i];
+		} else if (param->def_val != NULL && param->def_val->type == EXPR_LITERAL) {
+			params[i].value = param->def_val;
+			params[i].moved = true;
+		} else {
+			return false;
+		}
+		
+		if (!data_type_cmp(params[i].value->data_type, param->type))
+			return false;
+	}
+	return true;
+}
+
+// returns true if the call was inlined
+static bool inline_site_apply(inline_ctx* ctx, vec_size_t index, int* budget) {
+	inline_site* site = &ctx->site_vec[index];
+	heck_expr_call* call = &site->expr->value.call;
+	vec_size_t num_params = vector_size(call->func->param_vec);
+	if (vector_size(call->arg_vec) > num_params)
+		return false;
+	
+	inline_param* params = mem_calloc(num_params, sizeof(inline_param), MEM_AST);
+	int growth = INT_MAX;
+	if (inline_params(call, params)) {
+		count_uses(site->body, params, false);
+		growth = inline_growth(ctx, site, params, num_params);
+	}
+	
+	if (growth == INT_MAX || growth > *budget) {
+		mem_free(params);
+		return false;
+	}
+	if (growth > 0)
+		*budget -= growth;
+	
+	heck_expr* value = inline_copy(site->body, params);
+	move_expr(site->expr, value);
+	mem_free(params);
+	
+	// the value can be one of the arguments, which could be another site
+	for (vec_size_t i = index + 1; i < vector_size(ctx->site_vec); ++i) {
+		if (ctx->site_vec[i].expr == value)
+			ctx->site_vec[i].expr = site->expr;
+	}
+	
+	return true;
+}
+
+bool inline_func(heck_func* func) {
+	inline_ctx ctx = { func, vector_create(), 0 };
+	inline_find_block(&ctx, func->code);
+	
+	vec_size_t num_sites = vector_size(ctx.site_vec);
+	qsort(ctx.site_vec, num_sites, sizeof(inline_site), inline_site_cmp);
+	
+	int budget = INLINE_MIN_BUDGET + ctx.size / 2;
+	bool inlined = false;
+	for (vec_size_t i = 0; i < num_sites; ++i)
+		inlined = inline_site_apply(&ctx, i, &budget) || inlined;
+	
+	vector_free(ctx.site_vec);
+	return inlined;
+}
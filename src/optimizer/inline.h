@@ -0,0 +1,25 @@
+//
+//  inline.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Inlining for resolved code. Calls to functions whose body is a single expression are replaced
+//	with that expression, with the arguments in place of the parameters, so small functions don't
+//	cost a call and constant arguments can be folded into the caller.
+//
+
+#ifndef inline_h
+#define inline_h
+
+#include <stdbool.h>
+#include "declarations.h"
+
+// inlines the calls in the body of a resolved function that are worth it. the body should be folded
+// before, so constant arguments count, and again after, so the inlined code is folded with them.
+// heck_optimize works on callees first, so calls to functions it's still working on, like recursive
+// calls, are left alone. the body can grow by about half of its size at most.
+// returns true if anything was inlined
+bool inline_func(heck_func* func);
+
+#endif /* inline_h */
@@ -0,0 +1,379 @@
+//
+//  optimize.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "optimize.h"
+#include "code_impl.h"
+#include "scope.h"
+#include "class.h"
+#include "function.h"
+#include "overload.h"
+#include "statement.h"
+#include "fold.h"
+#include "inline.h"
+#include "shake.h"
+#include "vec.h"
+
+/*
+ *	Scanning finds every function that was resolved, and every shared variable that is assigned
+ *	somewhere, before anything is rewritten.
+ */
+
+typedef struct optimize_ctx {
+	heck_func** func_vec; // resolved functions and generic instances, in the order they were found
+	int opt_level;
+} optimize_ctx;
+
+static void scan_block(optimize_ctx* ctx, heck_block* block);
+static void scan_scope(optimize_ctx* ctx, heck_scope* scope);
+
+static void scan_target(heck_expr* expr) {
+	if (expr->type == EXPR_VALUE && expr->value.value.resolved != NULL)
+		expr->value.value.resolved->fold_status = RESOLVE_FAILED;
+}
+
+// marks the variables that are assigned, or changed with ++ and --
+static void scan_expr(heck_expr* expr) {
+	switch (expr->type) {
+		case EXPR_BINARY:
+			if (expr->vtable == &expr_vtable_asg)
+				scan_target(expr->value.binary.left);
+			scan_expr(expr->value.binary.left);
+			scan_expr(expr->value.binary.right);
+			break;
+		case EXPR_UNARY:
+			if (expr->value.unary.operator == TK_OP_INCR || expr->value.unary.operator == TK_OP_DECR)
+				scan_target(expr->value.unary.expr);
+			scan_expr(expr->value.unary.expr);
+			break;
+		case EXPR_TERNARY:
+			scan_expr(expr->value.ternary.condition);
+			scan_expr(expr->value.ternary.value_a);
+			scan_expr(expr->value.ternary.value_b);
+			break;
+		case EXPR_CALL: {
+			heck_expr_call* call = &expr->value.call;
+			scan_expr(call->operand);
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				scan_expr(call->arg_vec[i]);
+			break;
+		}
+		case EXPR_CAST:
+			scan_expr(expr->value.expr);
+			break;
+		default:
+			break;
+	}
+}
+
+static void scan_root(void* ctx, heck_expr* expr) {
+	scan_expr(expr);
+}
+
+// calls visit with each expression in the block that isn't part of another one
+static void walk_block(heck_block* block, void (*visit)(void*, heck_expr*), void* ctx) {
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		switch (stmt->type) {
+			case STMT_EXPR:
+			case STMT_RET:
+				if (stmt->value.expr != NULL)
+					visit(ctx, stmt->value.expr);
+				break;
+			case STMT_LET:
+				if (stmt->value.let_stmt->value != NULL)
+					visit(ctx, stmt->value.let_stmt->value);
+				break;
+			case STMT_IF:
+				for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next) {
+					if (node->condition != NULL)
+						visit(ctx, node->condition);
+					walk_block(node->code, visit, ctx);
+				}
+				break;
+			case STMT_BLOCK:
+				walk_block(stmt->value.block, visit, ctx);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void scan_func(optimize_ctx* ctx, heck_func* func) {
+	// each instance of a generic function has its own body
+	if (func->generic) {
+		heck_func** inst_vec = vector_create();
+		func_gen_instances(func, &inst_vec);
+		vec_size_t num_insts = vector_size(inst_vec);
+		for (vec_size_t i = 0; i < num_insts; ++i)
+			scan_func(ctx, inst_vec[i]);
+		vector_free(inst_vec);
+		return;
+	}
+	
+	vec_size_t num_params = vector_size(func->param_vec);
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		if (func->param_vec[i]->def_val != NULL)
+			scan_expr(func->param_vec[i]->def_val);
+	}
+	
+	// bodies that were never needed were never parsed
+	if (func->status != RESOLVE_DONE)
+		return;
+	
+	vector_add(&ctx->func_vec, func);
+	walk_block(func->code, scan_root, NULL);
+	scan_block(ctx, func->code);
+}
+
+static void scan_name(str_entry key, void* value, void* user_ptr) {
+	heck_name* name = value;
+	optimize_ctx* ctx = user_ptr;
+	
+	switch (name->type) {
+		case IDF_FUNCTION: {
+			heck_func** func_vec = name->value.func_value.func_vec;
+			vec_size_t num_funcs = vector_size(func_vec);
+			for (vec_size_t i = 0; i < num_funcs; ++i)
+				scan_func(ctx, func_vec[i]);
+			break;
+		}
+		case IDF_CLASS:
+		case IDF_UNDECLARED_CLASS: {
+			heck_class* class = name->value.class_value;
+			if (class != NULL) {
+				vec_size_t num_overloads = vector_size(class->op_overloads);
+				for (vec_size_t i = 0; i < num_overloads; ++i) {
+					heck_func** func_vec = class->op_overloads[i].overloads.func_vec;
+					vec_size_t num_funcs = vector_size(func_vec);
+					for (vec_size_t j = 0; j < num_funcs; ++j)
+						scan_func(ctx, func_vec[j]);
+				}
+			}
+			if (name->child_scope != NULL)
+				scan_scope(ctx, name->child_scope);
+			break;
+		}
+		case IDF_NAMESPACE:
+			if (name->child_scope != NULL)
+				scan_scope(ctx, name->child_scope);
+			break;
+		default:
+			break;
+	}
+}
+
+static void scan_scope(optimize_ctx* ctx, heck_scope* scope) {
+	if (scope->names != NULL)
+		idf_map_iterate(scope->names, scan_name, ctx);
+	
+	// member variables are assigned with each instance
+	if (scope->decl_vec != NULL) {
+		vec_size_t num_decls = vector_size(scope->decl_vec);
+		for (vec_size_t i = 0; i < num_decls; ++i) {
+			heck_stmt* decl = scope->decl_vec[i];
+			if (decl->type == STMT_LET && decl->value.let_stmt->value != NULL)
+				scan_expr(decl->value.let_stmt->value);
+		}
+	}
+}
+
+// finds the functions declared in the block and the blocks inside of it
+static void scan_block(optimize_ctx* ctx, heck_block* block) {
+	scan_scope(ctx, block->scope);
+	
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		if (stmt->type == STMT_BLOCK) {
+			scan_block(ctx, stmt->value.block);
+		} else if (stmt->type == STMT_IF) {
+			for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next)
+				scan_block(ctx, node->code);
+		}
+	}
+}
+
+/*
+ *	Shared variables are zero until their let statement runs, so they're only replaced with their
+ *	values if nothing can read them before that: the global code can't read them before the statement,
+ *	and no functions can be called before it.
+ */
+
+typedef struct order_ctx {
+	heck_name** init_vec; // the variables whose let statements ran, marked with RESOLVE_DONE for now
+	bool called; // a function could have been called, so it could have read any variable
+} order_ctx;
+
+static void order_expr(order_ctx* ctx, heck_expr* expr) {
+	switch (expr->type) {
+		case EXPR_VALUE: {
+			heck_name* name = expr->value.value.resolved;
+			if (name != NULL && name->fold_status == RESOLVE_PENDING)
+				name->fold_status = RESOLVE_FAILED;
+			break;
+		}
+		case EXPR_BINARY:
+			order_expr(ctx, expr->value.binary.left);
+			order_expr(ctx, expr->value.binary.right);
+			break;
+		case EXPR_UNARY:
+			order_expr(ctx, expr->value.unary.expr);
+			break;
+		case EXPR_TERNARY:
+			order_expr(ctx, expr->value.ternary.condition);
+			order_expr(ctx, expr->value.ternary.value_a);
+			order_expr(ctx, expr->value.ternary.value_b);
+			break;
+		case EXPR_CALL: {
+			heck_expr_call* call = &expr->value.call;
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				order_expr(ctx, call->arg_vec[i]);
+			ctx->called = true;
+			break;
+		}
+		case EXPR_CAST:
+			order_expr(ctx, expr->value.expr);
+			break;
+		default:
+			break;
+	}
+}
+
+// goes through the global code in the order it runs
+static void order_block(order_ctx* ctx, heck_block* block) {
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		switch (stmt->type) {
+			case STMT_EXPR:
+			case STMT_RET:
+				if (stmt->value.expr != NULL)
+					order_expr(ctx, stmt->value.expr);
+				break;
+			case STMT_LET: {
+				heck_stmt_let* let_stmt = stmt->value.let_stmt;
+				if (let_stmt->value != NULL)
+					order_expr(ctx, let_stmt->value);
+				
+				heck_name* name = NULL;
+				if (block->scope->names == NULL || !idf_map_get(block->scope->names, let_stmt->name, (void*)&name))
+					break;
+				if (ctx->called) {
+					name->fold_status = RESOLVE_FAILED;
+				} else if (name->fold_status == RESOLVE_PENDING) {
+					name->fold_status = RESOLVE_DONE;
+					vector_add(&ctx->init_vec, name);
+				}
+				break;
+			}
+			case STMT_IF:
+				for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next) {
+					if (node->condition != NULL)
+						order_expr(ctx, node->condition);
+					order_block(ctx, node->code);
+				}
+				break;
+			case STMT_BLOCK:
+				order_block(ctx, stmt->value.block);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+/*
+ *	Optimizing
+ */
+
+static void fold_root(void* ctx, heck_expr* expr) {
+	fold_expr(expr);
+}
+
+static void optimize_func(optimize_ctx* ctx, heck_func* func);
+
+static void optimize_callees(void* ctx, heck_expr* expr) {
+	switch (expr->type) {
+		case EXPR_BINARY:
+			optimize_callees(ctx, expr->value.binary.left);
+			optimize_callees(ctx, expr->value.binary.right);
+			break;
+		case EXPR_UNARY:
+			optimize_callees(ctx, expr->value.unary.expr);
+			break;
+		case EXPR_TERNARY:
+			optimize_callees(ctx, expr->value.ternary.condition);
+			optimize_callees(ctx, expr->value.ternary.value_a);
+			optimize_callees(ctx, expr->value.ternary.value_b);
+			break;
+		case EXPR_CALL: {
+			heck_expr_call* call = &expr->value.call;
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				optimize_callees(ctx, call->arg_vec[i]);
+			if (call->func != NULL && call->func->status == RESOLVE_DONE)
+				optimize_func(ctx, call->func);
+			break;
+		}
+		case EXPR_CAST:
+			optimize_callees(ctx, expr->value.expr);
+			break;
+		default:
+			break;
+	}
+}
+
+// callees are optimized first, so the expressions that are inlined are already folded
+static void optimize_func(optimize_ctx* ctx, heck_func* func) {
+	if (func->opt_status != RESOLVE_PENDING)
+		return;
+	func->opt_status = RESOLVE_ACTIVE;
+	
+	// calls are inlined once their arguments are folded, then the inlined code is folded with them
+	if (ctx->opt_level >= 2) {
+		walk_block(func->code, optimize_callees, ctx);
+		fold_func(func);
+		if (inline_func(func))
+			fold_func(func);
+	} else {
+		fold_func(func);
+	}
+	
+	func->opt_status = RESOLVE_DONE;
+}
+
+void heck_optimize(heck_code* c, int opt_level) {
+	if (opt_level < 1)
+		return;
+	
+	optimize_ctx ctx = { vector_create(), opt_level };
+	walk_block(c->global, scan_root, NULL);
+	scan_block(&ctx, c->global);
+	
+	order_ctx order = { vector_create(), false };
+	order_block(&order, c->global);
+	vec_size_t num_init = vector_size(order.init_vec);
+	for (vec_size_t i = 0; i < num_init; ++i) {
+		if (order.init_vec[i]->fold_status == RESOLVE_DONE)
+			order.init_vec[i]->fold_status = RESOLVE_PENDING;
+	}
+	vector_free(order.init_vec);
+	
+	// the values of shared variables are folded the first time they're read
+	walk_block(c->global, fold_root, NULL);
+	vec_size_t num_funcs = vector_size(ctx.func_vec);
+	for (vec_size_t i = 0; i < num_funcs; ++i)
+		optimize_func(&ctx, ctx.func_vec[i]);
+	vector_free(ctx.func_vec);
+	
+	// functions that were inlined everywhere they're called aren't needed anymore
+	heck_shake(c);
+}
@@ -0,0 +1,22 @@
+//
+//  optimize.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Optimizations on the resolved syntax tree before it is compiled. They rewrite the tree, so they
+//	run as a separate pass after resolving, and only the ones the optimization level asks for.
+//
+
+#ifndef optimize_h
+#define optimize_h
+
+#include "code.h"
+
+// the code must be resolved without errors. -O0 leaves the tree alone, -O1 and above fold the constants
+// in every function, replace shared variables that are never assigned with their values, and remove
+// what the global code can't reach with heck_shake. -O2 also inlines small functions into their callers
+// first, after the callees are optimized
+void heck_optimize(heck_code* c, int opt_level);
+
+#endif /* optimize_h */
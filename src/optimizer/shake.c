@@ -0,0 +1,503 @@
+//
+//  shake.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "shake.h"
+#include "code_impl.h"
+#include "scope.h"
+#include "class.h"
+#include "function.h"
+#include "overload.h"
+#include "statement.h"
+#include "dep_graph.h"
+#include "vec.h"
+
+/*
+ *	Marking starts with the global code and walks every function and class it reaches.
+ *	Functions and classes are marked when they are first seen and walked later from a work list,
+ *	so each one is only walked once.
+ */
+
+typedef struct shake_ctx {
+	heck_func** func_vec; // live functions that haven't been walked yet
+	heck_name** class_vec; // live classes that haven't been walked yet
+	heck_name** live_class_vec; // every live class, in the order they were marked
+} shake_ctx;
+
+static void shake_expr(shake_ctx* ctx, heck_expr* expr);
+static void shake_block(shake_ctx* ctx, heck_block* block);
+
+static void mark_func(shake_ctx* ctx, heck_func* func) {
+	if (func->live)
+		return;
+	func->live = true;
+	vector_add(&ctx->func_vec, func);
+}
+
+static void mark_class(shake_ctx* ctx, heck_name* name) {
+	heck_class* class = name->value.class_value;
+	if (class == NULL || class->live)
+		return;
+	class->live = true;
+	vector_add(&ctx->class_vec, name);
+	vector_add(&ctx->live_class_vec, name);
+}
+
+// marks the classes that a scope is nested in
+static void mark_owners(shake_ctx* ctx, heck_scope* scope) {
+	for (; scope != NULL; scope = scope->parent) {
+		if (scope_is_class(scope))
+			mark_class(ctx, scope->class);
+	}
+}
+
+// the hierarchy only keeps the parents' heck_classes, so they are looked up by name again
+static heck_name* class_parent(const heck_name* class_name, vec_size_t i) {
+	heck_name* parent = scope_resolve_idf(class_name->value.class_value->parent_vec[i], class_name->parent);
+	return parent != NULL && parent->type == IDF_CLASS ? parent : NULL;
+}
+
+// the class of a class type or of the elements of an array type, NULL for other types
+static heck_name* type_class(const heck_data_type* type) {
+	if (type == NULL)
+		return NULL;
+	
+	type = data_type_find(type);
+	while (type->type_name == TYPE_ARR)
+		type = type->type_value.arr_type;
+	if (type->type_name != TYPE_CLASS)
+		return NULL;
+	
+	// class types keep the name they were written with
+	const heck_class_type* class_type = &type->type_value.class_type;
+	heck_name* name = scope_resolve_idf(class_type->value.name, class_type->parent);
+	return name != NULL && name->type == IDF_CLASS ? name : NULL;
+}
+
+static void shake_type(shake_ctx* ctx, const heck_data_type* type) {
+	heck_name* class_name = type_class(type);
+	if (class_name == NULL)
+		return;
+	mark_class(ctx, class_name);
+	
+	type = data_type_find(type);
+	while (type->type_name == TYPE_ARR)
+		type = type->type_value.arr_type;
+	heck_data_type** type_arg_vec = type->type_value.class_type.type_args.type_vec;
+	if (type_arg_vec != NULL) {
+		vec_size_t num_type_args = vector_size(type_arg_vec);
+		for (vec_size_t i = 0; i < num_type_args; ++i)
+			shake_type(ctx, type_arg_vec[i]);
+	}
+}
+
+// marks the overloads that an operator or a cast could call on an instance of a class.
+// overloads are inherited, so the ancestors' overloads are marked too
+static void mark_op_overloads(shake_ctx* ctx, heck_name* class_name, const heck_op_overload_type* op) {
+	heck_class* class = class_name->value.class_value;
+	
+	vec_size_t num_overloads = vector_size(class->op_overloads);
+	for (vec_size_t i = 0; i < num_overloads; ++i) {
+		heck_op_overload* overload = &class->op_overloads[i];
+		if (overload->type.cast != op->cast)
+			continue;
+		if (op->cast ? !data_type_cmp(overload->type.value.cast, op->value.cast) : overload->type.value.operator != op->value.operator)
+			continue;
+		
+		vec_size_t num_funcs = vector_size(overload->overloads.func_vec);
+		for (vec_size_t j = 0; j < num_funcs; ++j)
+			mark_func(ctx, overload->overloads.func_vec[j]);
+	}
+	
+	vec_size_t num_parents = vector_size(class->parent_vec);
+	for (vec_size_t i = 0; i < num_parents; ++i) {
+		heck_name* parent = class_parent(class_name, i);
+		if (parent != NULL)
+			mark_op_overloads(ctx, parent, op);
+	}
+}
+
+static void shake_operator(shake_ctx* ctx, const heck_expr* operand, heck_tk_type operator) {
+	heck_name* class_name = type_class(operand->data_type);
+	if (class_name == NULL)
+		return;
+	
+	heck_op_overload_type op = { .cast = false, .value.operator = operator };
+	mark_op_overloads(ctx, class_name, &op);
+}
+
+static void shake_name(shake_ctx* ctx, heck_name* name) {
+	switch (name->type) {
+		case IDF_FUNCTION: {
+			// a function that is used as a value could be any of its overloads
+			heck_func** func_vec = name->value.func_value.func_vec;
+			vec_size_t num_funcs = vector_size(func_vec);
+			for (vec_size_t i = 0; i < num_funcs; ++i)
+				mark_func(ctx, func_vec[i]);
+			break;
+		}
+		case IDF_CLASS:
+			mark_class(ctx, name);
+			break;
+		default:
+			break;
+	}
+	
+	// static members keep their class
+	if (name->slot < 0)
+		mark_owners(ctx, name->parent);
+}
+
+static void shake_expr(shake_ctx* ctx, heck_expr* expr) {
+	shake_type(ctx, expr->data_type);
+	
+	switch (expr->type) {
+		case EXPR_VALUE:
+		case EXPR_CALLBACK:
+			if (expr->value.value.resolved != NULL)
+				shake_name(ctx, expr->value.value.resolved);
+			break;
+		case EXPR_BINARY: {
+			heck_expr_binary* binary = &expr->value.binary;
+			shake_expr(ctx, binary->left);
+			shake_expr(ctx, binary->right);
+			shake_operator(ctx, binary->left, binary->operator);
+			shake_operator(ctx, binary->right, binary->operator);
+			break;
+		}
+		case EXPR_UNARY:
+			shake_expr(ctx, expr->value.unary.expr);
+			shake_operator(ctx, expr->value.unary.expr, expr->value.unary.operator);
+			break;
+		case EXPR_TERNARY:
+			shake_expr(ctx, expr->value.ternary.condition);
+			shake_expr(ctx, expr->value.ternary.value_a);
+			shake_expr(ctx, expr->value.ternary.value_b);
+			break;
+		case EXPR_CALL: {
+			heck_expr_call* call = &expr->value.call;
+			if (call->func != NULL)
+				mark_func(ctx, call->func);
+			
+			// the operand names the function, the overloads that weren't called aren't needed
+			if (call->operand->type != EXPR_VALUE)
+				shake_expr(ctx, call->operand);
+			
+			vec_size_t num_args = vector_size(call->arg_vec);
+			for (vec_size_t i = 0; i < num_args; ++i)
+				shake_expr(ctx, call->arg_vec[i]);
+			break;
+		}
+		case EXPR_CAST: {
+			shake_expr(ctx, expr->value.expr);
+			
+			heck_name* class_name = type_class(expr->value.expr->data_type);
+			if (class_name != NULL) {
+				heck_op_overload_type op = { .cast = true, .value.cast = expr->data_type };
+				mark_op_overloads(ctx, class_name, &op);
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static void shake_block(shake_ctx* ctx, heck_block* block) {
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		switch (stmt->type) {
+			case STMT_EXPR:
+			case STMT_RET:
+				if (stmt->value.expr != NULL)
+					shake_expr(ctx, stmt->value.expr);
+				break;
+			case STMT_LET:
+				if (stmt->value.let_stmt->value != NULL)
+					shake_expr(ctx, stmt->value.let_stmt->value);
+				break;
+			case STMT_IF:
+				for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next) {
+					if (node->condition != NULL)
+						shake_expr(ctx, node->condition);
+					shake_block(ctx, node->code);
+				}
+				break;
+			case STMT_BLOCK:
+				shake_block(ctx, stmt->value.block);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+static void shake_func(shake_ctx* ctx, heck_func* func) {
+	// methods keep their class
+	mark_owners(ctx, func->code->scope->parent);
+	
+	vec_size_t num_params = vector_size(func->param_vec);
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		heck_param* param = func->param_vec[i];
+		shake_type(ctx, param->type);
+		if (param->def_val != NULL)
+			shake_expr(ctx, param->def_val);
+	}
+	
+	shake_block(ctx, func->code);
+}
+
+static void shake_class(shake_ctx* ctx, heck_name* class_name) {
+	mark_owners(ctx, class_name->parent);
+	
+	// instances have their ancestors' members
+	heck_class* class = class_name->value.class_value;
+	vec_size_t num_parents = vector_size(class->parent_vec);
+	for (vec_size_t i = 0; i < num_parents; ++i) {
+		heck_name* parent = class_parent(class_name, i);
+		if (parent != NULL)
+			mark_class(ctx, parent);
+	}
+	
+	// member variables are initialized with each instance
+	heck_scope* scope = class_name->child_scope;
+	if (scope == NULL || scope->decl_vec == NULL)
+		return;
+	vec_size_t num_decls = vector_size(scope->decl_vec);
+	for (vec_size_t i = 0; i < num_decls; ++i) {
+		heck_stmt* decl = scope->decl_vec[i];
+		if (decl->type == STMT_LET && decl->value.let_stmt->value != NULL)
+			shake_expr(ctx, decl->value.let_stmt->value);
+	}
+}
+
+static bool params_equal(const heck_func* a, const heck_func* b) {
+	vec_size_t num_params = vector_size(a->param_vec);
+	if (vector_size(b->param_vec) != num_params)
+		return false;
+	
+	for (vec_size_t i = 0; i < num_params; ++i) {
+		if (!data_type_cmp(a->param_vec[i]->type, b->param_vec[i]->type))
+			return false;
+	}
+	return true;
+}
+
+// true if an ancestor of the class has a live method with the same name and parameter types as func
+static bool overrides_live(const heck_name* class_name, str_entry key, const heck_func* func) {
+	vec_size_t num_parents = vector_size(class_name->value.class_value->parent_vec);
+	for (vec_size_t i = 0; i < num_parents; ++i) {
+		heck_name* parent = class_parent(class_name, i);
+		if (parent == NULL)
+			continue;
+		
+		heck_name* method = NULL;
+		heck_scope* scope = parent->child_scope;
+		if (scope != NULL && scope->names != NULL && idf_map_get(scope->names, key, (void*)&method) && method->type == IDF_FUNCTION) {
+			heck_func** func_vec = method->value.func_value.func_vec;
+			vec_size_t num_funcs = vector_size(func_vec);
+			for (vec_size_t j = 0; j < num_funcs; ++j) {
+				if (func_vec[j]->live && params_equal(func_vec[j], func))
+					return true;
+			}
+		}
+		
+		if (overrides_live(parent, key, func))
+			return true;
+	}
+	
+	return false;
+}
+
+typedef struct override_ctx {
+	shake_ctx* shake;
+	const heck_name* class_name;
+	bool marked;
+} override_ctx;
+
+static void mark_overrides(str_entry key, void* value, void* user_ptr) {
+	heck_name* name = value;
+	override_ctx* ctx = user_ptr;
+	if (name->type != IDF_FUNCTION)
+		return;
+	
+	heck_func** func_vec = name->value.func_value.func_vec;
+	vec_size_t num_funcs = vector_size(func_vec);
+	for (vec_size_t i = 0; i < num_funcs; ++i) {
+		if (!func_vec[i]->live && overrides_live(ctx->class_name, key, func_vec[i])) {
+			mark_func(ctx->shake, func_vec[i]);
+			ctx->marked = true;
+		}
+	}
+}
+
+static void shake_mark(shake_ctx* ctx, heck_block* global) {
+	shake_block(ctx, global);
+	
+	bool marked = true;
+	while (marked) {
+		while (vector_size(ctx->func_vec) > 0 || vector_size(ctx->class_vec) > 0) {
+			vec_size_t num_funcs = vector_size(ctx->func_vec);
+			if (num_funcs > 0) {
+				heck_func* func = ctx->func_vec[num_funcs - 1];
+				vector_remove(ctx->func_vec, num_funcs - 1);
+				shake_func(ctx, func);
+			} else {
+				vec_size_t num_classes = vector_size(ctx->class_vec);
+				heck_name* class_name = ctx->class_vec[num_classes - 1];
+				vector_remove(ctx->class_vec, num_classes - 1);
+				shake_class(ctx, class_name);
+			}
+		}
+		
+		// a method that overrides a live one can be called in its place through an instance of the subclass
+		marked = false;
+		vec_size_t num_classes = vector_size(ctx->live_class_vec);
+		for (vec_size_t i = 0; i < num_classes; ++i) {
+			heck_name* class_name = ctx->live_class_vec[i];
+			if (class_name->child_scope == NULL || class_name->child_scope->names == NULL)
+				continue;
+			
+			override_ctx override = { ctx, class_name, false };
+			idf_map_iterate(class_name->child_scope->names, mark_overrides, &override);
+			marked = override.marked || marked;
+		}
+	}
+}
+
+/*
+ *	Sweeping removes the functions and classes that weren't marked from every scope that is left.
+ *	The functions are freed once nothing can refer to them anymore.
+ */
+
+typedef struct sweep_ctx {
+	heck_func** dead_vec;
+} sweep_ctx;
+
+typedef struct sweep_scope_ctx {
+	sweep_ctx* sweep;
+	str_entry* dead_vec; // the names to remove, the map can't change while it's iterated
+} sweep_scope_ctx;
+
+static void sweep_block(sweep_ctx* ctx, heck_block* block);
+static void sweep_scope(sweep_ctx* ctx, heck_scope* scope);
+
+static void sweep_op_overloads(sweep_ctx* ctx, heck_class* class) {
+	vec_size_t i = 0;
+	while (i < vector_size(class->op_overloads)) {
+		heck_func_list* overloads = &class->op_overloads[i].overloads;
+		func_list_remove_dead(overloads, &ctx->dead_vec);
+		if (vector_size(overloads->func_vec) == 0) {
+			vector_remove(class->op_overloads, i);
+			continue;
+		}
+		
+		vec_size_t num_funcs = vector_size(overloads->func_vec);
+		for (vec_size_t j = 0; j < num_funcs; ++j)
+			sweep_block(ctx, overloads->func_vec[j]->code);
+		++i;
+	}
+}
+
+static void sweep_name(str_entry key, void* value, void* user_ptr) {
+	heck_name* name = value;
+	sweep_scope_ctx* ctx = user_ptr;
+	
+	switch (name->type) {
+		case IDF_FUNCTION: {
+			heck_func_list* list = &name->value.func_value;
+			func_list_remove_dead(list, &ctx->sweep->dead_vec);
+			
+			vec_size_t num_funcs = vector_size(list->func_vec);
+			if (num_funcs == 0) {
+				vector_add(&ctx->dead_vec, key);
+				break;
+			}
+			
+			// functions and classes can be declared in a body
+			for (vec_size_t i = 0; i < num_funcs; ++i)
+				sweep_block(ctx->sweep, list->func_vec[i]->code);
+			break;
+		}
+		case IDF_CLASS:
+		case IDF_UNDECLARED_CLASS: {
+			heck_class* class = name->value.class_value;
+			if (class != NULL && !class->live) {
+				vector_add(&ctx->dead_vec, key);
+				break;
+			}
+			
+			if (class != NULL)
+				sweep_op_overloads(ctx->sweep, class);
+			if (name->child_scope != NULL)
+				sweep_scope(ctx->sweep, name->child_scope);
+			break;
+		}
+		case IDF_NAMESPACE:
+			if (name->child_scope != NULL)
+				sweep_scope(ctx->sweep, name->child_scope);
+			break;
+		default:
+			break;
+	}
+}
+
+static void sweep_scope(sweep_ctx* ctx, heck_scope* scope) {
+	if (scope->names == NULL)
+		return;
+	
+	sweep_scope_ctx scope_ctx = { ctx, vector_create() };
+	idf_map_iterate(scope->names, sweep_name, &scope_ctx);
+	
+	vec_size_t num_dead = vector_size(scope_ctx.dead_vec);
+	for (vec_size_t i = 0; i < num_dead; ++i)
+		idf_map_remove(scope->names, scope_ctx.dead_vec[i]);
+	vector_free(scope_ctx.dead_vec);
+}
+
+static void sweep_block(sweep_ctx* ctx, heck_block* block) {
+	sweep_scope(ctx, block->scope);
+	
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		if (stmt->type == STMT_BLOCK) {
+			sweep_block(ctx, stmt->value.block);
+		} else if (stmt->type == STMT_IF) {
+			for (heck_if_node* node = stmt->value.if_stmt->contents; node != NULL; node = node->next)
+				sweep_block(ctx, node->code);
+		}
+	}
+}
+
+void heck_shake(heck_code* c) {
+	shake_ctx ctx = { vector_create(), vector_create(), vector_create() };
+	shake_mark(&ctx, c->global);
+	vector_free(ctx.func_vec);
+	vector_free(ctx.class_vec);
+	vector_free(ctx.live_class_vec);
+	
+	sweep_ctx sweep = { vector_create() };
+	sweep_block(&sweep, c->global);
+	
+	// heck_reparse can't reuse the bodies that were removed, or keep declarations that lost overloads
+	if (c->body_vec != NULL) {
+		vec_size_t num_bodies = vector_size(c->body_vec);
+		vec_size_t num_live = 0;
+		for (vec_size_t i = 0; i < num_bodies; ++i) {
+			if (c->body_vec[i]->live)
+				c->body_vec[num_live++] = c->body_vec[i];
+		}
+		vector_erase(c->body_vec, num_live, num_bodies - num_live);
+	}
+	dep_graph_forget(c->deps);
+	
+	vec_size_t num_dead = vector_size(sweep.dead_vec);
+	for (vec_size_t i = 0; i < num_dead; ++i)
+		func_free(sweep.dead_vec[i]);
+	vector_free(sweep.dead_vec);
+}
@@ -0,0 +1,21 @@
+//
+//  shake.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Tree shaking. Only the declarations that the global code can reach are compiled: the functions
+//	it calls, directly or not, the classes they use, and the operator overloads and overriding
+//	methods that could be called through those classes. Everything else is removed from the tree.
+//
+
+#ifndef shake_h
+#define shake_h
+
+#include "code.h"
+
+// the code must be resolved without errors. nothing can be exported yet, so the global code is the only root.
+// the declarations that are left can't be kept by heck_reparse, the next reparse resolves everything again
+void heck_shake(heck_code* c);
+
+#endif /* shake_h */
@@ -15,11 +15,14 @@
 #include "class.h"
 #include "types.h"
 #include "overload.h"
-#include "resolver.h"
 #include "error.h"
+#include "dep_graph.h"
 
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "mem.h"
 
 
 typedef struct parser parser;
@@ -28,6 +31,12 @@ struct parser {
 	int pos;
 	heck_code* code;
 	bool success; // true unless there are errors in the code
+	FILE* err; // stderr, or a worker's error buffer when parsing bodies in parallel
+	heck_func** body_vec; // functions whose bodies were skipped, NULL to parse bodies right away
+	long* err_mark_vec; // for each function in body_vec, how much had been written to err when it was skipped
+	const struct body_reuse* reuse; // the previous parse when reparsing, otherwise NULL
+	int block_end; // the '}' of the block being parsed, -1 outside of blocks or if it isn't matched
+	int panic_pos; // where panic_mode last skipped to, errors there are caused by the skip
 };
 
 // a function that parses a statement based on it's current scope
@@ -75,6 +84,12 @@ extern bool peek_newline(parser* p);
 inline bool peek_newline(parser* p) {
 	return peek(p)->ln != next(p)->ln;
 }
+
+// the first token starts a line, there is no token before it
+extern bool at_newline(parser* p);
+inline bool at_newline(parser* p) {
+	return p->pos == 0 || previous(p)->ln != peek(p)->ln;
+}
 #else
 
 //p is a parser*
@@ -85,7 +100,7 @@ inline bool peek_newline(parser* p) {
 #define previous(p)		((heck_token*)	((p)->code->token_vec[(p)->pos-1]))
 #define next(p)			((heck_token*)	((p)->code->token_vec[(p)->pos+1]))
 #define at_end(p)		((bool)			(peek(p)->type == TK_EOF))
-#define at_newline(p)	((bool)			(previous(p)->ln != peek(p)->ln))
+#define at_newline(p)	((bool)			((p)->pos == 0 || previous(p)->ln != peek(p)->ln)) // the first token starts a line
 
 #endif
 
@@ -104,12 +119,27 @@ void panic_mode(parser* p) {
 	// we are in panic mode, so obviously the code won't compile
 	p->success = false;
 	
+	// skip the rest of the block, the block parser picks up at its '}'
+	if (p->block_end >= 0 && p->pos <= p->block_end) {
+		p->pos = p->block_end;
+		p->panic_pos = p->pos;
+		return;
+	}
+	
 	// step until we are in a new statement
 	for (;;) {
 		if (at_end(p)) {
 			return;
 		}
 		switch (peek(p)->type) {
+			case TK_PAR_L:
+			case TK_SQR_L:
+				// nothing inside of a matched group can start a new statement
+				if (peek(p)->value.match_pos < 0)
+					step(p);
+				else
+					p->pos = peek(p)->value.match_pos + 1;
+				break;
 			case TK_BRAC_L:
 			case TK_BRAC_R:
 			case TK_KW_LET:
@@ -137,12 +167,18 @@ void panic_until_match(parser* p, heck_tk_type type) {
 }
 
 void parser_error(parser* p, heck_token* tk, int ch_offset, const char* format, ...) {
-	fputs("error: ", stderr);
+	// the statement that was skipped can't be finished, that was already reported
+	if (p->pos == p->panic_pos) {
+		panic_mode(p);
+		return;
+	}
+	
+	fputs("error: ", p->err);
 	va_list argptr;
 	va_start(argptr, format);
-	vfprintf(stderr, format, argptr);
+	vfprintf(p->err, format, argptr);
 	va_end(argptr);
-	fprintf(stderr, " - ln %i ch %i\n", tk->ln, tk->ch + ch_offset);
+	fprintf(p->err, " - ln %i ch %i\n", tk->ln, tk->ch + ch_offset);
 	panic_mode(p);
 }
 
@@ -219,7 +255,7 @@ const heck_data_type* parse_data_type(parser* p, heck_scope* parent) {
 		}
 		default: {
 			heck_token* err_tk = previous(p);
-			fprintf(stderr, "error: expected a type, ln %i ch %i\n", err_tk->ln, err_tk->ch);
+			fprintf(p->err, "error: expected a type, ln %i ch %i\n", err_tk->ln, err_tk->ch);
 			panic_mode(p);
 			return data_type_err;
 		}
@@ -233,7 +269,7 @@ const heck_data_type* parse_data_type(parser* p, heck_scope* parent) {
 			t->type_value.arr_type = temp;
 			t->vtable = &type_vtable_arr;
 		} else {
-			fprintf(stderr, "error: expected ']'\n");
+			fprintf(p->err, "error: expected ']'\n");
 			panic_mode(p);
 			free_data_type(t);
 			return data_type_err;
@@ -264,14 +300,14 @@ heck_expr* expression(parser* p, heck_scope* parent);
 heck_idf identifier(parser* p, heck_scope* parent) { // assumes an identifier was just found with match(p)
 	
 	int len = 0, alloc = 1;
-	str_entry* idf = malloc(sizeof(str_entry) * (alloc + 1));
+	str_entry* idf = mem_alloc(sizeof(str_entry) * (alloc + 1), MEM_AST);
 	
 	for (;;) {
 		// add string to identifier chain
 		idf[len++] = previous(p)->value.str_value;
 		// reallocate if necessary
 		if (len == alloc) {
-			idf = realloc(idf, sizeof(str_entry) * (++alloc + 1));
+			idf = mem_realloc(idf, sizeof(str_entry) * (++alloc + 1), MEM_AST);
 		}
 		
 		/*	don't advance until we know there is a dot followed by an idf
@@ -307,7 +343,7 @@ heck_expr* primary_idf(parser* p, heck_scope* parent, idf_context context) { //
 			return call;
 		
 		for (;;) {
-			vector_add(&call->value.call->arg_vec, expression(p, parent));
+			vector_add(&call->value.call.arg_vec, expression(p, parent));
 			
 			if (match(p, TK_PAR_R)) {
 				return call;
@@ -331,7 +367,7 @@ heck_expr* primary(parser* p, heck_scope* parent) {
 	//if (match(p, TK_KW_NULL)) return create_expr_literal(/* something to represent null */)
 	
 	if (match(p, TK_LITERAL)) {
-		return create_expr_literal(previous(p)->value.literal_value);
+		return create_expr_literal(&previous(p)->value.literal_value);
 	}
 	
 	if (match(p, TK_PAR_L)) { // parentheses grouping
@@ -363,210 +399,192 @@ heck_expr* primary(parser* p, heck_scope* parent) {
 	return create_expr_err();
 }
 
-// TODO: associate operators with their corresponding vtables during token creation
-heck_expr* unary(parser* p, heck_scope* parent) {
-	heck_tk_type operator = peek(p)->type;
+/*
+ *	Operators are parsed by precedence climbing, using the tables below.
+ *	Precedence levels are ordered from lowest to highest.
+ */
+
+typedef enum heck_prec {
+	PREC_NONE = 0,		// not an infix operator
+	PREC_ASG,			// = += -= *= /= %= &= |= ^= ~= <<= >>=
+	PREC_TERNARY,		// ?:
+	PREC_OR,			// ||
+	PREC_XOR,			// ^^
+	PREC_AND,			// &&
+	PREC_EQUALITY,		// == !=
+	PREC_COMPARISON,	// < <= > >=
+	PREC_BW_OR,			// |
+	PREC_BW_XOR,		// ^
+	PREC_BW_AND,		// &
+	PREC_SHIFT,			// << >>
+	PREC_TERM,			// + -
+	PREC_FACTOR,		// * / %
+	PREC_EXP,			// **
+	PREC_UNARY,			// prefix operators and casts
+} heck_prec;
+
+typedef enum heck_assoc { ASSOC_LEFT, ASSOC_RIGHT } heck_assoc;
+
+typedef struct infix_rule {
+	heck_prec prec;
+	heck_assoc assoc;
 	const expr_vtable* vtable;
-	
-	switch (operator) {
-		case TK_OP_NOT:
-			vtable = &expr_vtable_not;
-			break;
-		case TK_OP_SUB:
-			vtable = &expr_vtable_unary_minus;
-			break;
-		case TK_OP_LESS: { // <type>cast
-			step(p);
-			const heck_data_type* data_type = parse_data_type(p, parent);
-			if (data_type->type_name == TYPE_ERR)
-				return create_expr_err();
-			if (data_type->type_name != TYPE_CLASS || data_type->type_value.class_type.type_args.type_vec == NULL) {
-				if (!match(p, TK_OP_GTR)) {
-					parser_error(p, peek(p), 0, "unexpected token");
-					return create_expr_err();
-				}
-			}
-			return create_expr_cast(data_type, primary(p, parent));
-		}
-		default:
-			return primary(p, parent);
-	}
-	step(p); // step over operator
-	return create_expr_unary(unary(p, parent), operator, vtable);
-}
+} infix_rule;
 
-heck_expr* multiplication(parser* p, heck_scope* parent) {
-	heck_expr* expr = unary(p, parent);
-	
-	for (;;) {
-		heck_tk_type operator = peek(p)->type;
-		const expr_vtable* vtable;
-		
-		switch (operator) {
-			case TK_OP_MULT:
-				vtable = &expr_vtable_mult;
-				break;
-			case TK_OP_DIV:
-				vtable = &expr_vtable_div;
-				break;
-			case TK_OP_MOD:
-				vtable = &expr_vtable_mod;
-				break;
-			default:
-				return expr;
-		}
-		
-		step(p);
-		expr = create_expr_binary(expr, operator, unary(p, parent), vtable);
-	}
-//	while (match(p, TK_OP_MULT) || match(p, TK_OP_DIV) || match(p, TK_OP_MOD)) {
-//		heck_tk_type operator = previous(p)->type;
-//		heck_expr* right = unary(p);
-//		expr = create_expr_binary(expr, operator, right);
-//	}
-	
-	//return expr;
-}
+// every token that isn't listed has a precedence of PREC_NONE
+static const infix_rule infix_rules[TK_COUNT] = {
+	[TK_OP_ASG]			= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_MULT_ASG]	= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_DIV_ASG]		= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_MOD_ASG]		= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_ADD_ASG]		= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_SUB_ASG]		= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_BW_AND_ASG]	= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_BW_OR_ASG]	= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_BW_XOR_ASG]	= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_BW_NOT_ASG]	= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_SHFT_L_ASG]	= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	[TK_OP_SHFT_R_ASG]	= { PREC_ASG, ASSOC_RIGHT, &expr_vtable_asg },
+	
+	[TK_Q_MARK]			= { PREC_TERNARY, ASSOC_RIGHT, &expr_vtable_ternary },
+	
+	[TK_OP_OR]			= { PREC_OR, ASSOC_LEFT, &expr_vtable_or },
+	[TK_OP_XOR]			= { PREC_XOR, ASSOC_LEFT, &expr_vtable_xor },
+	[TK_OP_AND]			= { PREC_AND, ASSOC_LEFT, &expr_vtable_and },
+	
+	[TK_OP_EQ]			= { PREC_EQUALITY, ASSOC_LEFT, &expr_vtable_eq },
+	[TK_OP_N_EQ]		= { PREC_EQUALITY, ASSOC_LEFT, &expr_vtable_n_eq },
+	
+	[TK_OP_LESS]		= { PREC_COMPARISON, ASSOC_LEFT, &expr_vtable_less },
+	[TK_OP_LESS_EQ]		= { PREC_COMPARISON, ASSOC_LEFT, &expr_vtable_less_eq },
+	[TK_OP_GTR]			= { PREC_COMPARISON, ASSOC_LEFT, &expr_vtable_gtr },
+	[TK_OP_GTR_EQ]		= { PREC_COMPARISON, ASSOC_LEFT, &expr_vtable_gtr_eq },
+	
+	[TK_OP_BW_OR]		= { PREC_BW_OR, ASSOC_LEFT, &expr_vtable_bw_or },
+	[TK_OP_BW_XOR]		= { PREC_BW_XOR, ASSOC_LEFT, &expr_vtable_bw_xor },
+	[TK_OP_BW_AND]		= { PREC_BW_AND, ASSOC_LEFT, &expr_vtable_bw_and },
+	
+	[TK_OP_SHFT_L]		= { PREC_SHIFT, ASSOC_LEFT, &expr_vtable_shift_l },
+	[TK_OP_SHFT_R]		= { PREC_SHIFT, ASSOC_LEFT, &expr_vtable_shift_r },
+	
+	[TK_OP_ADD]			= { PREC_TERM, ASSOC_LEFT, &expr_vtable_add },
+	[TK_OP_SUB]			= { PREC_TERM, ASSOC_LEFT, &expr_vtable_sub },
+	
+	[TK_OP_MULT]		= { PREC_FACTOR, ASSOC_LEFT, &expr_vtable_mult },
+	[TK_OP_DIV]			= { PREC_FACTOR, ASSOC_LEFT, &expr_vtable_div },
+	[TK_OP_MOD]			= { PREC_FACTOR, ASSOC_LEFT, &expr_vtable_mod },
+	
+	[TK_OP_EXP]			= { PREC_EXP, ASSOC_RIGHT, &expr_vtable_exp },
+};
 
-heck_expr* addition(parser* p, heck_scope* parent) {
-	heck_expr* expr = multiplication(p, parent);
+// prefix operators, casts are handled separately
+static const expr_vtable* prefix_rules[TK_COUNT] = {
+	[TK_OP_NOT]		= &expr_vtable_not,
+	[TK_OP_SUB]		= &expr_vtable_unary_minus,
+	[TK_OP_BW_NOT]	= &expr_vtable_bw_not,
+	[TK_OP_INCR]	= &expr_vtable_pre_incr,
+	[TK_OP_DECR]	= &expr_vtable_pre_decr,
+};
+
+// forward declarations
+heck_expr* parse_precedence(parser* p, heck_scope* parent, heck_prec min_prec);
+
+heck_expr* postfix(parser* p, heck_scope* parent) {
+	heck_expr* expr = primary(p, parent);
 	
-	for (;;) {
+	// a ++ or -- on the next line belongs to the next statement
+	while (!at_newline(p)) {
 		heck_tk_type operator = peek(p)->type;
-		const expr_vtable* vtable;
 		
-		switch (operator) {
-			case TK_OP_ADD:
-				vtable = &expr_vtable_add;
-				break;
-			case TK_OP_SUB:
-				vtable = &expr_vtable_sub;
-				break;
-			default:
-				return expr;
+		if (operator == TK_OP_INCR) {
+			step(p);
+			expr = create_expr_unary(expr, operator, &expr_vtable_post_incr);
+		} else if (operator == TK_OP_DECR) {
+			step(p);
+			expr = create_expr_unary(expr, operator, &expr_vtable_post_decr);
+		} else {
+			break;
 		}
-		
-		step(p);
-		expr = create_expr_binary(expr, operator, multiplication(p, parent), vtable);
 	}
 	
-//	while (match(p, TK_OP_ADD) || match(p, TK_OP_SUB)) {
-//		heck_tk_type operator = previous(p)->type;
-//		heck_expr* right = multiplication(p);
-//		expr = create_expr_binary(expr, operator, right);
-//	}
-	
-	//return expr;
+	return expr;
 }
 
-heck_expr* comparison(parser* p, heck_scope* parent) {
-	heck_expr* expr = addition(p, parent);
+heck_expr* unary(parser* p, heck_scope* parent) {
+	heck_tk_type operator = peek(p)->type;
 	
-	for (;;) {
-		heck_tk_type operator = peek(p)->type;
-		const expr_vtable* vtable;
-		
-		switch (operator) {
-			case TK_OP_GTR:
-				vtable = &expr_vtable_gtr;
-				break;
-			case TK_OP_GTR_EQ:
-				vtable = &expr_vtable_gtr_eq;
-				break;
-			case TK_OP_LESS:
-				vtable = &expr_vtable_less;
-				break;
-			case TK_OP_LESS_EQ:
-				vtable = &expr_vtable_less_eq;
-				break;
-			default:
-				return expr;
-		}
-		
+	if (operator == TK_OP_LESS) { // <type>cast
 		step(p);
-		expr = create_expr_binary(expr, operator, addition(p, parent), vtable);
+		const heck_data_type* data_type = parse_data_type(p, parent);
+		if (data_type->type_name == TYPE_ERR)
+			return create_expr_err();
+		if (data_type->type_name != TYPE_CLASS || data_type->type_value.class_type.type_args.type_vec == NULL) {
+			if (!match(p, TK_OP_GTR)) {
+				parser_error(p, peek(p), 0, "unexpected token");
+				return create_expr_err();
+			}
+		}
+		return create_expr_cast(data_type, unary(p, parent));
 	}
 	
-//	while (match(p, TK_OP_GTR) || match(p, TK_OP_GTR_EQ) || match(p, TK_OP_LESS) || match(p, TK_OP_LESS_EQ)) {
-//		heck_tk_type operator = previous(p)->type;
-//		heck_expr* right = addition(p);
-//		expr = create_expr_binary(expr, operator, right);
-//	}
+	const expr_vtable* vtable = prefix_rules[operator];
+	if (vtable == NULL)
+		return postfix(p, parent);
+	
+	step(p); // step over operator
 	
-	//return expr;
+	// ** binds tighter than prefix operators, so -a ** b is -(a ** b)
+	return create_expr_unary(parse_precedence(p, parent, PREC_EXP), operator, vtable);
 }
 
-heck_expr* equality(parser* p, heck_scope* parent) {
-	heck_expr* expr = comparison(p, parent);
+heck_expr* parse_precedence(parser* p, heck_scope* parent, heck_prec min_prec) {
+	heck_expr* expr = unary(p, parent);
 	
 	for (;;) {
-		heck_tk_type operator = peek(p)->type;
-		const expr_vtable* vtable;
-		
-		switch (operator) {
-			case TK_OP_EQ:
-				vtable = &expr_vtable_eq;
-				break;
-			case TK_OP_N_EQ:
-				vtable = &expr_vtable_n_eq;
-			default:
-				return expr;
-		}
+		heck_token* op_token = peek(p);
+		heck_tk_type operator = op_token->type;
+		const infix_rule* rule = &infix_rules[operator];
 		
-
-		step(p);
-		expr = create_expr_binary(expr, operator, comparison(p, parent), vtable);
-	}
-	
-	
-//	while (match(p, TK_OP_EQ) || match(p, TK_OP_N_EQ)) {
-//		heck_tk_type operator = previous(p)->type;
-//		heck_expr* right = comparison(p);
-//		expr = create_expr_binary(expr, operator, right);
-//		//expr->data_type.type_name = TYPE_BOOL; // equality returns a bool
-//	}
-}
-
-heck_expr* assignment(parser* p, heck_scope* parent) {
-	heck_expr* expr = equality(p, parent);
-	
-	if (match(p, TK_OP_ASG)) {
+		if (rule->prec == PREC_NONE || rule->prec < min_prec)
+			return expr;
 		
-		if (expr->type == EXPR_VALUE) {
-			heck_expr* left = expression(p, parent);
-			heck_expr* asg = create_expr_asg(expr, left);
-			//asg->data_type = expr->data_type;
-			return asg;
-		}
+		step(p); // step over operator
 		
-		// TODO: report invalid assignment target
-	}
-	
-	return expr;
-}
-
-heck_expr* ternary(parser* p, heck_scope* parent) {
-	heck_expr* expr = assignment(p, parent);
-	
-	if (match(p, TK_Q_MARK)) {
-		heck_expr* value_a = expression(p, parent);
+		// left associative operators only take operands with a higher precedence on the right side
+		heck_prec right_prec = rule->assoc == ASSOC_LEFT ? rule->prec + 1 : rule->prec;
 		
-		if (!match(p, TK_COLON)) {
-			// TODO: report expected ':'
-			return create_expr_ternary(expr, value_a, create_expr_err());
-		} else {
-			return create_expr_ternary(expr, value_a, expression(p, parent));
+		switch (rule->prec) {
+			case PREC_TERNARY: {
+				heck_expr* value_a = expression(p, parent);
+				
+				if (!match(p, TK_COLON)) {
+					parser_error(p, peek(p), 0, "expected ':'");
+					return create_expr_ternary(expr, value_a, create_expr_err());
+				}
+				
+				expr = create_expr_ternary(expr, value_a, parse_precedence(p, parent, right_prec));
+				break;
+			}
+			case PREC_ASG: {
+				heck_expr* value = parse_precedence(p, parent, right_prec);
+				
+				if (expr->type != EXPR_VALUE) {
+					parser_error(p, op_token, 0, "invalid assignment target");
+					return create_expr_err();
+				}
+				
+				expr = create_expr_asg(expr, operator, value);
+				break;
+			}
+			default:
+				expr = create_expr_binary(expr, operator, parse_precedence(p, parent, right_prec), rule->vtable);
+				break;
 		}
-		
 	}
-	
-	return expr;
 }
 
 heck_expr* expression(parser* p, heck_scope* parent) {
-	heck_expr* value = ternary(p, parent);
-	return value;
-	//return ternary(p);
+	return parse_precedence(p, parent, PREC_ASG);
 }
 
 /*
@@ -600,9 +618,8 @@ heck_stmt* let_statement(parser* p, heck_scope* parent) {
 	if (match(p, TK_IDF)) {
 		str_entry name = previous(p)->value.str_value;
 		
-		// initialization is optional if the type is specified
-		// you get an error for using an uninitialized variable
-		return create_stmt_let(name, match(p, TK_OP_ASG) ? expression(p, parent) : NULL);
+		// without a value, the type is inferred from how the variable is used
+		return create_stmt_let(name, match(p, TK_OP_ASG) ? expression(p, parent) : create_expr_res_type(create_type_var()));
 //		if (match(p, TK_OP_ASG)) { // =
 //			return create_stmt_let(name, expression(p, parent));
 //		} else {
@@ -617,10 +634,11 @@ heck_stmt* let_statement(parser* p, heck_scope* parent) {
 	return create_stmt_err();
 }
 
-// parses a block using a given child scope
-heck_block* parse_block(parser* p, heck_scope* child, uint8_t flags) {
+// parses the statements of a block into an existing block, assumes the parser is at the '{'
+void parse_block_stmts(parser* p, heck_block* block, uint8_t flags) {
+	int outer_end = p->block_end;
+	p->block_end = peek(p)->value.match_pos;
 	step(p);
-	heck_block* block = block_create(child);
 
 	for (;;) {
 		if (at_end(p)) {
@@ -638,7 +656,14 @@ heck_block* parse_block(parser* p, heck_scope* child, uint8_t flags) {
 		
 		
 	}
+	
+	p->block_end = outer_end;
+}
 
+// parses a block using a given child scope
+heck_block* parse_block(parser* p, heck_scope* child, uint8_t flags) {
+	heck_block* block = block_create(child);
+	parse_block_stmts(p, block, flags);
 	return block;
 }
 heck_stmt* block_statement(parser* p, heck_scope* parent, uint8_t flags) {
@@ -691,6 +716,9 @@ heck_stmt* if_statement(parser* p, heck_scope* parent, uint8_t flags) {
 		}
 		
 		if (last || !match(p, TK_KW_ELSE)) {
+			// without an else block, the ladder can be skipped entirely
+			if (!last && type == BLOCK_RETURNS)
+				type = BLOCK_MAY_RETURN;
 			break;
 		}
 		
@@ -734,9 +762,10 @@ bool parse_parameters(parser* p, heck_func* func, heck_scope* parent) {
 			} else if (param_type->type_name == TYPE_CLASS && ((heck_idf)param_type->type_value.class_type.value.name)[1] == NULL) {
 				// transfer ownership of the class identifier from param_type to param_name
 				param_name = param_type->type_value.class_type.value.name;
-				free((heck_data_type*)param_type);
+				mem_free((heck_data_type*)param_type);
 				// make param_type generic
 				param_type = data_type_gen;
+				func->generic = true;
 			} else {
 				parser_error(p, peek(p), 0, "expected a name for a function parameter");
 			}
@@ -751,9 +780,9 @@ bool parse_parameters(parser* p, heck_func* func, heck_scope* parent) {
 				parser_error(p, peek(p), 0, "invalid parameter name (must not contain '.' separated values)");
 				
 				if (param_type != NULL) {
-					free((void*)param_type);
+					mem_free((void*)param_type);
 				}
-				free((void*)param_name);
+				mem_free((void*)param_name);
 				return false;
 			}
 			
@@ -762,22 +791,19 @@ bool parse_parameters(parser* p, heck_func* func, heck_scope* parent) {
 			for (vec_size_t i = 0; i < param_count; ++i) {
 				if (func->param_vec[i]->name == param_name[0]) {
 					heck_token* err_tk = previous(p);
-					fprintf(stderr, "error: duplicate parameter name, ln %i ch %i\n", err_tk->ln, err_tk->ch);
+					fprintf(p->err, "error: duplicate parameter name, ln %i ch %i\n", err_tk->ln, err_tk->ch);
 					panic_mode(p);
 					return false;
 				}
 			}
 			
 			
+			// transfer ownership of the parameter's name string from param_name to param->name
 			heck_param* param = param_create(param_name[0]);
-			free((void*)param_name);
+			mem_free((void*)param_name);
 			
 			param->type = param_type;
 			
-			// transfer ownership of the parameter's name string from param_name to param->name
-			param->name = param_name[0];
-			//free((void*)param_name);
-			
 			if (match(p, TK_OP_ASG)) { // handle default argument values (e.g. arg = expr)
 				param->def_val = expression(p, parent);
 			}//dddddd
@@ -801,7 +827,27 @@ bool parse_parameters(parser* p, heck_func* func, heck_scope* parent) {
 	return true;
 }
 
+// parses the body into func->code, assumes the parser is at the '{'
+void parse_func_body(parser* p, heck_func* func) {
+	bool success = p->success;
+	p->success = true;
+	func->body_parsed = true;
+	
+	parse_block_stmts(p, func->code, STMT_FLAG_FUNC);
+	
+	if (func->code->type == BLOCK_MAY_RETURN) {
+		parser_error(p, previous(p), 0, "function only returns in some cases");
+	}
+	
+	func->body_valid = p->success;
+	p->success = success && p->success;
+}
+
+bool reuse_body(parser* p, heck_func* func, int body_end);
+bool decl_edited(parser* p, int first, int last);
+
 void func_decl(parser* p, heck_scope* parent) {
+	int decl_start = p->pos;
 	step(p);
 	
 	heck_idf func_idf;
@@ -849,7 +895,7 @@ void func_decl(parser* p, heck_scope* parent) {
 			func_name = func_scope->class;
 		} else {
 			heck_token* err_tk = previous(p);
-			fprintf(stderr, "error: operator overload outside of class, ln %i ch %i\n", err_tk->ln, err_tk->ch);
+			fprintf(p->err, "error: operator overload outside of class, ln %i ch %i\n", err_tk->ln, err_tk->ch);
 			panic_mode(p);
 			return;
 		}
@@ -858,6 +904,8 @@ void func_decl(parser* p, heck_scope* parent) {
 		
 		// check if token is an operator
 		if (token_is_operator(peek(p)->type)) {
+			overload_type.cast = false;
+			overload_type.value.operator = peek(p)->type;
 			step(p);
 		} else {
 			// check for type cast instead
@@ -907,28 +955,24 @@ void func_decl(parser* p, heck_scope* parent) {
 			if (func_name->child_scope != NULL) {
 			//if (idf_map_size(func_scope->names) > 0) {
 				
-				fprintf(stderr, "error: unable to create child scope for a function: ");
-				fprint_idf(stderr, func_idf);
-				fprintf(stderr, "\n");
+				fprintf(p->err, "error: unable to create child scope for a function: ");
+				fprint_idf(p->err, func_idf);
+				fprintf(p->err, "\n");
 				return;
 			}
 			
 			func_name->type = IDF_FUNCTION;
-			func_name->value.func_value.func_vec = vector_create(); // create vector to store overloads/definitions
-			
-		} else if (func_name->type == IDF_FUNCTION) {
-			
-			// check if this is a unique overload
-			if (func_overload_exists(&func_name->value.func_value, func)) {
-				fprintf(stderr, "error: function has already been declared with the same parameters: ");
-				fprint_idf(stderr, func_idf);
-				fprintf(stderr, "\n");
-				return;
-			}
+			func_list_init(&func_name->value.func_value);
 			
 		}
 		
-		vector_add(&func_name->value.func_value.func_vec, func);
+		// check if this is a unique overload
+		if (!func_add_overload(&func_name->value.func_value, func)) {
+			fprintf(p->err, "error: function has already been declared with the same parameters: ");
+			fprint_idf(p->err, func_idf);
+			fprintf(p->err, "\n");
+			return;
+		}
 		
 	}
 //	} else {
@@ -941,13 +985,25 @@ void func_decl(parser* p, heck_scope* parent) {
 //		return;
 //	}
 	
+	if (parent->func != NULL)
+		parent->func->has_nested = true;
+	
 	if (peek(p)->type == TK_BRAC_L) {
 		
-		heck_scope* block_scope = scope_create(parent);
-		func->code = parse_block(p, block_scope, STMT_FLAG_FUNC);
+		func->body_code = p->code;
+		func->body_pos = p->pos;
 		
-		if (func->code->type == BLOCK_MAY_RETURN) {
-			parser_error(p, peek(p), 0, "function only returns in some cases");
+		int body_end = peek(p)->value.match_pos;
+		if (body_end >= 0 && p->body_vec != NULL) {
+			// skip the body for now, it will be parsed the first time it is needed
+			if (!reuse_body(p, func, body_end))
+				func->body_parsed = false;
+			p->pos = body_end + 1;
+			vector_add(&p->body_vec, func);
+			vector_add(&p->err_mark_vec, ftell(p->err));
+		} else {
+			// unmatched bracket, parse it now so the error is reported
+			parse_func_body(p, func);
 		}
 		
 	} else {
@@ -958,10 +1014,26 @@ void func_decl(parser* p, heck_scope* parent) {
 		parser_error(p, peek(p), 0, "expected '}'");
 	}
 	
+	// functions in the global scope can be kept by heck_reparse if nothing they depend on was edited
+	if (func_name != NULL && func_name->type == IDF_FUNCTION && func_scope == p->code->global->scope) {
+		func->dep = dep_graph_declare(p->code->deps, func_idf[0], func_name, decl_edited(p, decl_start, p->pos - 1));
+	}
+	
 	return;
 	
 }
 
+bool heck_parse_func_body(heck_code* c, heck_func* func, FILE* err) {
+	if (func->body_parsed)
+		return func->body_valid;
+	
+	// nested function bodies are parsed along with this one
+	parser p = { .pos = func->body_pos, .code = c, .success = true, .err = err, .block_end = -1, .panic_pos = -1 };
+	parse_func_body(&p, func);
+	
+	return p.success;
+}
+
 heck_stmt* ret_statement(parser* p, heck_scope* parent) {
 	step(p);
 	
@@ -1016,11 +1088,16 @@ void class_decl(parser* p, heck_scope* parent) {
 		
 	}
 	
-	if (!match(p, TK_BRAC_L)) {
+	if (peek(p)->type != TK_BRAC_L) {
 		parser_error(p, peek(p), 0, "expected '{'");
 		return;
 	}
 	
+	// errors in the class body skip to its '}'
+	int outer_end = p->block_end;
+	p->block_end = peek(p)->value.match_pos;
+	step(p);
+	
 	while (!match(p, TK_BRAC_R)) {
 		// parse child classes, variables, and functions
 		heck_token* current = peek(p);
@@ -1042,11 +1119,19 @@ void class_decl(parser* p, heck_scope* parent) {
 			case TK_KW_CLASS:
 				class_decl(p, class_name->child_scope);
 				break;
+			case TK_EOF:
+				parser_error(p, current, 0, "unexpected EOF");
+				p->block_end = outer_end;
+				return;
 			case TK_BRAC_L:
 				// assume function or class
-				do {
-					step(p);
-				} while (!match(p, TK_BRAC_R));
+				if (current->value.match_pos < 0) {
+					do {
+						step(p);
+					} while (!at_end(p) && !match(p, TK_BRAC_R));
+				} else {
+					p->pos = current->value.match_pos + 1;
+				}
 				// fallthrough
 			default:
 				parser_error(p, current, 0, "unexpected token");
@@ -1054,6 +1139,8 @@ void class_decl(parser* p, heck_scope* parent) {
 		}
 	}
 	
+	p->block_end = outer_end;
+	
 }
 
 // returns a block statement with the corresponding namespace scope
@@ -1105,9 +1192,15 @@ void parse_statement(parser* p, heck_block* block, uint8_t flags) {
 		
 		heck_token* t = peek(p);
 		switch (t->type) {
-			case TK_KW_LET:
+			case TK_KW_LET: {
+				int decl_start = p->pos;
 				stmt = let_statement(p, block->scope);
+				
+				// same as functions, variables are declared while resolving though
+				if (stmt->type == STMT_LET && block->scope == p->code->global->scope)
+					dep_graph_declare(p->code->deps, stmt->value.let_stmt->name, NULL, decl_edited(p, decl_start, p->pos - 1));
 				break;
+			}
 			case TK_KW_IF:
 				stmt = if_statement(p, block->scope, flags);
 				break;
@@ -1141,10 +1234,11 @@ void parse_statement(parser* p, heck_block* block, uint8_t flags) {
 				
 				if (STMT_IN_FUNC(flags)) {
 					stmt = ret_statement(p, block->scope);
+					block->type = BLOCK_RETURNS;
 				} else {
 					parser_error(p, t, 0, "return statement outside function");
+					return;
 				}
-				return;
 				break;
 			case TK_BRAC_L:
 				stmt = block_statement(p, block->scope, flags);
@@ -1153,35 +1247,909 @@ void parse_statement(parser* p, heck_block* block, uint8_t flags) {
 				stmt = create_stmt_expr(expression(p, block->scope));
 		}
 		
+		// a block returns if any of its statements always return
+		if (STMT_IN_FUNC(flags) && block->type != BLOCK_RETURNS) {
+			heck_block_type type = BLOCK_DEFAULT;
+			if (stmt->type == STMT_IF)
+				type = stmt->value.if_stmt->type;
+			else if (stmt->type == STMT_BLOCK)
+				type = stmt->value.block->type;
+			if (type > block->type)
+				block->type = type;
+		}
+		
 		vector_add(&block->stmt_vec, stmt);
 }
 
-bool heck_parse(heck_code* c) {
+/*
+ *
+ * Recognizing
+ *
+ *	The functions below follow the same grammar as the parser and report the same syntax errors,
+ *	but they only step over the tokens. No nodes, scopes, or types are created, so errors that
+ *	depend on declarations (duplicate overloads, redefinitions, etc.) are not reported.
+ *
+ */
+
+// check_data_type results, 0 means the type had errors
+#define CHECK_TYPE_OK	1
+#define CHECK_TYPE_NAME	2 // a class type with a single identifier and no array dimensions
+#define CHECK_TYPE_ARGS	4 // a class type with type arguments and no array dimensions
+
+void check_idf(parser* p) { // assumes an identifier was just found with match(p)
+	while (peek(p)->type == TK_DOT && next(p)->type == TK_IDF)
+		n_step(p, 2);
+}
+
+int check_data_type(parser* p) {
+	step(p);
 	
-	parser p = { .pos = 0, .code = c, .success = true };
+	int result = CHECK_TYPE_OK;
 	
-	for (;;) {
-		
-		parse_statement(&p, c->global, STMT_FLAG_GLOBAL);
-		
-		if (at_end(&p))
+	switch (previous(p)->type) {
+		case TK_IDF: {
+			int start = p->pos;
+			check_idf(p);
+			if (p->pos == start)
+				result |= CHECK_TYPE_NAME;
+			
+			if (match(p, TK_COLON)) {
+				
+				if (!match(p, TK_SQR_L)) {
+					parser_error(p, peek(p), 0, "expected a type argument list");
+					return 0;
+				}
+				
+				result |= CHECK_TYPE_ARGS;
+				
+				for (;;) {
+					if (!check_data_type(p))
+						return 0;
+					
+					if (!match(p, TK_COMMA)) {
+						if (!match(p, TK_SQR_R)) {
+							parser_error(p, peek(p), 0, "expected ']'");
+							return 0;
+						}
+						break;
+					}
+				}
+			}
+			break;
+		}
+		case TK_PRIM_TYPE:
 			break;
+		default: {
+			heck_token* err_tk = previous(p);
+			fprintf(p->err, "error: expected a type, ln %i ch %i\n", err_tk->ln, err_tk->ch);
+			panic_mode(p);
+			return 0;
+		}
+	}
+	
+	while (match(p, TK_SQR_L)) { // array
+		if (!match(p, TK_SQR_R)) {
+			fprintf(p->err, "error: expected ']'\n");
+			panic_mode(p);
+			return 0;
+		}
+		result = CHECK_TYPE_OK;
+	}
+	
+	return result;
+}
+
+// the expression functions return true if the expression could be an assignment target
+bool check_expression(parser* p);
+bool check_precedence(parser* p, heck_prec min_prec);
+
+bool check_primary_idf(parser* p) { // assumes an idf was already matched
+	check_idf(p);
+	
+	if (!match(p, TK_PAR_L)) // variable
+		return true;
+	
+	// function call
+	if (match(p, TK_PAR_R))
+		return false;
+	
+	for (;;) {
+		check_expression(p);
 		
-		// TODO: check for newline or ;
-		if (!at_newline(&p) && !match(&p, TK_SEMI)) {
-			parser_error(&p, peek(&p), 0, "expected ; or newline");
+		if (match(p, TK_PAR_R)) {
+			return false;
+		} else if (!match(p, TK_COMMA)) {
+			parser_error(p, peek(p), 0, "expected ')'");
+			return false;
 		}
 	}
+}
+
+bool check_primary(parser* p) {
 	
-	// resolve everything
-	if (heck_resolve(c) && p.success) {
-		printf("successfully resolved!\n");
-	} else {
-		printf("failed to resolve :(\n");
+	if (match(p, TK_LITERAL))
+		return false;
+	
+	if (match(p, TK_PAR_L)) { // parentheses grouping
+		bool is_value = check_expression(p);
+		if (match(p, TK_PAR_R))
+			return is_value;
+		
+		parser_error(p, peek(p), 0, "expected ')'");
+		return false;
 	}
 	
-	printf("global ");
-	print_block(c->global, 0);
+	if (match(p, TK_IDF))
+		return check_primary_idf(p);
 	
-	return p.success;
+	if (match(p, TK_CTX)) {
+		if (match(p, TK_DOT) && match(p, TK_IDF))
+			return check_primary_idf(p);
+		
+		parser_error(p, peek(p), 0, "expected an identifier");
+		return false;
+	}
+	
+	parser_error(p, peek(p), 0, "expected an expression");
+	return false;
+}
+
+bool check_postfix(parser* p) {
+	bool is_value = check_primary(p);
+	
+	while (!at_newline(p) && (peek(p)->type == TK_OP_INCR || peek(p)->type == TK_OP_DECR)) {
+		step(p);
+		is_value = false;
+	}
+	
+	return is_value;
+}
+
+bool check_unary(parser* p) {
+	heck_tk_type operator = peek(p)->type;
+	
+	if (operator == TK_OP_LESS) { // <type>cast
+		step(p);
+		int type = check_data_type(p);
+		if (!type)
+			return false;
+		if (!(type & CHECK_TYPE_ARGS) && !match(p, TK_OP_GTR)) {
+			parser_error(p, peek(p), 0, "unexpected token");
+			return false;
+		}
+		check_unary(p);
+		return false;
+	}
+	
+	if (prefix_rules[operator] == NULL)
+		return check_postfix(p);
+	
+	step(p); // step over operator
+	check_precedence(p, PREC_EXP);
+	return false;
+}
+
+bool check_precedence(parser* p, heck_prec min_prec) {
+	bool is_value = check_unary(p);
+	
+	for (;;) {
+		heck_token* op_token = peek(p);
+		const infix_rule* rule = &infix_rules[op_token->type];
+		
+		if (rule->prec == PREC_NONE || rule->prec < min_prec)
+			return is_value;
+		
+		step(p); // step over operator
+		
+		heck_prec right_prec = rule->assoc == ASSOC_LEFT ? rule->prec + 1 : rule->prec;
+		
+		switch (rule->prec) {
+			case PREC_TERNARY:
+				check_expression(p);
+				
+				if (!match(p, TK_COLON)) {
+					parser_error(p, peek(p), 0, "expected ':'");
+					return false;
+				}
+				
+				check_precedence(p, right_prec);
+				break;
+			case PREC_ASG:
+				check_precedence(p, right_prec);
+				
+				if (!is_value) {
+					parser_error(p, op_token, 0, "invalid assignment target");
+					return false;
+				}
+				break;
+			default:
+				check_precedence(p, right_prec);
+				break;
+		}
+		
+		is_value = false;
+	}
+}
+
+bool check_expression(parser* p) {
+	return check_precedence(p, PREC_ASG);
+}
+
+heck_block_type check_statement(parser* p, uint8_t flags);
+
+void check_let(parser* p) {
+	step(p);
+	
+	if (match(p, TK_IDF)) {
+		if (match(p, TK_OP_ASG))
+			check_expression(p);
+		return;
+	}
+	
+	panic_mode(p);
+}
+
+// returns whether the block returns, the same way parse_statement sets the type of a block
+heck_block_type check_block(parser* p, uint8_t flags) {
+	int outer_end = p->block_end;
+	p->block_end = peek(p)->value.match_pos;
+	step(p);
+	
+	heck_block_type type = BLOCK_DEFAULT;
+	for (;;) {
+		if (at_end(p)) {
+			parser_error(p, peek(p), 0, "unexpected EOF");
+			break;
+		} else if (match(p, TK_BRAC_R)) {
+			break;
+		} else {
+			// a block returns if any of its statements always return
+			heck_block_type stmt_type = check_statement(p, flags);
+			if (STMT_IN_FUNC(flags) && type != BLOCK_RETURNS && stmt_type > type)
+				type = stmt_type;
+			
+			if (!at_newline(p) && !match(p, TK_SEMI)) {
+				parser_error(p, peek(p), 0, "expected ; or newline");
+			}
+		}
+	}
+	
+	p->block_end = outer_end;
+	return type;
+}
+
+// returns whether the ladder returns, the same way if_statement does
+heck_block_type check_if(parser* p, uint8_t flags) {
+	step(p);
+	check_expression(p);
+	
+	heck_block_type type = BLOCK_DEFAULT;
+	bool first = true;
+	for (bool last = false;;) {
+		
+		if (peek(p)->type != TK_BRAC_L) {
+			panic_mode(p);
+			break;
+		}
+		
+		heck_block_type block_type = check_block(p, flags);
+		if (STMT_IN_FUNC(flags)) {
+			switch (block_type) {
+				case BLOCK_RETURNS:
+					if (first) {
+						type = BLOCK_RETURNS;
+					} else if (type != BLOCK_RETURNS) {
+						type = BLOCK_MAY_RETURN;
+					}
+					break;
+				case BLOCK_MAY_RETURN:
+					type = BLOCK_MAY_RETURN;
+					break;
+				default:
+					if (type == BLOCK_RETURNS) type = BLOCK_MAY_RETURN;
+					break;
+			}
+		}
+		first = false;
+		
+		if (last || !match(p, TK_KW_ELSE)) {
+			// without an else block, the ladder can be skipped entirely
+			if (!last && type == BLOCK_RETURNS)
+				type = BLOCK_MAY_RETURN;
+			break;
+		}
+		
+		if (match(p, TK_KW_IF))
+			check_expression(p);
+		else
+			last = true;
+	}
+	
+	return type;
+}
+
+bool check_parameters(parser* p) {
+	
+	if (!match(p, TK_PAR_L)) {
+		parser_error(p, peek(p), 0, "expected (");
+		return false;
+	}
+	
+	if (match(p, TK_PAR_R))
+		return true;
+	
+	// the names so far, for the duplicate check
+	str_entry* name_vec = vector_create();
+	bool success = false;
+	for (;;) {
+		
+		int type = check_data_type(p);
+		if (!type)
+			break;
+		
+		if (match(p, TK_IDF)) {
+			// the name must not contain '.' separated values
+			if (peek(p)->type == TK_DOT && next(p)->type == TK_IDF) {
+				check_idf(p);
+				parser_error(p, peek(p), 0, "invalid parameter name (must not contain '.' separated values)");
+				break;
+			}
+		} else if (!(type & CHECK_TYPE_NAME)) {
+			// a lone class name is a parameter with a generic type
+			parser_error(p, peek(p), 0, "expected a name for a function parameter");
+			break;
+		}
+		
+		// either way the name is the last token
+		heck_token* name_tk = previous(p);
+		vec_size_t name_count = vector_size(name_vec);
+		vec_size_t i = 0;
+		while (i < name_count && name_vec[i] != name_tk->value.str_value)
+			++i;
+		if (i < name_count) {
+			fprintf(p->err, "error: duplicate parameter name, ln %i ch %i\n", name_tk->ln, name_tk->ch);
+			panic_mode(p);
+			break;
+		}
+		vector_add(&name_vec, name_tk->value.str_value);
+		
+		if (match(p, TK_OP_ASG)) // default argument value
+			check_expression(p);
+		
+		if (!match(p, TK_COMMA)) {
+			if (match(p, TK_PAR_R)) {
+				success = true;
+				break;
+			}
+			
+			panic_mode(p);
+			break;
+		}
+	}
+	
+	vector_free(name_vec);
+	return success;
+}
+
+void check_func(parser* p) {
+	step(p);
+	
+	bool has_name = match(p, TK_IDF);
+	if (has_name)
+		check_idf(p);
+	
+	if (!has_name || match(p, TK_DOT)) {
+		
+		if (!match(p, TK_KW_OPERATOR)) {
+			parser_error(p, peek(p), 0, "expected a function name");
+			return;
+		}
+		
+		// operator or type cast overload
+		if (token_is_operator(peek(p)->type)) {
+			step(p);
+		} else if (!check_data_type(p)) {
+			return;
+		}
+	}
+	
+	if (!check_parameters(p))
+		return;
+	
+	if (peek(p)->type == TK_BRAC_L) {
+		if (check_block(p, STMT_FLAG_FUNC) == BLOCK_MAY_RETURN)
+			parser_error(p, previous(p), 0, "function only returns in some cases");
+	} else {
+		parser_error(p, peek(p), 0, "expected '}'");
+	}
+}
+
+void check_class(parser* p) {
+	step(p);
+	
+	if (!match(p, TK_IDF)) {
+		parser_error(p, peek(p), 0, "expected an identifier");
+		return;
+	}
+	check_idf(p);
+	
+	// parents and friends
+	if (match(p, TK_COLON)) {
+		for (;;) {
+			if ((match(p, TK_KW_FRIEND) && match(p, TK_IDF)) || match(p, TK_IDF)) {
+				check_idf(p);
+			} else {
+				parser_error(p, peek(p), 0, "unexpected token");
+				return;
+			}
+			
+			if (!match(p, TK_COMMA))
+				break;
+		}
+	}
+	
+	if (peek(p)->type != TK_BRAC_L) {
+		parser_error(p, peek(p), 0, "expected '{'");
+		return;
+	}
+	
+	// errors in the class body skip to its '}'
+	int outer_end = p->block_end;
+	p->block_end = peek(p)->value.match_pos;
+	step(p);
+	
+	while (!match(p, TK_BRAC_R)) {
+		heck_token* current = peek(p);
+		switch (current->type) {
+			case TK_KW_LET:
+				check_let(p);
+				break;
+			case TK_KW_FUNC:
+				check_func(p);
+				break;
+			case TK_KW_CLASS:
+				check_class(p);
+				break;
+			case TK_EOF:
+				parser_error(p, current, 0, "unexpected EOF");
+				p->block_end = outer_end;
+				return;
+			case TK_BRAC_L:
+				if (current->value.match_pos < 0) {
+					do {
+						step(p);
+					} while (!at_end(p) && !match(p, TK_BRAC_R));
+				} else {
+					p->pos = current->value.match_pos + 1;
+				}
+				// fallthrough
+			default:
+				parser_error(p, current, 0, "unexpected token");
+				break;
+		}
+	}
+	
+	p->block_end = outer_end;
+}
+
+void check_namespace(parser* p) {
+	step(p);
+	
+	if (!match(p, TK_IDF)) {
+		parser_error(p, peek(p), 0, "expected an identifier");
+		return;
+	}
+	check_idf(p);
+	
+	check_block(p, STMT_FLAG_GLOBAL);
+}
+
+// returns whether the statement returns, like the type of an if statement or a block
+heck_block_type check_statement(parser* p, uint8_t flags) {
+	heck_token* t = peek(p);
+	switch (t->type) {
+		case TK_KW_LET:
+			check_let(p);
+			break;
+		case TK_KW_IF:
+			return check_if(p, flags);
+		case TK_KW_NAMESPACE:
+			if (STMT_IN_GLOBAL(flags))
+				check_namespace(p);
+			else
+				parser_error(p, t, 0, "declaration of a namespace outside of the global scope");
+			break;
+		case TK_KW_FUNC:
+			check_func(p);
+			break;
+		case TK_KW_CLASS:
+			check_class(p);
+			break;
+		case TK_KW_RETURN:
+			if (STMT_IN_FUNC(flags)) {
+				step(p);
+				if (peek(p)->type != TK_SEMI && !at_newline(p))
+					check_expression(p);
+				return BLOCK_RETURNS;
+			}
+			parser_error(p, t, 0, "return statement outside function");
+			break;
+		case TK_BRAC_L:
+			return check_block(p, flags);
+		default:
+			check_expression(p);
+			break;
+	}
+	
+	return BLOCK_DEFAULT;
+}
+
+bool heck_check(heck_code* c) {
+	
+	parser p = { .pos = 0, .code = c, .success = true, .err = stderr, .body_vec = NULL, .block_end = -1, .panic_pos = -1 };
+	
+	while (!at_end(&p)) {
+		
+		// there is no block for a stray '}' to close, and panic_mode would stop at it forever
+		if (match(&p, TK_BRAC_R)) {
+			parser_error(&p, previous(&p), 0, "unexpected '}'");
+			continue;
+		}
+		
+		check_statement(&p, STMT_FLAG_GLOBAL);
+		
+		if (at_end(&p))
+			break;
+		
+		if (!at_newline(&p) && !match(&p, TK_SEMI)) {
+			parser_error(&p, peek(&p), 0, "expected ; or newline");
+		}
+	}
+	
+	return p.success;
+}
+
+/*
+ *
+ * Parsing Function Bodies
+ *
+ */
+
+// a skipped function body, errors are written to the buffer of the worker that parsed it
+typedef struct body_job {
+	heck_func* func;
+	long err_mark; // the errors in the body are printed after this much of the top level errors
+	int worker;
+	long err_start, err_end;
+} body_job;
+
+typedef struct body_pool {
+	heck_code* code;
+	body_job* jobs;
+	size_t num_jobs;
+	atomic_size_t next_job; // bodies vary a lot in size, so workers take the next job when they are done
+} body_pool;
+
+typedef struct body_worker {
+	body_pool* pool;
+	int id;
+	FILE* err;
+	char* err_buf;
+	size_t err_size;
+	pthread_t thread;
+} body_worker;
+
+void* body_worker_run(void* arg) {
+	body_worker* w = arg;
+	body_pool* pool = w->pool;
+	
+	for (;;) {
+		size_t i = atomic_fetch_add(&pool->next_job, 1);
+		if (i >= pool->num_jobs)
+			break;
+		
+		body_job* job = &pool->jobs[i];
+		parser p = { .pos = job->func->body_pos, .code = pool->code, .success = true, .err = w->err, .block_end = -1, .panic_pos = -1 };
+		
+		job->worker = w->id;
+		job->err_start = ftell(w->err);
+		parse_func_body(&p, job->func);
+		job->err_end = ftell(w->err);
+	}
+	
+	return NULL;
+}
+
+// parses every unparsed body in body_vec, only the function's own block and scope are written to,
+// so the bodies can be parsed in any order. err_buf has the errors from the top level, which are
+// printed along with the errors in the bodies in source order afterwards. err_mark_vec says where
+// each body goes in err_buf, err_buf is NULL if the top level errors were already printed.
+void parse_bodies(heck_code* c, heck_func** body_vec, const char* err_buf, size_t err_size, const long* err_mark_vec, int num_threads) {
+	vec_size_t num_bodies = vector_size(body_vec);
+	
+	body_pool pool = { .code = c, .num_jobs = 0 };
+	pool.jobs = mem_alloc(sizeof(body_job) * num_bodies, MEM_AST);
+	atomic_init(&pool.next_job, 0);
+	for (vec_size_t i = 0; i < num_bodies; ++i) {
+		if (!body_vec[i]->body_parsed) {
+			body_job* job = &pool.jobs[pool.num_jobs++];
+			job->func = body_vec[i];
+			job->err_mark = err_mark_vec[i];
+		}
+	}
+	
+	size_t num_jobs = pool.num_jobs;
+	if (num_threads > num_jobs)
+		num_threads = (int)num_jobs;
+	
+	// with a single thread, every body is parsed below while the errors are printed
+	body_worker* workers = NULL;
+	int num_workers = 0;
+	if (num_threads > 1) {
+		workers = mem_alloc(sizeof(body_worker) * num_threads, MEM_AST);
+		for (; num_workers < num_threads; ++num_workers) {
+			body_worker* w = &workers[num_workers];
+			w->pool = &pool;
+			w->id = num_workers;
+			w->err = open_memstream(&w->err_buf, &w->err_size);
+			if (w->err == NULL)
+				break;
+			
+			// the calling thread is worker 0
+			if (num_workers > 0 && pthread_create(&w->thread, NULL, body_worker_run, w) != 0) {
+				fclose(w->err);
+				free(w->err_buf);
+				break;
+			}
+		}
+		
+		if (num_workers > 0)
+			body_worker_run(&workers[0]);
+		
+		for (int i = 1; i < num_workers; ++i)
+			pthread_join(workers[i].thread, NULL);
+		for (int i = 0; i < num_workers; ++i)
+			fclose(workers[i].err);
+	}
+	
+	long printed = 0; // how much of err_buf has been printed
+	for (size_t i = 0; i < num_jobs; ++i) {
+		body_job* job = &pool.jobs[i];
+		
+		if (err_buf != NULL) {
+			fwrite(&err_buf[printed], 1, job->err_mark - printed, stderr);
+			printed = job->err_mark;
+		}
+		
+		// no worker could be started, or the job wasn't reached
+		if (!job->func->body_parsed) {
+			heck_parse_func_body(c, job->func, stderr);
+			continue;
+		}
+		
+		body_worker* w = &workers[job->worker];
+		fwrite(&w->err_buf[job->err_start], 1, job->err_end - job->err_start, stderr);
+	}
+	
+	if (err_buf != NULL)
+		fwrite(&err_buf[printed], 1, err_size - printed, stderr);
+	
+	// open_memstream buffers come from the C library, so they aren't tracked
+	if (workers != NULL) {
+		for (int i = 0; i < num_workers; ++i)
+			free(workers[i].err_buf);
+		mem_free(workers);
+	}
+	mem_free(pool.jobs);
+}
+
+/*
+ *
+ * Reparsing
+ *
+ */
+
+typedef struct body_reuse {
+	heck_func** body_vec; // functions from the previous parse, sorted by body_pos
+	const heck_token_edit* edits;
+	int num_edits;
+} body_reuse;
+
+// true if tokens from first to last were replaced by an edit
+static bool edit_overlaps(const heck_token_edit* edit, int first, int last) {
+	// tokens were only removed if the edit is empty
+	return edit->start == edit->end ?
+		edit->start > first && edit->start <= last :
+		edit->start <= last && edit->end > first;
+}
+
+// true if the tokens of a declaration were edited since the previous parse, or there wasn't one
+bool decl_edited(parser* p, int first, int last) {
+	const body_reuse* reuse = p->reuse;
+	if (reuse == NULL)
+		return true;
+	
+	for (int i = 0; i < reuse->num_edits; ++i) {
+		if (edit_overlaps(&reuse->edits[i], first, last))
+			return true;
+	}
+	return false;
+}
+
+// reuses the body of the function from the previous parse with the same tokens, if there is one
+bool reuse_body(parser* p, heck_func* func, int body_end) {
+	const body_reuse* reuse = p->reuse;
+	if (reuse == NULL)
+		return false;
+	
+	// find where the body was in the previous tokens
+	int body_start = func->body_pos;
+	int offset = 0;
+	for (int i = 0; i < reuse->num_edits; ++i) {
+		const heck_token_edit* edit = &reuse->edits[i];
+		if (edit_overlaps(edit, body_start, body_end))
+			return false;
+		
+		if (edit->end > body_start)
+			break;
+		
+		offset += edit->end - edit->old_end;
+	}
+	int prev_start = body_start - offset;
+	
+	// binary search for the previous function
+	heck_func** body_vec = reuse->body_vec;
+	vec_size_t lo = 0, hi = vector_size(body_vec);
+	while (lo < hi) {
+		vec_size_t mid = lo + (hi - lo) / 2;
+		if (body_vec[mid]->body_pos < prev_start)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	
+	if (lo == vector_size(body_vec) || body_vec[lo]->body_pos != prev_start || !body_vec[lo]->body_parsed)
+		return false;
+	
+	// resolved bodies point to names from the previous tree
+	if (body_vec[lo]->status != RESOLVE_PENDING)
+		return false;
+	
+	heck_func* prev = body_vec[lo];
+	heck_scope* parent = func->code->scope->parent;
+	block_free(func->code);
+	
+	// the body is moved, not copied. prev still points to it, but its scope is reparented below,
+	// so name lookups from it no longer reach the previous tree
+	func->code = prev->code;
+	func->body_valid = prev->body_valid;
+	func->num_locals = prev->num_locals; // slots are kept by the body's variables
+	func->has_nested = prev->has_nested;
+	block_reparent(func->code, parent, func);
+	
+	return true;
+}
+
+// parses the global scope, bodies from reuse are used where the tokens haven't changed
+bool parse_code(heck_code* c, const body_reuse* reuse, int num_threads) {
+	
+	// the top level errors are buffered, so the errors in the bodies can be printed between them
+	char* err_buf = NULL;
+	size_t err_size = 0;
+	FILE* err = open_memstream(&err_buf, &err_size);
+	
+	parser p = {
+		.pos = 0, .code = c, .success = true, .err = err != NULL ? err : stderr,
+		.body_vec = vector_create(), .err_mark_vec = vector_create(), .reuse = reuse, .block_end = -1, .panic_pos = -1
+	};
+	dep_graph_begin_parse(c->deps);
+	
+	while (!at_end(&p)) {
+		
+		// there is no block for a stray '}' to close, and panic_mode would stop at it forever
+		if (match(&p, TK_BRAC_R)) {
+			parser_error(&p, previous(&p), 0, "unexpected '}'");
+			continue;
+		}
+		
+		parse_statement(&p, c->global, STMT_FLAG_GLOBAL);
+		
+		if (at_end(&p))
+			break;
+		
+		// TODO: check for newline or ;
+		if (!at_newline(&p) && !match(&p, TK_SEMI)) {
+			parser_error(&p, peek(&p), 0, "expected ; or newline");
+		}
+	}
+	
+	// resolved declarations from the previous tree replace the new ones if nothing they read changed,
+	// so their bodies don't need to be parsed again
+	if (reuse != NULL)
+		dep_graph_update(c->deps, c->global->scope, p.body_vec);
+	
+	if (err != NULL)
+		fclose(err);
+	
+	// declarations are added to shared scopes, so they are parsed in order on this thread,
+	// then the bodies that were skipped are parsed by the workers
+	if (num_threads > 0)
+		parse_bodies(c, p.body_vec, err_buf, err_size, p.err_mark_vec, num_threads);
+	else if (err != NULL)
+		fwrite(err_buf, 1, err_size, stderr);
+	
+	// open_memstream buffers come from the C library, so they aren't tracked
+	free(err_buf);
+	vector_free(p.err_mark_vec);
+	
+	vec_size_t num_bodies = vector_size(p.body_vec);
+	for (vec_size_t i = 0; i < num_bodies; ++i) {
+		if (p.body_vec[i]->body_parsed && !p.body_vec[i]->body_valid)
+			p.success = false;
+	}
+	
+	// keep the functions so their bodies can be reused by heck_reparse
+	if (c->body_vec != NULL)
+		vector_free(c->body_vec);
+	c->body_vec = p.body_vec;
+	
+	return p.success;
+}
+
+// parses bodies from before heck_rescan that were never needed, so the old tokens can be freed
+void finish_prev_bodies(heck_code* c) {
+	heck_token** token_vec = c->token_vec;
+	c->token_vec = c->prev_token_vec;
+	
+	// the errors in the old code were never asked for
+	char* err_buf = NULL;
+	size_t err_size = 0;
+	FILE* err = open_memstream(&err_buf, &err_size);
+	
+	vec_size_t num_bodies = vector_size(c->body_vec);
+	for (vec_size_t i = 0; i < num_bodies; ++i) {
+		heck_func* func = c->body_vec[i];
+		if (func->body_parsed)
+			continue;
+		
+		parser p = { .pos = func->body_pos, .code = c, .success = true, .err = err != NULL ? err : stderr, .block_end = -1, .panic_pos = -1 };
+		parse_func_body(&p, func);
+	}
+	
+	if (err != NULL) {
+		fclose(err);
+		free(err_buf);
+	}
+	
+	c->token_vec = token_vec;
+}
+
+bool heck_reparse(heck_code* c, const heck_token_edit* edits, int num_edits, int num_threads) {
+	
+	if (c->prev_token_vec != NULL) {
+		if (c->body_vec != NULL)
+			finish_prev_bodies(c);
+		heck_free_token_vec(c->prev_token_vec);
+		c->prev_token_vec = NULL;
+	}
+	
+	body_reuse reuse = { .body_vec = c->body_vec, .edits = edits, .num_edits = num_edits };
+	c->body_vec = NULL;
+	
+	// the previous root is replaced, not freed, because reused bodies and kept declarations
+	// are moved out of it into the new tree
+	heck_scope* global_scope = scope_create(NULL);
+	global_scope->namespace = global_scope;
+	c->global = block_create(global_scope);
+	
+	bool success = parse_code(c, reuse.body_vec != NULL ? &reuse : NULL, num_threads);
+	
+	if (reuse.body_vec != NULL)
+		vector_free(reuse.body_vec);
+	
+	return success;
+}
+
+bool heck_parse(heck_code* c, int num_threads) {
+	return parse_code(c, NULL, num_threads);
 }
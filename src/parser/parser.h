@@ -8,11 +8,31 @@
 #ifndef parser_h
 #define parser_h
 
+#include <stdio.h>
 #include <stdbool.h>
 #include "code.h"
+#include "declarations.h"
 
 typedef struct heck_parser heck_parser;
 
-bool heck_parse(heck_code* c);
+// function bodies are skipped while parsing declarations, then parsed by num_threads workers.
+// if num_threads is 0, each body is parsed the first time it is needed instead.
+bool heck_parse(heck_code* c, int num_threads);
+
+// only checks the syntax, no syntax tree is created and nothing is resolved.
+// the tokens still have to be scanned first, blocks are skipped using the index of their '}'
+bool heck_check(heck_code* c);
+
+// parses the code again after heck_rescan. function bodies from the previous parse are reused
+// if none of their tokens are inside of edits, which must be sorted and must not overlap.
+// resolved functions and variables in the global scope are kept as they are if nothing they
+// depend on was edited, so only the declarations affected by the edits are resolved again.
+// the previous tree can't be used afterwards: reused bodies and kept declarations are moved
+// into the new tree, and the rest of it is never freed, like the tree itself in heck_free.
+bool heck_reparse(heck_code* c, const heck_token_edit* edits, int num_edits, int num_threads);
+
+// parses a function body that was skipped by heck_parse, does nothing if it was already parsed.
+// syntax errors are written to err
+bool heck_parse_func_body(heck_code* c, heck_func* func, FILE* err);
 
 #endif /* parser_h */
@@ -0,0 +1,315 @@
+//
+//  dep_graph.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "dep_graph.h"
+#include "scope.h"
+#include "function.h"
+#include "idf_map.h"
+#include "vec.h"
+#include "mem.h"
+
+struct heck_dep_graph {
+	idf_map* nodes; // key -> heck_dep_node*
+	heck_dep_node** node_vec; // in the order they were first declared
+	int mark;
+};
+
+// the reads of the declaration being resolved on this thread, NULL if nothing is being recorded
+static _Thread_local heck_dep_node*** current_reads = NULL;
+
+heck_dep_graph* dep_graph_create(void) {
+	heck_dep_graph* graph = mem_alloc(sizeof(heck_dep_graph), MEM_SCOPES);
+	graph->nodes = idf_map_create();
+	graph->node_vec = vector_create();
+	graph->mark = 0;
+	return graph;
+}
+
+void dep_graph_free(heck_dep_graph* graph) {
+	vec_size_t num_nodes = vector_size(graph->node_vec);
+	for (vec_size_t i = 0; i < num_nodes; ++i) {
+		heck_dep_node* node = graph->node_vec[i];
+		vector_free(node->dep_vec);
+		vector_free(node->user_vec);
+		vector_free(node->read_vec);
+	}
+	vector_free(graph->node_vec);
+	idf_map_free(graph->nodes); // frees the nodes too
+	mem_free(graph);
+}
+
+static heck_dep_node* dep_graph_get(heck_dep_graph* graph, str_entry key) {
+	heck_dep_node* node = NULL;
+	if (idf_map_get(graph->nodes, key, (void*)&node))
+		return node;
+	
+	node = mem_calloc(1, sizeof(heck_dep_node), MEM_SCOPES);
+	node->key = key;
+	node->dep_vec = vector_create();
+	node->user_vec = vector_create();
+	node->read_vec = vector_create();
+	idf_map_set(graph->nodes, key, node);
+	vector_add(&graph->node_vec, node);
+	
+	return node;
+}
+
+void dep_graph_begin_parse(heck_dep_graph* graph) {
+	vec_size_t num_nodes = vector_size(graph->node_vec);
+	for (vec_size_t i = 0; i < num_nodes; ++i) {
+		heck_dep_node* node = graph->node_vec[i];
+		node->prev_name = node->resolved ? node->name : NULL;
+		node->name = NULL;
+		node->prev_num_decls = node->num_decls;
+		node->num_decls = 0;
+		node->edited = false;
+		node->resolved = false;
+		node->kept = false;
+		node->fresh = false;
+	}
+}
+
+heck_dep_node* dep_graph_declare(heck_dep_graph* graph, str_entry key, heck_name* name, bool edited) {
+	heck_dep_node* node = dep_graph_get(graph, key);
+	if (name != NULL) {
+		node->name = name;
+		name->dep = node;
+	}
+	++node->num_decls;
+	node->edited = node->edited || edited;
+	node->fresh = true;
+	
+	return node;
+}
+
+// true if a node's own declarations allow the previous one to be kept, without looking at its dependencies
+static bool dep_node_unchanged(const heck_dep_node* node) {
+	if (node->prev_name == NULL || node->edited || node->untracked || node->num_decls != node->prev_num_decls)
+		return false;
+	
+	if (node->prev_name->type == IDF_FUNCTION) {
+		return node->name != NULL && node->name->type == IDF_FUNCTION &&
+			vector_size(node->name->value.func_value.func_vec) == vector_size(node->prev_name->value.func_value.func_vec);
+	}
+	
+	// variables aren't declared until they're resolved
+	return node->prev_name->type == IDF_VARIABLE && node->name == NULL;
+}
+
+// puts the overloads from the previous tree in place of the new ones, which are never used
+static void dep_node_keep_funcs(heck_dep_node* node, heck_scope* global, heck_func** body_vec) {
+	heck_func** prev_vec = node->prev_name->value.func_value.func_vec;
+	heck_func** new_vec = node->name->value.func_value.func_vec;
+	
+	vec_size_t num_funcs = vector_size(prev_vec);
+	for (vec_size_t i = 0; i < num_funcs; ++i) {
+		heck_func* prev = prev_vec[i];
+		prev->body_pos = new_vec[i]->body_pos;
+		block_reparent(prev->code, global, prev);
+		
+		// body_vec is sorted by body_pos
+		vec_size_t lo = 0, hi = vector_size(body_vec);
+		while (lo < hi) {
+			vec_size_t mid = lo + (hi - lo) / 2;
+			if (body_vec[mid]->body_pos < prev->body_pos)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		if (lo < vector_size(body_vec) && body_vec[lo] == new_vec[i])
+			body_vec[lo] = prev;
+	}
+	
+	node->prev_name->parent = global;
+	idf_map_set(global->names, node->key, node->prev_name);
+	node->name = node->prev_name;
+	node->fresh = false;
+}
+
+void dep_graph_update(heck_dep_graph* graph, heck_scope* global, heck_func** body_vec) {
+	heck_dep_node** stack = vector_create();
+	
+	vec_size_t num_nodes = vector_size(graph->node_vec);
+	for (vec_size_t i = 0; i < num_nodes; ++i) {
+		heck_dep_node* node = graph->node_vec[i];
+		node->kept = dep_node_unchanged(node);
+		if (!node->kept)
+			vector_add(&stack, node);
+	}
+	
+	// everything that read a changed declaration has to be resolved again, and so on
+	while (vector_size(stack) > 0) {
+		heck_dep_node* node = stack[vector_size(stack) - 1];
+		vector_remove(stack, vector_size(stack) - 1);
+		
+		vec_size_t num_users = vector_size(node->user_vec);
+		for (vec_size_t i = 0; i < num_users; ++i) {
+			heck_dep_node* user = node->user_vec[i];
+			if (user->kept) {
+				user->kept = false;
+				vector_add(&stack, user);
+			}
+		}
+	}
+	vector_free(stack);
+	
+	for (vec_size_t i = 0; i < num_nodes; ++i) {
+		heck_dep_node* node = graph->node_vec[i];
+		if (!node->kept)
+			continue;
+		
+		node->resolved = true;
+		if (node->name != NULL)
+			dep_node_keep_funcs(node, global, body_vec);
+		else
+			node->name = node->prev_name;
+	}
+}
+
+heck_name* dep_graph_declare_var(heck_dep_graph* graph, heck_scope* global, heck_stmt_let* let_stmt) {
+	heck_dep_node* node = NULL;
+	idf_map_get(graph->nodes, let_stmt->name, (void*)&node);
+	
+	heck_name* taken = NULL;
+	if (node != NULL && node->kept && (global->names == NULL || !idf_map_get(global->names, let_stmt->name, (void*)&taken))) {
+		heck_name* var = node->name;
+		var->parent = global;
+		
+		// the new value was never resolved, the statement gets the resolved one
+		let_stmt->value = var->value.var_value;
+		
+		if (global->names == NULL)
+			global->names = idf_map_create();
+		idf_map_set(global->names, let_stmt->name, var);
+		
+		return var;
+	}
+	
+	heck_name* var = scope_add_var(global, let_stmt->name, let_stmt->value);
+	if (var != NULL && node != NULL) {
+		node->name = var;
+		var->dep = node;
+	}
+	return var;
+}
+
+heck_dep_node*** dep_begin(heck_dep_node*** read_vec) {
+	heck_dep_node*** prev_read_vec = current_reads;
+	current_reads = read_vec;
+	return prev_read_vec;
+}
+
+void dep_end(heck_dep_node*** prev_read_vec) {
+	current_reads = prev_read_vec;
+}
+
+void dep_record(const heck_name* name) {
+	heck_dep_node*** read_vec = current_reads;
+	if (read_vec == NULL)
+		return;
+	
+	// locals can only be read from inside of the body they're in
+	if (name->parent->func != NULL)
+		return;
+	
+	// NULL stands for anything that isn't tracked
+	vec_size_t num_reads = vector_size(*read_vec);
+	if (num_reads > 0 && (*read_vec)[num_reads - 1] == name->dep)
+		return;
+	vector_add(read_vec, name->dep);
+}
+
+// functions with classes in their signatures keep pointing to the classes from the tree they were resolved in
+static bool type_has_class(const heck_data_type* type) {
+	while (type->type_name == TYPE_ARR)
+		type = type->type_value.prim_arr_type;
+	return type->type_name == TYPE_CLASS;
+}
+
+static void dep_node_add_reads(heck_dep_graph* graph, heck_dep_node* node, heck_dep_node*** read_vec) {
+	vec_size_t num_reads = vector_size(*read_vec);
+	for (vec_size_t i = 0; i < num_reads; ++i) {
+		heck_dep_node* dep = (*read_vec)[i];
+		if (dep == NULL) {
+			node->untracked = true;
+		} else if (dep->mark != graph->mark) {
+			dep->mark = graph->mark;
+			vector_add(&node->dep_vec, dep);
+			vector_add(&dep->user_vec, node);
+		}
+	}
+	
+	vector_free(*read_vec);
+	*read_vec = vector_create();
+}
+
+void dep_graph_commit(heck_dep_graph* graph) {
+	vec_size_t num_nodes = vector_size(graph->node_vec);
+	for (vec_size_t i = 0; i < num_nodes; ++i) {
+		heck_dep_node* node = graph->node_vec[i];
+		
+		// kept declarations still depend on the same things
+		if (!node->fresh && node->name != NULL)
+			continue;
+		node->fresh = false;
+		
+		vec_size_t num_deps = vector_size(node->dep_vec);
+		for (vec_size_t j = 0; j < num_deps; ++j) {
+			heck_dep_node* dep = node->dep_vec[j];
+			vec_size_t num_users = vector_size(dep->user_vec);
+			for (vec_size_t k = 0; k < num_users; ++k) {
+				if (dep->user_vec[k] == node) {
+					dep->user_vec[k] = dep->user_vec[num_users - 1];
+					vector_remove(dep->user_vec, num_users - 1);
+					break;
+				}
+			}
+		}
+		vector_free(node->dep_vec);
+		node->dep_vec = vector_create();
+		node->untracked = false;
+		node->resolved = false;
+		
+		heck_name* name = node->name;
+		if (name == NULL)
+			continue;
+		
+		// a declaration that reads itself doesn't depend on itself
+		node->mark = ++graph->mark;
+		
+		if (name->type == IDF_FUNCTION) {
+			node->resolved = true;
+			heck_func** func_vec = name->value.func_value.func_vec;
+			vec_size_t num_funcs = vector_size(func_vec);
+			for (vec_size_t j = 0; j < num_funcs; ++j) {
+				heck_func* func = func_vec[j];
+				dep_node_add_reads(graph, node, &func->read_vec);
+				
+				// instances of generic functions are shared between everything that calls them
+				if (func->generic)
+					node->untracked = true;
+				
+				vec_size_t num_params = vector_size(func->param_vec);
+				for (vec_size_t k = 0; k < num_params; ++k) {
+					if (type_has_class(func->param_vec[k]->type))
+						node->untracked = true;
+				}
+				
+				node->resolved = node->resolved && func->status == RESOLVE_DONE;
+			}
+		} else if (name->type == IDF_VARIABLE) {
+			dep_node_add_reads(graph, node, &node->read_vec);
+			node->resolved = name->status == RESOLVE_DONE;
+		}
+	}
+}
+
+void dep_graph_forget(heck_dep_graph* graph) {
+	vec_size_t num_nodes = vector_size(graph->node_vec);
+	for (vec_size_t i = 0; i < num_nodes; ++i)
+		graph->node_vec[i]->resolved = false;
+}
@@ -0,0 +1,79 @@
+//
+//  dep_graph.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Keeps track of what each declaration in the global scope read the last time it was resolved,
+//	so a reparse can keep the resolved declarations that nothing it changed could have affected.
+//	Functions are tracked by name, so a node stands for the whole overload set.
+//
+
+#ifndef dep_graph_h
+#define dep_graph_h
+
+#include <stdbool.h>
+#include "str.h"
+#include "declarations.h"
+#include "statement.h"
+
+typedef struct heck_dep_graph heck_dep_graph;
+
+struct heck_dep_node {
+	str_entry key;
+	heck_name* name; // the declaration in the newest tree, NULL if there isn't one
+	heck_name* prev_name; // the declaration from the previous tree if it was resolved without errors
+	
+	heck_dep_node** dep_vec; // the declarations this one read the last time it was resolved
+	heck_dep_node** user_vec; // the declarations that read this one
+	heck_dep_node** read_vec; // filled while a variable is resolved, functions have one for each overload
+	
+	int num_decls, prev_num_decls; // a function has a declaration for each overload
+	bool edited; // one of the declarations has tokens that were edited
+	bool untracked; // read something outside of the graph, like a class, so it can't be kept
+	bool resolved; // the current declaration was resolved without errors
+	bool kept; // the declaration from the previous tree is used instead of the new one
+	bool fresh; // declared by the last parse and not committed yet
+	int mark;
+};
+
+heck_dep_graph* dep_graph_create(void);
+void dep_graph_free(heck_dep_graph* graph);
+
+/*
+ *	Parsing
+ */
+
+// called before parsing the global scope, the current declarations become the previous ones
+void dep_graph_begin_parse(heck_dep_graph* graph);
+
+// adds a declaration from the global scope to a node, name is NULL for variables until they are declared
+heck_dep_node* dep_graph_declare(heck_dep_graph* graph, str_entry key, heck_name* name, bool edited);
+
+// decides which declarations from the previous tree are kept. a declaration is only kept if it
+// was resolved without errors, it wasn't edited, and nothing it depends on, directly or not, was either.
+// functions that are kept replace the new ones in the global scope and in body_vec.
+void dep_graph_update(heck_dep_graph* graph, heck_scope* global, heck_func** body_vec);
+
+/*
+ *	Resolving
+ */
+
+// declares a variable in the global scope, or puts back the one from the previous tree if it was kept
+heck_name* dep_graph_declare_var(heck_dep_graph* graph, heck_scope* global, heck_stmt_let* let_stmt);
+
+// the declarations read on this thread are added to read_vec until dep_end is called with the result.
+// read_vec can be NULL to stop recording, e.g. for declarations that aren't tracked
+heck_dep_node*** dep_begin(heck_dep_node*** read_vec);
+void dep_end(heck_dep_node*** prev_read_vec);
+
+// adds name to the reads of the declaration being resolved on this thread, if it is shared
+void dep_record(const heck_name* name);
+
+// replaces the dependencies of the declarations that were resolved since the last parse
+void dep_graph_commit(heck_dep_graph* graph);
+
+// none of the current declarations are kept by the next reparse, e.g. once heck_shake has removed overloads
+void dep_graph_forget(heck_dep_graph* graph);
+
+#endif /* dep_graph_h */
@@ -9,10 +9,429 @@
 #include "types.h"
 #include "scope.h"
 #include "function.h"
+#include "class.h"
 #include "statement.h"
 #include "code_impl.h"
+#include "dep_graph.h"
+#include "mem.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
-// WOW, this function really deserves its own file
-bool heck_resolve(heck_code* c) {
-	return resolve_block(c->global, c->global->scope);
+/*
+ *	Declarations are resolved on demand. Variables in global, namespace, and class scopes are
+ *	declared before anything is resolved, so they can be used before the statement that declares them.
+ *	Then every function body is resolved, on multiple threads if there are enough of them.
+ *	Resolving a value resolves the variable it refers to, and resolving a call resolves the
+ *	function it calls, each exactly once no matter which body or thread needs it first.
+ */
+
+// declares the variables in a global or namespace block and its nested namespaces.
+// deps is only used for the global block, variables in namespaces aren't tracked
+bool declare_block(heck_block* block, heck_name*** var_vec, heck_dep_graph* deps) {
+	bool result = true;
+	
+	vec_size_t num_stmts = vector_size(block->stmt_vec);
+	for (vec_size_t i = 0; i < num_stmts; ++i) {
+		heck_stmt* stmt = block->stmt_vec[i];
+		if (stmt->type == STMT_LET) {
+			heck_stmt_let* let_stmt = stmt->value.let_stmt;
+			heck_name* var = deps != NULL ?
+				dep_graph_declare_var(deps, block->scope, let_stmt) :
+				scope_add_var(block->scope, let_stmt->name, let_stmt->value);
+			if (var == NULL) {
+				result = false;
+			} else {
+				vector_add(var_vec, var);
+			}
+		} else if (stmt->type == STMT_BLOCK) {
+			result = declare_block(stmt->value.block, var_vec, NULL) && result;
+		}
+	}
+	
+	return result;
+}
+
+typedef struct declare_ctx {
+	heck_name** var_vec; // every variable that was declared, in order
+	bool result;
+} declare_ctx;
+
+// declares the member variables of every class in a scope and its child scopes
+void declare_members(str_entry key, void* value, void* user_ptr) {
+	heck_name* name = value;
+	declare_ctx* ctx = user_ptr;
+	
+	if (name->child_scope == NULL)
+		return;
+	
+	heck_scope* scope = name->child_scope;
+	if (name->type == IDF_CLASS && scope->decl_vec != NULL) {
+		vec_size_t num_decls = vector_size(scope->decl_vec);
+		for (vec_size_t i = 0; i < num_decls; ++i) {
+			heck_stmt* decl = scope->decl_vec[i];
+			if (decl->type != STMT_LET)
+				continue;
+			
+			heck_stmt_let* let_stmt = decl->value.let_stmt;
+			heck_name* var = scope_add_var(scope, let_stmt->name, let_stmt->value);
+			if (var == NULL) {
+				ctx->result = false;
+			} else {
+				vector_add(&ctx->var_vec, var);
+			}
+		}
+	}
+	
+	// nested classes and namespaces
+	if (scope->names != NULL)
+		idf_map_iterate(scope->names, declare_members, user_ptr);
+}
+
+/*
+ *
+ * Resolving Function Bodies
+ *
+ */
+
+// the errors a worker wrote while it was resolving a declaration
+typedef struct resolve_segment {
+	const void* decl; // the status of the declaration
+	size_t order; // where the declaration's errors are printed
+	int worker;
+	long start, end;
+	const char* text; // only set for declarations without a place of their own
+} resolve_segment;
+
+typedef struct resolve_worker resolve_worker;
+
+typedef struct resolve_pool {
+	heck_scope* global;
+	heck_func** job_vec;
+	atomic_size_t next_job; // bodies vary a lot in size, so workers take the next job when they are done
+	
+	resolve_worker* workers;
+	int num_workers;
+	
+	// guards claiming and finishing declarations, done is signaled whenever one is finished
+	pthread_mutex_t lock;
+	pthread_cond_t done;
+} resolve_pool;
+
+struct resolve_worker {
+	resolve_pool* pool;
+	int id;
+	FILE* err;
+	char* err_buf;
+	size_t err_size;
+	pthread_t thread;
+	
+	const void** claim_vec; // the declarations this worker is resolving, innermost last
+	const void* waiting_on; // a declaration claimed by another worker, or NULL
+	resolve_segment* segment_vec;
+};
+
+// NULL on the main thread outside of resolve_bodies
+static _Thread_local resolve_worker* current_worker = NULL;
+
+FILE* resolve_err(void) {
+	return current_worker == NULL ? stderr : current_worker->err;
+}
+
+// errors are written to the innermost declaration being resolved
+void resolve_begin_segment(resolve_worker* w) {
+	vec_size_t num_claims = vector_size(w->claim_vec);
+	if (num_claims == 0)
+		return;
+	
+	resolve_segment* segment = vector_add_asg(&w->segment_vec);
+	segment->decl = w->claim_vec[num_claims - 1];
+	segment->worker = w->id;
+	segment->start = ftell(w->err);
+	segment->end = -1;
+}
+
+void resolve_end_segment(resolve_worker* w) {
+	vec_size_t num_segments = vector_size(w->segment_vec);
+	if (num_segments > 0 && w->segment_vec[num_segments - 1].end == -1)
+		w->segment_vec[num_segments - 1].end = ftell(w->err);
+}
+
+// the worker that claimed a declaration, or NULL if nobody has
+resolve_worker* resolve_owner(resolve_pool* pool, const void* status) {
+	for (int i = 0; i < pool->num_workers; ++i) {
+		resolve_worker* w = &pool->workers[i];
+		vec_size_t num_claims = vector_size(w->claim_vec);
+		for (vec_size_t j = 0; j < num_claims; ++j) {
+			if (w->claim_vec[j] == status)
+				return w;
+		}
+	}
+	return NULL;
+}
+
+heck_resolve_status resolve_claim(_Atomic heck_resolve_status* status) {
+	heck_resolve_status result = atomic_load_explicit(status, memory_order_acquire);
+	if (result == RESOLVE_DONE || result == RESOLVE_FAILED)
+		return result;
+	
+	resolve_worker* w = current_worker;
+	if (w == NULL) {
+		// only one thread is resolving, so an active declaration is always a cycle
+		if (result == RESOLVE_PENDING)
+			atomic_store_explicit(status, RESOLVE_ACTIVE, memory_order_relaxed);
+		return result;
+	}
+	
+	resolve_pool* pool = w->pool;
+	pthread_mutex_lock(&pool->lock);
+	for (;;) {
+		result = atomic_load_explicit(status, memory_order_relaxed);
+		if (result == RESOLVE_PENDING) {
+			atomic_store_explicit(status, RESOLVE_ACTIVE, memory_order_relaxed);
+			resolve_end_segment(w);
+			vector_add(&w->claim_vec, status);
+			resolve_begin_segment(w);
+			break;
+		}
+		if (result != RESOLVE_ACTIVE)
+			break;
+		
+		// follow the workers that are waiting on each other, if the chain leads back here then
+		// waiting would never end, so it's treated the same way as recursion on a single thread
+		resolve_worker* owner = resolve_owner(pool, status);
+		while (owner != NULL && owner != w && owner->waiting_on != NULL)
+			owner = resolve_owner(pool, owner->waiting_on);
+		if (owner == w)
+			break;
+		
+		w->waiting_on = status;
+		pthread_cond_wait(&pool->done, &pool->lock);
+		w->waiting_on = NULL;
+	}
+	pthread_mutex_unlock(&pool->lock);
+	
+	return result;
+}
+
+void resolve_finish(_Atomic heck_resolve_status* status, bool success) {
+	heck_resolve_status result = success ? RESOLVE_DONE : RESOLVE_FAILED;
+	
+	resolve_worker* w = current_worker;
+	if (w == NULL) {
+		atomic_store_explicit(status, result, memory_order_relaxed);
+		return;
+	}
+	
+	resolve_pool* pool = w->pool;
+	pthread_mutex_lock(&pool->lock);
+	atomic_store_explicit(status, result, memory_order_release);
+	
+	// claims are finished in the reverse order they were made
+	resolve_end_segment(w);
+	vector_remove(w->claim_vec, vector_size(w->claim_vec) - 1);
+	resolve_begin_segment(w);
+	
+	pthread_cond_broadcast(&pool->done);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+void* resolve_worker_run(void* arg) {
+	resolve_worker* w = arg;
+	resolve_pool* pool = w->pool;
+	current_worker = w;
+	
+	vec_size_t num_jobs = vector_size(pool->job_vec);
+	for (;;) {
+		size_t i = atomic_fetch_add(&pool->next_job, 1);
+		if (i >= num_jobs)
+			break;
+		
+		// does nothing if the body was already resolved for a call in another body
+		func_def_resolve(pool->job_vec[i], pool->global);
+	}
+	
+	current_worker = NULL;
+	return NULL;
+}
+
+// a declaration and the position its errors are printed in
+typedef struct resolve_order {
+	const void* decl;
+	size_t order;
+} resolve_order;
+
+int resolve_order_cmp(const void* a, const void* b) {
+	const void* decl_a = ((const resolve_order*)a)->decl;
+	const void* decl_b = ((const resolve_order*)b)->decl;
+	return (decl_a > decl_b) - (decl_a < decl_b);
+}
+
+int resolve_segment_cmp(const void* a, const void* b) {
+	const resolve_segment* seg_a = a;
+	const resolve_segment* seg_b = b;
+	
+	if (seg_a->order != seg_b->order)
+		return seg_a->order < seg_b->order ? -1 : 1;
+	
+	// any worker can resolve generic instances, so their errors are sorted by what they say
+	if (seg_a->text != NULL) {
+		long len_a = seg_a->end - seg_a->start;
+		long len_b = seg_b->end - seg_b->start;
+		int cmp = memcmp(seg_a->text, seg_b->text, len_a < len_b ? len_a : len_b);
+		return cmp != 0 ? cmp : (len_a > len_b) - (len_a < len_b);
+	}
+	
+	// every segment of a declaration was written by the worker that claimed it
+	return (seg_a->start > seg_b->start) - (seg_a->start < seg_b->start);
+}
+
+// prints the errors of global variables, then function bodies, in source order,
+// so the output doesn't depend on which thread got to a declaration first
+void resolve_print_errors(resolve_pool* pool, heck_name** var_vec, heck_func** body_vec) {
+	vec_size_t num_vars = vector_size(var_vec);
+	vec_size_t num_bodies = vector_size(body_vec);
+	size_t num_orders = num_vars + num_bodies;
+	
+	resolve_order* orders = mem_alloc(sizeof(resolve_order) * (num_orders + 1), MEM_AST);
+	for (vec_size_t i = 0; i < num_vars; ++i)
+		orders[i] = (resolve_order){ &var_vec[i]->status, i };
+	for (vec_size_t i = 0; i < num_bodies; ++i)
+		orders[num_vars + i] = (resolve_order){ &body_vec[i]->status, num_vars + i };
+	qsort(orders, num_orders, sizeof(resolve_order), resolve_order_cmp);
+	
+	size_t num_segments = 0;
+	for (int i = 0; i < pool->num_workers; ++i)
+		num_segments += vector_size(pool->workers[i].segment_vec);
+	
+	resolve_segment* segments = mem_alloc(sizeof(resolve_segment) * (num_segments + 1), MEM_AST);
+	num_segments = 0;
+	for (int i = 0; i < pool->num_workers; ++i) {
+		resolve_worker* w = &pool->workers[i];
+		vec_size_t num_worker_segments = vector_size(w->segment_vec);
+		for (vec_size_t j = 0; j < num_worker_segments; ++j) {
+			resolve_segment segment = w->segment_vec[j];
+			if (segment.end <= segment.start)
+				continue;
+			
+			// declarations without a place of their own go last, like generic instances
+			resolve_order key = { segment.decl, 0 };
+			resolve_order* found = bsearch(&key, orders, num_orders, sizeof(resolve_order), resolve_order_cmp);
+			segment.order = found == NULL ? num_orders : found->order;
+			segment.text = found == NULL ? &w->err_buf[segment.start] : NULL;
+			segments[num_segments++] = segment;
+		}
+	}
+	
+	qsort(segments, num_segments, sizeof(resolve_segment), resolve_segment_cmp);
+	for (size_t i = 0; i < num_segments; ++i) {
+		resolve_segment* segment = &segments[i];
+		fwrite(&pool->workers[segment->worker].err_buf[segment->start], 1, segment->end - segment->start, stderr);
+	}
+	
+	mem_free(segments);
+	mem_free(orders);
+}
+
+// resolves every function body in body_vec. only a function's own body is written to while it is
+// resolved, and shared declarations are claimed with resolve_claim, so the bodies can be resolved
+// in any order. the errors are printed once every body is resolved.
+bool resolve_bodies(heck_func** body_vec, heck_name** var_vec, heck_scope* global, int num_threads) {
+	vec_size_t num_bodies = vector_size(body_vec);
+	
+	resolve_pool pool = { .global = global, .num_workers = 0 };
+	pool.job_vec = vector_create();
+	atomic_init(&pool.next_job, 0);
+	for (vec_size_t i = 0; i < num_bodies; ++i) {
+		// generic functions are resolved for each set of argument types
+		if (!body_vec[i]->generic)
+			vector_add(&pool.job_vec, body_vec[i]);
+	}
+	
+	// a single worker still buffers its errors, so the output is the same for any number of threads
+	vec_size_t num_jobs = vector_size(pool.job_vec);
+	if (num_threads > num_jobs)
+		num_threads = (int)num_jobs;
+	if (num_threads < 1)
+		num_threads = 1;
+	
+	pthread_mutex_init(&pool.lock, NULL);
+	pthread_cond_init(&pool.done, NULL);
+	
+	// workers must exist before any of them start, resolve_owner looks through all of them
+	pool.workers = mem_alloc(sizeof(resolve_worker) * num_threads, MEM_AST);
+	for (; pool.num_workers < num_threads; ++pool.num_workers) {
+		resolve_worker* w = &pool.workers[pool.num_workers];
+		w->pool = &pool;
+		w->id = pool.num_workers;
+		w->err = open_memstream(&w->err_buf, &w->err_size);
+		if (w->err == NULL)
+			break;
+		w->claim_vec = vector_create();
+		w->waiting_on = NULL;
+		w->segment_vec = vector_create();
+	}
+	
+	// the calling thread is worker 0
+	int num_started = pool.num_workers > 0 ? 1 : 0;
+	for (; num_started < pool.num_workers; ++num_started) {
+		resolve_worker* w = &pool.workers[num_started];
+		if (pthread_create(&w->thread, NULL, resolve_worker_run, w) != 0)
+			break;
+	}
+	
+	if (pool.num_workers > 0)
+		resolve_worker_run(&pool.workers[0]);
+	
+	for (int i = 1; i < num_started; ++i)
+		pthread_join(pool.workers[i].thread, NULL);
+	for (int i = 0; i < pool.num_workers; ++i)
+		fclose(pool.workers[i].err);
+	
+	resolve_print_errors(&pool, var_vec, body_vec);
+	
+	// every body has been resolved unless no worker could be started
+	bool result = true;
+	for (vec_size_t i = 0; i < num_jobs; ++i)
+		result = func_def_resolve(pool.job_vec[i], global) && result;
+	
+	// open_memstream buffers come from the C library, so they aren't tracked
+	for (int i = 0; i < pool.num_workers; ++i) {
+		free(pool.workers[i].err_buf);
+		vector_free(pool.workers[i].claim_vec);
+		vector_free(pool.workers[i].segment_vec);
+	}
+	mem_free(pool.workers);
+	vector_free(pool.job_vec);
+	
+	pthread_cond_destroy(&pool.done);
+	pthread_mutex_destroy(&pool.lock);
+	
+	return result;
+}
+
+bool heck_resolve(heck_code* c, int num_threads) {
+	heck_scope* global = c->global->scope;
+	
+	declare_ctx ctx = { vector_create(), true };
+	ctx.result = declare_block(c->global, &ctx.var_vec, c->deps);
+	if (global->names != NULL)
+		idf_map_iterate(global->names, declare_members, &ctx);
+	
+	// the hierarchy is needed before any body, calls are matched with subtypes
+	bool result = class_hierarchy_build(global) && ctx.result;
+	
+	// bodies only depend on each other through declarations, which are resolved the first time they're needed
+	if (c->body_vec != NULL)
+		result = resolve_bodies(c->body_vec, ctx.var_vec, global, num_threads) && result;
+	vector_free(ctx.var_vec);
+	
+	// most of the global code was already resolved for the bodies
+	result = resolve_block(c->global, global) && result;
+	
+	// the next reparse keeps what was resolved here unless something it read changes
+	dep_graph_commit(c->deps);
+	
+	return result;
 }
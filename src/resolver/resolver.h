@@ -10,7 +10,24 @@
 
 #include <stdio.h>
 #include "code.h"
+#include "declarations.h"
 
-bool heck_resolve(heck_code* c);
+// declarations are resolved first, then function bodies are resolved by num_threads workers,
+// then the rest of the global code. errors from the bodies are printed in source order.
+bool heck_resolve(heck_code* c, int num_threads);
+
+/*
+ *	Functions and variables outside of functions can be reached from more than one body,
+ *	so they are claimed by the first thread that needs them and the others wait for the result.
+ */
+
+// claims a declaration for the calling thread. returns RESOLVE_PENDING if the caller should resolve it
+// and call resolve_finish, RESOLVE_ACTIVE if it depends on itself (recursion or a cycle between threads),
+// and otherwise the result once it is resolved.
+heck_resolve_status resolve_claim(_Atomic heck_resolve_status* status);
+void resolve_finish(_Atomic heck_resolve_status* status, bool success);
+
+// errors found while resolving are written here instead of stderr so each worker can buffer them
+FILE* resolve_err(void);
 
 #endif /* resolver_h */
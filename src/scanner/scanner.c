@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include "str.h"
+#include "mem.h"
 
 typedef struct file_pos file_pos;
 
@@ -122,7 +123,13 @@ bool match_str(file_pos* fp, char* s) {
 	// you need to properly update fp->ln and fp->ch (which can't be l_pos)
 	fp->ch += s_pos;
 	fp->pos = l_pos;
-	fp->current = fp->file[fp->pos];
+	
+	// like scan_step, count the newline if the string ended a line
+	if (match_newline(fp)) {
+		fp->current = '\n';
+	} else {
+		fp->current = fp->file[fp->pos];
+	}
 	
 	return true;
 }
@@ -145,7 +152,7 @@ bool is_space_line_end(file_pos* fp) {
 }
 
 heck_token* add_token(heck_code* c, file_pos* fp, enum heck_tk_type type) {
-	heck_token* tk = malloc(sizeof(heck_token));
+	heck_token* tk = mem_alloc(sizeof(heck_token), MEM_TOKENS);
 	tk->ln = fp->tk_ln;
 	tk->ch = fp->tk_ch;
 	tk->type = type;
@@ -165,6 +172,34 @@ heck_token* add_token(heck_code* c, file_pos* fp, enum heck_tk_type type) {
 #define add_token_err(c, fp)				(add_token(c, fp, TK_ERR))
 #define add_token_ctx(c, fp, ctxval)		(add_token(c, fp, TK_CTX)->value.ctx_value = ctxval)
 
+// brackets are matched while scanning so the parser can skip over them
+// bracket_stack holds the indices of the unmatched opening brackets
+void add_bracket_l(heck_code* c, file_pos* fp, enum heck_tk_type type, int** bracket_stack) {
+	int pos = (int)vector_size(c->token_vec);
+	add_token(c, fp, type)->value.match_pos = -1;
+	vector_add(bracket_stack, pos);
+}
+
+void add_bracket_r(heck_code* c, file_pos* fp, enum heck_tk_type type, int** bracket_stack) {
+	int pos = (int)vector_size(c->token_vec);
+	heck_token* tk = add_token(c, fp, type);
+	tk->value.match_pos = -1;
+	
+	// find the nearest opening bracket of the same kind, the closing type is always one more than the opening type.
+	// any brackets opened after it are left unmatched so one mistake doesn't unmatch everything around it
+	vec_size_t depth = vector_size(*bracket_stack);
+	while (depth > 0) {
+		int open_pos = (*bracket_stack)[--depth];
+		heck_token* open = c->token_vec[open_pos];
+		if (open->type == type - 1) {
+			open->value.match_pos = pos;
+			tk->value.match_pos = open_pos;
+			vector_erase(*bracket_stack, depth, vector_size(*bracket_stack) - depth);
+			return;
+		}
+	}
+}
+
 // forward declarations
 bool parse_string(heck_code* c, file_pos* fp);
 void parse_number(heck_code* c, file_pos* fp);
@@ -189,13 +224,15 @@ bool heck_scan(heck_code* c, FILE* f) {
 	fp.size = ftell(f);
 	rewind(f);
 	
-	char* buffer = (char*)malloc(fp.size + 1);
+	char* buffer = (char*)mem_alloc(fp.size + 1, MEM_SOURCE);
 	fread(buffer, sizeof(char), fp.size, f);
 	buffer[fp.size] = '\0';
 	
 	fp.file = buffer;
 	buffer = NULL;
 	
+	int* bracket_stack = vector_create();
+	
 	// initialize scanner state
 	match_newline(&fp); // prevents the scanner from ignoring a potential newline at the beginning of a file
 	fp.current = fp.file[fp.pos]; // initialize fp.current (must use fp.pos in case of matched newline)
@@ -225,22 +262,22 @@ bool heck_scan(heck_code* c, FILE* f) {
 				add_token(c, &fp, TK_COMMA);
 				break;
 			case '(':
-				add_token(c, &fp, TK_PAR_L);
+				add_bracket_l(c, &fp, TK_PAR_L, &bracket_stack);
 				break;
 			case ')':
-				add_token(c, &fp, TK_PAR_R);
+				add_bracket_r(c, &fp, TK_PAR_R, &bracket_stack);
 				break;
 			case '[':
-				add_token(c, &fp, TK_SQR_L);
+				add_bracket_l(c, &fp, TK_SQR_L, &bracket_stack);
 				break;
 			case ']':
-				add_token(c, &fp, TK_SQR_R);
+				add_bracket_r(c, &fp, TK_SQR_R, &bracket_stack);
 				break;
 			case '{':
-				add_token(c, &fp, TK_BRAC_L);
+				add_bracket_l(c, &fp, TK_BRAC_L, &bracket_stack);
 				break;
 			case '}':
-				add_token(c, &fp, TK_BRAC_R);
+				add_bracket_r(c, &fp, TK_BRAC_R, &bracket_stack);
 				break;
 			case '=': {
 				if (match_str(&fp, "==")) {
@@ -269,12 +306,12 @@ bool heck_scan(heck_code* c, FILE* f) {
 				if (match_str(&fp, ">=")) {
 					add_token(c, &fp, TK_OP_GTR_EQ);
 					continue;
+				} else if (match_str(&fp, ">>=")) { // check before >> or it would never match
+					add_token(c, &fp, TK_OP_SHFT_R_ASG);
+					continue;
 				} else if (match_str(&fp, ">>")) {
 					add_token(c, &fp, TK_OP_SHFT_R);
 					continue;
-				} else if (match_str(&fp, ">>=")) {
-					add_token(c, &fp, TK_OP_SHFT_R_ASG);
-					continue;
 				} else {
 					add_token(c, &fp, TK_OP_GTR);
 				}
@@ -284,12 +321,12 @@ bool heck_scan(heck_code* c, FILE* f) {
 				if (match_str(&fp, "<=")) {
 					add_token(c, &fp, TK_OP_LESS_EQ);
 					continue;
+				} else if (match_str(&fp, "<<=")) { // check before << or it would never match
+					add_token(c, &fp, TK_OP_SHFT_L_ASG);
+					continue;
 				} else if (match_str(&fp, "<<")) {
 					add_token(c, &fp, TK_OP_SHFT_L);
 					continue;
-				} else if (match_str(&fp, "<<=")) {
-					add_token(c, &fp, TK_OP_SHFT_L_ASG);
-					continue;
 				} else {
 					add_token(c, &fp, TK_OP_LESS);
 				}
@@ -321,9 +358,11 @@ bool heck_scan(heck_code* c, FILE* f) {
 			}
 			case '*': {
 				if (match_str(&fp, "**")) {
-					add_token(c, &fp, TK_OP_EXP);
-				} if (match_str(&fp, "*=")) {
+					add_token(c, &fp, TK_OP_EXP); // exponent
+					continue;
+				} else if (match_str(&fp, "*=")) {
 					add_token(c, &fp, TK_OP_MULT_ASG); // multipication assignment
+					continue;
 				} else {
 					add_token(c, &fp, TK_OP_MULT); // multiplication
 				}
@@ -358,6 +397,7 @@ bool heck_scan(heck_code* c, FILE* f) {
 					
 				} else if (match_str(&fp, "/=")) {
 					add_token(c, &fp, TK_OP_DIV_ASG); // division assignment
+					continue;
 				} else {
 					add_token(c, &fp, TK_OP_DIV); // division
 				}
@@ -366,8 +406,10 @@ bool heck_scan(heck_code* c, FILE* f) {
 			case '+': {
 				if (match_str(&fp, "++")) {
 					add_token(c, &fp, TK_OP_INCR); // increment
+					continue;
 				} else if (match_str(&fp, "+=")) {
 					add_token(c, &fp, TK_OP_ADD_ASG); // addition assignment
+					continue;
 				} else {
 					add_token(c, &fp, TK_OP_ADD); // addition
 				}
@@ -375,17 +417,41 @@ bool heck_scan(heck_code* c, FILE* f) {
 			}
 			case '-': {
 				if (match_str(&fp, "--")) {
-					add_token(c, &fp, TK_OP_DECR); // increment
+					add_token(c, &fp, TK_OP_DECR); // decrement
+					continue;
 				} else if (match_str(&fp, "-=")) {
 					add_token(c, &fp, TK_OP_SUB_ASG); // subtraction assignment
+					continue;
 				} else {
 					add_token(c, &fp, TK_OP_SUB); // subtraction
 				}
 				break;
 			}
+			case '^': {
+				if (match_str(&fp, "^^")) {
+					add_token(c, &fp, TK_OP_XOR); // logical xor
+					continue;
+				} else if (match_str(&fp, "^=")) {
+					add_token(c, &fp, TK_OP_BW_XOR_ASG); // bitwise xor assignment
+					continue;
+				} else {
+					add_token(c, &fp, TK_OP_BW_XOR); // bitwise xor
+				}
+				break;
+			}
+			case '~': {
+				if (match_str(&fp, "~=")) {
+					add_token(c, &fp, TK_OP_BW_NOT_ASG); // bitwise not assignment
+					continue;
+				} else {
+					add_token(c, &fp, TK_OP_BW_NOT); // bitwise not
+				}
+				break;
+			}
 			case '%': {
 				if (match_str(&fp, "%=")) {
 					add_token(c, &fp, TK_OP_MOD_ASG); // modulus assignment
+					continue;
 				} else {
 					add_token(c, &fp, TK_OP_MOD); // modulus
 				}
@@ -498,7 +564,7 @@ bool heck_scan(heck_code* c, FILE* f) {
 						add_token_bool(c, &fp, true);
 						
 					} else if (strcmp(token, "false") == 0) {
-						add_token_bool(c, &fp, true);
+						add_token_bool(c, &fp, false);
 						
 					} else if (strcmp(token, "null") == 0) {
 						add_token(c, &fp, TK_KW_NULL);
@@ -531,7 +597,7 @@ bool heck_scan(heck_code* c, FILE* f) {
 						continue; // prevent the string from being freed
 					}
 					
-					free(token);
+					mem_free(token);
 					
 					continue; // avoid step at the end
 					
@@ -550,7 +616,9 @@ bool heck_scan(heck_code* c, FILE* f) {
 	// add the end token
 	add_token(c, &fp, TK_EOF);
 	
-	free((void*)fp.file); // clean up the file we loaded into memory
+	vector_free(bracket_stack);
+	
+	mem_free((void*)fp.file); // clean up the file we loaded into memory
 	
 	return true;
 }
@@ -560,8 +628,8 @@ bool parse_string(heck_code* c, file_pos* fp) {
 	
 	char quote = fp->current; // keep track of the quote type we're using
 	
-	int index, len;
-	char* str = str_create(&index, &len, NULL);
+	int len, alloc;
+	char* str = str_create(&len, &alloc, NULL);
 	
 	// add to the string until we reach an unescaped quote of the same type
 	bool ch_escaped = false;
@@ -574,7 +642,7 @@ bool parse_string(heck_code* c, file_pos* fp) {
 			add_token_err(c, fp);
 			
 			// free the invalid string
-			free(str);
+			mem_free(str);
 			return false;
 		}
 		
@@ -588,19 +656,19 @@ bool parse_string(heck_code* c, file_pos* fp) {
 				case '\'': // fallthrough
 				case '"':
 				case '\\':
-					str = str_add_char(str, &index, &len, fp->current);
+					str = str_add_char(str, &len, &alloc, fp->current);
 					break;
 				case 'n':
-					str = str_add_char(str, &index, &len, '\n');
+					str = str_add_char(str, &len, &alloc, '\n');
 					break;
 				case 'r':
-					str = str_add_char(str, &index, &len, '\r');
+					str = str_add_char(str, &len, &alloc, '\r');
 					break;
 				case 'b':
-					str = str_add_char(str, &index, &len, '\b');
+					str = str_add_char(str, &len, &alloc, '\b');
 					break;
 				case 't':
-					str = str_add_char(str, &index, &len, '\t');
+					str = str_add_char(str, &len, &alloc, '\t');
 					break;
 					// TODO: handle more escape sequences:
 					// https://en.wikipedia.org/wiki/Escape_sequences_in_C#Table_of_escape_sequences
@@ -620,7 +688,7 @@ bool parse_string(heck_code* c, file_pos* fp) {
 					} while (!is_end(fp));
 					
 					// free the invalid string
-					free(str);
+					mem_free(str);
 					return false;
 					
 				}
@@ -634,7 +702,7 @@ bool parse_string(heck_code* c, file_pos* fp) {
 			continue;
 			
 		} else {
-			str = str_add_char(str, &index, &len, fp->current);
+			str = str_add_char(str, &len, &alloc, fp->current);
 		}
 		
 	}
@@ -704,3 +772,48 @@ void parse_number(heck_code* c, file_pos* fp) {
 	}
 	
 }
+
+// tokens are only the same if they also start (or don't start) a new line, since newlines end statements
+bool token_same(heck_token** a_vec, int a, heck_token** b_vec, int b) {
+	if (!heck_token_cmp(a_vec[a], b_vec[b]))
+		return false;
+	
+	bool a_newline = a > 0 && a_vec[a]->ln != a_vec[a - 1]->ln;
+	bool b_newline = b > 0 && b_vec[b]->ln != b_vec[b - 1]->ln;
+	return a_newline == b_newline;
+}
+
+bool heck_rescan(heck_code* c, FILE* f, heck_token_edit* edit) {
+	
+	// if the code was rescanned without being reparsed, the tree still belongs to prev_token_vec
+	if (c->prev_token_vec == NULL)
+		c->prev_token_vec = c->token_vec;
+	else
+		heck_free_token_vec(c->token_vec);
+	c->token_vec = vector_create();
+	
+	// identifiers are interned in the same str_table, so they can be compared by address
+	bool success = heck_scan(c, f);
+	
+	heck_token** old_vec = c->prev_token_vec;
+	heck_token** new_vec = c->token_vec;
+	int old_size = (int)vector_size(old_vec);
+	int new_size = (int)vector_size(new_vec);
+	
+	// the range between the longest common prefix and suffix
+	int start = 0;
+	while (start < old_size && start < new_size && token_same(old_vec, start, new_vec, start))
+		++start;
+	
+	int old_end = old_size, new_end = new_size;
+	while (old_end > start && new_end > start && token_same(old_vec, old_end - 1, new_vec, new_end - 1)) {
+		--old_end;
+		--new_end;
+	}
+	
+	edit->start = start;
+	edit->end = new_end;
+	edit->old_end = old_end;
+	
+	return success;
+}
@@ -15,4 +15,8 @@
 // returns 0 on failure
 bool heck_scan(heck_code* c, FILE* f);
 
+// scans new source for code that was already parsed, the old tokens are kept until heck_reparse.
+// edit is set to the range of tokens that changed
+bool heck_rescan(heck_code* c, FILE* f, heck_token_edit* edit);
+
 #endif /* scanner_h */
@@ -0,0 +1,67 @@
+//
+//  arena.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "arena.h"
+#include <string.h>
+#include <stdalign.h>
+
+#define ARENA_CHUNK_SIZE 16384
+
+typedef struct arena_chunk {
+	struct arena_chunk* next;
+	size_t size; // usable bytes after the header
+	alignas(max_align_t) unsigned char data[];
+} arena_chunk;
+
+struct heck_arena {
+	arena_chunk* chunks; // the chunk being allocated from comes first
+	size_t pos; // bytes used in the first chunk
+	heck_mem_tag tag;
+};
+
+heck_arena* arena_create(heck_mem_tag tag) {
+	heck_arena* arena = mem_alloc(sizeof(heck_arena), tag);
+	arena->chunks = NULL;
+	arena->pos = 0;
+	arena->tag = tag;
+	
+	return arena;
+}
+
+void arena_free(heck_arena* arena) {
+	arena_chunk* chunk = arena->chunks;
+	while (chunk != NULL) {
+		arena_chunk* next = chunk->next;
+		mem_free(chunk);
+		chunk = next;
+	}
+	mem_free(arena);
+}
+
+void* arena_alloc(heck_arena* arena, size_t size) {
+	size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+	
+	arena_chunk* chunk = arena->chunks;
+	if (chunk == NULL || arena->pos + size > chunk->size) {
+		// allocations that don't fit in a chunk get one of their own
+		size_t chunk_size = size > ARENA_CHUNK_SIZE ? size : ARENA_CHUNK_SIZE;
+		chunk = mem_alloc(sizeof(arena_chunk) + chunk_size, arena->tag);
+		chunk->size = chunk_size;
+		chunk->next = arena->chunks;
+		arena->chunks = chunk;
+		arena->pos = 0;
+	}
+	
+	void* ptr = &chunk->data[arena->pos];
+	arena->pos += size;
+	
+	return ptr;
+}
+
+void* arena_calloc(heck_arena* arena, size_t size) {
+	return memset(arena_alloc(arena, size), 0, size);
+}
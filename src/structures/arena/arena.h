@@ -0,0 +1,27 @@
+//
+//  arena.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Bump allocation for data that is freed all at once. Allocations are carved out of large chunks,
+//	so many small nodes cost one malloc per chunk, and freeing the arena frees every chunk together.
+//
+
+#ifndef arena_h
+#define arena_h
+
+#include <stddef.h>
+#include "mem.h"
+
+typedef struct heck_arena heck_arena;
+
+// every chunk is counted under tag
+heck_arena* arena_create(heck_mem_tag tag);
+void arena_free(heck_arena* arena);
+
+// the memory is aligned for any type and isn't cleared
+void* arena_alloc(heck_arena* arena, size_t size);
+void* arena_calloc(heck_arena* arena, size_t size);
+
+#endif /* arena_h */
@@ -0,0 +1,93 @@
+//
+//  bitset.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "bitset.h"
+#include <string.h>
+#include "mem.h"
+
+heck_bits* bitset_create(int num_sets, int num_words) {
+	// calloc(0) may return NULL, which would look like a failed allocation
+	size_t num = (size_t)num_sets * num_words;
+	return mem_calloc(num > 0 ? num : 1, sizeof(heck_bits), MEM_FLOW);
+}
+
+void bitset_free(heck_bits* sets) {
+	mem_free(sets);
+}
+
+void bitset_clear(heck_bits* set, int num_words) {
+	memset(set, 0, num_words * sizeof(heck_bits));
+}
+
+void bitset_fill(heck_bits* set, int num_bits) {
+	int num_words = bitset_words(num_bits);
+	memset(set, 0xff, num_words * sizeof(heck_bits));
+	if (num_bits % BITSET_WORD_BITS != 0)
+		set[num_words - 1] = ((heck_bits)1 << (num_bits % BITSET_WORD_BITS)) - 1;
+}
+
+void bitset_copy(heck_bits* restrict dst, const heck_bits* restrict src, int num_words) {
+	memcpy(dst, src, num_words * sizeof(heck_bits));
+}
+
+bool bitset_union(heck_bits* restrict dst, const heck_bits* restrict src, int num_words) {
+	heck_bits changed = 0;
+	for (int i = 0; i < num_words; ++i) {
+		heck_bits word = dst[i] | src[i];
+		changed |= word ^ dst[i];
+		dst[i] = word;
+	}
+	return changed != 0;
+}
+
+bool bitset_intersect(heck_bits* restrict dst, const heck_bits* restrict src, int num_words) {
+	heck_bits changed = 0;
+	for (int i = 0; i < num_words; ++i) {
+		heck_bits word = dst[i] & src[i];
+		changed |= word ^ dst[i];
+		dst[i] = word;
+	}
+	return changed != 0;
+}
+
+void bitset_subtract(heck_bits* restrict dst, const heck_bits* restrict src, int num_words) {
+	for (int i = 0; i < num_words; ++i)
+		dst[i] &= ~src[i];
+}
+
+bool bitset_transfer(heck_bits* restrict out, const heck_bits* in, const heck_bits* gen, const heck_bits* kill, int num_words) {
+	heck_bits changed = 0;
+	for (int i = 0; i < num_words; ++i) {
+		heck_bits word = gen[i] | (in[i] & ~kill[i]);
+		changed |= word ^ out[i];
+		out[i] = word;
+	}
+	return changed != 0;
+}
+
+int bitset_next(const heck_bits* set, int bit, int num_bits) {
+	if (bit >= num_bits)
+		return -1;
+	
+	int i = bit / BITSET_WORD_BITS;
+	heck_bits word = set[i] & (~(heck_bits)0 << (bit % BITSET_WORD_BITS));
+	
+	int num_words = bitset_words(num_bits);
+	while (word == 0) {
+		if (++i == num_words)
+			return -1;
+		word = set[i];
+	}
+	
+	// index of the lowest set bit
+	int next = i * BITSET_WORD_BITS;
+	while ((word & 1) == 0) {
+		word >>= 1;
+		++next;
+	}
+	return next < num_bits ? next : -1;
+}
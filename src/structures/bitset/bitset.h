@@ -0,0 +1,59 @@
+//
+//  bitset.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Dense bitsets stored as arrays of 64-bit words. Dataflow analyses allocate every set they need
+//	in one array, so the operations take the number of words instead of storing it in each set.
+//	The loops have no branches in them, so the compiler can vectorize them.
+//
+
+#ifndef bitset_h
+#define bitset_h
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint64_t heck_bits;
+
+#define BITSET_WORD_BITS 64
+
+// the number of words needed to store num_bits bits
+static inline int bitset_words(int num_bits) {
+	return (num_bits + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+}
+
+// allocates num_sets empty sets in one array, set i starts at i * num_words
+heck_bits* bitset_create(int num_sets, int num_words);
+void bitset_free(heck_bits* sets);
+
+static inline bool bitset_test(const heck_bits* set, int bit) {
+	return (set[bit / BITSET_WORD_BITS] >> (bit % BITSET_WORD_BITS)) & 1;
+}
+static inline void bitset_set(heck_bits* set, int bit) {
+	set[bit / BITSET_WORD_BITS] |= (heck_bits)1 << (bit % BITSET_WORD_BITS);
+}
+static inline void bitset_reset(heck_bits* set, int bit) {
+	set[bit / BITSET_WORD_BITS] &= ~((heck_bits)1 << (bit % BITSET_WORD_BITS));
+}
+
+void bitset_clear(heck_bits* set, int num_words);
+// sets the first num_bits bits, the rest of the last word stays clear
+void bitset_fill(heck_bits* set, int num_bits);
+void bitset_copy(heck_bits* restrict dst, const heck_bits* restrict src, int num_words);
+
+// these return true if dst changed
+bool bitset_union(heck_bits* restrict dst, const heck_bits* restrict src, int num_words);
+bool bitset_intersect(heck_bits* restrict dst, const heck_bits* restrict src, int num_words);
+
+// dst = dst & ~src
+void bitset_subtract(heck_bits* restrict dst, const heck_bits* restrict src, int num_words);
+
+// out = gen | (in & ~kill), returns true if out changed
+bool bitset_transfer(heck_bits* restrict out, const heck_bits* in, const heck_bits* gen, const heck_bits* kill, int num_words);
+
+// returns the first set bit at or after bit, or -1 if there isn't one
+int bitset_next(const heck_bits* set, int bit, int num_bits);
+
+#endif /* bitset_h */
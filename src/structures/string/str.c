@@ -9,9 +9,10 @@
 #include "table.h"
 #include <stdlib.h>
 #include <string.h>
+#include "mem.h"
 
 str_entry create_str_entry(const char* value, size_t size) {
-	struct str_obj* s = malloc(sizeof(struct str_obj));
+	struct str_obj* s = mem_alloc(sizeof(struct str_obj), MEM_STRINGS);
 	s->value = value;
 	s->size = size;
 	s->hash = hash_data(value, size);
@@ -24,12 +25,12 @@ char* str_create(int* len, int* alloc, const char* val) {
 	if (val == NULL) {
 		*len = 0;
 		*alloc = 1;
-		str = malloc(sizeof(char) * (*alloc + 1));
+		str = mem_alloc(sizeof(char) * (*alloc + 1), MEM_STRINGS);
 		str[*alloc] = '\0'; // null terminator
 	} else {
 		*alloc = (int)strlen(val);
 		*len = *alloc - 1;
-		str = malloc(sizeof(char) * (*alloc + 1));
+		str = mem_alloc(sizeof(char) * (*alloc + 1), MEM_STRINGS);
 		strcpy(str, val);
 	}
 	
@@ -43,7 +44,7 @@ char* str_add_char(char* str, int* len, int* alloc, char val) {
 	// reallocate if necessary
 	if (*len == *alloc) {
 		*alloc = *len * 2;
-		str = realloc(str, sizeof(char) * (*alloc + 1));
+		str = mem_realloc(str, sizeof(char) * (*alloc + 1), MEM_STRINGS);
 	}
 	
 	// add null terminator
@@ -58,7 +59,7 @@ char* str_add_str(char* str, int* len, int* alloc, const char* val) {
 	int new_alloc = (int)strlen(val) + *len;
 	if (new_alloc >= *alloc) {
 		*alloc = new_alloc;
-		str = realloc(str, sizeof(char) * (*alloc + 1));
+		str = mem_realloc(str, sizeof(char) * (*alloc + 1), MEM_STRINGS);
 	}
 	
 	// add string
@@ -75,7 +76,7 @@ char* str_copy(const char* val, int* len) {
 	/*	it's ok to use an int instead of unsigned long,
 	 	this is for error messages, and this isn't C++ */
 	int val_len = (int)strlen(val);
-	char* str = malloc(sizeof(char) * val_len + 1);
+	char* str = mem_alloc(sizeof(char) * val_len + 1, MEM_STRINGS);
 	strcpy(str, val);
 	
 	if (len != NULL)
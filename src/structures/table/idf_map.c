@@ -8,6 +8,7 @@
 #include "idf_map.h"
 #include "table.h"
 #include <string.h>
+#include "mem.h"
 
 // calloc will set these to null
 typedef struct idf_entry {
@@ -22,9 +23,9 @@ struct idf_map {
 };
 
 idf_map* idf_map_create(void) {
-	idf_map* m = malloc(sizeof(idf_map));
+	idf_map* m = mem_alloc(sizeof(idf_map), MEM_SCOPES);
 	m->capacity = TABLE_DEFAULT_CAPACITY;
-	m->buckets = calloc(TABLE_DEFAULT_CAPACITY, sizeof(idf_entry));
+	m->buckets = mem_calloc(TABLE_DEFAULT_CAPACITY, sizeof(idf_entry), MEM_SCOPES);
 	m->count = 0;
 	return m;
 }
@@ -32,10 +33,10 @@ idf_map* idf_map_create(void) {
 void idf_map_free(idf_map* m) {
 	for (int i = 0; i < m->capacity; ++i) {
 		if (m->buckets[i].key != NULL) {
-			free((void*)m->buckets[i].value);
+			mem_free((void*)m->buckets[i].value);
 		}
 	}
-	free(m);
+	mem_free(m);
 }
 
 // puts an old bucket into a resized str_table
@@ -59,7 +60,7 @@ static void idf_map_resize(idf_map* m) {
 	idf_entry* old_buckets = m->buckets;
 	
 	m->capacity *= TABLE_RESIZE_FACTOR;
-	m->buckets = calloc(m->capacity, sizeof(idf_entry)); // initializes everything to 0
+	m->buckets = mem_calloc(m->capacity, sizeof(idf_entry), MEM_SCOPES); // initializes everything to 0
 	//printf("resize %i\n", t->capacity);
 	
 	for (int i = 0; i < old_capacity; ++i) {
@@ -69,7 +70,7 @@ static void idf_map_resize(idf_map* m) {
 		resize_entry(m, old_bucket);
 	}
 	
-	free(old_buckets);
+	mem_free(old_buckets);
 }
 
 
@@ -117,6 +118,36 @@ void idf_map_set(idf_map* m, str_entry key, void* input_val) {
 	
 }
 
+bool idf_map_remove(idf_map* m, str_entry key) {
+	idf_entry* entry = find_entry(m, key);
+	if (entry->key == NULL)
+		return false;
+	
+	// there are no tombstones, so entries after the hole are moved back into it
+	// unless that would put them before the bucket they hash to
+	uint32_t hole = (uint32_t)(entry - m->buckets);
+	uint32_t index = hole;
+	for (;;) {
+		index = (index + 1) % m->capacity;
+		idf_entry* next = &m->buckets[index];
+		if (next->key == NULL)
+			break;
+		
+		uint32_t home = next->key->hash % m->capacity;
+		bool movable = hole < index ? (home <= hole || home > index) : (home <= hole && home > index);
+		if (movable) {
+			m->buckets[hole] = *next;
+			hole = index;
+		}
+	}
+	
+	m->buckets[hole].key = NULL;
+	m->buckets[hole].value = NULL;
+	m->count--;
+	
+	return true;
+}
+
 int idf_map_size(idf_map* m) {
 	return m->count;
 }
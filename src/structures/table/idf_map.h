@@ -24,6 +24,9 @@ bool idf_map_get(idf_map* m, str_entry key, void** output_val);
 
 void idf_map_set(idf_map* m, str_entry key, void* input_val);
 
+// returns false if there is no match, the value isn't freed
+bool idf_map_remove(idf_map* m, str_entry key);
+
 int idf_map_size(idf_map* m);
 
 // map_iterate is not very fast, used mostly for printing/debugging
@@ -0,0 +1,70 @@
+//
+//  ptr_map.c
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+
+#include "ptr_map.h"
+#include "table.h"
+
+#define PTR_MAP_MIN_SIZE 16
+
+void ptr_map_init(ptr_map* map, heck_mem_tag tag) {
+	map->keys = NULL;
+	map->values = NULL;
+	map->alloc = 0;
+	map->size = 0;
+	map->tag = tag;
+}
+
+void ptr_map_free(ptr_map* map) {
+	mem_free(map->keys);
+	mem_free(map->values);
+}
+
+static uint32_t ptr_map_hash(const void* key) {
+	return hash_data(&key, sizeof(key));
+}
+
+int ptr_map_get(const ptr_map* map, const void* key) {
+	if (map->alloc == 0)
+		return -1;
+	
+	for (uint32_t i = ptr_map_hash(key) & (map->alloc - 1);; i = (i + 1) & (map->alloc - 1)) {
+		if (map->keys[i] == key)
+			return map->values[i];
+		if (map->keys[i] == NULL)
+			return -1;
+	}
+}
+
+static void ptr_map_insert(ptr_map* map, const void* key, int value) {
+	uint32_t i = ptr_map_hash(key) & (map->alloc - 1);
+	while (map->keys[i] != NULL)
+		i = (i + 1) & (map->alloc - 1);
+	map->keys[i] = key;
+	map->values[i] = value;
+}
+
+void ptr_map_set(ptr_map* map, const void* key, int value) {
+	if ((map->size + 1) * 4 > map->alloc * 3) {
+		const void** old_keys = map->keys;
+		int* old_values = map->values;
+		int old_alloc = map->alloc;
+		
+		map->alloc = old_alloc > 0 ? old_alloc * 2 : PTR_MAP_MIN_SIZE;
+		map->keys = mem_calloc(map->alloc, sizeof(void*), map->tag);
+		map->values = mem_alloc(map->alloc * sizeof(int), map->tag);
+		for (int i = 0; i < old_alloc; ++i) {
+			if (old_keys[i] != NULL)
+				ptr_map_insert(map, old_keys[i], old_values[i]);
+		}
+		
+		mem_free(old_keys);
+		mem_free(old_values);
+	}
+	
+	ptr_map_insert(map, key, value);
+	++map->size;
+}
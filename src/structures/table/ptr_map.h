@@ -0,0 +1,32 @@
+//
+//  ptr_map.h
+//  Heck
+//
+//  Created by agent on 10/19/26.
+//
+//	Maps pointers to indices, for giving the functions and variables the backend sees a number
+//	without adding a field to them. Keys are compared by address, and NULL can't be a key.
+//
+
+#ifndef ptr_map_h
+#define ptr_map_h
+
+#include "mem.h"
+
+typedef struct ptr_map {
+	const void** keys;
+	int* values;
+	int alloc; // always a power of 2
+	int size;
+	heck_mem_tag tag;
+} ptr_map;
+
+void ptr_map_init(ptr_map* map, heck_mem_tag tag);
+void ptr_map_free(ptr_map* map);
+
+// -1 if the key isn't in the map
+int ptr_map_get(const ptr_map* map, const void* key);
+// the key must not be in the map yet
+void ptr_map_set(ptr_map* map, const void* key, int value);
+
+#endif /* ptr_map_h */
@@ -11,6 +11,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include "mem.h"
 
 
 // values will be zero/false because of calloc
@@ -29,9 +30,9 @@ typedef struct str_table {
 } str_table;
 
 str_table* str_table_create(void) {
-	str_table* t = malloc(sizeof(str_table));
+	str_table* t = mem_alloc(sizeof(str_table), MEM_STRINGS);
 	t->capacity = TABLE_DEFAULT_CAPACITY;
-	t->buckets = calloc(TABLE_DEFAULT_CAPACITY, sizeof(str_entry));
+	t->buckets = mem_calloc(TABLE_DEFAULT_CAPACITY, sizeof(str_entry), MEM_STRINGS);
 	t->count = 0;
 	return t;
 }
@@ -39,20 +40,18 @@ str_table* str_table_create(void) {
 void str_table_free(str_table* t) {
 	for (int i = 0; i < t->capacity; ++i) {
 		if (t->buckets[i] != NULL) {
-			free((void*)t->buckets[i]);
+			mem_free((void*)t->buckets[i]);
 		}
 	}
-	free(t);
+	mem_free(t);
 }
 
 // puts an old bucket into a resized str_table
 static void resize_entry(str_table* t, str_entry old_entry) {
 	uint32_t index = old_entry->hash % t->capacity;
 	for (;;) {
-		str_entry entry = t->buckets[index];
-		
-		if (entry == NULL) {
-			entry = old_entry; // copy data from old entry
+		if (t->buckets[index] == NULL) {
+			t->buckets[index] = old_entry;
 			break;
 		}
 		
@@ -66,7 +65,7 @@ static void str_table_resize(str_table* t) {
 	str_entry* old_buckets = t->buckets;
 	
 	t->capacity *= TABLE_RESIZE_FACTOR;
-	t->buckets = calloc(t->capacity, sizeof(str_entry)); // initializes everything to 0
+	t->buckets = mem_calloc(t->capacity, sizeof(str_entry), MEM_STRINGS); // initializes everything to 0
 	//printf("resize %i\n", t->capacity);
 	
 	for (int i = 0; i < old_capacity; ++i) {
@@ -76,7 +75,7 @@ static void str_table_resize(str_table* t) {
 		resize_entry(t, old_bucket);
 	}
 	
-	free(old_buckets);
+	mem_free(old_buckets);
 }
 
 /*	returns the address of the bucket (str_obj**) rather than the actual bucket (str_obj*)
@@ -112,8 +111,8 @@ str_entry str_table_get_entry(str_table* t, str_entry value) {
 		/*	free duplicate
 		 	like realloc, it frees the old, unused value and returns the new one */
 		if (*entry != value) {
-			free((void*)value->value);
-			free((void*)value);
+			mem_free((void*)value->value);
+			mem_free((void*)value);
 		}
 		
 		return *entry;
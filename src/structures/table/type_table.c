@@ -9,6 +9,7 @@
 #include "table.h"
 #include <stdlib.h>
 #include <string.h>
+#include "mem.h"
 
 // calloc will initialize to zero
 typedef struct type_entry {
@@ -23,18 +24,32 @@ struct type_table {
 };
 
 // recursively hashes types with template arguments
-uint32_t hash_data_type(heck_data_type* type) {
+uint32_t hash_data_type(const heck_data_type* type) {
 	uint32_t hash = TABLE_HASH_INIT;
+	type = data_type_find(type);
 	
-	//if (type->type_name == TYPE_CLASS && type->type_value.)
+	// arrays hash the type they store
+	while (type->type_name == TYPE_ARR) {
+		hash = (hash ^ TYPE_ARR) * 16777619;
+		type = type->type_value.arr_type;
+	}
+	hash = (hash ^ type->type_name) * 16777619;
+	
+	// the class itself isn't known until it's resolved, so only the template arguments are hashed
+	if (type->type_name == TYPE_CLASS && type->type_value.class_type.type_args.type_vec != NULL) {
+		heck_data_type** type_vec = type->type_value.class_type.type_args.type_vec;
+		vec_size_t num_type_args = vector_size(type_vec);
+		for (vec_size_t i = 0; i < num_type_args; ++i)
+			hash = (hash ^ hash_data_type(type_vec[i])) * 16777619;
+	}
 
 	return hash;
 }
 
 type_table* type_table_create(void) {
-	type_table* t = malloc(sizeof(type_table));
+	type_table* t = mem_alloc(sizeof(type_table), MEM_TYPES);
 	t->capacity = TABLE_DEFAULT_CAPACITY;
-	t->buckets = calloc(TABLE_DEFAULT_CAPACITY, sizeof(type_entry));
+	t->buckets = mem_calloc(TABLE_DEFAULT_CAPACITY, sizeof(type_entry), MEM_TYPES);
 	t->count = 0;
 	return t;
 }
@@ -42,10 +57,10 @@ type_table* type_table_create(void) {
 void type_table_free(type_table* t) {
 	for (int i = 0; i < t->capacity; ++i) {
 		if (t->buckets[i].value != NULL) {
-			free((void*)t->buckets[i].value);
+			mem_free((void*)t->buckets[i].value);
 		}
 	}
-	free(t);
+	mem_free(t);
 }
 
 // puts an old bucket into a resized type_table
@@ -56,7 +71,7 @@ static void resize_entry(type_table* t, type_entry* old_entry) {
 		
 		// types in the table can never be NULL, must be empty
 		if (entry->value == NULL) {
-			entry = old_entry; // copy data from old entry
+			*entry = *old_entry; // copy data from old entry
 			break;
 		}
 		
@@ -70,7 +85,7 @@ static void type_table_resize(type_table* t) {
 	type_entry* old_buckets = t->buckets;
 	
 	t->capacity *= TABLE_RESIZE_FACTOR;
-	t->buckets = calloc(t->capacity, sizeof(type_entry)); // initializes everything to 0
+	t->buckets = mem_calloc(t->capacity, sizeof(type_entry), MEM_TYPES); // initializes everything to 0
 	//printf("resize %i\n", t->capacity);
 	
 	for (int i = 0; i < old_capacity; ++i) {
@@ -80,7 +95,7 @@ static void type_table_resize(type_table* t) {
 		resize_entry(t, old_bucket);
 	}
 	
-	free(old_buckets);
+	mem_free(old_buckets);
 }
 
 /*	returns the address of the bucket (str_obj**) rather than the actual bucket (str_obj*)
@@ -119,7 +134,7 @@ heck_data_type* type_table_get_entry(type_table* t, heck_data_type* value) {
 		/*	free duplicate
 		 like realloc, it frees the old, unused value and returns the new one */
 		if (entry->value != value) {
-			free((void*)value);
+			mem_free((void*)value);
 		}
 		
 		return entry->value;
@@ -20,6 +20,9 @@ typedef struct type_table type_table;
 type_table* type_table_create(void);
 void type_table_free(type_table* t);
 
+// types that data_type_cmp considers equal have the same hash
+uint32_t hash_data_type(const heck_data_type* type);
+
 // returns either an existing entry or a new one if no matching value exists
 // assumes ownership of the data if creating a new entry (to avoid copying), frees data if entry exists
 // TODO: better function name
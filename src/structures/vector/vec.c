@@ -6,35 +6,43 @@
 
 #include "vec.h"
 #include <string.h>
+#include "mem.h"
 
 typedef struct vector_data vector_data;
 
 struct vector_data {
-	vec_size_t alloc;				// stores the number of bytes allocated
+	vec_size_t alloc;				// stores the number of elements allocated
 	vec_size_t length;
 	char buff[]; // use char to store bytes of an unknown type
 };
 
-vector_data* vector_alloc(vec_size_t alloc, vec_size_t size) {
-	vector_data* v_data = malloc(sizeof(vector_data) + alloc * size);
-	v_data->alloc = alloc;
-	return v_data;
-}
+// set in alloc if the buffer is not on the heap (the empty vector or inline storage)
+#define VEC_NOT_OWNED	((vec_size_t)1 << (sizeof(vec_size_t) * 8 - 1))
+#define VEC_MIN_ALLOC	4
+
+// shared by every empty vector, it is never written to
+static vector_data vector_empty = { VEC_NOT_OWNED, 0 };
 
 vector_data* vector_get_data(vector vec) {
 	return &((vector_data*)vec)[-1];
 }
 
 vector vector_create(void) {
-	vector_data* v = malloc(sizeof(vector_data));
-	v->alloc = 0;
-	v->length = 0;
+	return &vector_empty.buff;
+}
+
+vector _vector_create_small(void* storage, vec_size_t count) {
+	vector_data* v_data = storage;
+	v_data->alloc = count | VEC_NOT_OWNED;
+	v_data->length = 0;
 	
-	return &v->buff;
+	return &v_data->buff;
 }
 
 void vector_free(vector vec) {
-	free(vector_get_data(vec));
+	vector_data* v_data = vector_get_data(vec);
+	if (!(v_data->alloc & VEC_NOT_OWNED))
+		mem_free(v_data);
 }
 
 vec_size_t vector_size(vector vec) {
@@ -42,25 +50,39 @@ vec_size_t vector_size(vector vec) {
 }
 
 vec_size_t vector_get_alloc(vector vec) {
-	return vector_get_data(vec)->alloc;
+	return vector_get_data(vec)->alloc & ~VEC_NOT_OWNED;
 }
 
-vector_data* vector_realloc(vector_data* v_data, vec_type_t type_size) {
-	vec_size_t new_alloc = (v_data->alloc == 0) ? 1 : v_data->alloc * 2;
-	vector_data* new_v_data = realloc(v_data, sizeof(vector_data) + new_alloc * type_size);
+// moves the vector to a heap buffer with room for new_alloc elements
+vector_data* vector_realloc(vector_data* v_data, vec_type_t type_size, vec_size_t new_alloc) {
+	vector_data* new_v_data;
+	
+	if (v_data->alloc & VEC_NOT_OWNED) {
+		new_v_data = mem_alloc(sizeof(vector_data) + new_alloc * type_size, MEM_VECTORS);
+		new_v_data->length = v_data->length;
+		memcpy(new_v_data->buff, v_data->buff, v_data->length * type_size);
+	} else {
+		new_v_data = mem_realloc(v_data, sizeof(vector_data) + new_alloc * type_size, MEM_VECTORS);
+	}
+	
 	new_v_data->alloc = new_alloc;
 	return new_v_data;
 }
 
+vector_data* vector_grow(vector_data* v_data, vec_type_t type_size) {
+	vec_size_t alloc = v_data->alloc & ~VEC_NOT_OWNED;
+	return vector_realloc(v_data, type_size, alloc < VEC_MIN_ALLOC ? VEC_MIN_ALLOC : alloc * 2);
+}
+
 bool vector_has_space(vector_data* v_data) {
-	return v_data->alloc - v_data->length > 0;
+	return (v_data->alloc & ~VEC_NOT_OWNED) > v_data->length;
 }
 
 void* _vector_add(vector* vec_addr, vec_type_t type_size) {
 	vector_data* v_data = vector_get_data(*vec_addr);
 	
 	if (!vector_has_space(v_data)) {
-		v_data = vector_realloc(v_data, type_size);
+		v_data = vector_grow(v_data, type_size);
 		*vec_addr = v_data->buff;
 	}
 	
@@ -70,23 +92,25 @@ void* _vector_add(vector* vec_addr, vec_type_t type_size) {
 void* _vector_insert(vector* vec_addr, vec_type_t type_size, vec_size_t pos) {
 	vector_data* v_data = vector_get_data(*vec_addr);
 	
-	vec_size_t new_length = v_data->length + 1;
-	
 	// make sure there is enough room for the new element
 	if (!vector_has_space(v_data)) {
-		v_data = vector_realloc(v_data, type_size);
+		v_data = vector_grow(v_data, type_size);
+		*vec_addr = v_data->buff;
 	}
 	memmove(&v_data->buff[(pos+1) * type_size],
 			&v_data->buff[pos * type_size],
 			(v_data->length - pos) * type_size); // move trailing elements
 	
-	v_data->length = new_length;
+	++v_data->length;
 	
 	return &v_data->buff[pos * type_size];
 }
 
-void _vector_erase(vector* vec_addr, vec_type_t type_size, vec_size_t pos, vec_size_t len) {
-	vector_data* v_data = vector_get_data(vec_addr);
+void _vector_erase(vector vec, vec_type_t type_size, vec_size_t pos, vec_size_t len) {
+	if (len == 0)
+		return;
+	
+	vector_data* v_data = vector_get_data(vec);
 	// anyone who puts in a bad index can face the consequences on their own
 	memmove(&v_data->buff[pos * type_size],
 			&v_data->buff[(pos+len) * type_size],
@@ -95,6 +119,33 @@ void _vector_erase(vector* vec_addr, vec_type_t type_size, vec_size_t pos, vec_s
 	v_data->length -= len;
 }
 
-void _vector_remove(vector* vec_addr, vec_type_t type_size, vec_size_t pos) {
-	_vector_erase(vec_addr, type_size, pos, 1);
+void _vector_remove(vector vec, vec_type_t type_size, vec_size_t pos) {
+	_vector_erase(vec, type_size, pos, 1);
+}
+
+void _vector_reserve(vector* vec_addr, vec_type_t type_size, vec_size_t count) {
+	vector_data* v_data = vector_get_data(*vec_addr);
+	
+	if ((v_data->alloc & ~VEC_NOT_OWNED) >= count)
+		return;
+	
+	v_data = vector_realloc(v_data, type_size, count);
+	*vec_addr = v_data->buff;
+}
+
+void _vector_shrink_to_fit(vector* vec_addr, vec_type_t type_size) {
+	vector_data* v_data = vector_get_data(*vec_addr);
+	
+	// inline storage can't be shrunk
+	if (v_data->alloc & VEC_NOT_OWNED || v_data->alloc == v_data->length)
+		return;
+	
+	if (v_data->length == 0) {
+		mem_free(v_data);
+		*vec_addr = vector_create();
+		return;
+	}
+	
+	v_data = vector_realloc(v_data, type_size, v_data->length);
+	*vec_addr = v_data->buff;
 }
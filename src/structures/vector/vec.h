@@ -12,11 +12,21 @@
 
 typedef void* vector; // you can't use this to store vectors, it's just used internally as a generic type
 typedef size_t vec_size_t; // stores the number of elements
-typedef unsigned char vec_type_t; // stores the number of bytes for a type
+typedef size_t vec_type_t; // stores the number of bytes for a type
 
 typedef int*	vec_int;
 typedef char*	vec_char;
 
+// inline storage for a small vector, e.g. as a struct member:
+//	heck_stmt** stmt_vec;
+//	vector_small_storage(heck_stmt*, 4) stmt_storage;
+// the vector uses the storage until it outgrows it, then moves to the heap.
+// the storage must not move while the vector is using it.
+#define vector_small_storage(type, count) struct { vec_size_t alloc; vec_size_t length; type buff[count]; }
+
+// storage is a pointer to a vector_small_storage
+#define vector_create_small(storage)		(_vector_create_small((storage), sizeof((storage)->buff) / sizeof(*(storage)->buff)))
+
 #ifndef _MSC_VER
 
 // shortcut defines
@@ -28,9 +38,12 @@ typedef char*	vec_char;
 #define vector_add(vec_addr, value)			(*vector_add_asg(vec_addr) = value)
 #define vector_insert(vec_addr, pos, value)	(*vector_insert_asg(vec_addr, pos) = value)
 
+#define vector_reserve(vec_addr, count)		(_vector_reserve((vector*)vec_addr, sizeof(typeof(**vec_addr)), count))
+#define vector_shrink_to_fit(vec_addr)		(_vector_shrink_to_fit((vector*)vec_addr, sizeof(typeof(**vec_addr))))
+
 // vec is a vector (aka type*)
-#define vector_erase(vec, pos, len)			(_vector_erase((vector*)vec, sizeof(typeof(*vec)), pos, len))
-#define vector_remove(vec, pos)				(_vector_remove((vector*)vec, sizeof(typeof(*vec)), pos))
+#define vector_erase(vec, pos, len)			(_vector_erase((vector)vec, sizeof(typeof(*vec)), pos, len))
+#define vector_remove(vec, pos)				(_vector_remove((vector)vec, sizeof(typeof(*vec)), pos))
 
 #else
 
@@ -43,23 +56,34 @@ typedef char*	vec_char;
 #define vector_add(vec_addr, type, value)			(*vector_add_asg(vec_addr, type) = value)
 #define vector_insert(vec_addr, type, pos, value)	(*vector_insert_asg(vec_addr, type, pos) = value)
 
+#define vector_reserve(vec_addr, type, count)		(_vector_reserve((vector*)vec_addr, sizeof(type), count))
+#define vector_shrink_to_fit(vec_addr, type)		(_vector_shrink_to_fit((vector*)vec_addr, sizeof(type)))
+
 // vec is a vector (aka type*)
-#define vector_erase(vec, type, pos, len)			(_vector_erase((vector*)vec, sizeof(type), pos, len))
-#define vector_remove(vec, type, pos)				(_vector_remove((vector*)vec, sizeof(type), pos))
+#define vector_erase(vec, type, pos, len)			(_vector_erase((vector)vec, sizeof(type), pos, len))
+#define vector_remove(vec, type, pos)				(_vector_remove((vector)vec, sizeof(type), pos))
 
 #endif
 
+// empty vectors don't allocate anything until the first element is added
 vector vector_create(void);
 
+vector _vector_create_small(void* storage, vec_size_t count);
+
 void vector_free(vector vec);
 
 void* _vector_add(vector* vec_addr, vec_type_t type_size);
 
 void* _vector_insert(vector* vec_addr, vec_type_t type_size, vec_size_t pos);
 
-void _vector_erase(vector* vec_addr, vec_type_t type_size, vec_size_t pos, vec_size_t len);
+void _vector_erase(vector vec, vec_type_t type_size, vec_size_t pos, vec_size_t len);
+
+void _vector_remove(vector vec, vec_type_t type_size, vec_size_t pos);
+
+// makes sure there is room for at least count elements
+void _vector_reserve(vector* vec_addr, vec_type_t type_size, vec_size_t count);
 
-void _vector_remove(vector* vec_addr, vec_type_t type_size, vec_size_t pos);
+void _vector_shrink_to_fit(vector* vec_addr, vec_type_t type_size);
 
 vec_size_t vector_size(vector vec);
 
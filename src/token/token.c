@@ -21,14 +21,49 @@ void heck_free_token_data(heck_token* tk) {
 		case TK_IDF:
 			//free((char*)tk->value.str_value);
 			break;
-		case TK_LITERAL:
-			free_literal(tk->value.literal_value);
 		default:
 			break;
 			
 	}
 }
 
+bool heck_token_cmp(const heck_token* a, const heck_token* b) {
+	if (a->type != b->type)
+		return false;
+	
+	switch (a->type) {
+		case TK_IDF:
+			return a->value.str_value == b->value.str_value;
+		case TK_ERR:
+			return false; // error tokens don't store what they were
+		case TK_LITERAL: {
+			const heck_literal* lit_a = &a->value.literal_value;
+			const heck_literal* lit_b = &b->value.literal_value;
+			if (lit_a->data_type != lit_b->data_type)
+				return false;
+			
+			switch (lit_a->data_type->type_name) {
+				case TYPE_INT:
+					return lit_a->value.int_value == lit_b->value.int_value;
+				case TYPE_FLOAT:
+					return lit_a->value.float_value == lit_b->value.float_value;
+				case TYPE_BOOL:
+					return lit_a->value.bool_value == lit_b->value.bool_value;
+				case TYPE_STRING:
+					return lit_a->value.str_value == lit_b->value.str_value;
+				default:
+					return lit_a->value.obj_value == lit_b->value.obj_value;
+			}
+		}
+		case TK_PRIM_TYPE:
+			return a->value.prim_type == b->value.prim_type;
+		case TK_CTX:
+			return a->value.ctx_value == b->value.ctx_value;
+		default:
+			return true; // brackets match different indices once other tokens move
+	}
+}
+
 void heck_print_token(heck_token* tk) {
 	
 	switch (tk->type) {
@@ -36,7 +71,7 @@ void heck_print_token(heck_token* tk) {
 			printf("[%s]", (char*)tk->value.str_value);
 			break;
 		case TK_LITERAL:
-			print_literal(tk->value.literal_value);
+			print_literal(&tk->value.literal_value);
 		case TK_ERR:
 			printf("\nerr: ln %i ch %i - %s\n", tk->ln, tk->ch, (char*)tk->value.str_value);
 			break;
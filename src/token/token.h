@@ -18,7 +18,8 @@ typedef struct heck_token heck_token;
 
 typedef union heck_token_value {
 	str_entry str_value; // for identifiers only, string literals are stored in literal_value
-	heck_literal* literal_value;
+	heck_literal literal_value;
+	int match_pos; // for brackets, the index of the matching bracket token or -1 if there isn't one
 	const heck_data_type* prim_type;
 	idf_context ctx_value;
 } heck_token_value;
@@ -31,6 +32,9 @@ struct heck_token {
 
 void heck_free_token_data(heck_token* tk);
 
+// compares the type and value of two tokens, but not where they are
+bool heck_token_cmp(const heck_token* a, const heck_token* b);
+
 // for testing only; remove this in release versions
 void heck_print_token(heck_token* tk);
 
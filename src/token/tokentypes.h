@@ -13,6 +13,9 @@
 // macro returns true if a token is an operator
 #define token_is_operator(token) (token > TK_BEGIN_OP && token < TK_END_OP)
 
+// macro returns true if a token is an assignment or compound assignment operator
+#define token_is_asg(token) (token >= TK_OP_ASG && token <= TK_OP_SHFT_R_ASG)
+
 // comments indicate the appropriate associated data type
 typedef enum heck_tk_type {
 	TK_IDF = 0,		// library string (identifier)
@@ -122,6 +125,8 @@ typedef enum heck_tk_type {
 	
 	// ALL TYPES
 	TK_PRIM_TYPE,		// primitive data type (heck_prim_type)
+	
+	TK_COUNT,		// the number of token types, used to size lookup tables
 } heck_tk_type;
 
 #endif /* tokentypes_h */
@@ -0,0 +1,55 @@
+#!/bin/sh
+# usage: tests/run.sh path/to/heck
+#
+# check/*.heck: heck --check must agree with a full parse and resolve on whether each file has errors
+# reparse/NAME.heck: reparsing it after NAME.old.heck must print the same as parsing it from scratch
+# out/NAME.heck: the output and exit code must match out/NAME.out, a first line like "// args: -O1 --print-ir"
+#   gives the options to run it with. if there is an out/NAME.old.heck, NAME.heck is reparsed after it
+
+heck=${1:?usage: $0 path/to/heck}
+dir=$(dirname "$0")
+failed=0
+
+for f in "$dir"/check/*.heck; do
+	"$heck" --check "$f" > /dev/null 2>&1
+	check=$?
+	"$heck" -j 1 "$f" > /dev/null 2>&1
+	full=$?
+	if [ "$check" != "$full" ]; then
+		echo "FAIL $f: --check exited $check, the full run exited $full"
+		failed=1
+	fi
+done
+
+# the output without the timing, then the exit code
+run() {
+	out=$("$heck" -j 1 "$@" 2>&1)
+	code=$?
+	printf '%s\nexit %s\n' "$out" "$code" | grep -v "^execution time"
+}
+
+for old in "$dir"/reparse/*.old.heck; do
+	f=${old%.old.heck}.heck
+	if [ "$(run --reparse "$old" "$f")" != "$(run "$f")" ]; then
+		echo "FAIL $f: reparsing it after $old doesn't match a fresh parse"
+		failed=1
+	fi
+done
+
+for f in "$dir"/out/*.heck; do
+	case "$f" in *.old.heck) continue ;; esac
+	args=$(sed -n '1s|^// args:||p' "$f")
+	old=${f%.heck}.old.heck
+	if [ -f "$old" ]; then
+		args="$args --reparse $old"
+	fi
+	if [ "$(run $args "$f")" != "$(cat "${f%.heck}.out")" ]; then
+		echo "FAIL $f: the output doesn't match ${f%.heck}.out"
+		failed=1
+	fi
+done
+
+if [ "$failed" = 0 ]; then
+	echo "all tests passed"
+fi
+exit $failed